@@ -24,6 +24,14 @@ subject to the following restrictions:
 #include "LinearMath/btAlignedAllocator.h"
 #include "LinearMath/btMinMax.h"
 
+#if defined(__linux__) || defined(__APPLE__)
+#define B_FILE_USE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif  //__linux__ || __APPLE__
+
 #define SIZEOFBLENDERHEADER 12
 #define MAX_ARRAY_LENGTH 512
 using namespace bParse;
@@ -57,6 +65,8 @@ bFile::bFile(const char *filename, const char headerString[7])
 	  mFileBuffer(0),
 	  mFileLen(0),
 	  mVersion(0),
+	  mMappedLen(0),
+	  mAllowZeroCopy(true),
 	  mDataStart(0),
 	  mFileDNA(0),
 	  mMemoryDNA(0),
@@ -67,6 +77,31 @@ bFile::bFile(const char *filename, const char headerString[7])
 		m_headerString[i] = headerString[i];
 	}
 
+#ifdef B_FILE_USE_MMAP
+	//map the file copy-on-write: pages are only copied when the parser modifies them
+	int fd = open(filename, O_RDONLY);
+	if (fd >= 0)
+	{
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			void *mapped = mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			if (mapped != MAP_FAILED)
+			{
+				mFileBuffer = (char *)mapped;
+				mFileLen = int(st.st_size);
+				mMappedLen = mFileLen;
+			}
+		}
+		close(fd);
+		if (mFileBuffer)
+		{
+			parseHeader();
+			return;
+		}
+	}
+#endif  //B_FILE_USE_MMAP
+
 	FILE *fp = fopen(filename, "rb");
 	if (fp)
 	{
@@ -91,6 +126,8 @@ bFile::bFile(char *memoryBuffer, int len, const char headerString[7])
 	  mFileBuffer(0),
 	  mFileLen(0),
 	  mVersion(0),
+	  mMappedLen(0),
+	  mAllowZeroCopy(false),
 	  mDataStart(0),
 	  mFileDNA(0),
 	  mMemoryDNA(0),
@@ -111,7 +148,12 @@ bFile::~bFile()
 {
 	if (mOwnsBuffer && mFileBuffer)
 	{
-		free(mFileBuffer);
+#ifdef B_FILE_USE_MMAP
+		if (mMappedLen)
+			munmap(mFileBuffer, mMappedLen);
+		else
+#endif  //B_FILE_USE_MMAP
+			free(mFileBuffer);
 		mFileBuffer = 0;
 	}
 
@@ -122,7 +164,7 @@ bFile::~bFile()
 // ----------------------------------------------------- //
 void bFile::parseHeader()
 {
-	if (!mFileLen || !mFileBuffer)
+	if (mFileLen < SIZEOFBLENDERHEADER || !mFileBuffer)
 		return;
 
 	char *blenderBuf = mFileBuffer;
@@ -206,12 +248,42 @@ void bFile::parseInternal(int verboseMode, char *memDna, int memDnaLength)
 		char *blenderData = mFileBuffer;
 		bChunkInd dna;
 		dna.oldPtr = 0;
+		dna.len = 0;
 
+		//Bullet files have no REND block and store DNA1 as the last chunk,
+		//so walk the chunk headers instead of scanning the whole file byte by byte
+		if (strncmp(m_headerString, "BULLET", 6) == 0)
+		{
+			char *chunkPtr = blenderData + SIZEOFBLENDERHEADER;
+			char *endPtr = blenderData + mFileLen;
+			while (chunkPtr + ChunkUtils::getOffset(mFlags) <= endPtr)
+			{
+				bChunkInd chunk;
+				int seek = getNextBlock(&chunk, chunkPtr, mFlags);
+				if (seek <= 0 || chunkPtr + seek > endPtr)
+					break;
+				if (chunk.code == DNA1)
+				{
+					char *dnaPtr = chunkPtr + ChunkUtils::getOffset(mFlags);
+					if (chunk.len >= 8 && strncmp(dnaPtr, "SDNANAME", 8) == 0)
+					{
+						dna.oldPtr = dnaPtr;
+						dna.len = chunk.len;
+					}
+					break;
+				}
+				chunkPtr += seek;
+			}
+		}
+
+		//the file may be memory mapped without any slack after its last byte, so no compare may read past mFileLen
 		char *tempBuffer = blenderData;
-		for (int i = 0; i < mFileLen; i++)
+		const int chunkHeaderLen = ChunkUtils::getOffset(mFlags);
+		for (int i = 0; i + 4 <= mFileLen && !dna.oldPtr; i++)
 		{
 			// looking for the data's starting position
 			// and the start of SDNA decls
+			const int remaining = mFileLen - i;
 
 			if (!mDataStart && strncmp(tempBuffer, "REND", 4) == 0)
 				mDataStart = i;
@@ -219,9 +291,9 @@ void bFile::parseInternal(int verboseMode, char *memDna, int memDnaLength)
 			if (strncmp(tempBuffer, "DNA1", 4) == 0)
 			{
 				// read the DNA1 block and extract SDNA
-				if (getNextBlock(&dna, tempBuffer, mFlags) > 0)
+				if (remaining >= chunkHeaderLen && getNextBlock(&dna, tempBuffer, mFlags) > 0)
 				{
-					if (strncmp((tempBuffer + ChunkUtils::getOffset(mFlags)), "SDNANAME", 8) == 0)
+					if (remaining >= chunkHeaderLen + 8 && strncmp((tempBuffer + chunkHeaderLen), "SDNANAME", 8) == 0)
 						dna.oldPtr = (tempBuffer + ChunkUtils::getOffset(mFlags));
 					else
 						dna.oldPtr = 0;
@@ -232,7 +304,7 @@ void bFile::parseInternal(int verboseMode, char *memDna, int memDnaLength)
 			// Some Bullet files are missing the DNA1 block
 			// In Blender it's DNA1 + ChunkUtils::getOffset() + SDNA + NAME
 			// In Bullet tests its SDNA + NAME
-			else if (strncmp(tempBuffer, "SDNANAME", 8) == 0)
+			else if (remaining >= 8 && strncmp(tempBuffer, "SDNANAME", 8) == 0)
 			{
 				dna.oldPtr = blenderData + i;
 				dna.len = mFileLen - i;
@@ -251,6 +323,17 @@ void bFile::parseInternal(int verboseMode, char *memDna, int memDnaLength)
 			return;
 		}
 
+		//a file written by the same build needs no struct conversion at all
+		if ((mFlags & (FD_ENDIAN_SWAP | FD_BITS_VARIES)) == 0 && dna.len >= memDnaLength &&
+			memcmp(dna.oldPtr, memDna, memDnaLength) == 0)
+		{
+			mFlags |= FD_FILEDNA_EQUALS_MEMDNA;
+			if (mAllowZeroCopy)
+			{
+				mFlags |= FD_ZERO_COPY;
+			}
+		}
+
 		mFileDNA = new bDNA();
 
 		///mFileDNA->init will convert part of DNA file endianness to current CPU endianness if necessary
@@ -717,6 +800,13 @@ char *bFile::readStruct(char *head, bChunkInd &dataChunk)
 		oldType = mFileDNA->getType(oldStruct[0]);
 		printf("%s equal structure, just memcpy\n", oldType);
 #endif  //
+		//btDefaultSerializer pads its chunks so the payloads are 8 byte aligned,
+		//files written before that (payloads at 4 mod 8) are still copied
+		if ((mFlags & FD_ZERO_COPY) && ((size_t)head & 7) == 0)
+		{
+			//use the struct in place, resolvePointers fixes up its pointers inside the file buffer
+			return head;
+		}
 	}
 
 	char *dataAlloc = new char[(dataChunk.len) + 1];
@@ -1171,13 +1261,123 @@ void bFile::resolvePointersChunk(const bChunkInd &dataChunk, int verboseMode)
 	//char* structType = fileDna->getType(oldStruct[0]);
 
 	char *cur = (char *)findLibPointer(dataChunk.oldPtr);
+	if (verboseMode & FD_VERBOSE_EXPORT_XML)
+	{
+		for (int block = 0; block < dataChunk.nr; block++)
+		{
+			resolvePointersStructRecursive(cur, dataChunk.dna_nr, verboseMode, 1);
+			cur += oldLen;
+		}
+		return;
+	}
+
+	//same fixups as resolvePointersStructRecursive, using the precomputed pointer offsets of the struct
+	int firstRelocation, numRelocations;
+	getRelocations(dataChunk.dna_nr, firstRelocation, numRelocations);
+	if (numRelocations == 0)
+		return;
+
 	for (int block = 0; block < dataChunk.nr; block++)
 	{
-		resolvePointersStructRecursive(cur, dataChunk.dna_nr, verboseMode, 1);
+		for (int r = firstRelocation; r < firstRelocation + numRelocations; r++)
+		{
+			const bRelocation &reloc = m_relocations[r];
+			void **ptrptr = (void **)(cur + reloc.m_offset);
+			if (reloc.m_type == bRelocation::BR_POINTER_ARRAY_ELEMENT)
+			{
+				*ptrptr = findLibPointer(*ptrptr);
+				continue;
+			}
+			void *ptr = findLibPointer(*ptrptr);
+			if (ptr)
+			{
+				*ptrptr = ptr;
+				if (reloc.m_type == bRelocation::BR_POINTER_TO_POINTER_ARRAY)
+				{
+					// This	will only work if the given	**array	is continuous
+					void **array = (void **)ptr;
+					void *np = array[0];
+					int n = 0;
+					while (np)
+					{
+						np = findLibPointer(array[n]);
+						if (np) array[n] = np;
+						n++;
+					}
+				}
+			}
+		}
 		cur += oldLen;
 	}
 }
 
+void bFile::getRelocations(int dna_nr, int &firstRelocation, int &numRelocations)
+{
+	bParse::bDNA *fileDna = mFileDNA ? mFileDNA : mMemoryDNA;
+	if (m_relocationRanges.size() == 0)
+	{
+		m_relocationRanges.resize(2 * fileDna->getNumStructs(), -1);
+	}
+	if (m_relocationRanges[2 * dna_nr] < 0)
+	{
+		int first = m_relocations.size();
+		appendRelocations(dna_nr, 0);
+		m_relocationRanges[2 * dna_nr] = first;
+		m_relocationRanges[2 * dna_nr + 1] = m_relocations.size() - first;
+	}
+	firstRelocation = m_relocationRanges[2 * dna_nr];
+	numRelocations = m_relocationRanges[2 * dna_nr + 1];
+}
+
+///collect the pointer offsets of a struct, including nested structs, in the same order as resolvePointersStructRecursive visits them
+int bFile::appendRelocations(int dna_nr, int baseOffset)
+{
+	bParse::bDNA *fileDna = mFileDNA ? mFileDNA : mMemoryDNA;
+	short firstStructType = fileDna->getStruct(0)[0];
+	short int *oldStruct = fileDna->getStruct(dna_nr);
+
+	int elementLength = oldStruct[1];
+	oldStruct += 2;
+
+	int offset = baseOffset;
+	for (int ele = 0; ele < elementLength; ele++, oldStruct += 2)
+	{
+		char *memName = fileDna->getName(oldStruct[1]);
+		int arrayLen = fileDna->getArraySizeNew(oldStruct[1]);
+		if (memName[0] == '*')
+		{
+			if (arrayLen > 1)
+			{
+				for (int a = 0; a < arrayLen; a++)
+				{
+					bRelocation reloc;
+					reloc.m_offset = offset + a * int(sizeof(void *));
+					reloc.m_type = bRelocation::BR_POINTER_ARRAY_ELEMENT;
+					m_relocations.push_back(reloc);
+				}
+			}
+			else
+			{
+				bRelocation reloc;
+				reloc.m_offset = offset;
+				reloc.m_type = memName[1] == '*' ? bRelocation::BR_POINTER_TO_POINTER_ARRAY : bRelocation::BR_POINTER;
+				m_relocations.push_back(reloc);
+			}
+		}
+		else if (oldStruct[0] >= firstStructType)
+		{
+			int revType = fileDna->getReverseType(oldStruct[0]);
+			int byteOffset = 0;
+			for (int i = 0; i < arrayLen; i++)
+			{
+				byteOffset += appendRelocations(revType, offset + byteOffset);
+			}
+		}
+		offset += fileDna->getElementSize(oldStruct[0], oldStruct[1]);
+	}
+	return offset - baseOffset;
+}
+
 int bFile::resolvePointersStructRecursive(char *strcPtr, int dna_nr, int verboseMode, int recursion)
 {
 	bParse::bDNA *fileDna = mFileDNA ? mFileDNA : mMemoryDNA;
@@ -34,7 +34,9 @@ enum bFileFlags
 	FD_VERSION_VARIES = 32,
 	FD_DOUBLE_PRECISION = 64,
 	FD_BROKEN_DNA = 128,
-	FD_FILEDNA_IS_MEMDNA = 256
+	FD_FILEDNA_IS_MEMDNA = 256,
+	FD_FILEDNA_EQUALS_MEMDNA = 512,
+	FD_ZERO_COPY = 1024
 };
 
 enum bFileVerboseMode
@@ -44,6 +46,19 @@ enum bFileVerboseMode
 	FD_VERBOSE_DUMP_CHUNKS = 4,
 	FD_VERBOSE_DUMP_FILE_INFO = 8,
 };
+///pointer location inside a struct, see bFile::getRelocations
+struct bRelocation
+{
+	enum
+	{
+		BR_POINTER_ARRAY_ELEMENT,
+		BR_POINTER,
+		BR_POINTER_TO_POINTER_ARRAY
+	};
+	int m_offset;
+	int m_type;
+};
+
 // ----------------------------------------------------- //
 class bFile
 {
@@ -54,6 +69,9 @@ protected:
 	char* mFileBuffer;
 	int mFileLen;
 	int mVersion;
+	//non-zero if mFileBuffer is a private memory mapping of the file
+	int mMappedLen;
+	bool mAllowZeroCopy;
 
 	bPtrMap mLibPointers;
 
@@ -73,6 +91,10 @@ protected:
 
 	int mFlags;
 
+	//pointer locations per file DNA struct, built on first use
+	btAlignedObjectArray<bRelocation> m_relocations;
+	btAlignedObjectArray<int> m_relocationRanges;
+
 	// ////////////////////////////////////////////////////////////////////////////
 
 	// buffer offset util
@@ -87,6 +109,8 @@ protected:
 	void resolvePointersChunk(const bChunkInd& dataChunk, int verboseMode);
 
 	int resolvePointersStructRecursive(char* strcPtr, int old_dna, int verboseMode, int recursion);
+	int appendRelocations(int dna_nr, int baseOffset);
+	void getRelocations(int dna_nr, int& firstRelocation, int& numRelocations);
 	//void swapPtr(char *dst, char *src);
 
 	void parseStruct(char* strcPtr, char* dtPtr, int old_dna, int new_dna, bool fixupPointers);
@@ -129,6 +153,14 @@ public:
 		mFlags |= FD_FILEDNA_IS_MEMDNA;
 	}
 
+	///When the file DNA equals the memory DNA, structs are used in place and their pointers are fixed up inside the file buffer.
+	///This is enabled by default for buffers owned by the bFile (loaded from file), and modifies the buffer:
+	///disable it before parse when the buffer has to stay intact, for example to use writeFile afterwards.
+	void setAllowZeroCopy(bool allowZeroCopy)
+	{
+		mAllowZeroCopy = allowZeroCopy;
+	}
+
 	bPtrMap& getLibPointers()
 	{
 		return mLibPointers;
@@ -38,6 +38,11 @@ btBulletWorldImporter::~btBulletWorldImporter()
 bool btBulletWorldImporter::loadFile(const char* fileName, const char* preSwapFilenameOut)
 {
 	bParse::btBulletFile* bulletFile2 = new bParse::btBulletFile(fileName);
+	if (preSwapFilenameOut)
+	{
+		//writeFile needs the original file buffer, without pointers fixed up in place
+		bulletFile2->setAllowZeroCopy(false);
+	}
 
 	bool result = loadFileFromMemory(bulletFile2);
 	//now you could save the file in 'native' format using
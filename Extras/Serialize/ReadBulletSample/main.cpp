@@ -14,6 +14,8 @@ subject to the following restrictions:
 */
 
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include "../BulletFileLoader/btBulletFile.h"
 #include "BulletDataExtractor.h"
 
@@ -22,11 +24,45 @@ subject to the following restrictions:
 ///For a more complete example how to load and convert Bullet data using the Bullet SDK check out
 ///the Bullet/Demos/SerializeDemo and Bullet/Serialize/BulletWorldImporter
 
+///Measure the load and parse time of a (large) .bullet file, with and without the zero-copy path
+///that is taken when the file was written by a build with identical DNA.
+static void benchmarkLoading(const char* fileName, int numIterations)
+{
+	for (int zeroCopy = 0; zeroCopy < 2; zeroCopy++)
+	{
+		double totalSeconds = 0;
+		int flags = 0;
+		for (int i = 0; i < numIterations; i++)
+		{
+			clock_t start = clock();
+			bParse::btBulletFile* bulletFile = new bParse::btBulletFile(fileName);
+			bulletFile->setAllowZeroCopy(zeroCopy != 0);
+			if (bulletFile->ok())
+				bulletFile->parse(false);
+			totalSeconds += double(clock() - start) / CLOCKS_PER_SEC;
+			flags = bulletFile->getFlags();
+			delete bulletFile;
+		}
+		printf("%s: zeroCopy=%d (DNA %s) average load+parse time %f ms over %d iterations\n", fileName, zeroCopy,
+			   (flags & bParse::FD_FILEDNA_EQUALS_MEMDNA) ? "matches" : "differs", 1000. * totalSeconds / numIterations, numIterations);
+	}
+}
+
 int main(int argc, char** argv)
 {
 	const char* fileName = "testFile.bullet";
 	bool verboseDumpAllTypes = false;
 
+	if (argc > 1)
+	{
+		fileName = argv[1];
+	}
+	if (argc > 2 && strcmp(argv[2], "--benchmark") == 0)
+	{
+		benchmarkLoading(fileName, 10);
+		return 0;
+	}
+
 	bParse::btBulletFile* bulletFile2 = new bParse::btBulletFile(fileName);
 
 	bool ok = (bulletFile2->getFlags() & bParse::FD_OK) != 0;
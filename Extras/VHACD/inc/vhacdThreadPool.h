@@ -0,0 +1,88 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#ifndef VHACD_THREAD_POOL_H
+#define VHACD_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VHACD
+{
+//! Fixed set of worker threads used to spread independent loop iterations (clipping planes, convex-hulls) over the CPU.
+//! The calling thread takes part in every ParallelFor as thread 0, so per-thread scratch buffers can be indexed by
+//! threadIndex in [0, GetNumThreads()).
+class ThreadPool
+{
+public:
+	class IJob
+	{
+	public:
+		virtual ~IJob(){};
+		virtual void Execute(const int index, const int threadIndex) = 0;
+	};
+
+	ThreadPool(void);
+	~ThreadPool(void);
+
+	//! Number of threads, including the caller. 0 selects the number of hardware threads, 1 runs everything serially.
+	void SetNumThreads(int numThreads);
+	int GetNumThreads(void) const { return (int)m_workers.size() + 1; }
+	static int GetNumHardwareThreads(void);
+
+	//! Calls job.Execute(i, threadIndex) once for each i in [0, count) and returns when all calls are done.
+	//! Indices are handed out dynamically, so jobs must not depend on which thread runs which index.
+	void ParallelFor(const int count, IJob& job);
+
+	template <class F>
+	void ParallelFor(const int count, const F& func)
+	{
+		FunctionJob<F> job(func);
+		ParallelFor(count, static_cast<IJob&>(job));
+	}
+
+private:
+	template <class F>
+	class FunctionJob : public IJob
+	{
+	public:
+		FunctionJob(const F& func)
+			: m_func(func) {}
+		void Execute(const int index, const int threadIndex) { m_func(index, threadIndex); }
+
+	private:
+		const F& m_func;
+	};
+
+	void StopWorkers(void);
+	void WorkerMain(const int threadIndex, unsigned int generation);
+	void RunJob(const int threadIndex);
+
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_wakeCondition;
+	std::condition_variable m_doneCondition;
+	IJob* m_job;
+	int m_count;
+	std::atomic<int> m_nextIndex;
+	int m_numBusyWorkers;
+	unsigned int m_generation;
+	bool m_quit;
+};
+}  // namespace VHACD
+#endif  // VHACD_THREAD_POOL_H
@@ -25,6 +25,7 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #endif  //OPENCL_FOUND
 
 #include "vhacdMutex.h"
+#include "vhacdThreadPool.h"
 #include "vhacdVolume.h"
 
 #define USE_THREAD 1
@@ -38,12 +39,11 @@ public:
 	//! Constructor.
 	VHACD()
 	{
-#if USE_THREAD == 1 && _OPENMP
-		m_ompNumProcessors = 2 * omp_get_num_procs();
-		omp_set_num_threads(m_ompNumProcessors);
-#else   //USE_THREAD == 1 && _OPENMP
+#if USE_THREAD == 1
+		m_ompNumProcessors = ThreadPool::GetNumHardwareThreads();
+#else   //USE_THREAD == 1
 		m_ompNumProcessors = 1;
-#endif  //USE_THREAD == 1 && _OPENMP
+#endif  //USE_THREAD == 1
 #ifdef CL_VERSION_1_1
 		m_oclWorkGroupSize = 0;
 		m_oclDevice = 0;
@@ -132,6 +132,10 @@ private:
 									  m_operationProgress,
 									  m_stage.c_str(),
 									  m_operation.c_str());
+			if (params.m_callback->CheckCancel())
+			{
+				SetCancel(true);
+			}
 		}
 	}
 	void Init()
@@ -316,6 +320,13 @@ private:
 					const Parameters& params)
 	{
 		Init();
+		// per-thread scratch buffers and OpenCL kernels are sized for m_ompNumProcessors threads
+		int numThreads = params.m_numThreads;
+		if (numThreads <= 0 || numThreads > m_ompNumProcessors)
+		{
+			numThreads = m_ompNumProcessors;
+		}
+		m_threadPool.SetNumThreads(numThreads);
 		if (params.m_oclAcceleration)
 		{
 			// build kernals
@@ -355,6 +366,7 @@ private:
 	Mutex m_cancelMutex;
 	bool m_cancel;
 	int m_ompNumProcessors;
+	ThreadPool m_threadPool;
 #ifdef CL_VERSION_1_1
 	cl_device_id* m_oclDevice;
 	cl_context m_oclContext;
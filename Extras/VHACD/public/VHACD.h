@@ -33,6 +33,8 @@ public:
 							const double operationProgress,
 							const char* const stage,
 							const char* const operation) = 0;
+		// polled together with Update, return true to stop the decomposition (same as IVHACD::Cancel)
+		virtual bool CheckCancel() { return false; }
 	};
 
 	class IUserLogger
@@ -73,6 +75,7 @@ public:
 			m_logger = 0;
 			m_convexhullApproximation = true;
 			m_oclAcceleration = true;
+			m_numThreads = 0;  // 0: one per hardware thread, 1: serial
 		}
 		double m_concavity;
 		double m_alpha;
@@ -90,6 +93,7 @@ public:
 		int m_mode;
 		int m_convexhullApproximation;
 		int m_oclAcceleration;
+		int m_numThreads;
 	};
 
 	virtual void Cancel() = 0;
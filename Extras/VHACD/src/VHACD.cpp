@@ -16,13 +16,11 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iomanip>
 #include <limits>
 #include <sstream>
-#if _OPENMP
-#include <omp.h>
-#endif  // _OPENMP
 
 #include "../public/VHACD.h"
 #include "btConvexHullComputer.h"
@@ -743,6 +741,22 @@ inline double ComputeConcavity(const double volume, const double volumeCH, const
 }
 
 //#define DEBUG_TEMP
+struct PlaneCost
+{
+	int m_index;
+	double m_total;
+	double m_concavity;
+	double m_balance;
+	double m_symmetry;
+	PlaneCost(void)
+		: m_index(-1),
+		  m_total(MAX_DOUBLE),
+		  m_concavity(MAX_DOUBLE),
+		  m_balance(MAX_DOUBLE),
+		  m_symmetry(MAX_DOUBLE)
+	{
+	}
+};
 void VHACD::ComputeBestClippingPlane(const PrimitiveSet* inputPSet, const double volume, const SArray<Plane>& planes,
 									 const Vec3<double>& preferredCuttingDirection, const double w, const double alpha, const double beta,
 									 const int convexhullDownsampling, const double progress0, const double progress1, Plane& bestPlane,
@@ -757,8 +771,6 @@ void VHACD::ComputeBestClippingPlane(const PrimitiveSet* inputPSet, const double
 	bool oclAcceleration = (nPrimitives > OCL_MIN_NUM_PRIMITIVES && params.m_oclAcceleration && params.m_mode == 0) ? true : false;
 	int iBest = -1;
 	int nPlanes = static_cast<int>(planes.Size());
-	bool cancel = false;
-	int done = 0;
 	double minTotal = MAX_DOUBLE;
 	double minBalance = MAX_DOUBLE;
 	double minSymmetry = MAX_DOUBLE;
@@ -855,33 +867,53 @@ void VHACD::ComputeBestClippingPlane(const PrimitiveSet* inputPSet, const double
 	timerComputeCost.Tic();
 #endif  // DEBUG_TEMP
 
-#if USE_THREAD == 1 && _OPENMP
-#pragma omp parallel for
-#endif
-	for (int x = 0; x < nPlanes; ++x)
-	{
-		int threadID = 0;
-#if USE_THREAD == 1 && _OPENMP
-		threadID = omp_get_thread_num();
-#pragma omp flush(cancel)
-#endif
-		if (!cancel)
+	// each thread keeps the best plane it has seen, ties go to the lowest plane index, and the per-thread
+	// results are merged below with the same rule, so the chosen plane does not depend on the thread count
+	const int numThreads = m_threadPool.GetNumThreads();
+	PlaneCost* threadBest = new PlaneCost[numThreads];
+	std::atomic<int> done(0);
+	std::atomic<bool> cancel(false);
+	int reported = 0;
+	m_threadPool.ParallelFor(nPlanes, [&](const int x, const int threadID) {
+		if (cancel)
+		{
+			return;
+		}
+		if (GetCancel())
 		{
-			//Update progress
-			if (GetCancel())
+			cancel = true;
+			return;
+		}
+		Plane plane = planes[x];
+
+		if (oclAcceleration)
+		{
+#ifdef CL_VERSION_1_1
+			const float fPlane[4] = {(float)plane.m_a, (float)plane.m_b, (float)plane.m_c, (float)plane.m_d};
+			cl_int error = clSetKernelArg(m_oclKernelComputePartialVolumes[threadID], 2, sizeof(float) * 4, fPlane);
+			if (error != CL_SUCCESS)
 			{
-				cancel = true;
-#if USE_THREAD == 1 && _OPENMP
-#pragma omp flush(cancel)
-#endif
+				if (params.m_logger)
+				{
+					params.m_logger->Log("Couldn't kernel atguments \n");
+				}
+				SetCancel(true);
 			}
-			Plane plane = planes[x];
 
-			if (oclAcceleration)
+			error = clEnqueueNDRangeKernel(m_oclQueue[threadID], m_oclKernelComputePartialVolumes[threadID],
+										   1, NULL, &globalSize, &m_oclWorkGroupSize, 0, NULL, NULL);
+			if (error != CL_SUCCESS)
 			{
-#ifdef CL_VERSION_1_1
-				const float fPlane[4] = {(float)plane.m_a, (float)plane.m_b, (float)plane.m_c, (float)plane.m_d};
-				cl_int error = clSetKernelArg(m_oclKernelComputePartialVolumes[threadID], 2, sizeof(float) * 4, fPlane);
+				if (params.m_logger)
+				{
+					params.m_logger->Log("Couldn't run kernel \n");
+				}
+				SetCancel(true);
+			}
+			int nValues = (int)nWorkGroups;
+			while (nValues > 1)
+			{
+				error = clSetKernelArg(m_oclKernelComputeSum[threadID], 1, sizeof(int), &nValues);
 				if (error != CL_SUCCESS)
 				{
 					if (params.m_logger)
@@ -890,8 +922,9 @@ void VHACD::ComputeBestClippingPlane(const PrimitiveSet* inputPSet, const double
 					}
 					SetCancel(true);
 				}
-
-				error = clEnqueueNDRangeKernel(m_oclQueue[threadID], m_oclKernelComputePartialVolumes[threadID],
+				size_t nWorkGroups = (nValues + m_oclWorkGroupSize - 1) / m_oclWorkGroupSize;
+				size_t globalSize = nWorkGroups * m_oclWorkGroupSize;
+				error = clEnqueueNDRangeKernel(m_oclQueue[threadID], m_oclKernelComputeSum[threadID],
 											   1, NULL, &globalSize, &m_oclWorkGroupSize, 0, NULL, NULL);
 				if (error != CL_SUCCESS)
 				{
@@ -901,140 +934,129 @@ void VHACD::ComputeBestClippingPlane(const PrimitiveSet* inputPSet, const double
 					}
 					SetCancel(true);
 				}
-				int nValues = (int)nWorkGroups;
-				while (nValues > 1)
-				{
-					error = clSetKernelArg(m_oclKernelComputeSum[threadID], 1, sizeof(int), &nValues);
-					if (error != CL_SUCCESS)
-					{
-						if (params.m_logger)
-						{
-							params.m_logger->Log("Couldn't kernel atguments \n");
-						}
-						SetCancel(true);
-					}
-					size_t nWorkGroups = (nValues + m_oclWorkGroupSize - 1) / m_oclWorkGroupSize;
-					size_t globalSize = nWorkGroups * m_oclWorkGroupSize;
-					error = clEnqueueNDRangeKernel(m_oclQueue[threadID], m_oclKernelComputeSum[threadID],
-												   1, NULL, &globalSize, &m_oclWorkGroupSize, 0, NULL, NULL);
-					if (error != CL_SUCCESS)
-					{
-						if (params.m_logger)
-						{
-							params.m_logger->Log("Couldn't run kernel \n");
-						}
-						SetCancel(true);
-					}
-					nValues = (int)nWorkGroups;
-				}
-#endif  // CL_VERSION_1_1
+				nValues = (int)nWorkGroups;
 			}
+#endif  // CL_VERSION_1_1
+		}
 
-			Mesh& leftCH = chs[threadID];
-			Mesh& rightCH = chs[threadID + m_ompNumProcessors];
-			rightCH.ResizePoints(0);
-			leftCH.ResizePoints(0);
-			rightCH.ResizeTriangles(0);
-			leftCH.ResizeTriangles(0);
+		Mesh& leftCH = chs[threadID];
+		Mesh& rightCH = chs[threadID + m_ompNumProcessors];
+		rightCH.ResizePoints(0);
+		leftCH.ResizePoints(0);
+		rightCH.ResizeTriangles(0);
+		leftCH.ResizeTriangles(0);
 
 // compute convex-hulls
 #ifdef TEST_APPROX_CH
-			double volumeLeftCH1;
-			double volumeRightCH1;
+		double volumeLeftCH1;
+		double volumeRightCH1;
 #endif  //TEST_APPROX_CH
-			if (params.m_convexhullApproximation)
-			{
-				SArray<Vec3<double> >& leftCHPts = chPts[threadID];
-				SArray<Vec3<double> >& rightCHPts = chPts[threadID + m_ompNumProcessors];
-				rightCHPts.Resize(0);
-				leftCHPts.Resize(0);
-				onSurfacePSet->Intersect(plane, &rightCHPts, &leftCHPts, convexhullDownsampling * 32);
-				inputPSet->GetConvexHull().Clip(plane, rightCHPts, leftCHPts);
-				rightCH.ComputeConvexHull((double*)rightCHPts.Data(), rightCHPts.Size());
-				leftCH.ComputeConvexHull((double*)leftCHPts.Data(), leftCHPts.Size());
+		if (params.m_convexhullApproximation)
+		{
+			SArray<Vec3<double> >& leftCHPts = chPts[threadID];
+			SArray<Vec3<double> >& rightCHPts = chPts[threadID + m_ompNumProcessors];
+			rightCHPts.Resize(0);
+			leftCHPts.Resize(0);
+			onSurfacePSet->Intersect(plane, &rightCHPts, &leftCHPts, convexhullDownsampling * 32);
+			inputPSet->GetConvexHull().Clip(plane, rightCHPts, leftCHPts);
+			rightCH.ComputeConvexHull((double*)rightCHPts.Data(), rightCHPts.Size());
+			leftCH.ComputeConvexHull((double*)leftCHPts.Data(), leftCHPts.Size());
 #ifdef TEST_APPROX_CH
-				Mesh leftCH1;
-				Mesh rightCH1;
-				VoxelSet right;
-				VoxelSet left;
-				onSurfacePSet->Clip(plane, &right, &left);
-				right.ComputeConvexHull(rightCH1, convexhullDownsampling);
-				left.ComputeConvexHull(leftCH1, convexhullDownsampling);
-
-				volumeLeftCH1 = leftCH1.ComputeVolume();
-				volumeRightCH1 = rightCH1.ComputeVolume();
+			Mesh leftCH1;
+			Mesh rightCH1;
+			VoxelSet right;
+			VoxelSet left;
+			onSurfacePSet->Clip(plane, &right, &left);
+			right.ComputeConvexHull(rightCH1, convexhullDownsampling);
+			left.ComputeConvexHull(leftCH1, convexhullDownsampling);
+
+			volumeLeftCH1 = leftCH1.ComputeVolume();
+			volumeRightCH1 = rightCH1.ComputeVolume();
 #endif  //TEST_APPROX_CH
-			}
-			else
-			{
-				PrimitiveSet* const right = psets[threadID];
-				PrimitiveSet* const left = psets[threadID + m_ompNumProcessors];
-				onSurfacePSet->Clip(plane, right, left);
-				right->ComputeConvexHull(rightCH, convexhullDownsampling);
-				left->ComputeConvexHull(leftCH, convexhullDownsampling);
-			}
-			double volumeLeftCH = leftCH.ComputeVolume();
-			double volumeRightCH = rightCH.ComputeVolume();
+		}
+		else
+		{
+			PrimitiveSet* const right = psets[threadID];
+			PrimitiveSet* const left = psets[threadID + m_ompNumProcessors];
+			onSurfacePSet->Clip(plane, right, left);
+			right->ComputeConvexHull(rightCH, convexhullDownsampling);
+			left->ComputeConvexHull(leftCH, convexhullDownsampling);
+		}
+		double volumeLeftCH = leftCH.ComputeVolume();
+		double volumeRightCH = rightCH.ComputeVolume();
 
-			// compute clipped volumes
-			double volumeLeft = 0.0;
-			double volumeRight = 0.0;
-			if (oclAcceleration)
-			{
+		// compute clipped volumes
+		double volumeLeft = 0.0;
+		double volumeRight = 0.0;
+		if (oclAcceleration)
+		{
 #ifdef CL_VERSION_1_1
-				unsigned int volumes[4];
-				cl_int error = clEnqueueReadBuffer(m_oclQueue[threadID], partialVolumes[threadID], CL_TRUE,
-												   0, sizeof(unsigned int) * 4, volumes, 0, NULL, NULL);
-				size_t nPrimitivesRight = volumes[0] + volumes[1] + volumes[2] + volumes[3];
-				size_t nPrimitivesLeft = nPrimitives - nPrimitivesRight;
-				volumeRight = nPrimitivesRight * unitVolume;
-				volumeLeft = nPrimitivesLeft * unitVolume;
-				if (error != CL_SUCCESS)
-				{
-					if (params.m_logger)
-					{
-						params.m_logger->Log("Couldn't read buffer \n");
-					}
-					SetCancel(true);
-				}
-#endif  // CL_VERSION_1_1
-			}
-			else
-			{
-				inputPSet->ComputeClippedVolumes(plane, volumeRight, volumeLeft);
-			}
-			double concavityLeft = ComputeConcavity(volumeLeft, volumeLeftCH, m_volumeCH0);
-			double concavityRight = ComputeConcavity(volumeRight, volumeRightCH, m_volumeCH0);
-			double concavity = (concavityLeft + concavityRight);
-
-			// compute cost
-			double balance = alpha * fabs(volumeLeft - volumeRight) / m_volumeCH0;
-			double d = w * (preferredCuttingDirection[0] * plane.m_a + preferredCuttingDirection[1] * plane.m_b + preferredCuttingDirection[2] * plane.m_c);
-			double symmetry = beta * d;
-			double total = concavity + balance + symmetry;
-
-#if USE_THREAD == 1 && _OPENMP
-#pragma omp critical
-#endif
+			unsigned int volumes[4];
+			cl_int error = clEnqueueReadBuffer(m_oclQueue[threadID], partialVolumes[threadID], CL_TRUE,
+											   0, sizeof(unsigned int) * 4, volumes, 0, NULL, NULL);
+			size_t nPrimitivesRight = volumes[0] + volumes[1] + volumes[2] + volumes[3];
+			size_t nPrimitivesLeft = nPrimitives - nPrimitivesRight;
+			volumeRight = nPrimitivesRight * unitVolume;
+			volumeLeft = nPrimitivesLeft * unitVolume;
+			if (error != CL_SUCCESS)
 			{
-				if (total < minTotal || (total == minTotal && x < iBest))
-				{
-					minConcavity = concavity;
-					minBalance = balance;
-					minSymmetry = symmetry;
-					bestPlane = plane;
-					minTotal = total;
-					iBest = x;
-				}
-				++done;
-				if (!(done & 127))  // reduce update frequency
+				if (params.m_logger)
 				{
-					double progress = done * (progress1 - progress0) / nPlanes + progress0;
-					Update(m_stageProgress, progress, params);
+					params.m_logger->Log("Couldn't read buffer \n");
 				}
+				SetCancel(true);
 			}
+#endif  // CL_VERSION_1_1
+		}
+		else
+		{
+			inputPSet->ComputeClippedVolumes(plane, volumeRight, volumeLeft);
+		}
+		double concavityLeft = ComputeConcavity(volumeLeft, volumeLeftCH, m_volumeCH0);
+		double concavityRight = ComputeConcavity(volumeRight, volumeRightCH, m_volumeCH0);
+		double concavity = (concavityLeft + concavityRight);
+
+		// compute cost
+		double balance = alpha * fabs(volumeLeft - volumeRight) / m_volumeCH0;
+		double d = w * (preferredCuttingDirection[0] * plane.m_a + preferredCuttingDirection[1] * plane.m_b + preferredCuttingDirection[2] * plane.m_c);
+		double symmetry = beta * d;
+		double total = concavity + balance + symmetry;
+
+		PlaneCost& best = threadBest[threadID];
+		if (total < best.m_total || (total == best.m_total && x < best.m_index))
+		{
+			best.m_index = x;
+			best.m_total = total;
+			best.m_concavity = concavity;
+			best.m_balance = balance;
+			best.m_symmetry = symmetry;
+		}
+		const int nDone = ++done;
+		if (threadID == 0 && nDone - reported >= 128)  // progress is only reported from the calling thread
+		{
+			reported = nDone;
+			double progress = nDone * (progress1 - progress0) / nPlanes + progress0;
+			Update(m_stageProgress, progress, params);
+		}
+	});
+	for (int t = 0; t < numThreads; ++t)
+	{
+		const PlaneCost& best = threadBest[t];
+		if (best.m_index < 0)
+		{
+			continue;
+		}
+		if (best.m_total < minTotal || (best.m_total == minTotal && best.m_index < iBest))
+		{
+			minConcavity = best.m_concavity;
+			minBalance = best.m_balance;
+			minSymmetry = best.m_symmetry;
+			bestPlane = planes[best.m_index];
+			minTotal = best.m_total;
+			iBest = best.m_index;
 		}
 	}
+	delete[] threadBest;
 
 #ifdef DEBUG_TEMP
 	timerComputeCost.Toc();
@@ -1313,10 +1335,16 @@ void VHACD::ComputeACD(const Parameters& params)
 
 	Update(m_stageProgress, 0.0, params);
 	m_convexHulls.Resize(0);
-	for (size_t p = 0; p < nConvexHulls && !m_cancel; ++p)
+	for (size_t p = 0; p < nConvexHulls; ++p)
 	{
-		Update(m_stageProgress, p * 100.0 / nConvexHulls, params);
 		m_convexHulls.PushBack(new Mesh);
+	}
+	std::atomic<int> done(0);
+	m_threadPool.ParallelFor((int)nConvexHulls, [&](const int p, const int threadID) {
+		if (GetCancel())
+		{
+			return;
+		}
 		parts[p]->ComputeConvexHull(*m_convexHulls[p]);
 		size_t nv = m_convexHulls[p]->GetNPoints();
 		double x, y, z;
@@ -1330,7 +1358,12 @@ void VHACD::ComputeACD(const Parameters& params)
 			pt[1] = m_rot[1][0] * x + m_rot[1][1] * y + m_rot[1][2] * z + m_barycenter[1];
 			pt[2] = m_rot[2][0] * x + m_rot[2][1] * y + m_rot[2][2] * z + m_barycenter[2];
 		}
-	}
+		const int nDone = ++done;
+		if (threadID == 0)
+		{
+			Update(m_stageProgress, nDone * 100.0 / nConvexHulls, params);
+		}
+	});
 
 	const size_t nParts = parts.Size();
 	for (size_t p = 0; p < nParts; ++p)
@@ -1422,22 +1455,25 @@ void VHACD::MergeConvexHulls(const Parameters& params)
 	if (nConvexHulls > 1 && !m_cancel)
 	{
 		const double threshold = params.m_gamma;
-		SArray<Vec3<double> > pts;
-		Mesh combinedCH;
 
-		// Populate the cost matrix
-		size_t idx = 0;
+		// per-thread scratch for the combined hulls
+		const int numThreads = m_threadPool.GetNumThreads();
+		SArray<Vec3<double> >* threadPts = new SArray<Vec3<double> >[numThreads];
+		Mesh* threadCombinedCH = new Mesh[numThreads];
+
+		// Populate the cost matrix, one row per job, entry (p1, p2 < p1) is stored at p1 * (p1 - 1) / 2 + p2
 		SArray<float> costMatrix;
 		costMatrix.Resize(((nConvexHulls * nConvexHulls) - nConvexHulls) >> 1);
-		for (size_t p1 = 1; p1 < nConvexHulls; ++p1)
-		{
+		m_threadPool.ParallelFor((int)nConvexHulls - 1, [&](const int row, const int threadID) {
+			const size_t p1 = (size_t)row + 1;
+			size_t idx = (p1 * (p1 - 1)) >> 1;
 			const float volume1 = m_convexHulls[p1]->ComputeVolume();
 			for (size_t p2 = 0; p2 < p1; ++p2)
 			{
-				ComputeConvexHull(m_convexHulls[p1], m_convexHulls[p2], pts, &combinedCH);
-				costMatrix[idx++] = ComputeConcavity(volume1 + m_convexHulls[p2]->ComputeVolume(), combinedCH.ComputeVolume(), m_volumeCH0);
+				ComputeConvexHull(m_convexHulls[p1], m_convexHulls[p2], threadPts[threadID], &threadCombinedCH[threadID]);
+				costMatrix[idx++] = ComputeConcavity(volume1 + m_convexHulls[p2]->ComputeVolume(), threadCombinedCH[threadID].ComputeVolume(), m_volumeCH0);
 			}
-		}
+		});
 
 		// Until we cant merge below the maximum cost
 		size_t costSize = m_convexHulls.Size();
@@ -1475,7 +1511,7 @@ void VHACD::MergeConvexHulls(const Parameters& params)
 
 			// Make the lowest cost row and column into a new hull
 			Mesh* cch = new Mesh;
-			ComputeConvexHull(m_convexHulls[p1], m_convexHulls[p2], pts, cch);
+			ComputeConvexHull(m_convexHulls[p1], m_convexHulls[p2], threadPts[0], cch);
 			delete m_convexHulls[p2];
 			m_convexHulls[p2] = cch;
 
@@ -1486,28 +1522,23 @@ void VHACD::MergeConvexHulls(const Parameters& params)
 			costSize = costSize - 1;
 
 			// Calculate costs versus the new hull
-			size_t rowIdx = ((p2 - 1) * p2) >> 1;
 			const float volume1 = m_convexHulls[p2]->ComputeVolume();
-			for (size_t i = 0; (i < p2) && (!m_cancel); ++i)
-			{
-				ComputeConvexHull(m_convexHulls[p2], m_convexHulls[i], pts, &combinedCH);
-				costMatrix[rowIdx++] = ComputeConcavity(volume1 + m_convexHulls[i]->ComputeVolume(), combinedCH.ComputeVolume(), m_volumeCH0);
-			}
-
-			rowIdx += p2;
-			for (size_t i = p2 + 1; (i < costSize) && (!m_cancel); ++i)
-			{
-				ComputeConvexHull(m_convexHulls[p2], m_convexHulls[i], pts, &combinedCH);
-				costMatrix[rowIdx] = ComputeConcavity(volume1 + m_convexHulls[i]->ComputeVolume(), combinedCH.ComputeVolume(), m_volumeCH0);
-				rowIdx += i;
-				assert(rowIdx >= 0);
-			}
+			m_threadPool.ParallelFor((int)costSize, [&](const int job, const int threadID) {
+				const size_t i = (size_t)job;
+				if (i == p2 || GetCancel())
+				{
+					return;
+				}
+				const size_t rowIdx = (i < p2) ? (((p2 - 1) * p2) >> 1) + i : ((i * (i - 1)) >> 1) + p2;
+				ComputeConvexHull(m_convexHulls[p2], m_convexHulls[i], threadPts[threadID], &threadCombinedCH[threadID]);
+				costMatrix[rowIdx] = ComputeConcavity(volume1 + m_convexHulls[i]->ComputeVolume(), threadCombinedCH[threadID].ComputeVolume(), m_volumeCH0);
+			});
 
 			// Move the top column in to replace its space
 			const size_t erase_idx = ((costSize - 1) * costSize) >> 1;
 			if (p1 < costSize)
 			{
-				rowIdx = (addrI * p1) >> 1;
+				size_t rowIdx = (addrI * p1) >> 1;
 				size_t top_row = erase_idx;
 				for (size_t i = 0; i < p1; ++i)
 				{
@@ -1530,6 +1561,8 @@ void VHACD::MergeConvexHulls(const Parameters& params)
 			}
 			costMatrix.Resize(erase_idx);
 		}
+		delete[] threadPts;
+		delete[] threadCombinedCH;
 	}
 	m_overallProgress = 99.0;
 	Update(100.0, 100.0, params);
@@ -1577,16 +1610,25 @@ void VHACD::SimplifyConvexHulls(const Parameters& params)
 	}
 
 	Update(0.0, 0.0, params);
-	for (size_t i = 0; i < nConvexHulls && !m_cancel; ++i)
+	for (size_t i = 0; i < nConvexHulls && params.m_logger; ++i)
 	{
-		if (params.m_logger)
+		msg.str("");
+		msg << "\t\t Simplify CH[" << std::setfill('0') << std::setw(5) << i << "] " << m_convexHulls[i]->GetNPoints() << " V, " << m_convexHulls[i]->GetNTriangles() << " T" << std::endl;
+		params.m_logger->Log(msg.str().c_str());
+	}
+	std::atomic<int> done(0);
+	m_threadPool.ParallelFor((int)nConvexHulls, [&](const int i, const int threadID) {
+		if (GetCancel())
 		{
-			msg.str("");
-			msg << "\t\t Simplify CH[" << std::setfill('0') << std::setw(5) << i << "] " << m_convexHulls[i]->GetNPoints() << " V, " << m_convexHulls[i]->GetNTriangles() << " T" << std::endl;
-			params.m_logger->Log(msg.str().c_str());
+			return;
 		}
 		SimplifyConvexHull(m_convexHulls[i], params.m_maxNumVerticesPerCH, m_volumeCH0 * params.m_minVolumePerCH);
-	}
+		const int nDone = ++done;
+		if (threadID == 0)
+		{
+			Update(nDone * 100.0 / nConvexHulls, 0.0, params);
+		}
+	});
 
 	m_overallProgress = 100.0;
 	Update(100.0, 100.0, params);
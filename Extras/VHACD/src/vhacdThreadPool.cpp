@@ -0,0 +1,134 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "vhacdThreadPool.h"
+
+namespace VHACD
+{
+ThreadPool::ThreadPool(void)
+	: m_job(0),
+	  m_count(0),
+	  m_nextIndex(0),
+	  m_numBusyWorkers(0),
+	  m_generation(0),
+	  m_quit(false)
+{
+}
+ThreadPool::~ThreadPool(void)
+{
+	StopWorkers();
+}
+int ThreadPool::GetNumHardwareThreads(void)
+{
+	int n = (int)std::thread::hardware_concurrency();
+	return (n > 0) ? n : 1;
+}
+void ThreadPool::SetNumThreads(int numThreads)
+{
+	if (numThreads <= 0)
+	{
+		numThreads = GetNumHardwareThreads();
+	}
+	if (numThreads == GetNumThreads())
+	{
+		return;
+	}
+	StopWorkers();
+	m_quit = false;
+	for (int t = 1; t < numThreads; ++t)
+	{
+		m_workers.push_back(std::thread(&ThreadPool::WorkerMain, this, t, m_generation));
+	}
+}
+void ThreadPool::StopWorkers(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wakeCondition.notify_all();
+	for (size_t t = 0; t < m_workers.size(); ++t)
+	{
+		m_workers[t].join();
+	}
+	m_workers.clear();
+}
+void ThreadPool::RunJob(const int threadIndex)
+{
+	for (;;)
+	{
+		const int index = m_nextIndex.fetch_add(1);
+		if (index >= m_count)
+		{
+			break;
+		}
+		m_job->Execute(index, threadIndex);
+	}
+}
+void ThreadPool::WorkerMain(const int threadIndex, unsigned int generation)
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (!m_quit && generation == m_generation)
+			{
+				m_wakeCondition.wait(lock);
+			}
+			if (m_quit)
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+		RunJob(threadIndex);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (--m_numBusyWorkers == 0)
+			{
+				m_doneCondition.notify_one();
+			}
+		}
+	}
+}
+void ThreadPool::ParallelFor(const int count, IJob& job)
+{
+	if (m_workers.empty() || count <= 1)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			job.Execute(i, 0);
+		}
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_job = &job;
+		m_count = count;
+		m_nextIndex = 0;
+		m_numBusyWorkers = (int)m_workers.size();
+		++m_generation;
+	}
+	m_wakeCondition.notify_all();
+	RunJob(0);
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (m_numBusyWorkers > 0)
+		{
+			m_doneCondition.wait(lock);
+		}
+		m_job = 0;
+	}
+}
+}  // namespace VHACD
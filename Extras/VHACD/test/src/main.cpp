@@ -16,6 +16,7 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include <algorithm>
 #include <assert.h>
+#include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -112,6 +113,7 @@ struct Parameters
 	string m_fileNameIn;
 	string m_fileNameOut;
 	string m_fileNameLog;
+	string m_fileNameBenchmark;
 	bool m_run;
 	IVHACD::Parameters m_paramsVHACD;
 	Parameters(void)
@@ -122,6 +124,7 @@ struct Parameters
 		m_fileNameIn = "";
 		m_fileNameOut = "output.obj";
 		m_fileNameLog = "log.txt";
+		m_fileNameBenchmark = "";
 	}
 };
 bool LoadOFF(const string& fileName, vector<float>& points, vector<int>& triangles, IVHACD::IUserLogger& logger);
@@ -137,6 +140,8 @@ void GetFileExtension(const string& fileName, string& fileExtension);
 void ComputeRandomColor(Material& mat);
 void Usage(const Parameters& params);
 void ParseParameters(int argc, char* argv[], Parameters& params);
+bool LoadMesh(const string& fileName, vector<float>& points, vector<int>& triangles, IVHACD::IUserLogger& logger);
+int RunBenchmark(const Parameters& params, IVHACD::IUserLogger& logger);
 
 int main(int argc, char* argv[])
 {
@@ -154,6 +159,10 @@ int main(int argc, char* argv[])
 		{
 			return 0;
 		}
+		if (params.m_fileNameBenchmark.length())
+		{
+			return RunBenchmark(params, myLogger);
+		}
 
 		std::ostringstream msg;
 
@@ -177,6 +186,7 @@ int main(int argc, char* argv[])
 		msg << "\t OpenCL acceleration                         " << params.m_paramsVHACD.m_oclAcceleration << endl;
 		msg << "\t OpenCL platform ID                          " << params.m_oclPlatformID << endl;
 		msg << "\t OpenCL device ID                            " << params.m_oclDeviceID << endl;
+		msg << "\t number of threads                           " << params.m_paramsVHACD.m_numThreads << endl;
 		msg << "\t output                                      " << params.m_fileNameOut << endl;
 		msg << "\t log                                         " << params.m_fileNameLog << endl;
 		msg << "+ Load mesh" << std::endl;
@@ -187,25 +197,8 @@ int main(int argc, char* argv[])
 		// load mesh
 		vector<float> points;
 		vector<int> triangles;
-		string fileExtension;
-		GetFileExtension(params.m_fileNameIn, fileExtension);
-		if (fileExtension == ".OFF")
+		if (!LoadMesh(params.m_fileNameIn, points, triangles, myLogger))
 		{
-			if (!LoadOFF(params.m_fileNameIn, points, triangles, myLogger))
-			{
-				return -1;
-			}
-		}
-		else if (fileExtension == ".OBJ")
-		{
-			if (!LoadOBJ(params.m_fileNameIn, points, triangles, myLogger))
-			{
-				return -1;
-			}
-		}
-		else
-		{
-			myLogger.Log("Format not supported!\n");
 			return -1;
 		}
 
@@ -302,10 +295,13 @@ void Usage(const Parameters& params)
 	msg << "       --oclAcceleration           Enable/disable OpenCL acceleration (default=0, range={0,1})" << endl;
 	msg << "       --oclPlatformID             OpenCL platform id (default=0, range=0-# OCL platforms)" << endl;
 	msg << "       --oclDeviceID               OpenCL device id (default=0, range=0-# OCL devices)" << endl;
+	msg << "       --numThreads                Number of CPU threads, 0 uses all hardware threads (default=0, range=0-# hardware threads)" << endl;
+	msg << "       --benchmark                 Text file listing one mesh per line; each mesh is decomposed with 1 and --numThreads threads, timings are printed and the outputs are compared" << endl;
 	msg << "       --help                      Print usage" << endl
 		<< endl;
 	msg << "Examples:" << endl;
-	msg << "       testVHACD.exe --input bunny.obj --output bunny_acd.obj --log log.txt" << endl
+	msg << "       testVHACD.exe --input bunny.obj --output bunny_acd.obj --log log.txt" << endl;
+	msg << "       testVHACD.exe --benchmark corpus.txt --numThreads 8 --log log.txt" << endl
 		<< endl;
 	cout << msg.str();
 	if (params.m_paramsVHACD.m_logger)
@@ -421,6 +417,16 @@ void ParseParameters(int argc, char* argv[], Parameters& params)
 			if (++i < argc)
 				params.m_oclDeviceID = atoi(argv[i]);
 		}
+		else if (!strcmp(argv[i], "--numThreads"))
+		{
+			if (++i < argc)
+				params.m_paramsVHACD.m_numThreads = atoi(argv[i]);
+		}
+		else if (!strcmp(argv[i], "--benchmark"))
+		{
+			if (++i < argc)
+				params.m_fileNameBenchmark = argv[i];
+		}
 		else if (!strcmp(argv[i], "--help"))
 		{
 			params.m_run = false;
@@ -444,6 +450,112 @@ void GetFileExtension(const string& fileName, string& fileExtension)
 		transform(fileExtension.begin(), fileExtension.end(), fileExtension.begin(), ::toupper);
 	}
 }
+bool LoadMesh(const string& fileName, vector<float>& points, vector<int>& triangles, IVHACD::IUserLogger& logger)
+{
+	string fileExtension;
+	GetFileExtension(fileName, fileExtension);
+	if (fileExtension == ".OFF")
+	{
+		return LoadOFF(fileName, points, triangles, logger);
+	}
+	else if (fileExtension == ".OBJ")
+	{
+		return LoadOBJ(fileName, points, triangles, logger);
+	}
+	logger.Log("Format not supported!\n");
+	return false;
+}
+// runs the decomposition and returns the wall clock time in seconds, or a negative value on failure
+double TimeDecomposition(IVHACD* interfaceVHACD, const vector<float>& points, const vector<int>& triangles, const IVHACD::Parameters& paramsVHACD)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	bool res = interfaceVHACD->Compute(&points[0], 3, (unsigned int)points.size() / 3,
+									   &triangles[0], 3, (unsigned int)triangles.size() / 3, paramsVHACD);
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	return res ? std::chrono::duration<double>(end - start).count() : -1.0;
+}
+bool SameConvexHulls(IVHACD* a, IVHACD* b)
+{
+	if (a->GetNConvexHulls() != b->GetNConvexHulls())
+	{
+		return false;
+	}
+	IVHACD::ConvexHull chA, chB;
+	for (unsigned int p = 0; p < a->GetNConvexHulls(); ++p)
+	{
+		a->GetConvexHull(p, chA);
+		b->GetConvexHull(p, chB);
+		if (chA.m_nPoints != chB.m_nPoints || chA.m_nTriangles != chB.m_nTriangles ||
+			memcmp(chA.m_points, chB.m_points, sizeof(double) * 3 * chA.m_nPoints) ||
+			memcmp(chA.m_triangles, chB.m_triangles, sizeof(int) * 3 * chA.m_nTriangles))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+int RunBenchmark(const Parameters& params, IVHACD::IUserLogger& logger)
+{
+	ifstream corpus(params.m_fileNameBenchmark.c_str());
+	if (!corpus.is_open())
+	{
+		logger.Log("Couldn't open benchmark corpus\n");
+		return -1;
+	}
+	IVHACD::Parameters serialParams = params.m_paramsVHACD;
+	IVHACD::Parameters parallelParams = params.m_paramsVHACD;
+	serialParams.m_callback = 0;
+	parallelParams.m_callback = 0;
+	serialParams.m_numThreads = 1;
+
+	std::ostringstream msg;
+	msg << "+ Benchmark " << params.m_fileNameBenchmark << " (numThreads " << parallelParams.m_numThreads << ")" << endl;
+	msg << setw(40) << left << "mesh" << right << setw(8) << "CHs" << setw(12) << "serial(s)" << setw(12) << "threads(s)" << setw(10) << "speedup"
+		<< "  output" << endl;
+	double totalSerial = 0.0;
+	double totalParallel = 0.0;
+	bool allSame = true;
+	string fileName;
+	while (getline(corpus, fileName))
+	{
+		if (fileName.empty() || fileName[0] == '#')
+		{
+			continue;
+		}
+		vector<float> points;
+		vector<int> triangles;
+		if (!LoadMesh(fileName, points, triangles, logger) || triangles.empty())
+		{
+			msg << setw(40) << left << fileName << right << "  couldn't load mesh" << endl;
+			continue;
+		}
+		IVHACD* serialVHACD = CreateVHACD();
+		IVHACD* parallelVHACD = CreateVHACD();
+		double serialTime = TimeDecomposition(serialVHACD, points, triangles, serialParams);
+		double parallelTime = TimeDecomposition(parallelVHACD, points, triangles, parallelParams);
+		bool same = SameConvexHulls(serialVHACD, parallelVHACD);
+		allSame = allSame && same;
+		totalSerial += serialTime;
+		totalParallel += parallelTime;
+		msg << setw(40) << left << fileName << right << setw(8) << serialVHACD->GetNConvexHulls()
+			<< fixed << setprecision(3) << setw(12) << serialTime << setw(12) << parallelTime
+			<< setprecision(2) << setw(10) << (parallelTime > 0.0 ? serialTime / parallelTime : 0.0)
+			<< "  " << (same ? "identical" : "DIFFERENT") << endl;
+		serialVHACD->Clean();
+		serialVHACD->Release();
+		parallelVHACD->Clean();
+		parallelVHACD->Release();
+		cout << msg.str();
+		logger.Log(msg.str().c_str());
+		msg.str("");
+	}
+	msg << setw(40) << left << "total" << right << setw(8) << ""
+		<< fixed << setprecision(3) << setw(12) << totalSerial << setw(12) << totalParallel
+		<< setprecision(2) << setw(10) << (totalParallel > 0.0 ? totalSerial / totalParallel : 0.0) << endl;
+	cout << msg.str();
+	logger.Log(msg.str().c_str());
+	return allSame ? 0 : 1;
+}
 void ComputeRandomColor(Material& mat)
 {
 	mat.m_diffuseColor[0] = mat.m_diffuseColor[1] = mat.m_diffuseColor[2] = 0.0f;
@@ -195,6 +195,24 @@ TEST(BulletDynamicsTest, pendulum)
 	delete setup;
 }
 
+TEST(BulletDynamicsTest, pendulumImplicitPD)
+{
+	DummyGUIHelper noGfx;
+	Pendulum* setup = new Pendulum(&noGfx);
+	setup->initPhysics();
+	//gains and time step for which an explicit PD controller diverges
+	btScalar targetPos = 0.5;
+	setup->m_multiBody->setJointImplicitPD(0, targetPos, 0, 1e6, 1e4);
+	for (int i = 0; i < 120; i++)
+	{
+		setup->m_dynamicsWorld->stepSimulation(1. / 30., 0);
+	}
+	ASSERT_NEAR(setup->m_multiBody->getJointPos(0), targetPos, 0.01);
+	ASSERT_NEAR(setup->m_multiBody->getJointVel(0), 0, 0.01);
+	setup->exitPhysics();
+	delete setup;
+}
+
 int main(int argc, char** argv)
 {
 #if _MSC_VER
@@ -181,10 +181,23 @@ public:
 			}
 			case GFX_CMD_SYNCHRONIZE_TRANSFORMS:
 			{
-				GUISyncPosition* positions = (GUISyncPosition*)bufferServerToClient;
+				//only the instances that moved since the previous sync are sent
+				const GraphicsSyncTransform* transforms = (const GraphicsSyncTransform*)bufferServerToClient;
 				for (int i = 0; i < clientCmd.m_syncTransformsCommand.m_numPositions; i++)
 				{
-					m_app->m_renderer->writeSingleInstanceTransformToCPU(positions[i].m_pos, positions[i].m_orn, positions[i].m_graphicsInstanceId);
+					float orn[4];
+					float lenSqr = 0.f;
+					for (int q = 0; q < 4; q++)
+					{
+						orn[q] = float(transforms[i].m_orn[q]);
+						lenSqr += orn[q] * orn[q];
+					}
+					float scale = lenSqr > 0.f ? 1.f / float(btSqrt(lenSqr)) : 0.f;
+					for (int q = 0; q < 4; q++)
+					{
+						orn[q] *= scale;
+					}
+					m_app->m_renderer->writeSingleInstanceTransformToCPU(transforms[i].m_pos, orn, transforms[i].m_graphicsInstanceId);
 				}
 				break;
 			}
@@ -101,6 +101,15 @@ struct GraphicsSyncTransformsCommand
 	int m_numPositions;
 };
 
+//GFX_CMD_SYNCHRONIZE_TRANSFORMS streams one of these for each changed graphics instance,
+//the unit quaternion is quantized to 16 bits per component and renormalized by the server
+struct GraphicsSyncTransform
+{
+	int m_graphicsInstanceId;
+	float m_pos[3];
+	short m_orn[4];
+};
+
 struct GraphicsRemoveInstanceCommand
 {
 	int m_graphicsUid;
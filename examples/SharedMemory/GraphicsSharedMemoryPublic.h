@@ -7,7 +7,8 @@
 //Please don't replace an existing magic number:
 //instead, only ADD a new one at the top, comment-out previous one
 
-#define GRAPHICS_SHARED_MEMORY_MAGIC_NUMBER 201904030
+#define GRAPHICS_SHARED_MEMORY_MAGIC_NUMBER 202010180
+//#define GRAPHICS_SHARED_MEMORY_MAGIC_NUMBER 201904030
 enum EnumGraphicsSharedMemoryClientCommand
 {
 	GFX_CMD_INVALID = 0,
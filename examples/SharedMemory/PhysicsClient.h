@@ -67,6 +67,12 @@ public:
 
 	virtual void getCachedMeshData(struct b3MeshData* meshData) = 0;
 
+	virtual void getCachedStateHash(struct b3StateHashInformation* stateHashInfo) = 0;
+
+	virtual void getCachedBatchedActualState(struct b3BatchedActualStateData* stateData) = 0;
+
+	virtual void getCachedStateSubscription(struct b3StateSubscriptionData* subscriptionData) = 0;
+
 	virtual void getCachedVREvents(struct b3VREventsData* vrEventsData) = 0;
 
 	virtual void getCachedKeyboardEvents(struct b3KeyboardEventsData* keyboardEventsData) = 0;
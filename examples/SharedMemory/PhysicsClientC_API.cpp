@@ -216,6 +216,32 @@ B3_SHARED_API b3SharedMemoryCommandHandle b3SaveBulletCommandInit(b3PhysicsClien
 	}
 	return 0;
 }
+
+B3_SHARED_API int b3SaveBulletCommandSetInBackground(b3SharedMemoryCommandHandle commandHandle)
+{
+	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
+	b3Assert(command);
+	b3Assert(command->m_type == CMD_SAVE_BULLET);
+	command->m_updateFlags |= SAVE_BULLET_IN_BACKGROUND;
+	return 0;
+}
+
+B3_SHARED_API b3SharedMemoryCommandHandle b3InitRequestSaveBulletStatusCommand(b3PhysicsClientHandle physClient)
+{
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	b3Assert(cl);
+	b3Assert(cl->canSubmitCommand());
+	if (cl)
+	{
+		struct SharedMemoryCommand* command = cl->getAvailableSharedMemoryCommand();
+		b3Assert(command);
+		command->m_type = CMD_SAVE_BULLET;
+		command->m_fileArguments.m_fileName[0] = 0;
+		command->m_updateFlags = SAVE_BULLET_REQUEST_STATUS;
+		return (b3SharedMemoryCommandHandle)command;
+	}
+	return 0;
+}
 B3_SHARED_API b3SharedMemoryCommandHandle b3LoadMJCFCommandInit(b3PhysicsClientHandle physClient, const char* fileName)
 {
 	PhysicsClient* cl = (PhysicsClient*)physClient;
@@ -1203,6 +1229,113 @@ B3_SHARED_API int b3RequestActualStateCommandComputeForwardKinematics(b3SharedMe
 	return 0;
 }
 
+B3_SHARED_API b3SharedMemoryCommandHandle b3RequestBatchedActualStateCommandInit(b3PhysicsClientHandle physClient, const int* bodyUniqueIds, int numBodies, int fields)
+{
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	b3Assert(cl);
+	b3Assert(cl->canSubmitCommand());
+	if (cl)
+	{
+		struct SharedMemoryCommand* command = cl->getAvailableSharedMemoryCommand();
+		b3Assert(command);
+		command->m_type = CMD_REQUEST_BATCHED_ACTUAL_STATE;
+		command->m_updateFlags = 0;
+		command->m_requestBatchedActualStateArgs.m_numBodies = numBodies;
+		command->m_requestBatchedActualStateArgs.m_fields = fields;
+		cl->uploadBulletFileToSharedMemory((const char*)bodyUniqueIds, sizeof(int) * numBodies);
+		return (b3SharedMemoryCommandHandle)command;
+	}
+	return 0;
+}
+
+B3_SHARED_API int b3RequestBatchedActualStateComputeForwardKinematics(b3SharedMemoryCommandHandle commandHandle, int computeForwardKinematics)
+{
+	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
+	b3Assert(command);
+	btAssert(command->m_type == CMD_REQUEST_BATCHED_ACTUAL_STATE);
+	if (computeForwardKinematics && command->m_type == CMD_REQUEST_BATCHED_ACTUAL_STATE)
+	{
+		command->m_updateFlags |= ACTUAL_STATE_COMPUTE_FORWARD_KINEMATICS;
+	}
+	return 0;
+}
+
+B3_SHARED_API void b3GetBatchedActualStateData(b3PhysicsClientHandle physClient, struct b3BatchedActualStateData* stateData)
+{
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	if (cl)
+	{
+		cl->getCachedBatchedActualState(stateData);
+	}
+}
+
+B3_SHARED_API b3SharedMemoryCommandHandle b3StateSubscriptionCommandInit(b3PhysicsClientHandle physClient)
+{
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	b3Assert(cl);
+	b3Assert(cl->canSubmitCommand());
+	if (cl)
+	{
+		struct SharedMemoryCommand* command = cl->getAvailableSharedMemoryCommand();
+		b3Assert(command);
+		command->m_type = CMD_STATE_SUBSCRIPTION;
+		command->m_updateFlags = 0;
+		return (b3SharedMemoryCommandHandle)command;
+	}
+	return 0;
+}
+
+B3_SHARED_API int b3StateSubscriptionSetBodies(b3PhysicsClientHandle physClient, b3SharedMemoryCommandHandle commandHandle, const int* bodyUniqueIds, int numBodies, int fields)
+{
+	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	b3Assert(command);
+	b3Assert(command->m_type == CMD_STATE_SUBSCRIPTION);
+	if (cl && command->m_type == CMD_STATE_SUBSCRIPTION)
+	{
+		command->m_updateFlags |= STATE_SUBSCRIPTION_SET_BODIES;
+		command->m_stateSubscriptionArgs.m_numBodies = numBodies;
+		command->m_stateSubscriptionArgs.m_fields = fields;
+		cl->uploadBulletFileToSharedMemory((const char*)bodyUniqueIds, sizeof(int) * numBodies);
+	}
+	return 0;
+}
+
+B3_SHARED_API int b3StateSubscriptionSetDecimation(b3SharedMemoryCommandHandle commandHandle, int decimation)
+{
+	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
+	b3Assert(command);
+	b3Assert(command->m_type == CMD_STATE_SUBSCRIPTION);
+	if (command->m_type == CMD_STATE_SUBSCRIPTION)
+	{
+		command->m_updateFlags |= STATE_SUBSCRIPTION_SET_DECIMATION;
+		command->m_stateSubscriptionArgs.m_decimation = decimation;
+	}
+	return 0;
+}
+
+B3_SHARED_API int b3StateSubscriptionSetTolerance(b3SharedMemoryCommandHandle commandHandle, double tolerance)
+{
+	struct SharedMemoryCommand* command = (struct SharedMemoryCommand*)commandHandle;
+	b3Assert(command);
+	b3Assert(command->m_type == CMD_STATE_SUBSCRIPTION);
+	if (command->m_type == CMD_STATE_SUBSCRIPTION)
+	{
+		command->m_updateFlags |= STATE_SUBSCRIPTION_SET_TOLERANCE;
+		command->m_stateSubscriptionArgs.m_tolerance = tolerance;
+	}
+	return 0;
+}
+
+B3_SHARED_API void b3GetStateSubscriptionData(b3PhysicsClientHandle physClient, struct b3StateSubscriptionData* subscriptionData)
+{
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	if (cl)
+	{
+		cl->getCachedStateSubscription(subscriptionData);
+	}
+}
+
 B3_SHARED_API int b3GetJointState(b3PhysicsClientHandle physClient, b3SharedMemoryStatusHandle statusHandle, int jointIndex, b3JointSensorState* state)
 {
 
@@ -1399,6 +1532,63 @@ B3_SHARED_API void b3GetMeshData(b3PhysicsClientHandle physClient, struct b3Mesh
 	}
 }
 
+B3_SHARED_API b3SharedMemoryCommandHandle b3InitRequestStateHashCommand(b3PhysicsClientHandle physClient)
+{
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	b3Assert(cl);
+	b3Assert(cl->canSubmitCommand());
+	if (cl)
+	{
+		struct SharedMemoryCommand* command = cl->getAvailableSharedMemoryCommand();
+		b3Assert(command);
+		command->m_type = CMD_REQUEST_STATE_HASH;
+		command->m_updateFlags = 0;
+		return (b3SharedMemoryCommandHandle)command;
+	}
+	return 0;
+}
+
+B3_SHARED_API void b3GetStateHashInformation(b3PhysicsClientHandle physClient, struct b3StateHashInformation* stateHashInfo)
+{
+	PhysicsClient* cl = (PhysicsClient*)physClient;
+	if (cl)
+	{
+		cl->getCachedStateHash(stateHashInfo);
+	}
+}
+
+B3_SHARED_API int b3FindFirstDivergingBody(const struct b3StateHashInformation* stateHashInfoA, const struct b3StateHashInformation* stateHashInfoB)
+{
+	if (stateHashInfoA->m_stateHash == stateHashInfoB->m_stateHash && stateHashInfoA->m_numBodies == stateHashInfoB->m_numBodies)
+	{
+		return -1;
+	}
+	int numBodies = btMin(stateHashInfoA->m_numBodies, stateHashInfoB->m_numBodies);
+	for (int i = 0; i < numBodies; i++)
+	{
+		if (stateHashInfoA->m_bodies[i].m_bodyUniqueId != stateHashInfoB->m_bodies[i].m_bodyUniqueId ||
+			stateHashInfoA->m_bodies[i].m_hash != stateHashInfoB->m_bodies[i].m_hash)
+		{
+			return stateHashInfoA->m_bodies[i].m_bodyUniqueId;
+		}
+	}
+	if (stateHashInfoA->m_numBodies > numBodies)
+	{
+		return stateHashInfoA->m_bodies[numBodies].m_bodyUniqueId;
+	}
+	if (stateHashInfoB->m_numBodies > numBodies)
+	{
+		return stateHashInfoB->m_bodies[numBodies].m_bodyUniqueId;
+	}
+	//the bodies we have match, but some were not sent: the divergence is in the missing part
+	if (stateHashInfoA->m_numBodiesTotal > stateHashInfoA->m_numBodies ||
+		stateHashInfoB->m_numBodiesTotal > stateHashInfoB->m_numBodies)
+	{
+		return -2;
+	}
+	return -1;
+}
+
 B3_SHARED_API int b3CreateVisualShapeAddSphere(b3SharedMemoryCommandHandle commandHandle, double radius)
 {
 	return b3CreateCollisionShapeAddSphere(commandHandle, radius);
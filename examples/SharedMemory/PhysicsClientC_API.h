@@ -401,6 +401,11 @@ extern "C"
 	B3_SHARED_API b3SharedMemoryCommandHandle b3LoadBulletCommandInit(b3PhysicsClientHandle physClient, const char* fileName);
 
 	B3_SHARED_API b3SharedMemoryCommandHandle b3SaveBulletCommandInit(b3PhysicsClientHandle physClient, const char* fileName);
+	///write the file on a worker thread while the simulation continues. The status is CMD_BULLET_SAVING_PENDING,
+	///poll b3InitRequestSaveBulletStatusCommand until it reports CMD_BULLET_SAVING_COMPLETED or CMD_BULLET_SAVING_FAILED.
+	///The file is written under a temporary name and renamed once complete. Without BT_THREADSAFE the file is written right away.
+	B3_SHARED_API int b3SaveBulletCommandSetInBackground(b3SharedMemoryCommandHandle commandHandle);
+	B3_SHARED_API b3SharedMemoryCommandHandle b3InitRequestSaveBulletStatusCommand(b3PhysicsClientHandle physClient);
 	B3_SHARED_API b3SharedMemoryCommandHandle b3LoadMJCFCommandInit(b3PhysicsClientHandle physClient, const char* fileName);
 	B3_SHARED_API b3SharedMemoryCommandHandle b3LoadMJCFCommandInit2(b3SharedMemoryCommandHandle commandHandle, const char* fileName);
 	B3_SHARED_API void b3LoadMJCFCommandSetFlags(b3SharedMemoryCommandHandle commandHandle, int flags);
@@ -511,6 +516,13 @@ extern "C"
 	B3_SHARED_API b3SharedMemoryCommandHandle b3GetMeshDataCommandInit(b3PhysicsClientHandle physClient, int bodyUniqueId, int linkIndex);
 	B3_SHARED_API void b3GetMeshData(b3PhysicsClientHandle physClient, struct b3MeshData* meshData);
 
+	///request a hash of the current simulation state, cheap enough to call after every step to check determinism and replays
+	B3_SHARED_API b3SharedMemoryCommandHandle b3InitRequestStateHashCommand(b3PhysicsClientHandle physClient);
+	B3_SHARED_API void b3GetStateHashInformation(b3PhysicsClientHandle physClient, struct b3StateHashInformation* stateHashInfo);
+	///returns the unique id of the first body whose hash differs between the two states, or -1 if they match
+	///returns -2 if the sent bodies match but a truncated reply left out the ones that differ
+	B3_SHARED_API int b3FindFirstDivergingBody(const struct b3StateHashInformation* stateHashInfoA, const struct b3StateHashInformation* stateHashInfoB);
+
 
 	B3_SHARED_API b3SharedMemoryCommandHandle b3CreateVisualShapeCommandInit(b3PhysicsClientHandle physClient);
 	B3_SHARED_API int b3CreateVisualShapeAddSphere(b3SharedMemoryCommandHandle commandHandle, double radius);
@@ -597,6 +609,24 @@ extern "C"
 	B3_SHARED_API int b3RequestActualStateCommandComputeLinkVelocity(b3SharedMemoryCommandHandle commandHandle, int computeLinkVelocity);
 	B3_SHARED_API int b3RequestActualStateCommandComputeForwardKinematics(b3SharedMemoryCommandHandle commandHandle, int computeForwardKinematics);
 
+	///request the fields (eBatchedActualStateFields) of many bodies in one command, without a limit on the number of links or degrees of freedom per body.
+	///the state of all bodies has to fit in one stream chunk (SHARED_MEMORY_MAX_STREAM_CHUNK_SIZE)
+	B3_SHARED_API b3SharedMemoryCommandHandle b3RequestBatchedActualStateCommandInit(b3PhysicsClientHandle physClient, const int* bodyUniqueIds, int numBodies, int fields);
+	B3_SHARED_API int b3RequestBatchedActualStateComputeForwardKinematics(b3SharedMemoryCommandHandle commandHandle, int computeForwardKinematics);
+	B3_SHARED_API void b3GetBatchedActualStateData(b3PhysicsClientHandle physClient, struct b3BatchedActualStateData* stateData);
+
+	///subscribe to the state of bodies: after every 'decimation' simulation steps, the server records the fields (eBatchedActualStateFields)
+	///of the subscribed bodies that changed more than the tolerance since they were last sent. Setting zero bodies ends the subscription.
+	///The records are not pushed: the server has no way to send data the client did not ask for, over shared memory or TCP. They only
+	///arrive with the status of the next step simulation command, or of a state subscription command, which a client of a real-time
+	///simulation has to send to pick them up. A client that does not step the simulation itself therefore still polls, but one command
+	///returns all records since the last one, and the server drops the oldest records when too many wait (see m_numDroppedRecords).
+	B3_SHARED_API b3SharedMemoryCommandHandle b3StateSubscriptionCommandInit(b3PhysicsClientHandle physClient);
+	B3_SHARED_API int b3StateSubscriptionSetBodies(b3PhysicsClientHandle physClient, b3SharedMemoryCommandHandle commandHandle, const int* bodyUniqueIds, int numBodies, int fields);
+	B3_SHARED_API int b3StateSubscriptionSetDecimation(b3SharedMemoryCommandHandle commandHandle, int decimation);
+	B3_SHARED_API int b3StateSubscriptionSetTolerance(b3SharedMemoryCommandHandle commandHandle, double tolerance);
+	B3_SHARED_API void b3GetStateSubscriptionData(b3PhysicsClientHandle physClient, struct b3StateSubscriptionData* subscriptionData);
+
 	B3_SHARED_API int b3GetJointState(b3PhysicsClientHandle physClient, b3SharedMemoryStatusHandle statusHandle, int jointIndex, struct b3JointSensorState* state);
 	B3_SHARED_API int b3GetJointStateMultiDof(b3PhysicsClientHandle physClient, b3SharedMemoryStatusHandle statusHandle, int jointIndex, struct b3JointSensorState2* state);
 	B3_SHARED_API int b3GetLinkState(b3PhysicsClientHandle physClient, b3SharedMemoryStatusHandle statusHandle, int linkIndex, struct b3LinkState* state);
@@ -56,6 +56,18 @@ struct PhysicsClientSharedMemoryInternalData
 	b3MeshData m_cachedMeshData;
 	btAlignedObjectArray<b3MeshVertex> m_cachedVertexPositions;
 
+	unsigned int m_cachedStateHash;
+	btAlignedObjectArray<b3StateHashBody> m_cachedStateHashBodies;
+	int m_cachedStateHashNumBodiesTotal;
+
+	btAlignedObjectArray<b3BatchedActualStateBody> m_cachedBatchedActualStateBodies;
+	btAlignedObjectArray<double> m_cachedBatchedActualStateValues;
+
+	btAlignedObjectArray<b3StateSubscriptionRecord> m_cachedSubscriptionRecords;
+	btAlignedObjectArray<b3BatchedActualStateBody> m_cachedSubscriptionBodies;
+	btAlignedObjectArray<double> m_cachedSubscriptionValues;
+	int m_cachedNumDroppedSubscriptionRecords;
+
 	btAlignedObjectArray<b3VRControllerEvent> m_cachedVREvents;
 	btAlignedObjectArray<b3KeyboardEvent> m_cachedKeyboardEvents;
 	btAlignedObjectArray<b3MouseEvent> m_cachedMouseEvents;
@@ -102,6 +114,42 @@ struct PhysicsClientSharedMemoryInternalData
 	{
 		m_cachedMeshData.m_numVertices = 0;
 		m_cachedMeshData.m_vertices = 0;
+		m_cachedStateHash = 0;
+		m_cachedStateHashNumBodiesTotal = 0;
+		m_cachedNumDroppedSubscriptionRecords = 0;
+	}
+
+	//the state subscription records come with the step simulation and state subscription statuses
+	void cacheStateSubscription(const char* stream, int numStreamBytes)
+	{
+		m_cachedSubscriptionRecords.resize(0);
+		m_cachedSubscriptionBodies.resize(0);
+		m_cachedSubscriptionValues.resize(0);
+		m_cachedNumDroppedSubscriptionRecords = 0;
+		if (numStreamBytes < int(sizeof(StateSubscriptionStreamHeader)))
+		{
+			return;
+		}
+		StateSubscriptionStreamHeader header;
+		memcpy(&header, stream, sizeof(header));
+		const char* records = stream + sizeof(header);
+		const char* bodies = records + header.m_numRecords * sizeof(b3StateSubscriptionRecord);
+		m_cachedSubscriptionRecords.resize(header.m_numRecords);
+		m_cachedSubscriptionBodies.resize(header.m_numBodies);
+		m_cachedSubscriptionValues.resize(header.m_numValues);
+		m_cachedNumDroppedSubscriptionRecords = header.m_numDroppedRecords;
+		if (header.m_numRecords)
+		{
+			memcpy(&m_cachedSubscriptionRecords[0], records, header.m_numRecords * sizeof(b3StateSubscriptionRecord));
+		}
+		if (header.m_numBodies)
+		{
+			memcpy(&m_cachedSubscriptionBodies[0], bodies, header.m_numBodies * sizeof(b3BatchedActualStateBody));
+		}
+		if (header.m_numValues)
+		{
+			memcpy(&m_cachedSubscriptionValues[0], stream + header.m_valueStreamOffset, header.m_numValues * sizeof(double));
+		}
 	}
 
 	void processServerStatus();
@@ -697,6 +745,7 @@ const SharedMemoryStatus* PhysicsClientSharedMemory::processServerStatus()
 				{
 					b3Printf("Server completed step simulation");
 				}
+				m_data->cacheStateSubscription(m_data->m_testBlock1->m_bulletStreamDataServerToClientRefactor, serverCmd.m_numDataStreamBytes);
 				break;
 			}
 			case CMD_URDF_LOADING_FAILED:
@@ -1061,6 +1110,58 @@ const SharedMemoryStatus* PhysicsClientSharedMemory::processServerStatus()
 				b3Warning("Request mesh data failed");
 				break;
 			}
+			case CMD_REQUEST_STATE_HASH_COMPLETED:
+			{
+				const b3StateHashBody* bodiesReceived = (const b3StateHashBody*)m_data->m_testBlock1->m_bulletStreamDataServerToClientRefactor;
+				m_data->m_cachedStateHash = serverCmd.m_sendStateHashArgs.m_stateHash;
+				m_data->m_cachedStateHashNumBodiesTotal = serverCmd.m_sendStateHashArgs.m_numBodies;
+				if (serverCmd.m_sendStateHashArgs.m_numBodiesCopied < serverCmd.m_sendStateHashArgs.m_numBodies)
+				{
+					b3Warning("State hash reply truncated: %d of %d bodies", serverCmd.m_sendStateHashArgs.m_numBodiesCopied, serverCmd.m_sendStateHashArgs.m_numBodies);
+				}
+				m_data->m_cachedStateHashBodies.resize(serverCmd.m_sendStateHashArgs.m_numBodiesCopied);
+				for (int i = 0; i < serverCmd.m_sendStateHashArgs.m_numBodiesCopied; i++)
+				{
+					m_data->m_cachedStateHashBodies[i] = bodiesReceived[i];
+				}
+				break;
+			}
+			case CMD_REQUEST_STATE_HASH_FAILED:
+			{
+				b3Warning("Request state hash failed");
+				break;
+			}
+			case CMD_BATCHED_ACTUAL_STATE_COMPLETED:
+			{
+				const char* streamReceived = (const char*)m_data->m_testBlock1->m_bulletStreamDataServerToClientRefactor;
+				const SendBatchedActualStateArgs& args = serverCmd.m_sendBatchedActualStateArgs;
+				m_data->m_cachedBatchedActualStateBodies.resize(args.m_numBodies);
+				m_data->m_cachedBatchedActualStateValues.resize(args.m_numValues);
+				if (args.m_numBodies)
+				{
+					memcpy(&m_data->m_cachedBatchedActualStateBodies[0], streamReceived, args.m_numBodies * sizeof(b3BatchedActualStateBody));
+				}
+				if (args.m_numValues)
+				{
+					memcpy(&m_data->m_cachedBatchedActualStateValues[0], streamReceived + args.m_valueStreamOffset, args.m_numValues * sizeof(double));
+				}
+				break;
+			}
+			case CMD_BATCHED_ACTUAL_STATE_FAILED:
+			{
+				b3Warning("Request batched actual state failed");
+				break;
+			}
+			case CMD_STATE_SUBSCRIPTION_COMPLETED:
+			{
+				m_data->cacheStateSubscription(m_data->m_testBlock1->m_bulletStreamDataServerToClientRefactor, serverCmd.m_numDataStreamBytes);
+				break;
+			}
+			case CMD_STATE_SUBSCRIPTION_FAILED:
+			{
+				b3Warning("State subscription failed");
+				break;
+			}
 			case CMD_CALCULATED_INVERSE_DYNAMICS_COMPLETED:
 			{
 				break;
@@ -1405,6 +1506,10 @@ const SharedMemoryStatus* PhysicsClientSharedMemory::processServerStatus()
 			{
 				break;
 			}
+			case CMD_BULLET_SAVING_PENDING:
+			{
+				break;
+			}
 			case CMD_COLLISION_SHAPE_INFO_FAILED:
 			{
 				b3Warning("getCollisionShapeData failed");
@@ -2027,6 +2132,31 @@ void PhysicsClientSharedMemory::getCachedMeshData(struct b3MeshData* meshData)
 	*meshData = m_data->m_cachedMeshData;
 }
 
+void PhysicsClientSharedMemory::getCachedStateHash(struct b3StateHashInformation* stateHashInfo)
+{
+	stateHashInfo->m_stateHash = m_data->m_cachedStateHash;
+	stateHashInfo->m_numBodies = m_data->m_cachedStateHashBodies.size();
+	stateHashInfo->m_bodies = stateHashInfo->m_numBodies ? &m_data->m_cachedStateHashBodies[0] : 0;
+	stateHashInfo->m_numBodiesTotal = m_data->m_cachedStateHashNumBodiesTotal;
+}
+
+void PhysicsClientSharedMemory::getCachedBatchedActualState(struct b3BatchedActualStateData* stateData)
+{
+	stateData->m_numBodies = m_data->m_cachedBatchedActualStateBodies.size();
+	stateData->m_bodies = stateData->m_numBodies ? &m_data->m_cachedBatchedActualStateBodies[0] : 0;
+	stateData->m_numValues = m_data->m_cachedBatchedActualStateValues.size();
+	stateData->m_values = stateData->m_numValues ? &m_data->m_cachedBatchedActualStateValues[0] : 0;
+}
+
+void PhysicsClientSharedMemory::getCachedStateSubscription(struct b3StateSubscriptionData* subscriptionData)
+{
+	subscriptionData->m_numRecords = m_data->m_cachedSubscriptionRecords.size();
+	subscriptionData->m_records = subscriptionData->m_numRecords ? &m_data->m_cachedSubscriptionRecords[0] : 0;
+	subscriptionData->m_bodies = m_data->m_cachedSubscriptionBodies.size() ? &m_data->m_cachedSubscriptionBodies[0] : 0;
+	subscriptionData->m_values = m_data->m_cachedSubscriptionValues.size() ? &m_data->m_cachedSubscriptionValues[0] : 0;
+	subscriptionData->m_numDroppedRecords = m_data->m_cachedNumDroppedSubscriptionRecords;
+}
+
 const float* PhysicsClientSharedMemory::getDebugLinesFrom() const
 {
 	if (m_data->m_debugLinesFrom.size())
@@ -69,6 +69,18 @@ struct PhysicsDirectInternalData
 	b3MeshData m_cachedMeshData;
 	btAlignedObjectArray<b3MeshVertex> m_cachedVertexPositions;
 
+	unsigned int m_cachedStateHash;
+	btAlignedObjectArray<b3StateHashBody> m_cachedStateHashBodies;
+	int m_cachedStateHashNumBodiesTotal;
+
+	btAlignedObjectArray<b3BatchedActualStateBody> m_cachedBatchedActualStateBodies;
+	btAlignedObjectArray<double> m_cachedBatchedActualStateValues;
+
+	btAlignedObjectArray<b3StateSubscriptionRecord> m_cachedSubscriptionRecords;
+	btAlignedObjectArray<b3BatchedActualStateBody> m_cachedSubscriptionBodies;
+	btAlignedObjectArray<double> m_cachedSubscriptionValues;
+	int m_cachedNumDroppedSubscriptionRecords;
+
 	btAlignedObjectArray<b3VRControllerEvent> m_cachedVREvents;
 
 	btAlignedObjectArray<b3KeyboardEvent> m_cachedKeyboardEvents;
@@ -95,10 +107,46 @@ struct PhysicsDirectInternalData
 		  m_timeOutInSeconds(1e30)
 	{
 		memset(&m_cachedMeshData.m_numVertices, 0, sizeof(b3MeshData));
+		m_cachedStateHash = 0;
+		m_cachedStateHashNumBodiesTotal = 0;
+		m_cachedNumDroppedSubscriptionRecords = 0;
 		memset(&m_command, 0, sizeof(m_command));
 		memset(&m_serverStatus, 0, sizeof(m_serverStatus));
 		memset(m_bulletStreamDataServerToClient, 0, sizeof(m_bulletStreamDataServerToClient));
 	}
+
+	//the state subscription records come with the step simulation and state subscription statuses
+	void cacheStateSubscription(const char* stream, int numStreamBytes)
+	{
+		m_cachedSubscriptionRecords.resize(0);
+		m_cachedSubscriptionBodies.resize(0);
+		m_cachedSubscriptionValues.resize(0);
+		m_cachedNumDroppedSubscriptionRecords = 0;
+		if (numStreamBytes < int(sizeof(StateSubscriptionStreamHeader)))
+		{
+			return;
+		}
+		StateSubscriptionStreamHeader header;
+		memcpy(&header, stream, sizeof(header));
+		const char* records = stream + sizeof(header);
+		const char* bodies = records + header.m_numRecords * sizeof(b3StateSubscriptionRecord);
+		m_cachedSubscriptionRecords.resize(header.m_numRecords);
+		m_cachedSubscriptionBodies.resize(header.m_numBodies);
+		m_cachedSubscriptionValues.resize(header.m_numValues);
+		m_cachedNumDroppedSubscriptionRecords = header.m_numDroppedRecords;
+		if (header.m_numRecords)
+		{
+			memcpy(&m_cachedSubscriptionRecords[0], records, header.m_numRecords * sizeof(b3StateSubscriptionRecord));
+		}
+		if (header.m_numBodies)
+		{
+			memcpy(&m_cachedSubscriptionBodies[0], bodies, header.m_numBodies * sizeof(b3BatchedActualStateBody));
+		}
+		if (header.m_numValues)
+		{
+			memcpy(&m_cachedSubscriptionValues[0], stream + header.m_valueStreamOffset, header.m_numValues * sizeof(double));
+		}
+	}
 };
 
 PhysicsDirect::PhysicsDirect(PhysicsCommandProcessorInterface* physSdk, bool passSdkOwnership)
@@ -1113,6 +1161,58 @@ void PhysicsDirect::postProcessStatus(const struct SharedMemoryStatus& serverCmd
 			b3Warning("Request mesh data failed");
 			break;
 		}
+		case CMD_REQUEST_STATE_HASH_COMPLETED:
+		{
+			const b3StateHashBody* bodiesReceived = (const b3StateHashBody*)&m_data->m_bulletStreamDataServerToClient[0];
+			m_data->m_cachedStateHash = serverCmd.m_sendStateHashArgs.m_stateHash;
+			m_data->m_cachedStateHashNumBodiesTotal = serverCmd.m_sendStateHashArgs.m_numBodies;
+			if (serverCmd.m_sendStateHashArgs.m_numBodiesCopied < serverCmd.m_sendStateHashArgs.m_numBodies)
+			{
+				b3Warning("State hash reply truncated: %d of %d bodies", serverCmd.m_sendStateHashArgs.m_numBodiesCopied, serverCmd.m_sendStateHashArgs.m_numBodies);
+			}
+			m_data->m_cachedStateHashBodies.resize(serverCmd.m_sendStateHashArgs.m_numBodiesCopied);
+			for (int i = 0; i < serverCmd.m_sendStateHashArgs.m_numBodiesCopied; i++)
+			{
+				m_data->m_cachedStateHashBodies[i] = bodiesReceived[i];
+			}
+			break;
+		}
+		case CMD_REQUEST_STATE_HASH_FAILED:
+		{
+			b3Warning("Request state hash failed");
+			break;
+		}
+		case CMD_BATCHED_ACTUAL_STATE_COMPLETED:
+		{
+			const char* streamReceived = (const char*)&m_data->m_bulletStreamDataServerToClient[0];
+			const SendBatchedActualStateArgs& args = serverCmd.m_sendBatchedActualStateArgs;
+			m_data->m_cachedBatchedActualStateBodies.resize(args.m_numBodies);
+			m_data->m_cachedBatchedActualStateValues.resize(args.m_numValues);
+			if (args.m_numBodies)
+			{
+				memcpy(&m_data->m_cachedBatchedActualStateBodies[0], streamReceived, args.m_numBodies * sizeof(b3BatchedActualStateBody));
+			}
+			if (args.m_numValues)
+			{
+				memcpy(&m_data->m_cachedBatchedActualStateValues[0], streamReceived + args.m_valueStreamOffset, args.m_numValues * sizeof(double));
+			}
+			break;
+		}
+		case CMD_BATCHED_ACTUAL_STATE_FAILED:
+		{
+			b3Warning("Request batched actual state failed");
+			break;
+		}
+		case CMD_STATE_SUBSCRIPTION_COMPLETED:
+		{
+			m_data->cacheStateSubscription(m_data->m_bulletStreamDataServerToClient, serverCmd.m_numDataStreamBytes);
+			break;
+		}
+		case CMD_STATE_SUBSCRIPTION_FAILED:
+		{
+			b3Warning("State subscription failed");
+			break;
+		}
 		case CMD_CUSTOM_COMMAND_COMPLETED:
 		{
 			break;
@@ -1163,6 +1263,7 @@ void PhysicsDirect::postProcessStatus(const struct SharedMemoryStatus& serverCmd
 		}
 		case CMD_STEP_FORWARD_SIMULATION_COMPLETED:
 		{
+			m_data->cacheStateSubscription(m_data->m_bulletStreamDataServerToClient, serverCmd.m_numDataStreamBytes);
 			break;
 		}
 		case CMD_REQUEST_PHYSICS_SIMULATION_PARAMETERS_COMPLETED:
@@ -1207,6 +1308,10 @@ void PhysicsDirect::postProcessStatus(const struct SharedMemoryStatus& serverCmd
 		{
 			break;
 		}
+		case CMD_BULLET_SAVING_PENDING:
+		{
+			break;
+		}
 		case CMD_LOAD_SOFT_BODY_FAILED:
 		{
 			b3Warning("loadSoftBody failed");
@@ -1591,6 +1696,31 @@ void PhysicsDirect::getCachedMeshData(struct b3MeshData* meshData)
 	*meshData = m_data->m_cachedMeshData;
 }
 
+void PhysicsDirect::getCachedStateHash(struct b3StateHashInformation* stateHashInfo)
+{
+	stateHashInfo->m_stateHash = m_data->m_cachedStateHash;
+	stateHashInfo->m_numBodies = m_data->m_cachedStateHashBodies.size();
+	stateHashInfo->m_bodies = stateHashInfo->m_numBodies ? &m_data->m_cachedStateHashBodies[0] : 0;
+	stateHashInfo->m_numBodiesTotal = m_data->m_cachedStateHashNumBodiesTotal;
+}
+
+void PhysicsDirect::getCachedBatchedActualState(struct b3BatchedActualStateData* stateData)
+{
+	stateData->m_numBodies = m_data->m_cachedBatchedActualStateBodies.size();
+	stateData->m_bodies = stateData->m_numBodies ? &m_data->m_cachedBatchedActualStateBodies[0] : 0;
+	stateData->m_numValues = m_data->m_cachedBatchedActualStateValues.size();
+	stateData->m_values = stateData->m_numValues ? &m_data->m_cachedBatchedActualStateValues[0] : 0;
+}
+
+void PhysicsDirect::getCachedStateSubscription(struct b3StateSubscriptionData* subscriptionData)
+{
+	subscriptionData->m_numRecords = m_data->m_cachedSubscriptionRecords.size();
+	subscriptionData->m_records = subscriptionData->m_numRecords ? &m_data->m_cachedSubscriptionRecords[0] : 0;
+	subscriptionData->m_bodies = m_data->m_cachedSubscriptionBodies.size() ? &m_data->m_cachedSubscriptionBodies[0] : 0;
+	subscriptionData->m_values = m_data->m_cachedSubscriptionValues.size() ? &m_data->m_cachedSubscriptionValues[0] : 0;
+	subscriptionData->m_numDroppedRecords = m_data->m_cachedNumDroppedSubscriptionRecords;
+}
+
 void PhysicsDirect::getCachedContactPointInformation(struct b3ContactInformation* contactPointData)
 {
 	contactPointData->m_numContactPoints = m_data->m_cachedContactPoints.size();
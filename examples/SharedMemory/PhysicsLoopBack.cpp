@@ -183,6 +183,21 @@ void PhysicsLoopBack::getCachedMeshData(struct b3MeshData* meshData)
 	return m_data->m_physicsClient->getCachedMeshData(meshData);
 }
 
+void PhysicsLoopBack::getCachedStateHash(struct b3StateHashInformation* stateHashInfo)
+{
+	return m_data->m_physicsClient->getCachedStateHash(stateHashInfo);
+}
+
+void PhysicsLoopBack::getCachedBatchedActualState(struct b3BatchedActualStateData* stateData)
+{
+	return m_data->m_physicsClient->getCachedBatchedActualState(stateData);
+}
+
+void PhysicsLoopBack::getCachedStateSubscription(struct b3StateSubscriptionData* subscriptionData)
+{
+	return m_data->m_physicsClient->getCachedStateSubscription(subscriptionData);
+}
+
 void PhysicsLoopBack::getCachedContactPointInformation(struct b3ContactInformation* contactPointData)
 {
 	return m_data->m_physicsClient->getCachedContactPointInformation(contactPointData);
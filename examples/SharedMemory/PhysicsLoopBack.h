@@ -78,6 +78,12 @@ public:
 
 	virtual void getCachedMeshData(struct b3MeshData* meshData);
 
+	virtual void getCachedStateHash(struct b3StateHashInformation* stateHashInfo);
+
+	virtual void getCachedBatchedActualState(struct b3BatchedActualStateData* stateData);
+
+	virtual void getCachedStateSubscription(struct b3StateSubscriptionData* subscriptionData);
+
 	virtual void getCachedVREvents(struct b3VREventsData* vrEventsData);
 
 	virtual void getCachedKeyboardEvents(struct b3KeyboardEventsData* keyboardEventsData);
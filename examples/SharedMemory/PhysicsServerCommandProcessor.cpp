@@ -1,6 +1,7 @@
 #include "PhysicsServerCommandProcessor.h"
 #include "../CommonInterfaces/CommonRenderInterface.h"
 #include "plugins/b3PluginCollisionInterface.h"
+#include "plugins/b3CollisionFilterTable.h"
 #include "../Importers/ImportURDFDemo/BulletUrdfImporter.h"
 #include "../Importers/ImportURDFDemo/MyMultiBodyCreator.h"
 #include "../Importers/ImportURDFDemo/URDF2Bullet.h"
@@ -54,6 +55,7 @@
 #include "../Extras/Serialize/BulletFileLoader/btBulletFile.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "LinearMath/TaskScheduler/btThreadSupportInterface.h"
+#include "LinearMath/btThreads.h"
 #include "Wavefront/tiny_obj_loader.h"
 #ifndef SKIP_COLLISION_FILTER_PLUGIN
 #include "plugins/collisionFilterPlugin/collisionFilterPlugin.h"
@@ -754,75 +756,104 @@ struct MyOverlapFilterCallback : public btOverlapFilterCallback
 {
 	int m_filterMode;
 	b3PluginManager* m_pluginManager;
+	//cached from m_pluginManager by syncCollisionInterface, so the per-pair test doesn't look up the plugin
+	b3PluginCollisionInterface* m_collisionInterface;
+	const b3CollisionFilterTable* m_filterTable;
 
 	MyOverlapFilterCallback(b3PluginManager* pluginManager)
 		: m_filterMode(B3_FILTER_GROUPAMASKB_AND_GROUPBMASKA),
-		  m_pluginManager(pluginManager)
+		  m_pluginManager(pluginManager),
+		  m_collisionInterface(0),
+		  m_filterTable(0)
 	{
+		syncCollisionInterface();
 	}
 
 	virtual ~MyOverlapFilterCallback()
 	{
 	}
+
+	//call when the collision plugin is loaded or unloaded
+	void syncCollisionInterface()
+	{
+		m_collisionInterface = m_pluginManager->getCollisionInterface();
+		m_filterTable = m_collisionInterface ? m_collisionInterface->getFilterTable() : 0;
+	}
+
+	static B3_FORCE_INLINE void getObjectUniqueIdAndLink(const btBroadphaseProxy* proxy, int& objectUniqueId, int& linkIndex)
+	{
+		btCollisionObject* colObj = (btCollisionObject*)proxy->m_clientObject;
+		btMultiBodyLinkCollider* mbl = btMultiBodyLinkCollider::upcast(colObj);
+		if (mbl)
+		{
+			objectUniqueId = mbl->m_multiBody->getUserIndex2();
+			linkIndex = mbl->m_link;
+		}
+		else
+		{
+			objectUniqueId = colObj->getUserIndex2();
+			linkIndex = -1;
+		}
+	}
+
+	B3_FORCE_INLINE bool needsCollisionByGroupMask(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1) const
+	{
+		if (m_filterMode == B3_FILTER_GROUPAMASKB_AND_GROUPBMASKA)
+		{
+			bool collides = (proxy0->m_collisionFilterGroup & proxy1->m_collisionFilterMask) != 0;
+			collides = collides && (proxy1->m_collisionFilterGroup & proxy0->m_collisionFilterMask);
+			return collides;
+		}
+
+		if (m_filterMode == B3_FILTER_GROUPAMASKB_OR_GROUPBMASKA)
+		{
+			bool collides = (proxy0->m_collisionFilterGroup & proxy1->m_collisionFilterMask) != 0;
+			collides = collides || (proxy1->m_collisionFilterGroup & proxy0->m_collisionFilterMask);
+			return collides;
+		}
+		return false;
+	}
+
 	// return true when pairs need collision
 	virtual bool needBroadphaseCollision(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1) const
 	{
-		b3PluginCollisionInterface* collisionInterface = m_pluginManager->getCollisionInterface();
-
-		if (collisionInterface && collisionInterface->getNumRules())
+		if (m_filterTable)
 		{
-			int objectUniqueIdB = -1, linkIndexB = -1;
-			btCollisionObject* colObjB = (btCollisionObject*)proxy1->m_clientObject;
-			btMultiBodyLinkCollider* mblB = btMultiBodyLinkCollider::upcast(colObjB);
-			if (mblB)
-			{
-				objectUniqueIdB = mblB->m_multiBody->getUserIndex2();
-				linkIndexB = mblB->m_link;
-			}
-			else
+			if (m_filterTable->isDirty())
 			{
-				objectUniqueIdB = colObjB->getUserIndex2();
-				linkIndexB = -1;
+				//first query after the rules changed, let the plugin recompile them once
+				m_collisionInterface->getFilterTable();
 			}
-			int objectUniqueIdA = -1, linkIndexA = -1;
-			btCollisionObject* colObjA = (btCollisionObject*)proxy0->m_clientObject;
-			btMultiBodyLinkCollider* mblA = btMultiBodyLinkCollider::upcast(colObjA);
-			if (mblA)
+			//the plugin keeps a compiled table of its rules, check it inline
+			if (m_filterTable->getNumRules())
 			{
-				objectUniqueIdA = mblA->m_multiBody->getUserIndex2();
-				linkIndexA = mblA->m_link;
-			}
-			else
-			{
-				objectUniqueIdA = colObjA->getUserIndex2();
-				linkIndexA = -1;
+				int objectUniqueIdA, linkIndexA, objectUniqueIdB, linkIndexB;
+				getObjectUniqueIdAndLink(proxy0, objectUniqueIdA, linkIndexA);
+				getObjectUniqueIdAndLink(proxy1, objectUniqueIdB, linkIndexB);
+				int rule = m_filterTable->lookup(objectUniqueIdA, linkIndexA, objectUniqueIdB, linkIndexB);
+				if (rule != B3_FILTER_RULE_NONE)
+				{
+					return rule == B3_FILTER_RULE_ENABLE;
+				}
 			}
+			return needsCollisionByGroupMask(proxy0, proxy1);
+		}
+
+		if (m_collisionInterface && m_collisionInterface->getNumRules())
+		{
+			int objectUniqueIdA, linkIndexA, objectUniqueIdB, linkIndexB;
+			getObjectUniqueIdAndLink(proxy0, objectUniqueIdA, linkIndexA);
+			getObjectUniqueIdAndLink(proxy1, objectUniqueIdB, linkIndexB);
 			int collisionFilterGroupA = proxy0->m_collisionFilterGroup;
 			int collisionFilterMaskA = proxy0->m_collisionFilterMask;
 			int collisionFilterGroupB = proxy1->m_collisionFilterGroup;
 			int collisionFilterMaskB = proxy1->m_collisionFilterMask;
 
-			return collisionInterface->needsBroadphaseCollision(objectUniqueIdA, linkIndexA,
-																collisionFilterGroupA, collisionFilterMaskA,
-																objectUniqueIdB, linkIndexB, collisionFilterGroupB, collisionFilterMaskB, m_filterMode);
-		}
-		else
-		{
-			if (m_filterMode == B3_FILTER_GROUPAMASKB_AND_GROUPBMASKA)
-			{
-				bool collides = (proxy0->m_collisionFilterGroup & proxy1->m_collisionFilterMask) != 0;
-				collides = collides && (proxy1->m_collisionFilterGroup & proxy0->m_collisionFilterMask);
-				return collides;
-			}
-
-			if (m_filterMode == B3_FILTER_GROUPAMASKB_OR_GROUPBMASKA)
-			{
-				bool collides = (proxy0->m_collisionFilterGroup & proxy1->m_collisionFilterMask) != 0;
-				collides = collides || (proxy1->m_collisionFilterGroup & proxy0->m_collisionFilterMask);
-				return collides;
-			}
-			return false;
+			return m_collisionInterface->needsBroadphaseCollision(objectUniqueIdA, linkIndexA,
+																  collisionFilterGroupA, collisionFilterMaskA,
+																  objectUniqueIdB, linkIndexB, collisionFilterGroupB, collisionFilterMaskB, m_filterMode);
 		}
+		return needsCollisionByGroupMask(proxy0, proxy1);
 	}
 };
 
@@ -1656,6 +1687,19 @@ struct PhysicsServerCommandProcessorInternalData
 
 	btAlignedObjectArray<InternalStateLogger*> m_stateLoggers;
 	int m_stateLoggersUniqueId;
+
+	//state subscription: the bodies, fields and decimation requested by the client,
+	//the state last sent per subscribed body and the records waiting to be sent
+	btAlignedObjectArray<int> m_subscribedBodies;
+	int m_subscriptionFields;
+	int m_subscriptionDecimation;
+	int m_subscriptionStepCount;
+	double m_subscriptionTolerance;
+	btAlignedObjectArray<btAlignedObjectArray<double> > m_subscriptionSentValues;
+	btAlignedObjectArray<b3StateSubscriptionRecord> m_subscriptionRecords;
+	btAlignedObjectArray<b3BatchedActualStateBody> m_subscriptionBodies;
+	btAlignedObjectArray<double> m_subscriptionValues;
+	int m_numDroppedSubscriptionRecords;
 	int m_profileTimingLoggingUid;
 	std::string m_profileTimingFileName;
 
@@ -1687,6 +1731,9 @@ struct PhysicsServerCommandProcessorInternalData
 	b3HashMap<b3HashString, UrdfVisualShapeCache> m_cachedVUrdfisualShapes;
 
 	b3ThreadPool* m_threadPool;
+	b3ThreadPool* m_saveThreadPool;
+	struct SaveBulletTask* m_saveTask;
+	bool m_saveTaskRunning;
 	btScalar m_defaultCollisionMargin;
 
 	double m_remoteSyncTransformTime;
@@ -1716,6 +1763,11 @@ struct PhysicsServerCommandProcessorInternalData
 		  m_constraintSolverType(-1),
 		  m_remoteDebugDrawer(0),
 		  m_stateLoggersUniqueId(0),
+		  m_subscriptionFields(0),
+		  m_subscriptionDecimation(1),
+		  m_subscriptionStepCount(0),
+		  m_subscriptionTolerance(0),
+		  m_numDroppedSubscriptionRecords(0),
 		  m_profileTimingLoggingUid(-1),
 		  m_guiHelper(0),
 		  m_sharedMemoryKey(SHARED_MEMORY_KEY),
@@ -1728,6 +1780,9 @@ struct PhysicsServerCommandProcessorInternalData
 		  m_collisionFilterPlugin(-1),
 		  m_grpcPlugin(-1),
 		  m_threadPool(0),
+		  m_saveThreadPool(0),
+		  m_saveTask(0),
+		  m_saveTaskRunning(false),
 		  m_defaultCollisionMargin(0.001),
 		  m_remoteSyncTransformTime(1. / 30.),
 		  m_remoteSyncTransformInterval(1. / 30.)
@@ -1911,7 +1966,7 @@ struct PhysicsServerCommandProcessorInternalData
 		}
 	}
 
-	cRBDModel* findOrCreateRBDModel(btMultiBody* multiBody, const double* jointPositionsQ, const double* jointVelocitiesQdot)
+	cRBDModel* findOrCreateRBDModel(btMultiBody* multiBody)
 	{
 		cRBDModel* rbdModel = 0;
 		cRBDModel** rbdModelPtr = m_rbdModels.find(multiBody);
@@ -1930,6 +1985,12 @@ struct PhysicsServerCommandProcessorInternalData
 			rbdModel->Init(jointMat, bodyDefs, gravity);
 			m_rbdModels.insert(multiBody, rbdModel);
 		}
+		return rbdModel;
+	}
+
+	cRBDModel* findOrCreateRBDModel(btMultiBody* multiBody, const double* jointPositionsQ, const double* jointVelocitiesQdot)
+	{
+		cRBDModel* rbdModel = findOrCreateRBDModel(multiBody);
 
 		//sync pose and vel
 
@@ -1947,6 +2008,201 @@ struct PhysicsServerCommandProcessorInternalData
 		return rbdModel;
 	}
 
+	//target of CONTROL_MODE_STABLE_PD for a multibody. It is evaluated in the pre-tick of the internal
+	//simulation steps of the next stepSimulation, so the torques are applied in every substep, and the
+	//factorized mass matrix is computed in the first substep and reused in the others.
+	struct StablePDControl
+	{
+		btMultiBody* m_multiBody;
+		cRBDModel* m_rbdModel;
+		btAlignedObjectArray<double> m_desiredQ;
+		btAlignedObjectArray<double> m_desiredQdot;
+		btAlignedObjectArray<double> m_kp;
+		btAlignedObjectArray<double> m_kd;
+		btAlignedObjectArray<double> m_maxForce;
+		int m_numSubStepsLeft;
+		bool m_hasMassMat;
+		Eigen::LDLT<Eigen::MatrixXd> m_massMatLDLT;
+
+		StablePDControl(btMultiBody* multiBody, cRBDModel* rbdModel)
+			: m_multiBody(multiBody),
+			  m_rbdModel(rbdModel),
+			  m_numSubStepsLeft(0),
+			  m_hasMassMat(false)
+		{
+		}
+	};
+	b3HashMap<btHashPtr, StablePDControl*> m_stablePDControls;
+	btAlignedObjectArray<StablePDControl*> m_activeStablePDControls;
+
+	StablePDControl* findOrCreateStablePDControl(btMultiBody* multiBody)
+	{
+		StablePDControl** controlPtr = m_stablePDControls.find(multiBody);
+		if (controlPtr)
+		{
+			return *controlPtr;
+		}
+		StablePDControl* control = new StablePDControl(multiBody, findOrCreateRBDModel(multiBody));
+		m_stablePDControls.insert(multiBody, control);
+		return control;
+	}
+
+	void removeStablePDControl(btMultiBody* multiBody)
+	{
+		StablePDControl** controlPtr = m_stablePDControls.find(multiBody);
+		if (controlPtr)
+		{
+			delete *controlPtr;
+			m_stablePDControls.remove(multiBody);
+		}
+	}
+
+	//generalized positions and velocities in the layout of the stable PD command (base first, quaternion xyzw)
+	static void getStablePDState(const btMultiBody* mb, btAlignedObjectArray<double>& jointPositionsQ, btAlignedObjectArray<double>& jointVelocitiesQdot)
+	{
+		jointPositionsQ.resize(0);
+		jointVelocitiesQdot.resize(0);
+		btTransform baseTr = mb->getBaseWorldTransform();
+		jointPositionsQ.push_back(baseTr.getOrigin()[0]);
+		jointPositionsQ.push_back(baseTr.getOrigin()[1]);
+		jointPositionsQ.push_back(baseTr.getOrigin()[2]);
+		jointPositionsQ.push_back(baseTr.getRotation()[0]);
+		jointPositionsQ.push_back(baseTr.getRotation()[1]);
+		jointPositionsQ.push_back(baseTr.getRotation()[2]);
+		jointPositionsQ.push_back(baseTr.getRotation()[3]);
+		jointVelocitiesQdot.push_back(mb->getBaseVel()[0]);
+		jointVelocitiesQdot.push_back(mb->getBaseVel()[1]);
+		jointVelocitiesQdot.push_back(mb->getBaseVel()[2]);
+		jointVelocitiesQdot.push_back(mb->getBaseOmega()[0]);
+		jointVelocitiesQdot.push_back(mb->getBaseOmega()[1]);
+		jointVelocitiesQdot.push_back(mb->getBaseOmega()[2]);
+		jointVelocitiesQdot.push_back(0);
+
+		for (int i = 0; i < mb->getNumLinks(); i++)
+		{
+			switch (mb->getLink(i).m_jointType)
+			{
+				case btMultibodyLink::eSpherical:
+				{
+					const btScalar* jointPos = mb->getJointPosMultiDof(i);
+					jointPositionsQ.push_back(jointPos[0]);
+					jointPositionsQ.push_back(jointPos[1]);
+					jointPositionsQ.push_back(jointPos[2]);
+					jointPositionsQ.push_back(jointPos[3]);
+					const btScalar* jointVel = mb->getJointVelMultiDof(i);
+					jointVelocitiesQdot.push_back(jointVel[0]);
+					jointVelocitiesQdot.push_back(jointVel[1]);
+					jointVelocitiesQdot.push_back(jointVel[2]);
+					jointVelocitiesQdot.push_back(0);
+					break;
+				}
+				case btMultibodyLink::ePrismatic:
+				case btMultibodyLink::eRevolute:
+				{
+					const btScalar* jointPos = mb->getJointPosMultiDof(i);
+					jointPositionsQ.push_back(jointPos[0]);
+					const btScalar* jointVel = mb->getJointVelMultiDof(i);
+					jointVelocitiesQdot.push_back(jointVel[0]);
+					break;
+				}
+				case btMultibodyLink::eFixed:
+				{
+					//skip
+					break;
+				}
+				default:
+				{
+					b3Error("Unsupported joint type");
+					btAssert(0);
+				}
+			}
+		}
+	}
+
+	//computes and applies the stable PD torques of one multibody, touches only that body and its model
+	static void applyStablePDControl(StablePDControl& control, btScalar timeStep)
+	{
+		btMultiBody* mb = control.m_multiBody;
+		cRBDModel* rbdModel = control.m_rbdModel;
+
+		btAlignedObjectArray<double> jointPositionsQ;
+		btAlignedObjectArray<double> jointVelocitiesQdot;
+		getStablePDState(mb, jointPositionsQ, jointVelocitiesQdot);
+		int num_dof = jointPositionsQ.size();
+
+		Eigen::VectorXd pose, vel;
+		convertPose(mb, &jointPositionsQ[0], &jointVelocitiesQdot[0], pose, vel);
+
+		Eigen::Map<const Eigen::VectorXd> mKp(&control.m_kp[0], num_dof);
+		Eigen::Map<const Eigen::VectorXd> mKd(&control.m_kd[0], num_dof);
+		Eigen::Map<const Eigen::VectorXd> maxForce(&control.m_maxForce[0], num_dof);
+
+		Eigen::DiagonalMatrix<double, Eigen::Dynamic> Kp_mat = mKp.asDiagonal();
+		Eigen::DiagonalMatrix<double, Eigen::Dynamic> Kd_mat = mKd.asDiagonal();
+
+		if (control.m_hasMassMat)
+		{
+			rbdModel->UpdateKeepMassMat(pose, vel);
+		}
+		else
+		{
+			rbdModel->Update(pose, vel);
+			Eigen::MatrixXd M = rbdModel->GetMassMat();
+			M.diagonal() += timeStep * mKd;
+			control.m_massMatLDLT.compute(M);
+			control.m_hasMassMat = true;
+		}
+		const Eigen::VectorXd& C = rbdModel->GetBiasForce();
+
+		Eigen::VectorXd pose_inc;
+		const Eigen::MatrixXd& joint_mat = rbdModel->GetJointMat();
+		cKinTree::VelToPoseDiff(joint_mat, rbdModel->GetPose(), rbdModel->GetVel(), pose_inc);
+
+		Eigen::VectorXd tar_pose, tar_vel;
+		convertPose(mb, &control.m_desiredQ[0], &control.m_desiredQdot[0], tar_pose, tar_vel);
+
+		pose_inc = rbdModel->GetPose() + timeStep * pose_inc;
+		cKinTree::PostProcessPose(joint_mat, pose_inc);
+
+		Eigen::VectorXd pose_err;
+		cKinTree::CalcVel(joint_mat, pose_inc, tar_pose, 1, pose_err);
+		for (int i = 0; i < 7; i++)
+		{
+			pose_err[i] = 0;
+		}
+
+		Eigen::VectorXd vel_err = tar_vel - rbdModel->GetVel();
+		Eigen::VectorXd acc = Kp_mat * pose_err + Kd_mat * vel_err - C;
+		acc = control.m_massMatLDLT.solve(acc);
+
+		Eigen::VectorXd out_tau = Eigen::VectorXd::Zero(num_dof);
+		out_tau += Kp_mat * pose_err + Kd_mat * (vel_err - timeStep * acc);
+		//clamp the forces
+		out_tau = out_tau.cwiseMax(-maxForce);
+		out_tau = out_tau.cwiseMin(maxForce);
+		//apply the forces
+		int torqueIndex = 7;
+		for (int link = 0; link < mb->getNumLinks(); link++)
+		{
+			int dofCount = mb->getLink(link).m_dofCount;
+			if (dofCount == 3)
+			{
+				for (int dof = 0; dof < 3; dof++)
+				{
+					double torque = out_tau[torqueIndex + dof];
+					mb->addJointTorqueMultiDof(link, dof, torque);
+				}
+				torqueIndex += 4;
+			}
+			if (dofCount == 1)
+			{
+				double torque = out_tau[torqueIndex];
+				mb->addJointTorqueMultiDof(link, 0, torque);
+				torqueIndex++;
+			}
+		}
+	}
+
 #endif
 
 	btInverseDynamics::MultiBodyTree* findOrCreateTree(btMultiBody* multiBody)
@@ -2018,6 +2274,9 @@ PhysicsServerCommandProcessor::~PhysicsServerCommandProcessor()
 	}
 	if (m_data->m_threadPool)
 		delete m_data->m_threadPool;
+	waitForPendingSave();
+	delete m_data->m_saveThreadPool;
+	delete m_data->m_saveTask;
 
 	delete m_data;
 }
@@ -2026,6 +2285,7 @@ void preTickCallback(btDynamicsWorld* world, btScalar timeStep)
 {
 	PhysicsServerCommandProcessor* proc = (PhysicsServerCommandProcessor*)world->getWorldUserInfo();
 
+	proc->applyStablePDControls(timeStep);
 	proc->tickPlugins(timeStep, true);
 }
 
@@ -2035,6 +2295,7 @@ void logCallback(btDynamicsWorld* world, btScalar timeStep)
 	PhysicsServerCommandProcessor* proc = (PhysicsServerCommandProcessor*)world->getWorldUserInfo();
 	proc->processCollisionForces(timeStep);
 	proc->logObjectStates(timeStep);
+	proc->recordStateSubscription();
 
 	proc->tickPlugins(timeStep, false);
 }
@@ -2149,6 +2410,66 @@ void PhysicsServerCommandProcessor::reportNotifications()
 	m_data->m_pluginManager.reportNotifications();
 }
 
+#ifdef STATIC_LINK_SPD_PLUGIN
+struct StablePDControlLoop : public btIParallelForBody
+{
+	PhysicsServerCommandProcessorInternalData::StablePDControl** m_controls;
+	btScalar m_timeStep;
+
+	StablePDControlLoop(PhysicsServerCommandProcessorInternalData::StablePDControl** controls, btScalar timeStep)
+		: m_controls(controls),
+		  m_timeStep(timeStep)
+	{
+	}
+
+	virtual void forLoop(int iBegin, int iEnd) const
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			PhysicsServerCommandProcessorInternalData::applyStablePDControl(*m_controls[i], m_timeStep);
+		}
+	}
+};
+#endif  //STATIC_LINK_SPD_PLUGIN
+
+void PhysicsServerCommandProcessor::applyStablePDControls(btScalar timeStep)
+{
+#ifdef STATIC_LINK_SPD_PLUGIN
+	btAlignedObjectArray<PhysicsServerCommandProcessorInternalData::StablePDControl*>& activeControls = m_data->m_activeStablePDControls;
+	activeControls.resize(0);
+	btVector3 gravOrg = m_data->m_dynamicsWorld->getGravity();
+	tVector grav(gravOrg[0], gravOrg[1], gravOrg[2], 0);
+	for (int i = 0; i < m_data->m_stablePDControls.size(); i++)
+	{
+		PhysicsServerCommandProcessorInternalData::StablePDControl* control = *m_data->m_stablePDControls.getAtIndex(i);
+		if (control->m_numSubStepsLeft > 0)
+		{
+			control->m_numSubStepsLeft--;
+			control->m_rbdModel->SetGravity(grav);
+			activeControls.push_back(control);
+		}
+	}
+	if (activeControls.size() == 0)
+	{
+		return;
+	}
+
+	BT_PROFILE("applyStablePDControls");
+	//each control only touches its own multibody and model, so the bodies are evaluated in parallel
+	StablePDControlLoop loop(&activeControls[0], timeStep);
+#if BT_THREADSAFE
+	if (btGetTaskScheduler())
+	{
+		btParallelFor(0, activeControls.size(), 1, loop);
+	}
+	else
+#endif
+	{
+		loop.forLoop(0, activeControls.size());
+	}
+#endif  //STATIC_LINK_SPD_PLUGIN
+}
+
 void PhysicsServerCommandProcessor::tickPlugins(btScalar timeStep, bool isPreTick)
 {
 	b3PluginManagerTickMode tickMode = isPreTick ? B3_PRE_TICK_MODE : B3_POST_TICK_MODE;
@@ -2772,6 +3093,12 @@ void PhysicsServerCommandProcessor::deleteDynamicsWorld()
 	deleteCachedInverseDynamicsBodies();
 	deleteCachedInverseKinematicsBodies();
 	deleteStateLoggers();
+	m_data->m_subscribedBodies.clear();
+	m_data->m_subscriptionSentValues.clear();
+	m_data->m_subscriptionRecords.clear();
+	m_data->m_subscriptionBodies.clear();
+	m_data->m_subscriptionValues.clear();
+	m_data->m_numDroppedSubscriptionRecords = 0;
 
 	m_data->m_userConstraints.clear();
 	m_data->m_saveWorldBodyData.clear();
@@ -2968,6 +3295,12 @@ void PhysicsServerCommandProcessor::deleteDynamicsWorld()
 	m_data->m_collisionConfiguration = 0;
 	m_data->m_userConstraintUIDGenerator = 1;
 #ifdef STATIC_LINK_SPD_PLUGIN
+	for (int i = 0; i < m_data->m_stablePDControls.size(); i++)
+	{
+		delete *(m_data->m_stablePDControls.getAtIndex(i));
+	}
+	m_data->m_stablePDControls.clear();
+	m_data->m_activeStablePDControls.clear();
 	for (int i = 0; i < m_data->m_rbdModels.size(); i++)
 	{
 		delete *(m_data->m_rbdModels.getAtIndex(i));
@@ -5220,6 +5553,84 @@ bool PhysicsServerCommandProcessor::processRequestMeshDataCommand(const struct S
 	return hasStatus;
 }
 
+bool PhysicsServerCommandProcessor::processRequestStateHashCommand(const struct SharedMemoryCommand& clientCmd, struct SharedMemoryStatus& serverStatusOut, char* bufferServerToClient, int bufferSizeInBytes)
+{
+	bool hasStatus = true;
+	BT_PROFILE("CMD_REQUEST_STATE_HASH");
+	serverStatusOut.m_type = CMD_REQUEST_STATE_HASH_FAILED;
+	serverStatusOut.m_numDataStreamBytes = 0;
+	if (m_data->m_dynamicsWorld == 0)
+	{
+		return hasStatus;
+	}
+
+	btAlignedObjectArray<unsigned int> stateHashes;
+	unsigned int stateHash = m_data->m_dynamicsWorld->computeStateHash(stateHashes);
+
+	b3AlignedObjectArray<int> usedHandles;
+	m_data->m_bodyHandles.getUsedHandles(usedHandles);
+	int maxNumBodies = bufferSizeInBytes / sizeof(b3StateHashBody);
+	b3StateHashBody* bodiesOut = (b3StateHashBody*)bufferServerToClient;
+	int numBodies = 0;
+	int numBodiesCopied = 0;
+	for (int i = 0; i < usedHandles.size(); i++)
+	{
+		InternalBodyData* body = m_data->m_bodyHandles.getHandle(usedHandles[i]);
+		if (body == 0)
+			continue;
+		unsigned int hash = 2166136261u;
+		if (body->m_multiBody)
+		{
+			btMultiBody* mb = body->m_multiBody;
+			hash = btMultiBodyDynamicsWorld::hashMultiBodyState(hash, mb);
+			if (mb->getBaseCollider())
+			{
+				hash = btDiscreteDynamicsWorld::hashCollisionObjectState(hash, mb->getBaseCollider());
+			}
+			for (int l = 0; l < mb->getNumLinks(); l++)
+			{
+				if (mb->getLink(l).m_collider)
+				{
+					hash = btDiscreteDynamicsWorld::hashCollisionObjectState(hash, mb->getLink(l).m_collider);
+				}
+			}
+		}
+		else if (body->m_rigidBody)
+		{
+			hash = btDiscreteDynamicsWorld::hashCollisionObjectState(hash, body->m_rigidBody);
+		}
+#ifndef SKIP_SOFT_BODY_MULTI_BODY_DYNAMICS_WORLD
+		else if (body->m_softBody)
+		{
+			btSoftBody* psb = body->m_softBody;
+			for (int n = 0; n < psb->m_nodes.size(); n++)
+			{
+				hash = btDiscreteDynamicsWorld::hashVector3(hash, psb->m_nodes[n].m_x);
+				hash = btDiscreteDynamicsWorld::hashVector3(hash, psb->m_nodes[n].m_v);
+			}
+		}
+#endif  //SKIP_SOFT_BODY_MULTI_BODY_DYNAMICS_WORLD
+		else
+		{
+			continue;
+		}
+		if (numBodiesCopied < maxNumBodies)
+		{
+			bodiesOut[numBodiesCopied].m_bodyUniqueId = usedHandles[i];
+			bodiesOut[numBodiesCopied].m_hash = hash;
+			numBodiesCopied++;
+		}
+		numBodies++;
+	}
+
+	serverStatusOut.m_type = CMD_REQUEST_STATE_HASH_COMPLETED;
+	serverStatusOut.m_sendStateHashArgs.m_stateHash = stateHash;
+	serverStatusOut.m_sendStateHashArgs.m_numBodiesCopied = numBodiesCopied;
+	serverStatusOut.m_sendStateHashArgs.m_numBodies = numBodies;
+	serverStatusOut.m_numDataStreamBytes = numBodiesCopied * sizeof(b3StateHashBody);
+	return hasStatus;
+}
+
 bool PhysicsServerCommandProcessor::processCreateVisualShapeCommand(const struct SharedMemoryCommand& clientCmd, struct SharedMemoryStatus& serverStatusOut, char* bufferServerToClient, int bufferSizeInBytes)
 {
 	bool hasStatus = true;
@@ -5449,6 +5860,10 @@ bool PhysicsServerCommandProcessor::processCustomCommand(const struct SharedMemo
 		}
 
 		int pluginUniqueId = m_data->m_pluginManager.loadPlugin(clientCmd.m_customCommandArgs.m_pluginPath, postFix);
+		if (m_data->m_broadphaseCollisionFilterCallback)
+		{
+			m_data->m_broadphaseCollisionFilterCallback->syncCollisionInterface();
+		}
 		if (pluginUniqueId >= 0)
 		{
 			serverCmd.m_customCommandResultArgs.m_pluginUniqueId = pluginUniqueId;
@@ -5458,6 +5873,10 @@ bool PhysicsServerCommandProcessor::processCustomCommand(const struct SharedMemo
 	if (clientCmd.m_updateFlags & CMD_CUSTOM_COMMAND_UNLOAD_PLUGIN)
 	{
 		m_data->m_pluginManager.unloadPlugin(clientCmd.m_customCommandArgs.m_pluginUniqueId);
+		if (m_data->m_broadphaseCollisionFilterCallback)
+		{
+			m_data->m_broadphaseCollisionFilterCallback->syncCollisionInterface();
+		}
 		serverCmd.m_type = CMD_CUSTOM_COMMAND_COMPLETED;
 	}
 	if (clientCmd.m_updateFlags & CMD_CUSTOM_COMMAND_EXECUTE_PLUGIN_COMMAND)
@@ -6709,205 +7128,55 @@ bool PhysicsServerCommandProcessor::processSendDesiredStateCommand(const struct
 #ifdef STATIC_LINK_SPD_PLUGIN
 			case CONTROL_MODE_STABLE_PD:
 			{
-				int posVal = body->m_multiBody->getNumPosVars();
-				btAlignedObjectArray<double> zeroVel;
-				int dof = 7 + posVal;
-				zeroVel.resize(dof);
-				//clientCmd.m_sendDesiredStateCommandArgument.
-				//current positions and velocities
-				btAlignedObjectArray<double> jointPositionsQ;
-				btAlignedObjectArray<double> jointVelocitiesQdot;
-				btTransform baseTr = body->m_multiBody->getBaseWorldTransform();
-#if 1
-				jointPositionsQ.push_back(baseTr.getOrigin()[0]);
-				jointPositionsQ.push_back(baseTr.getOrigin()[1]);
-				jointPositionsQ.push_back(baseTr.getOrigin()[2]);
-				jointPositionsQ.push_back(baseTr.getRotation()[0]);
-				jointPositionsQ.push_back(baseTr.getRotation()[1]);
-				jointPositionsQ.push_back(baseTr.getRotation()[2]);
-				jointPositionsQ.push_back(baseTr.getRotation()[3]);
-				jointVelocitiesQdot.push_back(body->m_multiBody->getBaseVel()[0]);
-				jointVelocitiesQdot.push_back(body->m_multiBody->getBaseVel()[1]);
-				jointVelocitiesQdot.push_back(body->m_multiBody->getBaseVel()[2]);
-				jointVelocitiesQdot.push_back(body->m_multiBody->getBaseOmega()[0]);
-				jointVelocitiesQdot.push_back(body->m_multiBody->getBaseOmega()[1]);
-				jointVelocitiesQdot.push_back(body->m_multiBody->getBaseOmega()[2]);
-				jointVelocitiesQdot.push_back(0);
-#else
-				for (int i = 0; i < 7; i++)
-				{
-					jointPositionsQ.push_back(0);
-					jointVelocitiesQdot.push_back(0);
-				}
-				jointPositionsQ[6] = 1;
+				//store the target, the torques are computed and applied in the pre-tick of the
+				//next internal simulation steps (see applyStablePDControls)
+				PhysicsServerCommandProcessorInternalData::StablePDControl* control = 0;
+				{
+					BT_PROFILE("findOrCreateStablePDControl");
+					control = m_data->findOrCreateStablePDControl(mb);
+				}
+				int num_dof = 7 + mb->getNumPosVars();
+				control->m_desiredQ.resize(num_dof);
+				control->m_desiredQdot.resize(num_dof);
+				control->m_kp.resize(num_dof);
+				control->m_kd.resize(num_dof);
+				control->m_maxForce.resize(num_dof);
+				for (int i = 0; i < num_dof; i++)
+				{
+					control->m_desiredQ[i] = clientCmd.m_sendDesiredStateCommandArgument.m_desiredStateQ[i];
+					control->m_desiredQdot[i] = clientCmd.m_sendDesiredStateCommandArgument.m_desiredStateQdot[i];
+					control->m_kp[i] = clientCmd.m_sendDesiredStateCommandArgument.m_Kp[i];
+					control->m_kd[i] = clientCmd.m_sendDesiredStateCommandArgument.m_Kd[i];
+					control->m_maxForce[i] = clientCmd.m_sendDesiredStateCommandArgument.m_desiredStateForceTorque[i];
+				}
+				control->m_numSubStepsLeft = m_data->m_numSimulationSubSteps > 0 ? m_data->m_numSimulationSubSteps : 1;
+				control->m_hasMassMat = false;
+				break;
+			}
 #endif
-				for (int i = 0; i < body->m_multiBody->getNumLinks(); i++)
-				{
-					switch (body->m_multiBody->getLink(i).m_jointType)
-					{
-						case btMultibodyLink::eSpherical:
-						{
-							btScalar* jointPos = body->m_multiBody->getJointPosMultiDof(i);
-							jointPositionsQ.push_back(jointPos[0]);
-							jointPositionsQ.push_back(jointPos[1]);
-							jointPositionsQ.push_back(jointPos[2]);
-							jointPositionsQ.push_back(jointPos[3]);
-							btScalar* jointVel = body->m_multiBody->getJointVelMultiDof(i);
-							jointVelocitiesQdot.push_back(jointVel[0]);
-							jointVelocitiesQdot.push_back(jointVel[1]);
-							jointVelocitiesQdot.push_back(jointVel[2]);
-							jointVelocitiesQdot.push_back(0);
-							break;
-						}
-						case btMultibodyLink::ePrismatic:
-						case btMultibodyLink::eRevolute:
-						{
-							btScalar* jointPos = body->m_multiBody->getJointPosMultiDof(i);
-							jointPositionsQ.push_back(jointPos[0]);
-							btScalar* jointVel = body->m_multiBody->getJointVelMultiDof(i);
-							jointVelocitiesQdot.push_back(jointVel[0]);
-							break;
-						}
-						case btMultibodyLink::eFixed:
-						{
-							//skip
-							break;
-						}
-						default:
-						{
-							b3Error("Unsupported joint type");
-							btAssert(0);
-						}
-					}
-				}
+			default:
+			{
+				b3Warning("m_controlMode not implemented yet");
+				break;
+			}
+		}
+	}
+	else
+	{
+		//support for non-btMultiBody, such as btRigidBody
 
-				cRBDModel* rbdModel = 0;
+		if (body && body->m_rigidBody)
+		{
+			btRigidBody* rb = body->m_rigidBody;
+			btAssert(rb);
 
+			//switch (clientCmd.m_sendDesiredStateCommandArgument.m_controlMode)
+			{
+				//case CONTROL_MODE_TORQUE:
 				{
-					BT_PROFILE("findOrCreateRBDModel");
-					rbdModel = m_data->findOrCreateRBDModel(body->m_multiBody, &jointPositionsQ[0], &jointVelocitiesQdot[0]);
-				}
-				if (rbdModel)
-				{
-					int num_dof = jointPositionsQ.size();
-					const Eigen::VectorXd& pose = rbdModel->GetPose();
-					const Eigen::VectorXd& vel = rbdModel->GetVel();
-
-					Eigen::Map<Eigen::VectorXd> mKp((double*)clientCmd.m_sendDesiredStateCommandArgument.m_Kp, num_dof);
-					Eigen::Map<Eigen::VectorXd> mKd((double*)clientCmd.m_sendDesiredStateCommandArgument.m_Kd, num_dof);
-					Eigen::Map<Eigen::VectorXd> maxForce((double*)clientCmd.m_sendDesiredStateCommandArgument.m_desiredStateForceTorque, num_dof);
-
-					Eigen::DiagonalMatrix<double, Eigen::Dynamic> Kp_mat = mKp.asDiagonal();
-					Eigen::DiagonalMatrix<double, Eigen::Dynamic> Kd_mat = mKd.asDiagonal();
-
-					Eigen::MatrixXd M = rbdModel->GetMassMat();
-					//rbdModel->UpdateBiasForce();
-					const Eigen::VectorXd& C = rbdModel->GetBiasForce();
-					M.diagonal() += m_data->m_physicsDeltaTime * mKd;
-
-					Eigen::VectorXd pose_inc;
-
-					const Eigen::MatrixXd& joint_mat = rbdModel->GetJointMat();
+					if (m_data->m_verboseOutput)
 					{
-						BT_PROFILE("cKinTree::VelToPoseDiff");
-						cKinTree::VelToPoseDiff(joint_mat, rbdModel->GetPose(), rbdModel->GetVel(), pose_inc);
-					}
-
-					//tar_pose needs to be reshuffled?
-					Eigen::VectorXd tar_pose, tar_vel;
-
-					{
-						BT_PROFILE("convertPose");
-						PhysicsServerCommandProcessorInternalData::convertPose(body->m_multiBody,
-																			   (double*)clientCmd.m_sendDesiredStateCommandArgument.m_desiredStateQ,
-																			   (double*)clientCmd.m_sendDesiredStateCommandArgument.m_desiredStateQdot,
-																			   tar_pose, tar_vel);
-					}
-
-					pose_inc = pose + m_data->m_physicsDeltaTime * pose_inc;
-
-					{
-						BT_PROFILE("cKinTree::PostProcessPose");
-						cKinTree::PostProcessPose(joint_mat, pose_inc);
-					}
-
-					Eigen::VectorXd pose_err;
-					{
-						BT_PROFILE("cKinTree::CalcVel");
-						cKinTree::CalcVel(joint_mat, pose_inc, tar_pose, 1, pose_err);
-					}
-					for (int i = 0; i < 7; i++)
-					{
-						pose_err[i] = 0;
-					}
-
-					Eigen::VectorXd vel_err = tar_vel - vel;
-					Eigen::VectorXd acc;
-
-					{
-						BT_PROFILE("acc");
-						acc = Kp_mat * pose_err + Kd_mat * vel_err - C;
-					}
-
-					{
-						BT_PROFILE("M.ldlt().solve");
-						acc = M.ldlt().solve(acc);
-					}
-					Eigen::VectorXd out_tau = Eigen::VectorXd::Zero(num_dof);
-					out_tau += Kp_mat * pose_err + Kd_mat * (vel_err - m_data->m_physicsDeltaTime * acc);
-					//clamp the forces
-					out_tau = out_tau.cwiseMax(-maxForce);
-					out_tau = out_tau.cwiseMin(maxForce);
-					//apply the forces
-					int torqueIndex = 7;
-					for (int link = 0; link < mb->getNumLinks(); link++)
-					{
-						int dofCount = mb->getLink(link).m_dofCount;
-						int dofOffset = mb->getLink(link).m_dofOffset;
-						if (dofCount == 3)
-						{
-							for (int dof = 0; dof < 3; dof++)
-							{
-								double torque = out_tau[torqueIndex + dof];
-								mb->addJointTorqueMultiDof(link, dof, torque);
-							}
-							torqueIndex += 4;
-						}
-						if (dofCount == 1)
-						{
-							double torque = out_tau[torqueIndex];
-							mb->addJointTorqueMultiDof(link, 0, torque);
-							torqueIndex++;
-						}
-					}
-				}
-
-				break;
-			}
-#endif
-			default:
-			{
-				b3Warning("m_controlMode not implemented yet");
-				break;
-			}
-		}
-	}
-	else
-	{
-		//support for non-btMultiBody, such as btRigidBody
-
-		if (body && body->m_rigidBody)
-		{
-			btRigidBody* rb = body->m_rigidBody;
-			btAssert(rb);
-
-			//switch (clientCmd.m_sendDesiredStateCommandArgument.m_controlMode)
-			{
-				//case CONTROL_MODE_TORQUE:
-				{
-					if (m_data->m_verboseOutput)
-					{
-						b3Printf("Using CONTROL_MODE_TORQUE");
+						b3Printf("Using CONTROL_MODE_TORQUE");
 					}
 					//  mb->clearForcesAndTorques();
 					///see addJointInfoFromConstraint
@@ -7426,6 +7695,511 @@ bool PhysicsServerCommandProcessor::processRequestActualStateCommand(const struc
 	return hasStatus;
 }
 
+//appends the layout of the fields of one body to numValues, the body must have a multibody or rigid body
+static void layoutBatchedActualState(const InternalBodyData* body, int bodyUniqueId, int fields, b3BatchedActualStateBody& bodyOut, int& numValues)
+{
+	bodyOut.m_bodyUniqueId = bodyUniqueId;
+	bodyOut.m_numPositions = 7;
+	bodyOut.m_numVelocities = 6;
+	bodyOut.m_numLinks = 0;
+	if (body->m_multiBody)
+	{
+		bodyOut.m_numPositions += body->m_multiBody->getNumPosVars();
+		bodyOut.m_numVelocities += body->m_multiBody->getNumDofs();
+		bodyOut.m_numLinks = body->m_multiBody->getNumLinks();
+	}
+	bodyOut.m_positionOffset = -1;
+	bodyOut.m_velocityOffset = -1;
+	bodyOut.m_linkPoseOffset = -1;
+	bodyOut.m_linkVelocityOffset = -1;
+	bodyOut.m_jointReactionForceOffset = -1;
+	if (fields & BATCHED_STATE_JOINT_POSITIONS)
+	{
+		bodyOut.m_positionOffset = numValues;
+		numValues += bodyOut.m_numPositions;
+	}
+	if (fields & BATCHED_STATE_JOINT_VELOCITIES)
+	{
+		bodyOut.m_velocityOffset = numValues;
+		numValues += bodyOut.m_numVelocities;
+	}
+	if (fields & BATCHED_STATE_LINK_POSES)
+	{
+		bodyOut.m_linkPoseOffset = numValues;
+		numValues += 7 * bodyOut.m_numLinks;
+	}
+	if (fields & BATCHED_STATE_LINK_VELOCITIES)
+	{
+		bodyOut.m_linkVelocityOffset = numValues;
+		numValues += 6 * bodyOut.m_numLinks;
+	}
+	if (fields & BATCHED_STATE_JOINT_REACTION_FORCES)
+	{
+		bodyOut.m_jointReactionForceOffset = numValues;
+		numValues += 6 * bodyOut.m_numLinks;
+	}
+}
+
+//writes the fields of one body at the offsets computed by layoutBatchedActualState
+static void writeBatchedActualState(InternalBodyData* body, const b3BatchedActualStateBody& bodyOut, bool computeForwardKinematics, double* values)
+{
+	btMultiBody* mb = body->m_multiBody;
+	if (mb == 0)
+	{
+		btRigidBody* rb = body->m_rigidBody;
+		if (bodyOut.m_positionOffset >= 0)
+		{
+			double* q = &values[bodyOut.m_positionOffset];
+			const btTransform& tr = rb->getWorldTransform();
+			btQuaternion orn = tr.getRotation();
+			q[0] = tr.getOrigin()[0];
+			q[1] = tr.getOrigin()[1];
+			q[2] = tr.getOrigin()[2];
+			q[3] = orn[0];
+			q[4] = orn[1];
+			q[5] = orn[2];
+			q[6] = orn[3];
+		}
+		if (bodyOut.m_velocityOffset >= 0)
+		{
+			double* qdot = &values[bodyOut.m_velocityOffset];
+			for (int d = 0; d < 3; d++)
+			{
+				qdot[d] = rb->getLinearVelocity()[d];
+				qdot[3 + d] = rb->getAngularVelocity()[d];
+			}
+		}
+		return;
+	}
+
+	if (bodyOut.m_positionOffset >= 0)
+	{
+		double* q = &values[bodyOut.m_positionOffset];
+		btQuaternion orn = mb->getWorldToBaseRot().inverse();
+		q[0] = mb->getBasePos()[0];
+		q[1] = mb->getBasePos()[1];
+		q[2] = mb->getBasePos()[2];
+		q[3] = orn[0];
+		q[4] = orn[1];
+		q[5] = orn[2];
+		q[6] = orn[3];
+		int numPositions = 7;
+		for (int l = 0; l < mb->getNumLinks(); l++)
+		{
+			for (int d = 0; d < mb->getLink(l).m_posVarCount; d++)
+			{
+				q[numPositions++] = mb->getJointPosMultiDof(l)[d];
+			}
+		}
+	}
+	if (bodyOut.m_velocityOffset >= 0)
+	{
+		double* qdot = &values[bodyOut.m_velocityOffset];
+		for (int d = 0; d < 3; d++)
+		{
+			qdot[d] = mb->getBaseVel()[d];
+			qdot[3 + d] = mb->getBaseOmega()[d];
+		}
+		int numVelocities = 6;
+		for (int l = 0; l < mb->getNumLinks(); l++)
+		{
+			for (int d = 0; d < mb->getLink(l).m_dofCount; d++)
+			{
+				qdot[numVelocities++] = mb->getJointVelMultiDof(l)[d];
+			}
+		}
+	}
+	if (bodyOut.m_numLinks == 0)
+	{
+		return;
+	}
+	if (bodyOut.m_linkPoseOffset >= 0)
+	{
+		if (computeForwardKinematics)
+		{
+			btAlignedObjectArray<btQuaternion> world_to_local;
+			btAlignedObjectArray<btVector3> local_origin;
+			world_to_local.resize(mb->getNumLinks() + 1);
+			local_origin.resize(mb->getNumLinks() + 1);
+			mb->forwardKinematics(world_to_local, local_origin);
+		}
+		double* linkPoses = &values[bodyOut.m_linkPoseOffset];
+		for (int l = 0; l < mb->getNumLinks(); l++)
+		{
+			const btTransform& tr = mb->getLink(l).m_cachedWorldTransform;
+			btQuaternion orn = tr.getRotation();
+			linkPoses[l * 7 + 0] = tr.getOrigin()[0];
+			linkPoses[l * 7 + 1] = tr.getOrigin()[1];
+			linkPoses[l * 7 + 2] = tr.getOrigin()[2];
+			linkPoses[l * 7 + 3] = orn[0];
+			linkPoses[l * 7 + 4] = orn[1];
+			linkPoses[l * 7 + 5] = orn[2];
+			linkPoses[l * 7 + 6] = orn[3];
+		}
+	}
+	if (bodyOut.m_linkVelocityOffset >= 0)
+	{
+		btAlignedObjectArray<btVector3> omega;
+		btAlignedObjectArray<btVector3> linVel;
+		omega.resize(mb->getNumLinks() + 1);
+		linVel.resize(mb->getNumLinks() + 1);
+		mb->compTreeLinkVelocities(&omega[0], &linVel[0]);
+		double* linkVelocities = &values[bodyOut.m_linkVelocityOffset];
+		for (int l = 0; l < mb->getNumLinks(); l++)
+		{
+			const btMatrix3x3& linkRotMat = mb->getLink(l).m_cachedWorldTransform.getBasis();
+			btVector3 worldLinVel = linkRotMat * linVel[l + 1];
+			btVector3 worldAngVel = linkRotMat * omega[l + 1];
+			for (int d = 0; d < 3; d++)
+			{
+				linkVelocities[l * 6 + d] = worldLinVel[d];
+				linkVelocities[l * 6 + 3 + d] = worldAngVel[d];
+			}
+		}
+	}
+	if (bodyOut.m_jointReactionForceOffset >= 0)
+	{
+		double* reactionForces = &values[bodyOut.m_jointReactionForceOffset];
+		for (int l = 0; l < mb->getNumLinks(); l++)
+		{
+			const btMultiBodyJointFeedback* feedback = mb->getLink(l).m_jointFeedback;
+			for (int d = 0; d < 3; d++)
+			{
+				reactionForces[l * 6 + d] = feedback ? feedback->m_reactionForces.getLinear()[d] : 0;
+				reactionForces[l * 6 + 3 + d] = feedback ? feedback->m_reactionForces.getAngular()[d] : 0;
+			}
+		}
+	}
+}
+
+bool PhysicsServerCommandProcessor::processRequestBatchedActualStateCommand(const struct SharedMemoryCommand& clientCmd, struct SharedMemoryStatus& serverStatusOut, char* bufferServerToClient, int bufferSizeInBytes)
+{
+	bool hasStatus = true;
+	BT_PROFILE("CMD_REQUEST_BATCHED_ACTUAL_STATE");
+	serverStatusOut.m_type = CMD_BATCHED_ACTUAL_STATE_FAILED;
+	serverStatusOut.m_numDataStreamBytes = 0;
+
+	int numBodies = clientCmd.m_requestBatchedActualStateArgs.m_numBodies;
+	int fields = clientCmd.m_requestBatchedActualStateArgs.m_fields;
+	if (numBodies < 0 || numBodies * int(sizeof(int)) > bufferSizeInBytes)
+	{
+		return hasStatus;
+	}
+
+	//the body unique ids are uploaded into the same stream that receives the state, so copy them first
+	btAlignedObjectArray<int> bodyUniqueIds;
+	bodyUniqueIds.resize(numBodies);
+	if (numBodies)
+	{
+		memcpy(&bodyUniqueIds[0], bufferServerToClient, numBodies * sizeof(int));
+	}
+
+	//first pass: validate the bodies and lay out the packed values
+	btAlignedObjectArray<b3BatchedActualStateBody> bodies;
+	bodies.resize(numBodies);
+	int numValues = 0;
+	for (int i = 0; i < numBodies; i++)
+	{
+		InternalBodyData* body = m_data->m_bodyHandles.getHandle(bodyUniqueIds[i]);
+		if (body == 0 || (body->m_multiBody == 0 && body->m_rigidBody == 0))
+		{
+			b3Warning("Request batched actual state: body %d has no multibody or rigid body", bodyUniqueIds[i]);
+			return hasStatus;
+		}
+		layoutBatchedActualState(body, bodyUniqueIds[i], fields, bodies[i], numValues);
+	}
+
+	//the body descriptions come first, followed by the values, aligned to a double
+	int valueStreamOffset = numBodies * sizeof(b3BatchedActualStateBody);
+	valueStreamOffset = (valueStreamOffset + sizeof(double) - 1) & ~int(sizeof(double) - 1);
+	int numStreamBytes = valueStreamOffset + numValues * sizeof(double);
+	if (numStreamBytes > bufferSizeInBytes)
+	{
+		b3Warning("Request batched actual state: %d bytes of state exceed the stream size of %d bytes", numStreamBytes, bufferSizeInBytes);
+		return hasStatus;
+	}
+	if (numBodies)
+	{
+		memcpy(bufferServerToClient, &bodies[0], numBodies * sizeof(b3BatchedActualStateBody));
+	}
+	double* values = (double*)(bufferServerToClient + valueStreamOffset);
+	bool computeForwardKinematics = ((clientCmd.m_updateFlags & ACTUAL_STATE_COMPUTE_FORWARD_KINEMATICS) != 0);
+	for (int i = 0; i < numBodies; i++)
+	{
+		writeBatchedActualState(m_data->m_bodyHandles.getHandle(bodyUniqueIds[i]), bodies[i], computeForwardKinematics, values);
+	}
+
+	serverStatusOut.m_type = CMD_BATCHED_ACTUAL_STATE_COMPLETED;
+	serverStatusOut.m_sendBatchedActualStateArgs.m_numBodies = numBodies;
+	serverStatusOut.m_sendBatchedActualStateArgs.m_numValues = numValues;
+	serverStatusOut.m_sendBatchedActualStateArgs.m_valueStreamOffset = valueStreamOffset;
+	serverStatusOut.m_numDataStreamBytes = numStreamBytes;
+	return hasStatus;
+}
+
+static int computeStateSubscriptionStreamSize(int numRecords, int numBodies, int numValues, int& valueStreamOffset)
+{
+	valueStreamOffset = sizeof(StateSubscriptionStreamHeader) + numRecords * sizeof(b3StateSubscriptionRecord) + numBodies * sizeof(b3BatchedActualStateBody);
+	valueStreamOffset = (valueStreamOffset + sizeof(double) - 1) & ~int(sizeof(double) - 1);
+	return valueStreamOffset + numValues * sizeof(double);
+}
+
+//the values of a body are laid out in field order, so its first value is the first offset in use
+static int getBatchedActualStateFirstValue(const b3BatchedActualStateBody& body)
+{
+	const int offsets[] = {body.m_positionOffset, body.m_velocityOffset, body.m_linkPoseOffset, body.m_linkVelocityOffset, body.m_jointReactionForceOffset};
+	for (int o = 0; o < 5; o++)
+	{
+		if (offsets[o] >= 0)
+		{
+			return offsets[o];
+		}
+	}
+	return -1;
+}
+
+void PhysicsServerCommandProcessor::recordStateSubscription()
+{
+	int numBodies = m_data->m_subscribedBodies.size();
+	if (numBodies == 0)
+	{
+		return;
+	}
+	int step = m_data->m_subscriptionStepCount++;
+	if (step % m_data->m_subscriptionDecimation)
+	{
+		return;
+	}
+	BT_PROFILE("recordStateSubscription");
+
+	btAlignedObjectArray<b3BatchedActualStateBody>& bodies = m_data->m_subscriptionBodies;
+	btAlignedObjectArray<double>& values = m_data->m_subscriptionValues;
+	b3StateSubscriptionRecord record;
+	record.m_simulationStep = step;
+	record.m_numBodies = 0;
+	record.m_firstBody = bodies.size();
+	for (int i = 0; i < numBodies; i++)
+	{
+		int bodyUniqueId = m_data->m_subscribedBodies[i];
+		InternalBodyData* body = m_data->m_bodyHandles.getHandle(bodyUniqueId);
+		if (body == 0 || (body->m_multiBody == 0 && body->m_rigidBody == 0))
+		{
+			//the body was removed after subscribing
+			continue;
+		}
+		b3BatchedActualStateBody bodyOut;
+		int bodyFirstValue = values.size();
+		int numValues = bodyFirstValue;
+		layoutBatchedActualState(body, bodyUniqueId, m_data->m_subscriptionFields, bodyOut, numValues);
+		if (numValues > bodyFirstValue)
+		{
+			values.resize(numValues);
+			writeBatchedActualState(body, bodyOut, false, &values[0]);
+		}
+
+		//only send the bodies that moved more than the tolerance since they were last sent
+		btAlignedObjectArray<double>& sentValues = m_data->m_subscriptionSentValues[i];
+		bool changed = sentValues.size() != numValues - bodyFirstValue;
+		for (int v = 0; !changed && v < sentValues.size(); v++)
+		{
+			changed = btFabs(values[bodyFirstValue + v] - sentValues[v]) > m_data->m_subscriptionTolerance;
+		}
+		if (!changed)
+		{
+			values.resize(bodyFirstValue);
+			continue;
+		}
+		sentValues.resize(numValues - bodyFirstValue);
+		for (int v = 0; v < sentValues.size(); v++)
+		{
+			sentValues[v] = values[bodyFirstValue + v];
+		}
+		bodies.push_back(bodyOut);
+		record.m_numBodies++;
+	}
+	if (record.m_numBodies == 0)
+	{
+		return;
+	}
+
+	btAlignedObjectArray<b3StateSubscriptionRecord>& records = m_data->m_subscriptionRecords;
+	records.push_back(record);
+
+	int valueStreamOffset;
+	if (computeStateSubscriptionStreamSize(records.size(), bodies.size(), values.size(), valueStreamOffset) <= SHARED_MEMORY_MAX_STREAM_CHUNK_SIZE)
+	{
+		return;
+	}
+
+	//nobody picked up the records in time: drop the oldest ones, so the latest state still gets through.
+	//dropping down to half the stream keeps the remaining records from being moved on every step
+	int numDroppedRecords = 0;
+	int numDroppedBodies = 0;
+	int numDroppedValues = 0;
+	while (numDroppedRecords < records.size() - 1 &&
+		   computeStateSubscriptionStreamSize(records.size() - numDroppedRecords, bodies.size() - numDroppedBodies, values.size() - numDroppedValues, valueStreamOffset) > SHARED_MEMORY_MAX_STREAM_CHUNK_SIZE / 2)
+	{
+		numDroppedRecords++;
+		numDroppedBodies = records[numDroppedRecords].m_firstBody;
+		numDroppedValues = getBatchedActualStateFirstValue(bodies[numDroppedBodies]);
+	}
+	if (computeStateSubscriptionStreamSize(records.size() - numDroppedRecords, bodies.size() - numDroppedBodies, values.size() - numDroppedValues, valueStreamOffset) > SHARED_MEMORY_MAX_STREAM_CHUNK_SIZE)
+	{
+		//the latest record does not fit on its own either
+		numDroppedRecords = records.size();
+		numDroppedBodies = bodies.size();
+		numDroppedValues = values.size();
+	}
+	dropStateSubscriptionRecords(numDroppedRecords, numDroppedBodies, numDroppedValues);
+}
+
+void PhysicsServerCommandProcessor::dropStateSubscriptionRecords(int numRecords, int numBodies, int numValues)
+{
+	btAlignedObjectArray<b3StateSubscriptionRecord>& records = m_data->m_subscriptionRecords;
+	btAlignedObjectArray<b3BatchedActualStateBody>& bodies = m_data->m_subscriptionBodies;
+	btAlignedObjectArray<double>& values = m_data->m_subscriptionValues;
+
+	//the client never sees the state of these bodies, so send them again with the next record.
+	//the bodies of a record are in subscription order, so one pass over the subscribed bodies finds them
+	for (int r = 0; r < numRecords; r++)
+	{
+		int index = 0;
+		for (int b = records[r].m_firstBody; b < records[r].m_firstBody + records[r].m_numBodies; b++)
+		{
+			while (m_data->m_subscribedBodies[index] != bodies[b].m_bodyUniqueId)
+			{
+				index++;
+			}
+			m_data->m_subscriptionSentValues[index++].clear();
+		}
+	}
+
+	//move the remaining records to the front and re-base their body and value offsets
+	for (int r = numRecords; r < records.size(); r++)
+	{
+		records[r - numRecords] = records[r];
+		records[r - numRecords].m_firstBody -= numBodies;
+	}
+	records.resize(records.size() - numRecords);
+	for (int b = numBodies; b < bodies.size(); b++)
+	{
+		b3BatchedActualStateBody& body = bodies[b - numBodies];
+		body = bodies[b];
+		int* offsets[] = {&body.m_positionOffset, &body.m_velocityOffset, &body.m_linkPoseOffset, &body.m_linkVelocityOffset, &body.m_jointReactionForceOffset};
+		for (int o = 0; o < 5; o++)
+		{
+			if (*offsets[o] >= 0)
+			{
+				*offsets[o] -= numValues;
+			}
+		}
+	}
+	bodies.resize(bodies.size() - numBodies);
+	for (int v = numValues; v < values.size(); v++)
+	{
+		values[v - numValues] = values[v];
+	}
+	values.resize(values.size() - numValues);
+	m_data->m_numDroppedSubscriptionRecords += numRecords;
+}
+
+int PhysicsServerCommandProcessor::flushStateSubscription(char* bufferServerToClient, int bufferSizeInBytes)
+{
+	int numRecords = m_data->m_subscriptionRecords.size();
+	if (numRecords == 0 && m_data->m_numDroppedSubscriptionRecords == 0)
+	{
+		return 0;
+	}
+	int numBodies = m_data->m_subscriptionBodies.size();
+	int numValues = m_data->m_subscriptionValues.size();
+	int valueStreamOffset;
+	int numStreamBytes = computeStateSubscriptionStreamSize(numRecords, numBodies, numValues, valueStreamOffset);
+	if (numStreamBytes > bufferSizeInBytes)
+	{
+		return 0;
+	}
+
+	StateSubscriptionStreamHeader header;
+	header.m_numRecords = numRecords;
+	header.m_numBodies = numBodies;
+	header.m_numValues = numValues;
+	header.m_numDroppedRecords = m_data->m_numDroppedSubscriptionRecords;
+	header.m_valueStreamOffset = valueStreamOffset;
+	char* stream = bufferServerToClient;
+	memcpy(stream, &header, sizeof(header));
+	stream += sizeof(header);
+	if (numRecords)
+	{
+		memcpy(stream, &m_data->m_subscriptionRecords[0], numRecords * sizeof(b3StateSubscriptionRecord));
+		stream += numRecords * sizeof(b3StateSubscriptionRecord);
+	}
+	if (numBodies)
+	{
+		memcpy(stream, &m_data->m_subscriptionBodies[0], numBodies * sizeof(b3BatchedActualStateBody));
+	}
+	if (numValues)
+	{
+		memcpy(bufferServerToClient + valueStreamOffset, &m_data->m_subscriptionValues[0], numValues * sizeof(double));
+	}
+
+	m_data->m_subscriptionRecords.resize(0);
+	m_data->m_subscriptionBodies.resize(0);
+	m_data->m_subscriptionValues.resize(0);
+	m_data->m_numDroppedSubscriptionRecords = 0;
+	return numStreamBytes;
+}
+
+bool PhysicsServerCommandProcessor::processStateSubscriptionCommand(const struct SharedMemoryCommand& clientCmd, struct SharedMemoryStatus& serverStatusOut, char* bufferServerToClient, int bufferSizeInBytes)
+{
+	bool hasStatus = true;
+	BT_PROFILE("CMD_STATE_SUBSCRIPTION");
+	serverStatusOut.m_type = CMD_STATE_SUBSCRIPTION_FAILED;
+	serverStatusOut.m_numDataStreamBytes = 0;
+	const StateSubscriptionArgs& args = clientCmd.m_stateSubscriptionArgs;
+
+	if (clientCmd.m_updateFlags & STATE_SUBSCRIPTION_SET_DECIMATION)
+	{
+		if (args.m_decimation < 1)
+		{
+			return hasStatus;
+		}
+		m_data->m_subscriptionDecimation = args.m_decimation;
+	}
+	if (clientCmd.m_updateFlags & STATE_SUBSCRIPTION_SET_TOLERANCE)
+	{
+		if (args.m_tolerance < 0)
+		{
+			return hasStatus;
+		}
+		m_data->m_subscriptionTolerance = args.m_tolerance;
+	}
+	if (clientCmd.m_updateFlags & STATE_SUBSCRIPTION_SET_BODIES)
+	{
+		int numBodies = args.m_numBodies;
+		if (numBodies < 0 || numBodies * int(sizeof(int)) > bufferSizeInBytes || (numBodies && (args.m_fields & BATCHED_STATE_ALL_FIELDS) == 0))
+		{
+			return hasStatus;
+		}
+		m_data->m_subscribedBodies.resize(numBodies);
+		if (numBodies)
+		{
+			memcpy(&m_data->m_subscribedBodies[0], bufferServerToClient, numBodies * sizeof(int));
+		}
+		m_data->m_subscriptionFields = args.m_fields;
+		m_data->m_subscriptionStepCount = 0;
+		m_data->m_subscriptionSentValues.clear();
+		m_data->m_subscriptionSentValues.resize(numBodies);
+		m_data->m_subscriptionRecords.resize(0);
+		m_data->m_subscriptionBodies.resize(0);
+		m_data->m_subscriptionValues.resize(0);
+		m_data->m_numDroppedSubscriptionRecords = 0;
+	}
+
+	serverStatusOut.m_type = CMD_STATE_SUBSCRIPTION_COMPLETED;
+	serverStatusOut.m_numDataStreamBytes = flushStateSubscription(bufferServerToClient, bufferSizeInBytes);
+	return hasStatus;
+}
+
 bool PhysicsServerCommandProcessor::processRequestContactpointInformationCommand(const struct SharedMemoryCommand& clientCmd, struct SharedMemoryStatus& serverStatusOut, char* bufferServerToClient, int bufferSizeInBytes)
 {
 	bool hasStatus = true;
@@ -8734,6 +9508,8 @@ bool PhysicsServerCommandProcessor::processForwardDynamicsCommand(const struct S
 		serverCmd.m_forwardDynamicsAnalyticsArgs.m_islandData[i].m_numContactManifolds = islandAnalyticsData[i].m_numContactManifolds;
 	}
 	serverCmd.m_type = CMD_STEP_FORWARD_SIMULATION_COMPLETED;
+	//the state subscription records of this step go along with the status, without another round trip
+	serverCmd.m_numDataStreamBytes = flushStateSubscription(bufferServerToClient, bufferSizeInBytes);
 
 	m_data->m_remoteSyncTransformTime += deltaTimeScaled;
 	if (m_data->m_remoteSyncTransformTime >= m_data->m_remoteSyncTransformInterval)
@@ -10659,6 +11435,9 @@ bool PhysicsServerCommandProcessor::processRemoveBodyCommand(const struct Shared
 				}
 				int numCollisionObjects = m_data->m_dynamicsWorld->getNumCollisionObjects();
 				m_data->m_dynamicsWorld->removeMultiBody(bodyHandle->m_multiBody);
+#ifdef STATIC_LINK_SPD_PLUGIN
+				m_data->removeStablePDControl(bodyHandle->m_multiBody);
+#endif  //STATIC_LINK_SPD_PLUGIN
 				numCollisionObjects = m_data->m_dynamicsWorld->getNumCollisionObjects();
 
 				delete bodyHandle->m_multiBody;
@@ -12671,6 +13450,9 @@ bool PhysicsServerCommandProcessor::processLoadBulletCommand(const struct Shared
 {
 	BT_PROFILE("CMD_LOAD_BULLET");
 
+	//the file may still be written by a background CMD_SAVE_BULLET
+	waitForPendingSave();
+
 	bool hasStatus = true;
 	SharedMemoryStatus& serverCmd = serverStatusOut;
 	serverCmd.m_type = CMD_BULLET_LOADING_FAILED;
@@ -12797,6 +13579,80 @@ bool PhysicsServerCommandProcessor::processLoadMJCFCommand(const struct SharedMe
 	return hasStatus;
 }
 
+struct SaveBulletTask
+{
+	btSerializedSnapshot* m_snapshot;
+	char m_fileName[MAX_URDF_FILENAME_LENGTH];
+	btSpinMutex m_statusMutex;
+	int m_status;  //CMD_BULLET_SAVING_PENDING until the worker is done
+
+	SaveBulletTask()
+		: m_snapshot(0),
+		  m_status(CMD_BULLET_SAVING_PENDING)
+	{
+		m_fileName[0] = 0;
+	}
+
+	~SaveBulletTask()
+	{
+		delete m_snapshot;
+	}
+
+	int getStatus()
+	{
+		m_statusMutex.lock();
+		int status = m_status;
+		m_statusMutex.unlock();
+		return status;
+	}
+};
+
+//writes the snapshot under a temporary name and renames it when complete, so the file never appears truncated
+static void saveBulletFunc(void* userPtr)
+{
+	BT_PROFILE("saveBulletFunc");
+	SaveBulletTask* task = (SaveBulletTask*)userPtr;
+	char tmpFileName[MAX_URDF_FILENAME_LENGTH + 8];
+	sprintf(tmpFileName, "%s.tmp", task->m_fileName);
+	bool written = false;
+	FILE* f = fopen(tmpFileName, "wb");
+	if (f)
+	{
+		btFileSerializerSink sink(f);
+		written = task->m_snapshot->writeToSink(sink);
+		written = (fclose(f) == 0) && written;
+		if (written && rename(tmpFileName, task->m_fileName) != 0)
+		{
+			//rename doesn't replace an existing file on all platforms
+			remove(task->m_fileName);
+			written = rename(tmpFileName, task->m_fileName) == 0;
+		}
+		if (!written)
+		{
+			remove(tmpFileName);
+		}
+	}
+	if (!written)
+	{
+		b3Warning("Cannot write %s\n", task->m_fileName);
+	}
+	delete task->m_snapshot;
+	task->m_snapshot = 0;
+	task->m_statusMutex.lock();
+	task->m_status = written ? CMD_BULLET_SAVING_COMPLETED : CMD_BULLET_SAVING_FAILED;
+	task->m_statusMutex.unlock();
+}
+
+void PhysicsServerCommandProcessor::waitForPendingSave()
+{
+	if (m_data->m_saveTaskRunning)
+	{
+		BT_PROFILE("waitForPendingSave");
+		m_data->m_saveThreadPool->waitForAllTasks();
+		m_data->m_saveTaskRunning = false;
+	}
+}
+
 bool PhysicsServerCommandProcessor::processSaveBulletCommand(const struct SharedMemoryCommand& clientCmd, struct SharedMemoryStatus& serverStatusOut, char* bufferServerToClient, int bufferSizeInBytes)
 {
 	bool hasStatus = true;
@@ -12804,21 +13660,75 @@ bool PhysicsServerCommandProcessor::processSaveBulletCommand(const struct Shared
 	BT_PROFILE("CMD_SAVE_BULLET");
 	SharedMemoryStatus& serverCmd = serverStatusOut;
 
+	serverCmd.m_type = CMD_BULLET_SAVING_FAILED;
+
+	if (clientCmd.m_updateFlags & SAVE_BULLET_REQUEST_STATUS)
+	{
+		//report the last background save, without waiting for it
+		if (m_data->m_saveTask)
+		{
+			serverCmd.m_type = m_data->m_saveTask->getStatus();
+			if (serverCmd.m_type != CMD_BULLET_SAVING_PENDING)
+			{
+				waitForPendingSave();
+			}
+		}
+		return hasStatus;
+	}
+
+	if (clientCmd.m_updateFlags & SAVE_BULLET_IN_BACKGROUND)
+	{
+		//only one save in flight, the same file may be saved twice in a row
+		waitForPendingSave();
+		delete m_data->m_saveTask;
+
+		//the snapshot holds a copy of the world state, stepping can continue while it is written
+		btDefaultSerializer ser;
+		ser.setSerializationFlags(ser.getSerializationFlags() | BT_SERIALIZE_CONTACT_MANIFOLDS | BT_SERIALIZE_STREAMING);
+		m_data->m_dynamicsWorld->serialize(&ser);
+		SaveBulletTask* task = new SaveBulletTask;
+		task->m_snapshot = ser.detachSnapshot();
+		strcpy(task->m_fileName, clientCmd.m_fileArguments.m_fileName);
+		m_data->m_saveTask = task;
+#ifdef BT_THREADSAFE
+		if (m_data->m_saveThreadPool == 0)
+		{
+			m_data->m_saveThreadPool = new b3ThreadPool("PhysicsServerCommandProcessorSaveThread");
+		}
+		if (m_data->m_saveThreadPool->numWorkers() > 0)
+		{
+			m_data->m_saveThreadPool->runTask(0, saveBulletFunc, task);
+			m_data->m_saveTaskRunning = true;
+			serverCmd.m_type = CMD_BULLET_SAVING_PENDING;
+			return hasStatus;
+		}
+#endif  //BT_THREADSAFE
+		saveBulletFunc(task);
+		serverCmd.m_type = task->getStatus();
+		return hasStatus;
+	}
+
 	FILE* f = fopen(clientCmd.m_fileArguments.m_fileName, "wb");
 	if (f)
 	{
-		btDefaultSerializer* ser = new btDefaultSerializer();
-		int currentFlags = ser->getSerializationFlags();
-		ser->setSerializationFlags(currentFlags | BT_SERIALIZE_CONTACT_MANIFOLDS);
+		btDefaultSerializer ser;
+		int currentFlags = ser.getSerializationFlags();
+		ser.setSerializationFlags(currentFlags | BT_SERIALIZE_CONTACT_MANIFOLDS | BT_SERIALIZE_STREAMING);
 
-		m_data->m_dynamicsWorld->serialize(ser);
-		fwrite(ser->getBufferPointer(), ser->getCurrentBufferSize(), 1, f);
-		fclose(f);
-		serverCmd.m_type = CMD_BULLET_SAVING_COMPLETED;
-		delete ser;
-		return hasStatus;
+		//the chunks are streamed from the arena, without a contiguous copy of the whole file.
+		//The status is only sent once the file is complete, so a client can open it right away
+		m_data->m_dynamicsWorld->serialize(&ser);
+		btFileSerializerSink sink(f);
+		bool written = ser.writeToSink(sink);
+		if (fclose(f) == 0 && written)
+		{
+			serverCmd.m_type = CMD_BULLET_SAVING_COMPLETED;
+		}
+		else
+		{
+			b3Warning("Cannot write %s\n", clientCmd.m_fileArguments.m_fileName);
+		}
 	}
-	serverCmd.m_type = CMD_BULLET_SAVING_FAILED;
 	return hasStatus;
 }
 
@@ -12919,6 +13829,11 @@ bool PhysicsServerCommandProcessor::processCommand(const struct SharedMemoryComm
 			hasStatus = processRequestMeshDataCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
 			break;
 		}
+		case CMD_REQUEST_STATE_HASH:
+		{
+			hasStatus = processRequestStateHashCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
+			break;
+		}
 		case CMD_CREATE_MULTI_BODY:
 		{
 			hasStatus = processCreateMultiBodyCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
@@ -12965,6 +13880,16 @@ bool PhysicsServerCommandProcessor::processCommand(const struct SharedMemoryComm
 			hasStatus = processRequestActualStateCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
 			break;
 		}
+		case CMD_REQUEST_BATCHED_ACTUAL_STATE:
+		{
+			hasStatus = processRequestBatchedActualStateCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
+			break;
+		}
+		case CMD_STATE_SUBSCRIPTION:
+		{
+			hasStatus = processStateSubscriptionCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
+			break;
+		}
 		case CMD_STEP_FORWARD_SIMULATION:
 		{
 			hasStatus = processForwardDynamicsCommand(clientCmd, serverStatusOut, bufferServerToClient, bufferSizeInBytes);
@@ -23,6 +23,8 @@ struct RemoteGUIHelperInternalData
 	GraphicsSharedMemoryStatus m_lastServerStatus;
 	int m_sharedMemoryKey;
 	bool m_isConnected;
+	//last transform sent for each graphics instance, m_graphicsInstanceId is -1 when it needs to be sent again
+	b3AlignedObjectArray<GraphicsSyncTransform> m_sentTransforms;
 
 	RemoteGUIHelperInternalData()
 		: m_waitingForServer(false),
@@ -65,11 +67,20 @@ struct RemoteGUIHelperInternalData
 		return false;
 	}
 
+	//GFX_CMD_SYNCHRONIZE_TRANSFORMS doesn't wait for the server, so its status may still be outstanding
+	void waitForPendingStatus()
+	{
+		while (m_waitingForServer && processServerStatus() == 0)
+		{
+		}
+	}
+
 	struct GraphicsSharedMemoryCommand* getAvailableSharedMemoryCommand()
 	{
 		static int sequence = 0;
 		if (m_testBlock1)
 		{
+			waitForPendingStatus();
 			m_testBlock1->m_clientCommands[0].m_sequenceNumber = sequence++;
 			return &m_testBlock1->m_clientCommands[0];
 		}
@@ -198,6 +209,7 @@ struct RemoteGUIHelperInternalData
 	{
 		if (m_isConnected && m_sharedMemory)
 		{
+			waitForPendingStatus();
 			m_sharedMemory->releaseSharedMemory(m_sharedMemoryKey, GRAPHICS_SHARED_MEMORY_SIZE);
 		}
 		m_isConnected = false;
@@ -345,21 +357,72 @@ void RemoteGUIHelper::syncPhysicsToGraphics2(const btDiscreteDynamicsWorld* rbWo
 	}
 }
 
+static void quantizeTransform(const GUISyncPosition& position, GraphicsSyncTransform& transform)
+{
+	//q and -q are the same rotation, keep w positive so the sign doesn't flip-flop between syncs
+	float sign = position.m_orn[3] < 0.f ? -32767.f : 32767.f;
+	transform.m_graphicsInstanceId = position.m_graphicsInstanceId;
+	for (int i = 0; i < 3; i++)
+	{
+		transform.m_pos[i] = position.m_pos[i];
+	}
+	for (int i = 0; i < 4; i++)
+	{
+		float q = btClamped(position.m_orn[i] * sign, -32767.f, 32767.f);
+		transform.m_orn[i] = short(q < 0.f ? q - 0.5f : q + 0.5f);
+	}
+}
+
+static bool sameTransform(const GraphicsSyncTransform& a, const GraphicsSyncTransform& b)
+{
+	return a.m_graphicsInstanceId == b.m_graphicsInstanceId &&
+		   a.m_pos[0] == b.m_pos[0] && a.m_pos[1] == b.m_pos[1] && a.m_pos[2] == b.m_pos[2] &&
+		   a.m_orn[0] == b.m_orn[0] && a.m_orn[1] == b.m_orn[1] && a.m_orn[2] == b.m_orn[2] && a.m_orn[3] == b.m_orn[3];
+}
+
 void RemoteGUIHelper::syncPhysicsToGraphics2(const GUISyncPosition* positions, int numPositions)
 {
+	if (!m_data->m_testBlock1)
+		return;
+
+	//never block the simulation on the graphics server: when the previous sync is still being
+	//processed, skip this one. Skipped transforms still differ from the sent ones, so they go with the next sync.
+	if (m_data->m_waitingForServer && m_data->processServerStatus() == 0)
+		return;
+
+	B3_PROFILE("syncPhysicsToGraphics2");
 	GraphicsSharedMemoryCommand* cmd = m_data->getAvailableSharedMemoryCommand();
-	if (cmd)
+	GraphicsSyncTransform* transforms = (GraphicsSyncTransform*)m_data->m_testBlock1->m_bulletStreamData;
+	const int maxTransforms = GRAPHICS_SHARED_MEMORY_MAX_STREAM_CHUNK_SIZE / sizeof(GraphicsSyncTransform);
+	int numTransforms = 0;
+	for (int i = 0; i < numPositions && numTransforms < maxTransforms; i++)
+	{
+		int graphicsInstanceId = positions[i].m_graphicsInstanceId;
+		if (graphicsInstanceId < 0)
+			continue;
+		if (graphicsInstanceId >= m_data->m_sentTransforms.size())
+		{
+			GraphicsSyncTransform unsent;
+			unsent.m_graphicsInstanceId = -1;
+			m_data->m_sentTransforms.resize(btMax(graphicsInstanceId + 1, 2 * m_data->m_sentTransforms.size()), unsent);
+		}
+		GraphicsSyncTransform& sent = m_data->m_sentTransforms[graphicsInstanceId];
+		GraphicsSyncTransform transform;
+		quantizeTransform(positions[i], transform);
+		if (!sameTransform(transform, sent))
+		{
+			sent = transform;
+			transforms[numTransforms++] = transform;
+		}
+	}
+
+	if (numTransforms)
 	{
-		uploadData((unsigned char*)positions, numPositions * sizeof(GUISyncPosition), 0);
 		cmd->m_updateFlags = 0;
-		cmd->m_syncTransformsCommand.m_numPositions = numPositions;
+		cmd->m_syncTransformsCommand.m_numPositions = numTransforms;
 		cmd->m_type = GFX_CMD_SYNCHRONIZE_TRANSFORMS;
 		m_data->submitClientCommand(*cmd);
 	}
-	const GraphicsSharedMemoryStatus* status = 0;
-	while ((status = m_data->processServerStatus()) == 0)
-	{
-	}
 }
 
 void RemoteGUIHelper::render(const btDiscreteDynamicsWorld* rbWorld)
@@ -489,6 +552,10 @@ int RemoteGUIHelper::registerGraphicsInstance(int shapeIndex, const float* posit
 		if (status->m_type == GFX_CMD_REGISTER_GRAPHICS_INSTANCE_COMPLETED)
 		{
 			graphicsInstanceId = status->m_registerGraphicsInstanceStatus.m_graphicsInstanceId;
+			if (graphicsInstanceId >= 0 && graphicsInstanceId < m_data->m_sentTransforms.size())
+			{
+				m_data->m_sentTransforms[graphicsInstanceId].m_graphicsInstanceId = -1;
+			}
 		}
 	}
 	return graphicsInstanceId;
@@ -506,6 +573,7 @@ void RemoteGUIHelper::removeAllGraphicsInstances()
 		while ((status = m_data->processServerStatus()) == 0)
 		{
 		}
+		m_data->m_sentTransforms.clear();
 	}
 }
 
@@ -522,6 +590,10 @@ void RemoteGUIHelper::removeGraphicsInstance(int graphicsUid)
 		while ((status = m_data->processServerStatus()) == 0)
 		{
 		}
+		if (graphicsUid >= 0 && graphicsUid < m_data->m_sentTransforms.size())
+		{
+			m_data->m_sentTransforms[graphicsUid].m_graphicsInstanceId = -1;
+		}
 	}
 }
 void RemoteGUIHelper::changeRGBAColor(int instanceUid, const double rgbaColor[4])
@@ -78,6 +78,12 @@ struct FileArgs
 	int m_stateId;
 };
 
+enum EnumSaveBulletFlags
+{
+	SAVE_BULLET_IN_BACKGROUND = 1,
+	SAVE_BULLET_REQUEST_STATUS = 2,
+};
+
 enum EnumLoadStateArgsUpdateFlags
 {
 	CMD_LOAD_STATE_HAS_STATEID = 1,
@@ -552,6 +558,45 @@ struct RequestActualStateArgs
 	int m_bodyUniqueId;
 };
 
+struct RequestBatchedActualStateArgs
+{
+	int m_numBodies;
+	int m_fields;
+};
+
+struct SendBatchedActualStateArgs
+{
+	int m_numBodies;
+	int m_numValues;
+	int m_valueStreamOffset;
+};
+
+enum EnumStateSubscriptionFlags
+{
+	STATE_SUBSCRIPTION_SET_BODIES = 1,
+	STATE_SUBSCRIPTION_SET_DECIMATION = 2,
+	STATE_SUBSCRIPTION_SET_TOLERANCE = 4,
+};
+
+struct StateSubscriptionArgs
+{
+	int m_numBodies;
+	int m_fields;
+	int m_decimation;
+	double m_tolerance;
+};
+
+///the state subscription records are streamed as this header, the records, the bodies and
+///the values at m_valueStreamOffset, with the status of a step simulation or state subscription command
+struct StateSubscriptionStreamHeader
+{
+	int m_numRecords;
+	int m_numBodies;
+	int m_numValues;
+	int m_numDroppedRecords;
+	int m_valueStreamOffset;
+};
+
 struct SendActualStateArgs
 {
 	int m_bodyUniqueId;
@@ -1105,6 +1150,13 @@ struct b3SendMeshDataArgs
 	int m_numVerticesRemaining;
 };
 
+struct b3SendStateHashArgs
+{
+	unsigned int m_stateHash;
+	int m_numBodiesCopied;
+	int m_numBodies;
+};
+
 struct SharedMemoryCommand
 {
 	int m_type;
@@ -1166,6 +1218,8 @@ struct SharedMemoryCommand
 		struct UserDataRequestArgs m_removeUserDataRequestArgs;
 		struct b3CollisionFilterArgs m_collisionFilterArgs;
 		struct b3RequestMeshDataArgs m_requestMeshDataArgs;
+		struct RequestBatchedActualStateArgs m_requestBatchedActualStateArgs;
+		struct StateSubscriptionArgs m_stateSubscriptionArgs;
 	};
 };
 
@@ -1242,6 +1296,8 @@ struct SharedMemoryStatus
 		struct UserDataRequestArgs m_removeUserDataResponseArgs;
 		struct b3ForwardDynamicsAnalyticsArgs m_forwardDynamicsAnalyticsArgs;
 		struct b3SendMeshDataArgs m_sendMeshDataArgs;
+		struct b3SendStateHashArgs m_sendStateHashArgs;
+		struct SendBatchedActualStateArgs m_sendBatchedActualStateArgs;
 	};
 };
 
@@ -7,7 +7,11 @@
 //Please don't replace an existing magic number:
 //instead, only ADD a new one at the top, comment-out previous one
 
-#define SHARED_MEMORY_MAGIC_NUMBER 202002030
+#define SHARED_MEMORY_MAGIC_NUMBER 202010183
+//#define SHARED_MEMORY_MAGIC_NUMBER 202010182
+//#define SHARED_MEMORY_MAGIC_NUMBER 202010181
+//#define SHARED_MEMORY_MAGIC_NUMBER 202010180
+//#define SHARED_MEMORY_MAGIC_NUMBER 202002030
 //#define SHARED_MEMORY_MAGIC_NUMBER 202001230
 //#define SHARED_MEMORY_MAGIC_NUMBER 201911280
 //#define SHARED_MEMORY_MAGIC_NUMBER 201911180
@@ -110,6 +114,9 @@ enum EnumSharedMemoryClientCommand
 	CMD_REMOVE_USER_DATA,
 	CMD_COLLISION_FILTER,
 	CMD_REQUEST_MESH_DATA,
+	CMD_REQUEST_STATE_HASH,
+	CMD_REQUEST_BATCHED_ACTUAL_STATE,
+	CMD_STATE_SUBSCRIPTION,
 
 	//don't go beyond this command!
 	CMD_MAX_CLIENT_COMMANDS,
@@ -233,6 +240,13 @@ enum EnumSharedMemoryServerStatus
 
 	CMD_REQUEST_MESH_DATA_COMPLETED,
 	CMD_REQUEST_MESH_DATA_FAILED,
+	CMD_REQUEST_STATE_HASH_COMPLETED,
+	CMD_REQUEST_STATE_HASH_FAILED,
+	CMD_BATCHED_ACTUAL_STATE_COMPLETED,
+	CMD_BATCHED_ACTUAL_STATE_FAILED,
+	CMD_STATE_SUBSCRIPTION_COMPLETED,
+	CMD_STATE_SUBSCRIPTION_FAILED,
+	CMD_BULLET_SAVING_PENDING,
 	//don't go beyond 'CMD_MAX_SERVER_COMMANDS!
 	CMD_MAX_SERVER_COMMANDS
 };
@@ -455,6 +469,83 @@ struct b3MeshData
 	struct b3MeshVertex* m_vertices;
 };
 
+struct b3StateHashBody
+{
+	int m_bodyUniqueId;
+	unsigned int m_hash;
+};
+
+///hash of the simulation state after the last step: m_stateHash covers all bodies and contacts,
+///m_bodies has one hash per body (base/link transforms and velocities, joint positions)
+///m_numBodiesTotal is the number of bodies on the server, if it exceeds m_numBodies the reply was truncated
+struct b3StateHashInformation
+{
+	unsigned int m_stateHash;
+	int m_numBodies;
+	struct b3StateHashBody* m_bodies;
+	int m_numBodiesTotal;
+};
+
+enum eBatchedActualStateFields
+{
+	BATCHED_STATE_JOINT_POSITIONS = 1,
+	BATCHED_STATE_JOINT_VELOCITIES = 2,
+	BATCHED_STATE_LINK_POSES = 4,
+	BATCHED_STATE_LINK_VELOCITIES = 8,
+	BATCHED_STATE_JOINT_REACTION_FORCES = 16,
+	BATCHED_STATE_ALL_FIELDS = 31,
+};
+
+///location of the state of one body in b3BatchedActualStateData::m_values, offsets are in doubles
+///and -1 for fields that were not requested. The positions are the base center of mass position and
+///orientation (7) followed by the joint positions, the velocities are the base linear and angular velocity (6)
+///followed by the joint velocities. Link poses (COM position and quaternion x,y,z,w, 7 values per link) and link
+///velocities (linear and angular, 6 values per link) are in world space. Joint reaction forces (force and torque,
+///6 values per link) are the raw joint feedback, like in b3GetJointState: in the link frame by default, in world space
+///or in the joint frame when JOINT_FEEDBACK_IN_WORLD_SPACE or JOINT_FEEDBACK_IN_JOINT_FRAME is set with
+///b3PhysicsParameterSetJointFeedbackMode.
+struct b3BatchedActualStateBody
+{
+	int m_bodyUniqueId;
+	int m_numPositions;
+	int m_numVelocities;
+	int m_numLinks;
+	int m_positionOffset;
+	int m_velocityOffset;
+	int m_linkPoseOffset;
+	int m_linkVelocityOffset;
+	int m_jointReactionForceOffset;
+};
+
+struct b3BatchedActualStateData
+{
+	int m_numBodies;
+	struct b3BatchedActualStateBody* m_bodies;
+	int m_numValues;
+	double* m_values;
+};
+
+///the subscribed bodies whose state changed beyond the tolerance after one simulation step,
+///m_bodies[m_firstBody] up to m_bodies[m_firstBody + m_numBodies - 1] of b3StateSubscriptionData
+struct b3StateSubscriptionRecord
+{
+	int m_simulationStep;
+	int m_numBodies;
+	int m_firstBody;
+};
+
+///the records received with the last step simulation or state subscription status, the body offsets index into m_values
+///m_numDroppedRecords counts the oldest records the server dropped because they were not picked up in time,
+///their bodies are sent again with the next record
+struct b3StateSubscriptionData
+{
+	int m_numRecords;
+	struct b3StateSubscriptionRecord* m_records;
+	struct b3BatchedActualStateBody* m_bodies;
+	double* m_values;
+	int m_numDroppedRecords;
+};
+
 struct b3OpenGLVisualizerCameraInfo
 {
 	int m_width;
@@ -836,6 +927,13 @@ enum EnumRendererAuxFlags
 	ER_SEGMENTATION_MASK_OBJECT_AND_LINKINDEX = 1,
 	ER_USE_PROJECTIVE_TEXTURE = 2,
 	ER_NO_SEGMENTATION_MASK = 4,
+	//TinyRenderer only: skip shading, textures and shadows, only the depth buffer and segmentation mask are rendered
+	ER_DEPTH_AND_SEGMENTATION_ONLY = 8,
+	//together with ER_DEPTH_AND_SEGMENTATION_ONLY: rasterize at half the width and height, then upsample to the requested size.
+	//Without ER_DEPTH_AND_SEGMENTATION_ONLY it is ignored, and TinyRenderer prints a warning
+	ER_REDUCED_RESOLUTION = 16,
+	//TinyRenderer only: render every object, without frustum and occlusion culling. The image is the same, only slower
+	ER_NO_CULLING = 32,
 };
 
 ///flags to pick the IK solver and other options
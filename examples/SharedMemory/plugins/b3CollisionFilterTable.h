@@ -0,0 +1,171 @@
+#ifndef B3_COLLISION_FILTER_TABLE_H
+#define B3_COLLISION_FILTER_TABLE_H
+
+#include "Bullet3Common/b3AlignedObjectArray.h"
+
+enum b3CollisionFilterTableRule
+{
+	B3_FILTER_RULE_NONE = 0,
+	B3_FILTER_RULE_DISABLE,
+	B3_FILTER_RULE_ENABLE
+};
+
+///b3CollisionFilterTable holds per link-pair collision rules in a form that can be checked inline
+///in the overlap filter callback, without virtual calls or hashing. The collision plugin marks it dirty
+///whenever its rules change and rebuilds it (via begin/addRule/end) on the next getFilterTable.
+///Bodies that appear in a rule get a dense rule index, each pair of rule bodies with rules between them
+///gets a dense (numLinks+1) x (numLinks+1) matrix of b3CollisionFilterTableRule values. Link -1 is the base.
+struct b3CollisionFilterTable
+{
+	//rule index for each body unique id + 1, or -1 if the body has no rules
+	b3AlignedObjectArray<int> m_bodyRuleIndex;
+	//number of matrix rows/columns of each rule body (highest link index in its rules + 2)
+	b3AlignedObjectArray<int> m_numLinkSlots;
+	//offset into m_cells of the matrix of each (ruleIndexA, ruleIndexB) pair, row major, -1 if there are no rules
+	b3AlignedObjectArray<int> m_pairOffsets;
+	b3AlignedObjectArray<unsigned char> m_cells;
+	int m_numRules;
+
+	struct Rule
+	{
+		int m_objectUniqueIdA;
+		int m_linkIndexA;
+		int m_objectUniqueIdB;
+		int m_linkIndexB;
+		bool m_enableCollision;
+	};
+	b3AlignedObjectArray<Rule> m_pendingRules;
+	//set when the plugin rules changed after the last end(), lookups are stale until it is rebuilt
+	bool m_dirty;
+
+	b3CollisionFilterTable()
+		: m_numRules(0),
+		  m_dirty(false)
+	{
+	}
+
+	int getNumRules() const
+	{
+		return m_numRules;
+	}
+
+	bool isDirty() const
+	{
+		return m_dirty;
+	}
+
+	void setDirty()
+	{
+		m_dirty = true;
+	}
+
+	void begin()
+	{
+		m_pendingRules.resize(0);
+	}
+
+	void addRule(int objectUniqueIdA, int linkIndexA, int objectUniqueIdB, int linkIndexB, bool enableCollision)
+	{
+		//ids below -1 can't be stored, they are never looked up either
+		if (objectUniqueIdA < -1 || objectUniqueIdB < -1 || linkIndexA < -1 || linkIndexB < -1)
+		{
+			return;
+		}
+		Rule& rule = m_pendingRules.expandNonInitializing();
+		rule.m_objectUniqueIdA = objectUniqueIdA;
+		rule.m_linkIndexA = linkIndexA;
+		rule.m_objectUniqueIdB = objectUniqueIdB;
+		rule.m_linkIndexB = linkIndexB;
+		rule.m_enableCollision = enableCollision;
+	}
+
+	void end()
+	{
+		m_bodyRuleIndex.resize(0);
+		m_numLinkSlots.resize(0);
+		m_pairOffsets.resize(0);
+		m_cells.resize(0);
+		m_numRules = m_pendingRules.size();
+
+		//dense rule index per body, and the matrix size it needs
+		for (int i = 0; i < m_pendingRules.size(); i++)
+		{
+			const Rule& rule = m_pendingRules[i];
+			registerBody(rule.m_objectUniqueIdA, rule.m_linkIndexA);
+			registerBody(rule.m_objectUniqueIdB, rule.m_linkIndexB);
+		}
+		int numRuleBodies = m_numLinkSlots.size();
+		m_pairOffsets.resize(numRuleBodies * numRuleBodies, -1);
+
+		for (int i = 0; i < m_pendingRules.size(); i++)
+		{
+			const Rule& rule = m_pendingRules[i];
+			unsigned char value = rule.m_enableCollision ? B3_FILTER_RULE_ENABLE : B3_FILTER_RULE_DISABLE;
+			int ruleIndexA = m_bodyRuleIndex[rule.m_objectUniqueIdA + 1];
+			int ruleIndexB = m_bodyRuleIndex[rule.m_objectUniqueIdB + 1];
+			//both orders are stored, so a lookup never has to swap
+			getMatrix(ruleIndexA, ruleIndexB)[(rule.m_linkIndexA + 1) * m_numLinkSlots[ruleIndexB] + rule.m_linkIndexB + 1] = value;
+			getMatrix(ruleIndexB, ruleIndexA)[(rule.m_linkIndexB + 1) * m_numLinkSlots[ruleIndexA] + rule.m_linkIndexA + 1] = value;
+		}
+		m_pendingRules.resize(0);
+		m_dirty = false;
+	}
+
+	//returns a b3CollisionFilterTableRule
+	B3_FORCE_INLINE int lookup(int objectUniqueIdA, int linkIndexA, int objectUniqueIdB, int linkIndexB) const
+	{
+		unsigned int bodyA = (unsigned int)(objectUniqueIdA + 1);
+		unsigned int bodyB = (unsigned int)(objectUniqueIdB + 1);
+		if (bodyA >= (unsigned int)m_bodyRuleIndex.size() || bodyB >= (unsigned int)m_bodyRuleIndex.size())
+		{
+			return B3_FILTER_RULE_NONE;
+		}
+		int ruleIndexA = m_bodyRuleIndex[bodyA];
+		int ruleIndexB = m_bodyRuleIndex[bodyB];
+		if (ruleIndexA < 0 || ruleIndexB < 0)
+		{
+			return B3_FILTER_RULE_NONE;
+		}
+		int offset = m_pairOffsets[ruleIndexA * m_numLinkSlots.size() + ruleIndexB];
+		unsigned int slotA = (unsigned int)(linkIndexA + 1);
+		unsigned int slotB = (unsigned int)(linkIndexB + 1);
+		if (offset < 0 || slotA >= (unsigned int)m_numLinkSlots[ruleIndexA] || slotB >= (unsigned int)m_numLinkSlots[ruleIndexB])
+		{
+			return B3_FILTER_RULE_NONE;
+		}
+		return m_cells[offset + slotA * m_numLinkSlots[ruleIndexB] + slotB];
+	}
+
+private:
+	void registerBody(int objectUniqueId, int linkIndex)
+	{
+		int body = objectUniqueId + 1;
+		if (body >= m_bodyRuleIndex.size())
+		{
+			m_bodyRuleIndex.resize(body + 1, -1);
+		}
+		if (m_bodyRuleIndex[body] < 0)
+		{
+			m_bodyRuleIndex[body] = m_numLinkSlots.size();
+			m_numLinkSlots.push_back(0);
+		}
+		int& numSlots = m_numLinkSlots[m_bodyRuleIndex[body]];
+		if (linkIndex + 2 > numSlots)
+		{
+			numSlots = linkIndex + 2;
+		}
+	}
+
+	unsigned char* getMatrix(int ruleIndexA, int ruleIndexB)
+	{
+		int& offset = m_pairOffsets[ruleIndexA * m_numLinkSlots.size() + ruleIndexB];
+		if (offset < 0)
+		{
+			offset = m_cells.size();
+			m_cells.resize(offset + m_numLinkSlots[ruleIndexA] * m_numLinkSlots[ruleIndexB], B3_FILTER_RULE_NONE);
+		}
+		return &m_cells[offset];
+	}
+};
+
+#endif  //B3_COLLISION_FILTER_TABLE_H
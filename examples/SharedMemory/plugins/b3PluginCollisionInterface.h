@@ -27,6 +27,14 @@ struct b3PluginCollisionInterface
 										 int objectUniqueIdB, int linkIndexB,
 										 int collisionFilterGroupB, int collisionFilterMaskB,
 										 int filterMode) = 0;
+
+	//optional compiled form of the rules. The pointer stays valid for the lifetime of the plugin. After the rules
+	//change the table is marked dirty and the next call recompiles it. When available, the server checks it
+	//inline instead of calling needsBroadphaseCollision for each pair.
+	virtual const struct b3CollisionFilterTable* getFilterTable() const
+	{
+		return 0;
+	}
 };
 
 #endif  //B3_PLUGIN_COLLISION_INTERFACE_H
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "Bullet3Common/b3HashMap.h"
 
 #include "../b3PluginCollisionInterface.h"
+#include "../b3CollisionFilterTable.h"
 
 struct b3CustomCollisionFilter
 {
@@ -47,6 +48,29 @@ struct b3CustomCollisionFilter
 struct DefaultPluginCollisionInterface : public b3PluginCollisionInterface
 {
 	b3HashMap<b3CustomCollisionFilter, b3CustomCollisionFilter> m_customCollisionFilters;
+	//compiled from m_customCollisionFilters on the first getFilterTable after a change,
+	//so setting or removing many rules in a row doesn't rebuild it each time
+	mutable b3CollisionFilterTable m_filterTable;
+
+	void compileFilterTable() const
+	{
+		m_filterTable.begin();
+		for (int i = 0; i < m_customCollisionFilters.size(); i++)
+		{
+			const b3CustomCollisionFilter* filter = m_customCollisionFilters.getAtIndex(i);
+			m_filterTable.addRule(filter->m_objectUniqueIdA, filter->m_linkIndexA, filter->m_objectUniqueIdB, filter->m_linkIndexB, filter->m_enableCollision);
+		}
+		m_filterTable.end();
+	}
+
+	virtual const b3CollisionFilterTable* getFilterTable() const
+	{
+		if (m_filterTable.isDirty())
+		{
+			compileFilterTable();
+		}
+		return &m_filterTable;
+	}
 
 	virtual void setBroadphaseCollisionFilter(
 		int objectUniqueIdA, int objectUniqueIdB,
@@ -74,6 +98,7 @@ struct DefaultPluginCollisionInterface : public b3PluginCollisionInterface
 		}
 
 		m_customCollisionFilters.insert(keyValue, keyValue);
+		m_filterTable.setDirty();
 	}
 
 	virtual void removeBroadphaseCollisionFilter(
@@ -100,6 +125,7 @@ struct DefaultPluginCollisionInterface : public b3PluginCollisionInterface
 		}
 
 		m_customCollisionFilters.remove(keyValue);
+		m_filterTable.setDirty();
 	}
 
 	virtual int getNumRules() const
@@ -110,6 +136,7 @@ struct DefaultPluginCollisionInterface : public b3PluginCollisionInterface
 	virtual void resetAll()
 	{
 		m_customCollisionFilters.clear();
+		m_filterTable.setDirty();
 	}
 
 	virtual int needsBroadphaseCollision(int objectUniqueIdA, int linkIndexA,
@@ -6,7 +6,9 @@
 
 #include "LinearMath/btScalar.h"
 #include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btThreads.h"
 
+#include "../../PhysicsClientC_API.h"
 #include "../../b3RobotSimulatorClientAPI_NoDirect.h"
 #include "../../b3RobotSimulatorClientAPI_InternalData.h"
 
@@ -19,20 +21,92 @@ struct MyPDControl
 	btScalar m_kd;
 	btScalar m_kp;
 	btScalar m_maxForce;
+
+	//per tick scratch data
+	bool m_hasActualState;
+	btScalar m_qActual;
+	btScalar m_qdActual;
+	btScalar m_force;
+};
+
+//controllers are kept sorted by body, so each body is a contiguous range
+//and its state is fetched and its torques are applied with one command
+struct MyPDControlBodyRange
+{
+	int m_objectUniqueId;
+	int m_firstController;
+	int m_numControllers;
 };
 
 struct MyPDControlContainer
 {
 	int m_testData;
 	btAlignedObjectArray<MyPDControl> m_controllers;
+	btAlignedObjectArray<MyPDControlBodyRange> m_bodies;
+	bool m_bodiesNeedUpdate;
 	b3RobotSimulatorClientAPI_NoDirect m_api;
+	b3PhysicsClientHandle m_physClient;
 	MyPDControlContainer()
-		: m_testData(42)
+		: m_testData(42),
+		  m_bodiesNeedUpdate(false),
+		  m_physClient(0)
 	{
 	}
 	virtual ~MyPDControlContainer()
 	{
 	}
+
+	void updateBodyRanges()
+	{
+		m_bodiesNeedUpdate = false;
+		m_bodies.resize(0);
+		for (int i = 0; i < m_controllers.size(); i++)
+		{
+			if (m_bodies.size() == 0 || m_bodies[m_bodies.size() - 1].m_objectUniqueId != m_controllers[i].m_objectUniqueId)
+			{
+				MyPDControlBodyRange& range = m_bodies.expandNonInitializing();
+				range.m_objectUniqueId = m_controllers[i].m_objectUniqueId;
+				range.m_firstController = i;
+				range.m_numControllers = 0;
+			}
+			m_bodies[m_bodies.size() - 1].m_numControllers++;
+		}
+	}
+};
+
+//evaluates the PD controllers of a range of bodies, bodies are independent so this runs in parallel
+struct MyPDControlLoop : public btIParallelForBody
+{
+	MyPDControlContainer* m_obj;
+
+	MyPDControlLoop(MyPDControlContainer* obj)
+		: m_obj(obj)
+	{
+	}
+
+	virtual void forLoop(int iBegin, int iEnd) const
+	{
+		for (int b = iBegin; b < iEnd; b++)
+		{
+			const MyPDControlBodyRange& range = m_obj->m_bodies[b];
+			for (int i = range.m_firstController; i < range.m_firstController + range.m_numControllers; i++)
+			{
+				MyPDControl& pdControl = m_obj->m_controllers[i];
+				if (!pdControl.m_hasActualState || pdControl.m_maxForce <= 0)
+				{
+					continue;
+				}
+				//compute torque
+				btScalar positionError = (pdControl.m_desiredPosition - pdControl.m_qActual);
+				btScalar velocityError = (pdControl.m_desiredVelocity - pdControl.m_qdActual);
+
+				btScalar force = pdControl.m_kp * positionError + pdControl.m_kd * velocityError;
+
+				btClamp(force, -pdControl.m_maxForce, pdControl.m_maxForce);
+				pdControl.m_force = force;
+			}
+		}
+	}
 };
 
 B3_SHARED_API int initPlugin_pdControlPlugin(struct b3PluginContext* context)
@@ -42,6 +116,7 @@ B3_SHARED_API int initPlugin_pdControlPlugin(struct b3PluginContext* context)
 	data.m_physicsClientHandle = context->m_physClient;
 	data.m_guiHelper = 0;
 	obj->m_api.setInternalData(&data);
+	obj->m_physClient = context->m_physClient;
 	context->m_userPointer = obj;
 
 	return SHARED_MEMORY_MAGIC_NUMBER;
@@ -51,34 +126,72 @@ B3_SHARED_API int preTickPluginCallback_pdControlPlugin(struct b3PluginContext*
 {
 	//apply pd control here, apply forces using the PD gains
 	MyPDControlContainer* obj = (MyPDControlContainer*)context->m_userPointer;
-
-	for (int i = 0; i < obj->m_controllers.size(); i++)
+	if (obj->m_bodiesNeedUpdate)
+	{
+		obj->updateBodyRanges();
+	}
+	if (obj->m_bodies.size() == 0)
 	{
-		const MyPDControl& pdControl = obj->m_controllers[i];
+		return 0;
+	}
+	b3PhysicsClientHandle physClient = obj->m_physClient;
 
-		int dof1 = 0;
-		b3JointSensorState actualState;
-		if (obj->m_api.getJointState(pdControl.m_objectUniqueId, pdControl.m_linkIndex, &actualState))
+	//gather the actual state, one request per body
+	for (int b = 0; b < obj->m_bodies.size(); b++)
+	{
+		const MyPDControlBodyRange& range = obj->m_bodies[b];
+		b3SharedMemoryCommandHandle command = b3RequestActualStateCommandInit(physClient, range.m_objectUniqueId);
+		b3SharedMemoryStatusHandle statusHandle = b3SubmitClientCommandAndWaitStatus(physClient, command);
+		bool hasStatus = b3GetStatusType(statusHandle) == CMD_ACTUAL_STATE_UPDATE_COMPLETED;
+		for (int i = range.m_firstController; i < range.m_firstController + range.m_numControllers; i++)
 		{
-			if (pdControl.m_maxForce > 0)
+			MyPDControl& pdControl = obj->m_controllers[i];
+			b3JointSensorState actualState;
+			pdControl.m_hasActualState = hasStatus && b3GetJointState(physClient, statusHandle, pdControl.m_linkIndex, &actualState);
+			if (pdControl.m_hasActualState)
 			{
-				//compute torque
-				btScalar qActual = actualState.m_jointPosition;
-				btScalar qdActual = actualState.m_jointVelocity;
-
-				btScalar positionError = (pdControl.m_desiredPosition - qActual);
-				double desiredVelocity = 0;
-				btScalar velocityError = (pdControl.m_desiredVelocity - qdActual);
-
-				btScalar force = pdControl.m_kp * positionError + pdControl.m_kd * velocityError;
+				pdControl.m_qActual = actualState.m_jointPosition;
+				pdControl.m_qdActual = actualState.m_jointVelocity;
+			}
+		}
+	}
 
-				btClamp(force, -pdControl.m_maxForce, pdControl.m_maxForce);
+	//the client API is not thread safe, only the controller evaluation runs in parallel
+	MyPDControlLoop loop(obj);
+#if BT_THREADSAFE
+	if (btGetTaskScheduler())
+	{
+		btParallelFor(0, obj->m_bodies.size(), 16, loop);
+	}
+	else
+#endif
+	{
+		loop.forLoop(0, obj->m_bodies.size());
+	}
 
-				//apply torque
-				b3RobotSimulatorJointMotorArgs args(CONTROL_MODE_TORQUE);
-				args.m_maxTorqueValue = force;
-				obj->m_api.setJointMotorControl(pdControl.m_objectUniqueId, pdControl.m_linkIndex, args);
+	//apply the torques, one command per body
+	for (int b = 0; b < obj->m_bodies.size(); b++)
+	{
+		const MyPDControlBodyRange& range = obj->m_bodies[b];
+		b3SharedMemoryCommandHandle command = b3JointControlCommandInit2(physClient, range.m_objectUniqueId, CONTROL_MODE_TORQUE);
+		int numTorques = 0;
+		for (int i = range.m_firstController; i < range.m_firstController + range.m_numControllers; i++)
+		{
+			const MyPDControl& pdControl = obj->m_controllers[i];
+			if (!pdControl.m_hasActualState || pdControl.m_maxForce <= 0)
+			{
+				continue;
 			}
+			b3JointInfo jointInfo;
+			if (b3GetJointInfo(physClient, range.m_objectUniqueId, pdControl.m_linkIndex, &jointInfo) && jointInfo.m_uIndex >= 0)
+			{
+				b3JointControlSetDesiredForceTorque(command, jointInfo.m_uIndex, pdControl.m_force);
+				numTorques++;
+			}
+		}
+		if (numTorques)
+		{
+			b3SubmitClientCommandAndWaitStatus(physClient, command);
 		}
 	}
 
@@ -131,8 +244,20 @@ B3_SHARED_API int executePluginCommand_pdControlPlugin(struct b3PluginContext* c
 			}
 			if (foundIndex < 0)
 			{
+				//insert after the last controller of the same (or a lower) body
+				int insertIndex = obj->m_controllers.size();
+				while (insertIndex > 0 && obj->m_controllers[insertIndex - 1].m_objectUniqueId > controller.m_objectUniqueId)
+				{
+					insertIndex--;
+				}
 				obj->m_controllers.push_back(controller);
+				for (int i = obj->m_controllers.size() - 1; i > insertIndex; i--)
+				{
+					obj->m_controllers[i] = obj->m_controllers[i - 1];
+				}
+				obj->m_controllers[insertIndex] = controller;
 			}
+			obj->m_bodiesNeedUpdate = true;
 			break;
 		}
 		case eRemovePDControl:
@@ -145,10 +270,16 @@ B3_SHARED_API int executePluginCommand_pdControlPlugin(struct b3PluginContext* c
 			{
 				if (obj->m_controllers[i].m_objectUniqueId == controller.m_objectUniqueId && obj->m_controllers[i].m_linkIndex == controller.m_linkIndex)
 				{
-					obj->m_controllers.removeAtIndex(i);
+					//keep the order, so controllers stay sorted by body
+					for (int j = i; j < obj->m_controllers.size() - 1; j++)
+					{
+						obj->m_controllers[j] = obj->m_controllers[j + 1];
+					}
+					obj->m_controllers.pop_back();
 					break;
 				}
 			}
+			obj->m_bodiesNeedUpdate = true;
 			break;
 		}
 		default:
@@ -60,6 +60,17 @@ void cRBDModel::Update(const Eigen::VectorXd& pose, const Eigen::VectorXd& vel)
 	}
 }
 
+void cRBDModel::UpdateKeepMassMat(const Eigen::VectorXd& pose, const Eigen::VectorXd& vel)
+{
+	SetPose(pose);
+	SetVel(vel);
+
+	UpdateJointSubspaceArr();
+	UpdateChildParentMatArr();
+	UpdateSpWorldTrans();
+	UpdateBiasForce();
+}
+
 int cRBDModel::GetNumDof() const
 {
 	return cKinTree::GetNumDof(mJointMat);
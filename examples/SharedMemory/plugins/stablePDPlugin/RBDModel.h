@@ -14,6 +14,8 @@ public:
 
 	virtual void Init(const Eigen::MatrixXd& joint_mat, const Eigen::MatrixXd& body_defs, const tVector& gravity);
 	virtual void Update(const Eigen::VectorXd& pose, const Eigen::VectorXd& vel);
+	// same as Update, but keeps the current mass matrix (when it is reused over several substeps)
+	virtual void UpdateKeepMassMat(const Eigen::VectorXd& pose, const Eigen::VectorXd& vel);
 
 	virtual int GetNumDof() const;
 	virtual int GetNumJoints() const;
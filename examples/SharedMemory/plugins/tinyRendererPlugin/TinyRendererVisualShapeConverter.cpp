@@ -15,6 +15,7 @@ subject to the following restrictions:
 
 #include "../Importers/ImportURDFDemo/URDFImporterInterface.h"
 #include "btBulletCollisionCommon.h"
+#include "BulletCollision/BroadphaseCollision/btDbvt.h"
 #include "../Importers/ImportObjDemo/LoadMeshFromObj.h"
 #include "../Importers/ImportSTLDemo/LoadMeshFromSTL.h"
 #include "../Importers/ImportColladaDemo/LoadMeshFromCollada.h"
@@ -24,6 +25,7 @@ subject to the following restrictions:
 #include <string>
 #include "../Utils/b3ResourcePath.h"
 #include "../TinyRenderer/TinyRenderer.h"
+#include "../TinyRenderer/our_gl.h"
 #include "../OpenGLWindow/SimpleCamera.h"
 #include "../Importers/ImportMeshUtility/b3ImportMeshUtility.h"
 #include <iostream>
@@ -48,14 +50,30 @@ struct TinyRendererObjectArray
 	int m_linkIndex;
 	btTransform m_worldTransform;
 	btVector3 m_localScaling;
+	//bounds of all render objects before scaling, and their leaf in the bounding volume hierarchy
+	btVector3 m_localAabbMin;
+	btVector3 m_localAabbMax;
+	btDbvtNode* m_treeNode;
 
 	TinyRendererObjectArray()
+		: m_treeNode(0)
 	{
 		m_worldTransform.setIdentity();
 		m_localScaling.setValue(1, 1, 1);
+		m_localAabbMin.setValue(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+		m_localAabbMax.setValue(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
 	}
 };
 
+//a model shared by the instances of identical visual shapes, such as the links of many copies of the same robot
+struct TinyRendererSharedModel
+{
+	TinyRender::Model* m_model;
+	const unsigned char* m_textureImage;
+	int m_textureWidth;
+	int m_textureHeight;
+};
+
 #define START_WIDTH 640
 #define START_HEIGHT 480
 
@@ -63,6 +81,12 @@ struct TinyRendererVisualShapeConverterInternalData
 {
 	btHashMap<btHashInt, TinyRendererObjectArray*> m_swRenderInstances;
 
+	//shared models by hash of their vertices, indices, color and texture, the cache holds one reference to each
+	btHashMap<btHashInt, btAlignedObjectArray<TinyRendererSharedModel> > m_sharedModels;
+
+	//world bounds of each TinyRendererObjectArray, for frustum and occlusion culling
+	btDbvt m_objectTree;
+
 	// Maps bodyUniqueId to a list of visual shapes belonging to the body.
 	btHashMap<btHashInt, btAlignedObjectArray<b3VisualShapeData> > m_visualShapesMap;
 
@@ -75,6 +99,9 @@ struct TinyRendererVisualShapeConverterInternalData
 	b3AlignedObjectArray<float> m_depthBuffer;
 	b3AlignedObjectArray<float> m_shadowBuffer;
 	b3AlignedObjectArray<int> m_segmentationMaskBuffer;
+	//half resolution buffers for ER_REDUCED_RESOLUTION
+	b3AlignedObjectArray<float> m_reducedDepthBuffer;
+	b3AlignedObjectArray<int> m_reducedSegmentationMaskBuffer;
 	btVector3 m_lightDirection;
 	bool m_hasLightDirection;
 	btVector3 m_lightColor;
@@ -119,6 +146,33 @@ struct TinyRendererVisualShapeConverterInternalData
 
 	virtual ~TinyRendererVisualShapeConverterInternalData()
 	{
+		releaseSharedModels(false);
+	}
+
+	//drops the cache reference of all shared models, or only of those no render object uses anymore
+	void releaseSharedModels(bool unusedOnly)
+	{
+		for (int i = 0; i < m_sharedModels.size(); i++)
+		{
+			btAlignedObjectArray<TinyRendererSharedModel>* models = m_sharedModels.getAtIndex(i);
+			for (int m = models->size() - 1; m >= 0; m--)
+			{
+				TinyRender::Model* model = models->at(m).m_model;
+				if (!unusedOnly || model->getReferenceCount() == 1)
+				{
+					if (model->removeReference() == 0)
+					{
+						delete model;
+					}
+					models->swap(m, models->size() - 1);
+					models->pop_back();
+				}
+			}
+		}
+		if (!unusedOnly)
+		{
+			m_sharedModels.clear();
+		}
 	}
 };
 
@@ -651,6 +705,59 @@ static btVector4 sColors[4] =
 		//btVector4(1,1,0,1),
 };
 
+static unsigned int hashBytes(unsigned int hash, const void* data, int numBytes)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (int i = 0; i < numBytes; i++)
+	{
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+//the same visual shape, for example a link of another copy of the same robot, reuses the model of the first one
+static TinyRender::Model* findSharedModel(btAlignedObjectArray<TinyRendererSharedModel>* models, const GLInstanceVertex* vertices, int numVertices, const int* indices, int numIndices, const float rgbaColor[4], const unsigned char* textureImage, int textureWidth, int textureHeight)
+{
+	if (models)
+	{
+		for (int i = 0; i < models->size(); i++)
+		{
+			const TinyRendererSharedModel& shared = models->at(i);
+			const TinyRender::Vec4f& color = shared.m_model->getColorRGBA();
+			if (shared.m_textureImage == textureImage && shared.m_textureWidth == textureWidth && shared.m_textureHeight == textureHeight &&
+				color[0] == rgbaColor[0] && color[1] == rgbaColor[1] && color[2] == rgbaColor[2] && color[3] == rgbaColor[3] &&
+				shared.m_model->isSameMesh(&vertices[0].xyzw[0], numVertices, indices, numIndices))
+			{
+				return shared.m_model;
+			}
+		}
+	}
+	return 0;
+}
+
+static void updateObjectBounds(btDbvt& tree, TinyRendererObjectArray* visuals)
+{
+	if (visuals->m_renderObjects.size() == 0)
+		return;
+	btVector3 scaledMin = visuals->m_localAabbMin * visuals->m_localScaling;
+	btVector3 scaledMax = visuals->m_localAabbMax * visuals->m_localScaling;
+	btVector3 localAabbMin = scaledMin;
+	btVector3 localAabbMax = scaledMax;
+	localAabbMin.setMin(scaledMax);
+	localAabbMax.setMax(scaledMin);
+	btVector3 aabbMin, aabbMax;
+	btTransformAabb(localAabbMin, localAabbMax, 0, visuals->m_worldTransform, aabbMin, aabbMax);
+	btDbvtVolume volume = btDbvtVolume::FromMM(aabbMin, aabbMax);
+	if (visuals->m_treeNode)
+	{
+		tree.update(visuals->m_treeNode, volume);
+	}
+	else
+	{
+		visuals->m_treeNode = tree.insert(volume, visuals);
+	}
+}
+
 int  TinyRendererVisualShapeConverter::convertVisualShapes(
 	int linkIndex, const char* pathPrefix, const btTransform& localInertiaFrame, 
 	const UrdfLink* linkPtr, const UrdfModel* model, int unused, 
@@ -800,13 +907,41 @@ int  TinyRendererVisualShapeConverter::convertVisualShapes(
 					isCached = textures[0].m_isCached;
 				}
 
+				unsigned int hash = hashBytes(2166136261u, &vertices[0], vertices.size() * sizeof(GLInstanceVertex));
+				hash = hashBytes(hash, &indices[0], indices.size() * sizeof(int));
+				hash = hashBytes(hash, rgbaColor, sizeof(rgbaColor));
+				hash = hashBytes(hash, &textureImage1, sizeof(textureImage1));
+				TinyRender::Model* sharedModel = findSharedModel(m_data->m_sharedModels[hash], &vertices[0], vertices.size(), &indices[0], indices.size(), rgbaColor,
+																 textureImage1, textureWidth, textureHeight);
+				if (sharedModel)
+				{
+					tinyObj->shareModel(sharedModel);
+				}
+				else
 				{
 					B3_PROFILE("registerMeshShape");
 
 					tinyObj->registerMeshShape(&vertices[0].xyzw[0], vertices.size(), &indices[0], indices.size(), rgbaColor,
 											   textureImage1, textureWidth, textureHeight);
+					if (m_data->m_sharedModels[hash] == 0)
+					{
+						m_data->m_sharedModels.insert(hash, btAlignedObjectArray<TinyRendererSharedModel>());
+					}
+					TinyRendererSharedModel shared;
+					shared.m_model = tinyObj->m_model;
+					shared.m_textureImage = textureImage1;
+					shared.m_textureWidth = textureWidth;
+					shared.m_textureHeight = textureHeight;
+					shared.m_model->addReference();
+					m_data->m_sharedModels[hash]->push_back(shared);
 				}
 				visuals->m_renderObjects.push_back(tinyObj);
+
+				TinyRender::Vec3f aabbMin, aabbMax;
+				tinyObj->m_model->getAabb(aabbMin, aabbMax);
+				visuals->m_localAabbMin.setMin(btVector3(aabbMin[0], aabbMin[1], aabbMin[2]));
+				visuals->m_localAabbMax.setMax(btVector3(aabbMax[0], aabbMax[1], aabbMax[2]));
+				updateObjectBounds(m_data->m_objectTree, visuals);
 			}
 
 			btAssert(textures.size() <= 1);
@@ -943,12 +1078,18 @@ void TinyRendererVisualShapeConverter::changeRGBAColor(int bodyUniqueId, int lin
 				{
 					if (shapeIndex < 0 || q == shapeIndex)
 					{
-						visuals->m_renderObjects[q]->m_model->setColorRGBA(rgba);
+						TinyRenderObjectData* renderObj = visuals->m_renderObjects[q];
+						const TinyRender::Vec4f& color = renderObj->m_model->getColorRGBA();
+						if (color[0] != rgba[0] || color[1] != rgba[1] || color[2] != rgba[2] || color[3] != rgba[3])
+						{
+							renderObj->getUniqueModel()->setColorRGBA(rgba);
+						}
 					}
 				}
 			}
 		}
 	}
+	m_data->releaseSharedModels(true);
 }
 
 void TinyRendererVisualShapeConverter::setUpAxis(int axis)
@@ -999,11 +1140,177 @@ void TinyRendererVisualShapeConverter::syncTransform(int collisionObjectUniqueId
 	if (renderObjPtr)
 	{
 		TinyRendererObjectArray* renderObj = *renderObjPtr;
-		renderObj->m_worldTransform = worldTransform;
-		renderObj->m_localScaling = localScaling;
+		if (!(renderObj->m_worldTransform == worldTransform) || renderObj->m_localScaling != localScaling)
+		{
+			renderObj->m_worldTransform = worldTransform;
+			renderObj->m_localScaling = localScaling;
+			updateObjectBounds(m_data->m_objectTree, renderObj);
+		}
 	}
 }
 
+//renders the links inside the view frustum front to back, and skips the subtrees of the bounding volume hierarchy
+//that are completely behind the depth buffer rendered so far, so each render object only pays for visible links
+struct TinyRendererCullingPolicy : public btDbvt::ICollide
+{
+	const float* m_viewMat;
+	const float* m_projMat;
+	TinyRender::Matrix m_viewProjectionMatrix;
+	TinyRender::Matrix m_viewportMatrix;
+	int m_width;
+	int m_height;
+	float* m_depthBuffer;
+	//renderObjectDepthAndSegmentation instead of renderObject
+	bool m_depthAndSegmentationOnly;
+	//false for ER_NO_CULLING: render every link in tree order
+	bool m_cullingEnabled;
+	int* m_segmentationMaskBuffer;
+	btVector3 m_lightDirWorld;
+	btVector3 m_lightColor;
+	float m_lightDistance;
+	float m_lightAmbientCoeff;
+	float m_lightDiffuseCoeff;
+	float m_lightSpecularCoeff;
+
+	TinyRendererCullingPolicy(const float viewMat[16], const float projMat[16], const TinyRender::Matrix& viewportMatrix, int width, int height, float* depthBuffer)
+		: m_viewMat(viewMat),
+		  m_projMat(projMat),
+		  m_viewportMatrix(viewportMatrix),
+		  m_width(width),
+		  m_height(height),
+		  m_depthBuffer(depthBuffer),
+		  m_depthAndSegmentationOnly(false),
+		  m_cullingEnabled(true),
+		  m_segmentationMaskBuffer(0),
+		  m_lightDistance(0),
+		  m_lightAmbientCoeff(0),
+		  m_lightDiffuseCoeff(0),
+		  m_lightSpecularCoeff(0)
+	{
+		TinyRender::Matrix viewMatrix, projectionMatrix;
+		for (int i = 0; i < 4; i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				projectionMatrix[i][j] = projMat[i + 4 * j];
+				viewMatrix[i][j] = viewMat[i + 4 * j];
+			}
+		}
+		m_viewProjectionMatrix = projectionMatrix * viewMatrix;
+	}
+
+	void renderVisible(const btDbvt& tree)
+	{
+		if (!m_cullingEnabled)
+		{
+			if (tree.m_root)
+			{
+				btDbvt::enumLeaves(tree.m_root, *this);
+			}
+			return;
+		}
+		//world space planes of the clip volume -w <= x,y,z <= w, pushed out a little to never cull a visible link
+		btVector3 normals[6];
+		btScalar offsets[6];
+		for (int i = 0; i < 6; i++)
+		{
+			float sign = (i & 1) ? -1.f : 1.f;
+			const TinyRender::Vec4f& row = m_viewProjectionMatrix[i >> 1];
+			const TinyRender::Vec4f& w = m_viewProjectionMatrix[3];
+			normals[i].setValue(w[0] + sign * row[0], w[1] + sign * row[1], w[2] + sign * row[2]);
+			offsets[i] = w[3] + sign * row[3] + btScalar(1e-3) * normals[i].length();
+		}
+		btVector3 viewDirection(-m_viewMat[2], -m_viewMat[6], -m_viewMat[10]);
+		btDbvt::collideOCL(tree.m_root, normals, offsets, viewDirection, 6, *this, true);
+	}
+
+	//true if every pixel the bounds could cover already holds a nearer depth, so all fragments would fail the depth test
+	bool isOccluded(const btDbvtVolume& volume) const
+	{
+		const btVector3& mi = volume.Mins();
+		const btVector3& mx = volume.Maxs();
+		float minX = BT_LARGE_FLOAT, minY = BT_LARGE_FLOAT;
+		float maxX = -BT_LARGE_FLOAT, maxY = -BT_LARGE_FLOAT;
+		float maxDepth = -BT_LARGE_FLOAT;
+		for (int i = 0; i < 8; i++)
+		{
+			TinyRender::Vec4f corner = TinyRender::embed<4>(TinyRender::Vec3f((i & 1) ? mx[0] : mi[0], (i & 2) ? mx[1] : mi[1], (i & 4) ? mx[2] : mi[2]));
+			TinyRender::Vec4f clip = m_viewProjectionMatrix * corner;
+			//the bounds reach behind the camera
+			if (!(clip[3] > 0))
+				return false;
+			TinyRender::Vec4f screen = m_viewportMatrix * clip;
+			minX = btMin(minX, screen[0] / screen[3]);
+			maxX = btMax(maxX, screen[0] / screen[3]);
+			minY = btMin(minY, screen[1] / screen[3]);
+			maxY = btMax(maxY, screen[1] / screen[3]);
+			//the depth buffer holds -z in clip space, which is larger for nearer fragments
+			maxDepth = btMax(maxDepth, -clip[2]);
+		}
+		maxDepth += 1e-4f * (btFabs(maxDepth) + 1.f);
+		int xmin = btMax(0, int(floorf(minX)) - 1);
+		int ymin = btMax(0, int(floorf(minY)) - 1);
+		int xmax = btMin(m_width - 1, int(floorf(maxX)) + 1);
+		int ymax = btMin(m_height - 1, int(floorf(maxY)) + 1);
+		for (int y = ymin; y <= ymax; y++)
+		{
+			const float* depthRow = m_depthBuffer + y * m_width;
+			for (int x = xmin; x <= xmax; x++)
+			{
+				if (depthRow[x] <= maxDepth)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	virtual bool Descent(const btDbvtNode* node)
+	{
+		return !isOccluded(node->volume);
+	}
+
+	virtual void Process(const btDbvtNode* leaf)
+	{
+		Process(leaf, 0);
+	}
+
+	virtual void Process(const btDbvtNode* leaf, btScalar)
+	{
+		TinyRendererObjectArray* visualArray = (TinyRendererObjectArray*)leaf->data;
+		ATTRIBUTE_ALIGNED16(btScalar modelMat[16]);
+		visualArray->m_worldTransform.getOpenGLMatrix(modelMat);
+
+		for (int v = 0; v < visualArray->m_renderObjects.size(); v++)
+		{
+			TinyRenderObjectData* renderObj = visualArray->m_renderObjects[v];
+			for (int i = 0; i < 4; i++)
+			{
+				for (int j = 0; j < 4; j++)
+				{
+					renderObj->m_projectionMatrix[i][j] = m_projMat[i + 4 * j];
+					renderObj->m_modelMatrix[i][j] = modelMat[i + 4 * j];
+					renderObj->m_viewMatrix[i][j] = m_viewMat[i + 4 * j];
+				}
+			}
+			renderObj->m_localScaling = visualArray->m_localScaling;
+			if (m_depthAndSegmentationOnly)
+			{
+				TinyRenderer::renderObjectDepthAndSegmentation(*renderObj, m_viewportMatrix, m_width, m_height, m_depthBuffer, m_segmentationMaskBuffer);
+			}
+			else
+			{
+				renderObj->m_lightDirWorld = m_lightDirWorld;
+				renderObj->m_lightColor = m_lightColor;
+				renderObj->m_lightDistance = m_lightDistance;
+				renderObj->m_lightAmbientCoeff = m_lightAmbientCoeff;
+				renderObj->m_lightDiffuseCoeff = m_lightDiffuseCoeff;
+				renderObj->m_lightSpecularCoeff = m_lightSpecularCoeff;
+				TinyRenderer::renderObject(*renderObj);
+			}
+		}
+	}
+};
+
 void TinyRendererVisualShapeConverter::render(const float viewMat[16], const float projMat[16])
 {
 	//clear the color buffer
@@ -1019,6 +1326,16 @@ void TinyRendererVisualShapeConverter::render(const float viewMat[16], const flo
 	m_data->m_camera.setCameraFrustumNear(near);
 	m_data->m_camera.setCameraFrustumFar(far);
 
+	if (m_data->m_flags & ER_DEPTH_AND_SEGMENTATION_ONLY)
+	{
+		renderDepthAndSegmentation(viewMat, projMat);
+		return;
+	}
+	if (m_data->m_flags & ER_REDUCED_RESOLUTION)
+	{
+		b3Warning("TinyRenderer: ER_REDUCED_RESOLUTION is ignored without ER_DEPTH_AND_SEGMENTATION_ONLY\n");
+	}
+
 	clearBuffers(clearColor);
 
 	ATTRIBUTE_ALIGNED16(btScalar modelMat[16]);
@@ -1114,39 +1431,17 @@ void TinyRendererVisualShapeConverter::render(const float viewMat[16], const flo
 		}
 	}
 
-	for (int n = 0; n < m_data->m_swRenderInstances.size(); n++)
+	m_data->m_objectTree.optimizeIncremental(1);
 	{
-		TinyRendererObjectArray** visualArrayPtr = m_data->m_swRenderInstances.getAtIndex(n);
-		if (0 == visualArrayPtr)
-			continue;  //can this ever happen?
-		TinyRendererObjectArray* visualArray = *visualArrayPtr;
-
-		for (int v = 0; v < visualArray->m_renderObjects.size(); v++)
-		{
-			TinyRenderObjectData* renderObj = visualArray->m_renderObjects[v];
-
-			//sync the object transform
-			const btTransform& tr = visualArray->m_worldTransform;
-			tr.getOpenGLMatrix(modelMat);
-
-			for (int i = 0; i < 4; i++)
-			{
-				for (int j = 0; j < 4; j++)
-				{
-					renderObj->m_projectionMatrix[i][j] = projMat[i + 4 * j];
-					renderObj->m_modelMatrix[i][j] = modelMat[i + 4 * j];
-					renderObj->m_viewMatrix[i][j] = viewMat[i + 4 * j];
-				}
-			}
-			renderObj->m_localScaling = visualArray->m_localScaling;
-			renderObj->m_lightDirWorld = lightDirWorld;
-			renderObj->m_lightColor = lightColor;
-			renderObj->m_lightDistance = lightDistance;
-			renderObj->m_lightAmbientCoeff = lightAmbientCoeff;
-			renderObj->m_lightDiffuseCoeff = lightDiffuseCoeff;
-			renderObj->m_lightSpecularCoeff = lightSpecularCoeff;
-			TinyRenderer::renderObject(*renderObj);
-		}
+		TinyRendererCullingPolicy policy(viewMat, projMat, TinyRender::viewport(0, 0, m_data->m_swWidth, m_data->m_swHeight), m_data->m_swWidth, m_data->m_swHeight, &m_data->m_depthBuffer[0]);
+		policy.m_lightDirWorld = lightDirWorld;
+		policy.m_lightColor = lightColor;
+		policy.m_lightDistance = lightDistance;
+		policy.m_lightAmbientCoeff = lightAmbientCoeff;
+		policy.m_lightDiffuseCoeff = lightDiffuseCoeff;
+		policy.m_lightSpecularCoeff = lightSpecularCoeff;
+		policy.m_cullingEnabled = (m_data->m_flags & ER_NO_CULLING) == 0;
+		policy.renderVisible(m_data->m_objectTree);
 	}
 	//printf("write tga \n");
 	//m_data->m_rgbColorBuffer.write_tga_file("camera.tga");
@@ -1170,6 +1465,94 @@ void TinyRendererVisualShapeConverter::render(const float viewMat[16], const flo
 	}
 }
 
+void TinyRendererVisualShapeConverter::renderDepthAndSegmentation(const float viewMat[16], const float projMat[16])
+{
+	B3_PROFILE("renderDepthAndSegmentation");
+	int width = m_data->m_swWidth;
+	int height = m_data->m_swHeight;
+	TinyRender::Matrix viewportMatrix = TinyRender::viewport(0, 0, width, height);
+	float* depthBuffer = &m_data->m_depthBuffer[0];
+	int* segmentationMaskBuffer = (m_data->m_flags & ER_NO_SEGMENTATION_MASK) ? 0 : &m_data->m_segmentationMaskBuffer[0];
+
+	//the color image stays white, and there is no shadow buffer to clear
+	float farPlane = m_data->m_camera.getCameraFrustumFar();
+	memset(m_data->m_rgbColorBuffer.buffer(), 255, width * height * 3);
+
+	bool reducedResolution = (m_data->m_flags & ER_REDUCED_RESOLUTION) != 0;
+	if (!reducedResolution)
+	{
+		for (int i = 0; i < width * height; i++)
+		{
+			m_data->m_depthBuffer[i] = -farPlane;
+			m_data->m_segmentationMaskBuffer[i] = -1;
+		}
+	}
+	else
+	{
+		//the same viewport scaled by one half, so each reduced pixel is an exact sample of the full resolution image
+		width = (width + 1) / 2;
+		height = (height + 1) / 2;
+		for (int i = 0; i < 2; i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				viewportMatrix[i][j] *= 0.5f;
+			}
+		}
+		m_data->m_reducedDepthBuffer.resize(0);
+		m_data->m_reducedDepthBuffer.resize(width * height, -farPlane);
+		m_data->m_reducedSegmentationMaskBuffer.resize(0);
+		m_data->m_reducedSegmentationMaskBuffer.resize(width * height, -1);
+		depthBuffer = &m_data->m_reducedDepthBuffer[0];
+		segmentationMaskBuffer = segmentationMaskBuffer ? &m_data->m_reducedSegmentationMaskBuffer[0] : 0;
+	}
+
+	m_data->m_objectTree.optimizeIncremental(1);
+	{
+		TinyRendererCullingPolicy policy(viewMat, projMat, viewportMatrix, width, height, depthBuffer);
+		policy.m_depthAndSegmentationOnly = true;
+		policy.m_segmentationMaskBuffer = segmentationMaskBuffer;
+		policy.m_cullingEnabled = (m_data->m_flags & ER_NO_CULLING) == 0;
+		policy.renderVisible(m_data->m_objectTree);
+	}
+
+	//the color buffer only holds the clear color, so only depth and segmentation are flipped.
+	//With ER_REDUCED_RESOLUTION, each pixel takes the nearest reduced sample: this never blends the depth
+	//or object index of different objects along silhouettes, unlike bilinear filtering
+	int fullWidth = m_data->m_swWidth;
+	int fullHeight = m_data->m_swHeight;
+	if (reducedResolution)
+	{
+		for (int y = 0; y < fullHeight; y++)
+		{
+			int srcRow = (y >> 1) * width;
+			int dstRow = (fullHeight - 1 - y) * fullWidth;
+			for (int x = 0; x < fullWidth; x++)
+			{
+				m_data->m_depthBuffer[dstRow + x] = m_data->m_reducedDepthBuffer[srcRow + (x >> 1)];
+				if (segmentationMaskBuffer)
+				{
+					m_data->m_segmentationMaskBuffer[dstRow + x] = m_data->m_reducedSegmentationMaskBuffer[srcRow + (x >> 1)];
+				}
+			}
+		}
+	}
+	else
+	{
+		int half = fullHeight >> 1;
+		for (int j = 0; j < half; j++)
+		{
+			int l1 = j * fullWidth;
+			int l2 = (fullHeight - 1 - j) * fullWidth;
+			for (int i = 0; i < fullWidth; i++)
+			{
+				btSwap(m_data->m_depthBuffer[l1 + i], m_data->m_depthBuffer[l2 + i]);
+				btSwap(m_data->m_segmentationMaskBuffer[l1 + i], m_data->m_segmentationMaskBuffer[l2 + i]);
+			}
+		}
+	}
+}
+
 void TinyRendererVisualShapeConverter::getWidthAndHeight(int& width, int& height)
 {
 	width = m_data->m_swWidth;
@@ -1210,13 +1593,12 @@ void TinyRendererVisualShapeConverter::copyCameraImageData(unsigned char* pixels
 	int numRequestedPixels = btMin(rgbaBufferSizeInPixels, numRemainingPixels);
 	if (numRequestedPixels)
 	{
+		float farPlane = m_data->m_camera.getCameraFrustumFar();
+		float nearPlane = m_data->m_camera.getCameraFrustumNear();
 		for (int i = 0; i < numRequestedPixels; i++)
 		{
 			if (depthBuffer)
 			{
-				float farPlane = m_data->m_camera.getCameraFrustumFar();
-				float nearPlane = m_data->m_camera.getCameraFrustumNear();
-
 				// TinyRenderer returns clip coordinates, transform to eye coordinates first
 				float z_c = -m_data->m_depthBuffer[i + startPixelIndex];
 				// float distance = (farPlane - nearPlane) / (farPlane + nearPlane) * (z_c + 2. * farPlane * nearPlane / (farPlane - nearPlane));
@@ -1271,9 +1653,14 @@ void TinyRendererVisualShapeConverter::removeVisualShape(int collisionObjectUniq
 			{
 				delete ptr->m_renderObjects[o];
 			}
+			if (ptr->m_treeNode)
+			{
+				m_data->m_objectTree.remove(ptr->m_treeNode);
+			}
 		}
 		delete ptr;
 		m_data->m_swRenderInstances.remove(collisionObjectUniqueId);
+		m_data->releaseSharedModels(true);
 	}
 }
 
@@ -1306,6 +1693,8 @@ void TinyRendererVisualShapeConverter::resetAll()
 	m_data->m_textures.clear();
 	m_data->m_swRenderInstances.clear();
 	m_data->m_visualShapesMap.clear();
+	m_data->releaseSharedModels(false);
+	m_data->m_objectTree.clear();
 }
 
 void TinyRendererVisualShapeConverter::changeShapeTexture(int objectUniqueId, int jointIndex, int shapeIndex, int textureUniqueId)
@@ -1330,15 +1719,16 @@ void TinyRendererVisualShapeConverter::changeShapeTexture(int objectUniqueId, in
 					{
 						if (textureUniqueId>=0)
 						{
-							renderObj->m_model->setDiffuseTextureFromData(m_data->m_textures[textureUniqueId].textureData1, m_data->m_textures[textureUniqueId].m_width, m_data->m_textures[textureUniqueId].m_height);
+							renderObj->getUniqueModel()->setDiffuseTextureFromData(m_data->m_textures[textureUniqueId].textureData1, m_data->m_textures[textureUniqueId].m_width, m_data->m_textures[textureUniqueId].m_height);
 						} else
 						{
-							renderObj->m_model->setDiffuseTextureFromData(0,0,0);
+							renderObj->getUniqueModel()->setDiffuseTextureFromData(0,0,0);
 						}
 					}
 				}
 			}
 		}
+		m_data->releaseSharedModels(true);
 	}
 }
 
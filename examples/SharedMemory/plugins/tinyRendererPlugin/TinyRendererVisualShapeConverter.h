@@ -48,6 +48,7 @@ struct TinyRendererVisualShapeConverter : public UrdfRenderingInterface
 
 	virtual void render();
 	virtual void render(const float viewMat[16], const float projMat[16]);
+	void renderDepthAndSegmentation(const float viewMat[16], const float projMat[16]);
 
 	virtual int loadTextureFile(const char* filename, struct CommonFileIOInterface* fileIO);
 	virtual int registerTexture(unsigned char* texels, int width, int height);
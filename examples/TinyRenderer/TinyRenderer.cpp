@@ -422,9 +422,30 @@ void TinyRenderObjectData::createCube(float halfExtentsX, float halfExtentsY, fl
 	}
 }
 
+void TinyRenderObjectData::shareModel(Model* model)
+{
+	btAssert(m_model == 0);
+	model->addReference();
+	m_model = model;
+}
+
+Model* TinyRenderObjectData::getUniqueModel()
+{
+	if (m_model && m_model->getReferenceCount() > 1)
+	{
+		Model* model = m_model->clone();
+		m_model->removeReference();
+		m_model = model;
+	}
+	return m_model;
+}
+
 TinyRenderObjectData::~TinyRenderObjectData()
 {
-	delete m_model;
+	if (m_model && m_model->removeReference() == 0)
+	{
+		delete m_model;
+	}
 }
 
 static bool equals(const Vec4f& vA, const Vec4f& vB)
@@ -643,3 +664,179 @@ void TinyRenderer::renderObjectDepth(TinyRenderObjectData& renderData)
 		}
 	}
 }
+
+//rasterizes a clip space triangle with edge functions, without calling a shader per fragment.
+//Both the barycentric coordinates and the perspective correct depth (sum b_i z_i/w_i / sum b_i/w_i) are affine in screen space.
+static void rasterizeDepthAndSegmentation(const mat<4, 3, float>& clipc, const Matrix& viewportMatrix, int width, int height, float nearPlane, float farPlane, float* zbuffer, int* segmentationMaskBuffer, int objectAndLinkIndex)
+{
+	mat<3, 4, float> pts = (viewportMatrix * clipc).transpose();
+
+	Vec2f pts2[3];
+	float invW[3];
+	float zOverW[3];
+	for (int i = 0; i < 3; i++)
+	{
+		invW[i] = 1.f / pts[i][3];
+		pts2[i] = Vec2f(pts[i][0] * invW[i], pts[i][1] * invW[i]);
+		zOverW[i] = clipc[2][i] * invW[i];
+	}
+
+	float area = (pts2[1].x - pts2[0].x) * (pts2[2].y - pts2[0].y) - (pts2[2].x - pts2[0].x) * (pts2[1].y - pts2[0].y);
+	//same threshold as barycentric() for degenerate triangles
+	if (std::abs(area) <= 1e-2)
+		return;
+
+	float bboxminX = b3Max(0.f, b3Min(pts2[0].x, b3Min(pts2[1].x, pts2[2].x)));
+	float bboxminY = b3Max(0.f, b3Min(pts2[0].y, b3Min(pts2[1].y, pts2[2].y)));
+	float bboxmaxX = b3Min(float(width - 1), b3Max(pts2[0].x, b3Max(pts2[1].x, pts2[2].x)));
+	float bboxmaxY = b3Min(float(height - 1), b3Max(pts2[0].y, b3Max(pts2[1].y, pts2[2].y)));
+	if (bboxmaxX < bboxminX || bboxmaxY < bboxminY)
+		return;
+
+	//edge function of the edge opposite to vertex i, normalized so it is the barycentric coordinate of vertex i
+	float edgeX[3], edgeY[3], edgeC[3];
+	float invArea = 1.f / area;
+	for (int i = 0; i < 3; i++)
+	{
+		const Vec2f& a = pts2[(i + 1) % 3];
+		const Vec2f& b = pts2[(i + 2) % 3];
+		edgeX[i] = -(b.y - a.y) * invArea;
+		edgeY[i] = (b.x - a.x) * invArea;
+		edgeC[i] = ((b.y - a.y) * a.x - (b.x - a.x) * a.y) * invArea;
+	}
+	float numX = 0.f, numY = 0.f, numC = 0.f;
+	float denX = 0.f, denY = 0.f, denC = 0.f;
+	for (int i = 0; i < 3; i++)
+	{
+		numX += edgeX[i] * zOverW[i];
+		numY += edgeY[i] * zOverW[i];
+		numC += edgeC[i] * zOverW[i];
+		denX += edgeX[i] * invW[i];
+		denY += edgeY[i] * invW[i];
+		denC += edgeC[i] * invW[i];
+	}
+
+	int xmin = int(bboxminX);
+	int xmax = int(bboxmaxX);
+	int ymin = int(bboxminY);
+	int ymax = int(bboxmaxY);
+	for (int y = ymin; y <= ymax; y++)
+	{
+		float b0Row = edgeY[0] * y + edgeC[0];
+		float b1Row = edgeY[1] * y + edgeC[1];
+		float b2Row = edgeY[2] * y + edgeC[2];
+		float numRow = numY * y + numC;
+		float denRow = denY * y + denC;
+		float* zbufferRow = zbuffer + y * width;
+		int* segmentationMaskRow = segmentationMaskBuffer ? segmentationMaskBuffer + y * width : 0;
+		for (int x = xmin; x <= xmax; x++)
+		{
+			float b0 = edgeX[0] * x + b0Row;
+			float b1 = edgeX[1] * x + b1Row;
+			float b2 = edgeX[2] * x + b2Row;
+			if (b0 < 0 || b1 < 0 || b2 < 0)
+				continue;
+			float fragDepth = -(numX * x + numRow) / (denX * x + denRow);
+			if (zbufferRow[x] > fragDepth || fragDepth < -farPlane || fragDepth > nearPlane)
+				continue;
+			zbufferRow[x] = fragDepth;
+			if (segmentationMaskRow)
+			{
+				segmentationMaskRow[x] = objectAndLinkIndex;
+			}
+		}
+	}
+}
+
+static bool sameMatrix(const Matrix& a, const Matrix& b)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		for (int j = 0; j < 4; j++)
+		{
+			if (a[i][j] != b[i][j])
+				return false;
+		}
+	}
+	return true;
+}
+
+void TinyRenderer::renderObjectDepthAndSegmentation(TinyRenderObjectData& renderData, const Matrix& viewportMatrix, int width, int height, float* depthBuffer, int* segmentationMaskBuffer)
+{
+	B3_PROFILE("renderObjectDepthAndSegmentation");
+	Model* model = renderData.m_model;
+	if (0 == model)
+		return;
+	//discard invisible objects (zero alpha)
+	if (model->getColorRGBA()[3] == 0)
+		return;
+
+	Matrix& projectionMatrix = renderData.m_projectionMatrix;
+	float nearPlane = projectionMatrix.col(3)[2] / (projectionMatrix.col(2)[2] - 1);
+	float farPlane = projectionMatrix.col(3)[2] / (projectionMatrix.col(2)[2] + 1);
+	int objectAndLinkIndex = renderData.m_objectIndex + ((renderData.m_linkIndex + 1) << 24);
+
+	//static objects seen from the same camera reuse the clip space vertices and front faces of the previous image
+	b3AlignedObjectArray<Vec4f>& clipVertices = renderData.m_cachedClipVertices;
+	b3AlignedObjectArray<int>& frontFaces = renderData.m_cachedFrontFaces;
+	if (clipVertices.size() != model->nverts() ||
+		!sameMatrix(renderData.m_cachedModelMatrix, renderData.m_modelMatrix) ||
+		!sameMatrix(renderData.m_cachedViewMatrix, renderData.m_viewMatrix) ||
+		!sameMatrix(renderData.m_cachedProjectionMatrix, projectionMatrix) ||
+		renderData.m_cachedLocalScaling != renderData.m_localScaling)
+	{
+		Matrix projectionModelViewMatrix = projectionMatrix * (renderData.m_viewMatrix * renderData.m_modelMatrix);
+		Matrix viewMatrixInv = renderData.m_viewMatrix.invert();
+		btVector3 P(viewMatrixInv[0][3], viewMatrixInv[1][3], viewMatrixInv[2][3]);
+
+		//transform each vertex once, instead of once for every face that uses it
+		b3AlignedObjectArray<btVector3> worldVertices;
+		clipVertices.resize(model->nverts());
+		worldVertices.resize(model->nverts());
+		for (int i = 0; i < model->nverts(); i++)
+		{
+			Vec3f unScaledVert = model->vert(i);
+			Vec4f scaledVert = embed<4>(Vec3f(unScaledVert[0] * renderData.m_localScaling[0],
+											  unScaledVert[1] * renderData.m_localScaling[1],
+											  unScaledVert[2] * renderData.m_localScaling[2]));
+			clipVertices[i] = projectionModelViewMatrix * scaledVert;
+			Vec4f worldVertex = renderData.m_modelMatrix * scaledVert;
+			worldVertices[i].setValue(worldVertex[0], worldVertex[1], worldVertex[2]);
+		}
+
+		// backface culling, same as renderObject
+		frontFaces.resize(0);
+		for (int i = 0; i < model->nfaces(); i++)
+		{
+			const btVector3& v0 = worldVertices[model->vertIndex(i, 0)];
+			btVector3 N = (worldVertices[model->vertIndex(i, 1)] - v0).cross(worldVertices[model->vertIndex(i, 2)] - v0);
+			if (!((v0 - P).dot(N) >= 0))
+			{
+				frontFaces.push_back(i);
+			}
+		}
+
+		renderData.m_cachedModelMatrix = renderData.m_modelMatrix;
+		renderData.m_cachedViewMatrix = renderData.m_viewMatrix;
+		renderData.m_cachedProjectionMatrix = projectionMatrix;
+		renderData.m_cachedLocalScaling = renderData.m_localScaling;
+	}
+
+	mat<4, 3, float> clipTriangle;
+	for (int f = 0; f < frontFaces.size(); f++)
+	{
+		int i = frontFaces[f];
+		clipTriangle.set_col(0, clipVertices[model->vertIndex(i, 0)]);
+		clipTriangle.set_col(1, clipVertices[model->vertIndex(i, 1)]);
+		clipTriangle.set_col(2, clipVertices[model->vertIndex(i, 2)]);
+
+		mat<4, 3, float> stackTris[3];
+		b3AlignedObjectArray<mat<4, 3, float> > clippedTriangles;
+		clippedTriangles.initializeFromBuffer(stackTris, 0, 3);
+		clipTriangleAgainstNearplane(clipTriangle, clippedTriangles);
+		for (int t = 0; t < clippedTriangles.size(); t++)
+		{
+			rasterizeDepthAndSegmentation(clippedTriangles[t], viewportMatrix, width, height, nearPlane, farPlane, depthBuffer, segmentationMaskBuffer, objectAndLinkIndex);
+		}
+	}
+}
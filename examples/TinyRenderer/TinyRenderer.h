@@ -49,6 +49,20 @@ struct TinyRenderObjectData
 
 	void registerMesh2(btAlignedObjectArray<btVector3>& vertices, btAlignedObjectArray<btVector3>& normals, btAlignedObjectArray<int>& indices, struct CommonFileIOInterface* fileIO);
 
+	//uses the model of another instance instead of a copy of its vertices, indices and texture
+	void shareModel(TinyRender::Model* model);
+	//returns the model after making it private to this instance, before changing its color or texture
+	TinyRender::Model* getUniqueModel();
+
+	//clip space vertices and front facing triangles of the last renderObjectDepthAndSegmentation,
+	//reused as long as the model, view and projection matrices and the scaling stay the same
+	b3AlignedObjectArray<TinyRender::Vec4f> m_cachedClipVertices;
+	b3AlignedObjectArray<int> m_cachedFrontFaces;
+	TinyRender::Matrix m_cachedModelMatrix;
+	TinyRender::Matrix m_cachedViewMatrix;
+	TinyRender::Matrix m_cachedProjectionMatrix;
+	btVector3 m_cachedLocalScaling;
+
 	void* m_userData;
 	int m_userIndex;
 	int m_objectIndex;
@@ -60,6 +74,8 @@ class TinyRenderer
 public:
 	static void renderObjectDepth(TinyRenderObjectData& renderData);
 	static void renderObject(TinyRenderObjectData& renderData);
+	//only writes depth and the object/link index, without shading, textures or shadows (segmentationMaskBuffer can be null)
+	static void renderObjectDepthAndSegmentation(TinyRenderObjectData& renderData, const TinyRender::Matrix& viewportMatrix, int width, int height, float* depthBuffer, int* segmentationMaskBuffer);
 };
 
 #endif  // TINY_RENDERER_Hbla
@@ -1,6 +1,7 @@
 
 #include "model.h"
 #include <string.h>  // memcpy
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iostream>
@@ -9,7 +10,7 @@
 
 namespace TinyRender
 {
-Model::Model(const char *filename) : verts_(), faces_(), norms_(), uv_(), diffusemap_(), normalmap_(), specularmap_()
+Model::Model(const char *filename) : verts_(), faces_(), norms_(), uv_(), diffusemap_(), normalmap_(), specularmap_(), m_referenceCount(1)
 {
 	std::ifstream in;
 	in.open(filename, std::ifstream::in);
@@ -60,10 +61,51 @@ Model::Model(const char *filename) : verts_(), faces_(), norms_(), uv_(), diffus
 	load_texture(filename, "_spec.tga", specularmap_);
 }
 
-Model::Model() : verts_(), faces_(), norms_(), uv_(), diffusemap_(), normalmap_(), specularmap_()
+Model::Model() : verts_(), faces_(), norms_(), uv_(), diffusemap_(), normalmap_(), specularmap_(), m_referenceCount(1)
 {
 }
 
+Model *Model::clone() const
+{
+	Model *model = new Model(*this);
+	model->m_referenceCount = 1;
+	return model;
+}
+
+bool Model::isSameMesh(const float *vertices, int numVertices, const int *indices, int numIndices) const
+{
+	if (numVertices != (int)verts_.size() || numIndices != 3 * (int)faces_.size())
+		return false;
+	for (int i = 0; i < numVertices; i++)
+	{
+		const float *v = &vertices[i * 9];
+		if (verts_[i][0] != v[0] || verts_[i][1] != v[1] || verts_[i][2] != v[2] ||
+			norms_[i][0] != v[4] || norms_[i][1] != v[5] || norms_[i][2] != v[6] ||
+			uv_[i][0] != v[7] || uv_[i][1] != v[8])
+			return false;
+	}
+	for (int i = 0; i < numIndices; i++)
+	{
+		if (faces_[i / 3][i % 3][0] != indices[i])
+			return false;
+	}
+	return true;
+}
+
+void Model::getAabb(Vec3f &aabbMin, Vec3f &aabbMax) const
+{
+	aabbMin = Vec3f(1e30f, 1e30f, 1e30f);
+	aabbMax = Vec3f(-1e30f, -1e30f, -1e30f);
+	for (int i = 0; i < (int)verts_.size(); i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			aabbMin[j] = std::min(aabbMin[j], verts_[i][j]);
+			aabbMax[j] = std::max(aabbMax[j], verts_[i][j]);
+		}
+	}
+}
+
 void Model::setDiffuseTextureFromData(unsigned char *textureImage, int textureWidth, int textureHeight)
 {
 	{
@@ -146,6 +188,11 @@ Vec3f Model::vert(int iface, int nthvert)
 	return verts_[faces_[iface][nthvert][0]];
 }
 
+int Model::vertIndex(int iface, int nthvert)
+{
+	return faces_[iface][nthvert][0];
+}
+
 void Model::load_texture(std::string filename, const char *suffix, TGAImage &img)
 {
 	std::string texfile(filename);
@@ -18,6 +18,7 @@ private:
 	TGAImage normalmap_;
 	TGAImage specularmap_;
 	Vec4f m_colorRGBA;
+	int m_referenceCount;
 
 	void load_texture(std::string filename, const char* suffix, TGAImage& img);
 
@@ -34,6 +35,24 @@ public:
 	{
 		return m_colorRGBA;
 	}
+	//a model can be shared by several TinyRenderObjectData, the last one to release it deletes it
+	int addReference()
+	{
+		return ++m_referenceCount;
+	}
+	int removeReference()
+	{
+		return --m_referenceCount;
+	}
+	int getReferenceCount() const
+	{
+		return m_referenceCount;
+	}
+	//an unshared copy, for changing the color or texture of one instance
+	Model* clone() const;
+	//true if the model holds exactly the vertices (x,y,z,w,nx,ny,nz,u,v) and triangles given to registerMeshShape
+	bool isSameMesh(const float* vertices, int numVertices, const int* indices, int numIndices) const;
+	void getAabb(Vec3f& aabbMin, Vec3f& aabbMax) const;
 	void loadDiffuseTexture(const char* relativeFileName);
 	void setDiffuseTextureFromData(unsigned char* textureImage, int textureWidth, int textureHeight);
 	void reserveMemory(int numVertices, int numIndices);
@@ -49,6 +68,7 @@ public:
 	Vec3f normal(Vec2f uv);
 	Vec3f vert(int i);
 	Vec3f vert(int iface, int nthvert);
+	int vertIndex(int iface, int nthvert);
 	Vec2f uv(int iface, int nthvert);
 	TGAColor diffuse(Vec2f uv);
 	float specular(Vec2f uv);
@@ -0,0 +1,34 @@
+import pybullet as p
+import time
+
+#times getCameraImage with TinyRenderer for the full shading path and the depth and segmentation only paths
+p.connect(p.DIRECT)
+p.loadURDF("plane.urdf")
+for x in range(4):
+  for y in range(4):
+    p.loadURDF("r2d2.urdf", [x - 1.5, y - 1.5, 0.5])
+
+width = 640
+height = 480
+numFrames = 30
+viewMatrix = p.computeViewMatrix([0, -6, 3], [0, 0, 0.5], [0, 0, 1])
+projectionMatrix = p.computeProjectionMatrixFOV(60, width / float(height), 0.1, 20)
+
+modes = [("full shading, shadow", 1, 0), ("full shading", 0, 0),
+         ("depth and segmentation", 0, p.ER_DEPTH_AND_SEGMENTATION_ONLY),
+         ("depth and segmentation, reduced", 0,
+          p.ER_DEPTH_AND_SEGMENTATION_ONLY | p.ER_REDUCED_RESOLUTION),
+         ("depth, reduced", 0, p.ER_DEPTH_AND_SEGMENTATION_ONLY | p.ER_REDUCED_RESOLUTION |
+          p.ER_NO_SEGMENTATION_MASK)]
+
+for name, shadow, flags in modes:
+  start = time.time()
+  for i in range(numFrames):
+    p.getCameraImage(width,
+                     height,
+                     viewMatrix,
+                     projectionMatrix,
+                     shadow=shadow,
+                     flags=flags,
+                     renderer=p.ER_TINY_RENDERER)
+  print("%s: %.2f ms per image" % (name, 1000. * (time.time() - start) / numFrames))
@@ -5458,6 +5458,134 @@ static PyObject* pybullet_getJointStates(PyObject* self, PyObject* args, PyObjec
 	Py_INCREF(Py_None);
 	return Py_None;
 }
+//returns a numpy array (or tuple without numpy) with numRows rows of numColumns values, or a flat one for numRows < 0
+static PyObject* pybullet_batchedActualStateArray(const double* values, int numRows, int numColumns)
+{
+	int numValues = numRows < 0 ? numColumns : numRows * numColumns;
+#ifdef PYBULLET_USE_NUMPY
+	PyObject* pyArray;
+	npy_intp dims[2] = {numRows, numColumns};
+	if (numRows < 0)
+	{
+		pyArray = PyArray_SimpleNew(1, &dims[1], NPY_FLOAT64);
+	}
+	else
+	{
+		pyArray = PyArray_SimpleNew(2, dims, NPY_FLOAT64);
+	}
+	if (numValues)
+	{
+		memcpy(PyArray_DATA(pyArray), values, numValues * sizeof(double));
+	}
+	return pyArray;
+#else   //PYBULLET_USE_NUMPY
+	int i, j;
+	PyObject* pyTuple;
+	if (numRows < 0)
+	{
+		pyTuple = PyTuple_New(numColumns);
+		for (j = 0; j < numColumns; j++)
+		{
+			PyTuple_SetItem(pyTuple, j, PyFloat_FromDouble(values[j]));
+		}
+		return pyTuple;
+	}
+	pyTuple = PyTuple_New(numRows);
+	for (i = 0; i < numRows; i++)
+	{
+		PyObject* pyRow = PyTuple_New(numColumns);
+		for (j = 0; j < numColumns; j++)
+		{
+			PyTuple_SetItem(pyRow, j, PyFloat_FromDouble(values[i * numColumns + j]));
+		}
+		PyTuple_SetItem(pyTuple, i, pyRow);
+	}
+	return pyTuple;
+#endif  //PYBULLET_USE_NUMPY
+}
+
+static PyObject* pybullet_getBatchedActualStates(PyObject* self, PyObject* args, PyObject* keywds)
+{
+	PyObject* bodyUniqueIdsObj = 0;
+	PyObject* bodyUniqueIdsSeq = 0;
+	PyObject* pyResultList = 0;
+	int fields = BATCHED_STATE_ALL_FIELDS;
+	int computeForwardKinematics = 0;
+	int numBodies = 0;
+	int* bodyUniqueIds = 0;
+	int i;
+	int statusType;
+	struct b3BatchedActualStateData stateData;
+	b3SharedMemoryCommandHandle commandHandle;
+	b3SharedMemoryStatusHandle statusHandle;
+	b3PhysicsClientHandle sm = 0;
+	int physicsClientId = 0;
+	static char* kwlist[] = {"bodyUniqueIds", "fields", "computeForwardKinematics", "physicsClientId", NULL};
+	if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|iii", kwlist, &bodyUniqueIdsObj, &fields, &computeForwardKinematics, &physicsClientId))
+	{
+		return NULL;
+	}
+	sm = getPhysicsClient(physicsClientId);
+	if (sm == 0)
+	{
+		PyErr_SetString(SpamError, "Not connected to physics server.");
+		return NULL;
+	}
+
+	bodyUniqueIdsSeq = PySequence_Fast(bodyUniqueIdsObj, "expected a sequence of body unique ids");
+	if (bodyUniqueIdsSeq == 0)
+	{
+		return NULL;
+	}
+	numBodies = PySequence_Size(bodyUniqueIdsObj);
+	if (numBodies)
+	{
+		bodyUniqueIds = (int*)malloc(numBodies * sizeof(int));
+		for (i = 0; i < numBodies; i++)
+		{
+			bodyUniqueIds[i] = pybullet_internalGetIntFromSequence(bodyUniqueIdsSeq, i);
+		}
+	}
+	Py_DECREF(bodyUniqueIdsSeq);
+
+	commandHandle = b3RequestBatchedActualStateCommandInit(sm, bodyUniqueIds, numBodies, fields);
+	b3RequestBatchedActualStateComputeForwardKinematics(commandHandle, computeForwardKinematics);
+	statusHandle = b3SubmitClientCommandAndWaitStatus(sm, commandHandle);
+	statusType = b3GetStatusType(statusHandle);
+	free(bodyUniqueIds);
+	if (statusType != CMD_BATCHED_ACTUAL_STATE_COMPLETED)
+	{
+		PyErr_SetString(SpamError, "getBatchedActualStates failed.");
+		return NULL;
+	}
+
+	b3GetBatchedActualStateData(sm, &stateData);
+	pyResultList = PyTuple_New(stateData.m_numBodies);
+	for (i = 0; i < stateData.m_numBodies; i++)
+	{
+		const struct b3BatchedActualStateBody* body = &stateData.m_bodies[i];
+		int offsets[5] = {body->m_positionOffset, body->m_velocityOffset, body->m_linkPoseOffset, body->m_linkVelocityOffset, body->m_jointReactionForceOffset};
+		int numRows[5] = {-1, -1, body->m_numLinks, body->m_numLinks, body->m_numLinks};
+		int numColumns[5] = {body->m_numPositions, body->m_numVelocities, 7, 6, 6};
+		int f;
+		PyObject* pyBodyState = PyTuple_New(5);
+		for (f = 0; f < 5; f++)
+		{
+			if (offsets[f] < 0)
+			{
+				Py_INCREF(Py_None);
+				PyTuple_SetItem(pyBodyState, f, Py_None);
+			}
+			else
+			{
+				PyTuple_SetItem(pyBodyState, f, pybullet_batchedActualStateArray(&stateData.m_values[offsets[f]], numRows[f], numColumns[f]));
+			}
+		}
+		PyTuple_SetItem(pyResultList, i, pyBodyState);
+	}
+	return pyResultList;
+}
+
 static PyObject* pybullet_getLinkState(PyObject* self, PyObject* args, PyObject* keywds)
 {
 	PyObject* pyLinkState;
@@ -12073,6 +12201,12 @@ static PyMethodDef SpamMethods[] = {
 	{"getJointStates", (PyCFunction)pybullet_getJointStates, METH_VARARGS | METH_KEYWORDS,
 	 "Get the state (position, velocity etc) for multiple joints on a body."},
 
+	{"getBatchedActualStates", (PyCFunction)pybullet_getBatchedActualStates, METH_VARARGS | METH_KEYWORDS,
+	 "Get the state of multiple bodies in one command, returns per body (positions, velocities, linkPoses,\n"
+	 "linkVelocities, jointReactionForces), numpy arrays if enabled, None for fields that are not requested.\n"
+	 "  = getBatchedActualStates(bodyUniqueIds, fields=BATCHED_STATE_ALL_FIELDS,\n"
+	 "                           computeForwardKinematics=0, physicsClientId=0)"},
+
 	 { "getJointStateMultiDof", (PyCFunction)pybullet_getJointStateMultiDof, METH_VARARGS | METH_KEYWORDS,
 		"Get the state (position, velocity etc) for a joint on a body. (supports planar and spherical joints)" },
 
@@ -12586,6 +12720,9 @@ initpybullet(void)
 	PyModule_AddIntConstant(m, "ER_BULLET_HARDWARE_OPENGL", ER_BULLET_HARDWARE_OPENGL);
 	PyModule_AddIntConstant(m, "ER_SEGMENTATION_MASK_OBJECT_AND_LINKINDEX", ER_SEGMENTATION_MASK_OBJECT_AND_LINKINDEX);
 	PyModule_AddIntConstant(m, "ER_NO_SEGMENTATION_MASK", ER_NO_SEGMENTATION_MASK);
+	PyModule_AddIntConstant(m, "ER_DEPTH_AND_SEGMENTATION_ONLY", ER_DEPTH_AND_SEGMENTATION_ONLY);
+	PyModule_AddIntConstant(m, "ER_REDUCED_RESOLUTION", ER_REDUCED_RESOLUTION);
+	PyModule_AddIntConstant(m, "ER_NO_CULLING", ER_NO_CULLING);
 	PyModule_AddIntConstant(m, "ER_USE_PROJECTIVE_TEXTURE", ER_USE_PROJECTIVE_TEXTURE);
 
 	PyModule_AddIntConstant(m, "IK_DLS", IK_DLS);
@@ -12676,6 +12813,13 @@ initpybullet(void)
 	PyModule_AddIntConstant(m, "STATE_LOG_JOINT_USER_TORQUES", STATE_LOG_JOINT_USER_TORQUES);
 	PyModule_AddIntConstant(m, "STATE_LOG_JOINT_TORQUES", STATE_LOG_JOINT_USER_TORQUES + STATE_LOG_JOINT_MOTOR_TORQUES);
 
+	PyModule_AddIntConstant(m, "BATCHED_STATE_JOINT_POSITIONS", BATCHED_STATE_JOINT_POSITIONS);
+	PyModule_AddIntConstant(m, "BATCHED_STATE_JOINT_VELOCITIES", BATCHED_STATE_JOINT_VELOCITIES);
+	PyModule_AddIntConstant(m, "BATCHED_STATE_LINK_POSES", BATCHED_STATE_LINK_POSES);
+	PyModule_AddIntConstant(m, "BATCHED_STATE_LINK_VELOCITIES", BATCHED_STATE_LINK_VELOCITIES);
+	PyModule_AddIntConstant(m, "BATCHED_STATE_JOINT_REACTION_FORCES", BATCHED_STATE_JOINT_REACTION_FORCES);
+	PyModule_AddIntConstant(m, "BATCHED_STATE_ALL_FIELDS", BATCHED_STATE_ALL_FIELDS);
+
 	PyModule_AddIntConstant(m, "AddFileIOAction", eAddFileIOAction);
 	PyModule_AddIntConstant(m, "RemoveFileIOAction", eRemoveFileIOAction);
 
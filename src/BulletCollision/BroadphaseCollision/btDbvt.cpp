@@ -69,48 +69,113 @@ static void getmaxdepth(const btDbvtNode* node, int depth, int& maxdepth)
 }
 
 //
-static DBVT_INLINE void deletenode(btDbvt* pdbvt,
-								   btDbvtNode* node)
+static void refitnode(btDbvtNode* node)
 {
-	btAlignedFree(pdbvt->m_free);
-	pdbvt->m_free = node;
+	if (node->isinternal())
+	{
+		refitnode(node->childs[0]);
+		refitnode(node->childs[1]);
+		Merge(node->childs[0]->volume, node->childs[1]->volume, node->volume);
+	}
 }
 
 //
-static void recursedeletenode(btDbvt* pdbvt,
-							  btDbvtNode* node)
+btDbvtNode* btDbvtNodePool::allocate()
 {
-	if (node == 0) return;
-	if (!node->isleaf())
+	btDbvtNode* node;
+	if (m_free)
 	{
-		recursedeletenode(pdbvt, node->childs[0]);
-		recursedeletenode(pdbvt, node->childs[1]);
+		node = m_free;
+		m_free = node->parent;
+	}
+	else
+	{
+		if ((m_blocks.size() == 0) || (m_lastBlockUsed == m_blockSizes[m_blocks.size() - 1]))
+		{
+			//grow geometrically, so a tree of n nodes lives in O(log n) blocks
+			const int blockSize = btMax(64, m_capacity);
+			m_blocks.push_back((btDbvtNode*)btAlignedAlloc(sizeof(btDbvtNode) * blockSize, 16));
+			m_blockSizes.push_back(blockSize);
+			m_capacity += blockSize;
+			m_lastBlockUsed = 0;
+		}
+		node = &m_blocks[m_blocks.size() - 1][m_lastBlockUsed++];
 	}
-	if (node == pdbvt->m_root) pdbvt->m_root = 0;
-	deletenode(pdbvt, node);
+	++m_numNodes;
+	return (node);
 }
 
 //
-static DBVT_INLINE btDbvtNode* createnode(btDbvt* pdbvt,
-										  btDbvtNode* parent,
-										  void* data)
+void btDbvtNodePool::deallocate(btDbvtNode* node)
 {
-	btDbvtNode* node;
-	if (pdbvt->m_free)
+	node->parent = m_free;
+	m_free = node;
+	--m_numNodes;
+}
+
+//
+void btDbvtNodePool::clear()
+{
+	for (int i = 0; i < m_blocks.size(); ++i)
 	{
-		node = pdbvt->m_free;
-		pdbvt->m_free = 0;
+		btAlignedFree(m_blocks[i]);
 	}
+	m_blocks.clear();
+	m_blockSizes.clear();
+	m_free = 0;
+	m_lastBlockUsed = 0;
+	m_capacity = 0;
+	m_numNodes = 0;
+}
+
+//
+void btDbvtNodePool::adoptBlock(btDbvtNode* block, int capacity, int numNodes)
+{
+	clear();
+	m_blocks.push_back(block);
+	m_blockSizes.push_back(capacity);
+	m_capacity = capacity;
+	m_lastBlockUsed = numNodes;
+	m_numNodes = numNodes;
+}
+
+//
+static DBVT_INLINE void deletenode(btDbvt* pdbvt,
+								   btDbvtNode* node)
+{
+	if (node->isleaf())
+		pdbvt->m_leafNodes.deallocate(node);
 	else
-	{
-		node = new (btAlignedAlloc(sizeof(btDbvtNode), 16)) btDbvtNode();
-	}
+		pdbvt->m_internalNodes.deallocate(node);
+}
+
+//
+static DBVT_INLINE btDbvtNode* createnode(btDbvt* pdbvt,
+										  btDbvtNode* parent,
+										  void* data)
+{
+	btDbvtNode* node = pdbvt->m_internalNodes.allocate();
+	++pdbvt->m_internalNodesSinceLayout;
 	node->parent = parent;
 	node->data = data;
 	node->childs[1] = 0;
 	return (node);
 }
 
+//
+static DBVT_INLINE btDbvtNode* createleaf(btDbvt* pdbvt,
+										  btDbvtNode* parent,
+										  const btDbvtVolume& volume,
+										  void* data)
+{
+	btDbvtNode* node = pdbvt->m_leafNodes.allocate();
+	node->parent = parent;
+	node->data = data;
+	node->childs[1] = 0;
+	node->volume = volume;
+	return (node);
+}
+
 //
 static DBVT_INLINE btDbvtNode* createnode(btDbvt* pdbvt,
 										  btDbvtNode* parent,
@@ -461,10 +526,11 @@ static DBVT_INLINE btDbvtNode*	walkup(btDbvtNode* n,int count)
 btDbvt::btDbvt()
 {
 	m_root = 0;
-	m_free = 0;
 	m_lkhd = -1;
 	m_leaves = 0;
 	m_opath = 0;
+	m_relayoutPercent = 50;
+	m_internalNodesSinceLayout = 0;
 }
 
 //
@@ -476,10 +542,11 @@ btDbvt::~btDbvt()
 //
 void btDbvt::clear()
 {
-	if (m_root)
-		recursedeletenode(this, m_root);
-	btAlignedFree(m_free);
-	m_free = 0;
+	//all nodes live in the pools, so there is no need to walk the tree
+	m_root = 0;
+	m_internalNodes.clear();
+	m_leafNodes.clear();
+	m_internalNodesSinceLayout = 0;
 	m_lkhd = -1;
 	m_stkStack.clear();
 	m_opath = 0;
@@ -495,6 +562,8 @@ void btDbvt::optimizeBottomUp()
 		fetchleaves(this, m_root, leaves);
 		bottomup(this, &leaves[0], leaves.size());
 		m_root = leaves[0];
+		if (m_relayoutPercent > 0)
+			optimizeNodeLayout();
 	}
 }
 
@@ -507,6 +576,8 @@ void btDbvt::optimizeTopDown(int bu_treshold)
 		leaves.reserve(m_leaves);
 		fetchleaves(this, m_root, leaves);
 		m_root = topdown(this, &leaves[0], leaves.size(), bu_treshold);
+		if (m_relayoutPercent > 0)
+			optimizeNodeLayout();
 	}
 }
 
@@ -529,12 +600,106 @@ void btDbvt::optimizeIncremental(int passes)
 			++m_opath;
 		} while (--passes);
 	}
+	//updates mostly reuse the node slot they just released, so reallocations alone don't mean the layout degraded
+	if ((m_relayoutPercent > 0) && (m_internalNodesSinceLayout * 100 > m_internalNodes.m_numNodes * m_relayoutPercent))
+	{
+		m_internalNodesSinceLayout = 0;
+		if (computeLayoutFragmentation() > m_relayoutPercent)
+		{
+			optimizeNodeLayout();
+		}
+	}
+}
+
+//
+int btDbvt::computeLayoutFragmentation() const
+{
+	if ((m_root == 0) || m_root->isleaf())
+		return 0;
+	//optimizeNodeLayout stores an internal node right after its parent, for the first child that is internal
+	int numParents = 0;
+	int numScattered = 0;
+	btAlignedObjectArray<const btDbvtNode*> stack;
+	stack.reserve(64);
+	stack.push_back(m_root);
+	do
+	{
+		const btDbvtNode* n = stack[stack.size() - 1];
+		stack.pop_back();
+		bool hasInternalChild = false;
+		bool followed = false;
+		for (int i = 0; i < 2; ++i)
+		{
+			const btDbvtNode* child = n->childs[i];
+			if (child->isinternal())
+			{
+				stack.push_back(child);
+				hasInternalChild = true;
+				followed |= (child == n + 1);
+			}
+		}
+		if (hasInternalChild)
+		{
+			++numParents;
+			if (!followed)
+				++numScattered;
+		}
+	} while (stack.size() > 0);
+	return numParents ? (numScattered * 100) / numParents : 0;
+}
+
+//
+void btDbvt::optimizeNodeLayout()
+{
+	m_internalNodesSinceLayout = 0;
+	if ((m_root == 0) || m_root->isleaf())
+		return;
+	//copy the internal nodes in depth-first order into a fresh block, the old blocks are released afterwards.
+	//Leaves stay where they are, only their parent pointers are updated
+	const int capacity = m_internalNodes.m_capacity;
+	btDbvtNode* block = (btDbvtNode*)btAlignedAlloc(sizeof(btDbvtNode) * capacity, 16);
+	int count = 0;
+	btAlignedObjectArray<sStkCLN> stack;
+	stack.reserve(64);
+	stack.push_back(sStkCLN(m_root, 0));
+	do
+	{
+		const sStkCLN e = stack[stack.size() - 1];
+		stack.pop_back();
+		btAssert(count < capacity);
+		btDbvtNode* n = &block[count++];
+		*n = *e.node;
+		n->parent = e.parent;
+		if (e.parent)
+		{
+			//the parent copy still points at the old node
+			e.parent->childs[e.parent->childs[0] == e.node ? 0 : 1] = n;
+		}
+		for (int i = 1; i >= 0; --i)
+		{
+			btDbvtNode* child = n->childs[i];
+			if (child->isinternal())
+				stack.push_back(sStkCLN(child, n));
+			else
+				child->parent = n;
+		}
+	} while (stack.size() > 0);
+	btAssert(count == m_internalNodes.m_numNodes);
+	m_internalNodes.adoptBlock(block, capacity, count);
+	m_root = block;
+}
+
+//
+void btDbvt::refit()
+{
+	if (m_root)
+		refitnode(m_root);
 }
 
 //
 btDbvtNode* btDbvt::insert(const btDbvtVolume& volume, void* data)
 {
-	btDbvtNode* leaf = createnode(this, 0, volume, data);
+	btDbvtNode* leaf = createleaf(this, 0, volume, data);
 	insertleaf(this, m_root, leaf);
 	++m_leaves;
 	return (leaf);
@@ -653,7 +818,7 @@ void btDbvt::clone(btDbvt& dest, IClone* iclone) const
 		{
 			const int i = stack.size() - 1;
 			const sStkCLN e = stack[i];
-			btDbvtNode* n = createnode(&dest, e.parent, e.node->volume, e.node->data);
+			btDbvtNode* n = e.node->isinternal() ? createnode(&dest, e.parent, e.node->volume, e.node->data) : createleaf(&dest, e.parent, e.node->volume, e.node->data);
 			stack.pop_back();
 			if (e.parent != 0)
 				e.parent->childs[i & 1] = n;
@@ -666,9 +831,11 @@ void btDbvt::clone(btDbvt& dest, IClone* iclone) const
 			}
 			else
 			{
-				iclone->CloneLeaf(n);
+				if (iclone)
+					iclone->CloneLeaf(n);
 			}
 		} while (stack.size() > 0);
+		dest.m_leaves = m_leaves;
 	}
 }
 
@@ -222,6 +222,28 @@ struct btDbvntNode
 
 typedef btAlignedObjectArray<const btDbvtNode*> btNodeStack;
 
+/* btDbvtNodePool			*/
+///btDbvtNodePool hands out btDbvtNode storage from a few large contiguous blocks instead of one heap allocation per node,
+///so the nodes of a tree stay close together in memory. Released nodes are kept in a free list linked through btDbvtNode::parent.
+struct btDbvtNodePool
+{
+	btAlignedObjectArray<btDbvtNode*> m_blocks;
+	btAlignedObjectArray<int> m_blockSizes;
+	btDbvtNode* m_free;
+	int m_lastBlockUsed;
+	int m_capacity;
+	int m_numNodes;
+
+	btDbvtNodePool() : m_free(0), m_lastBlockUsed(0), m_capacity(0), m_numNodes(0) {}
+	~btDbvtNodePool() { clear(); }
+	btDbvtNode* allocate();
+	void deallocate(btDbvtNode* node);
+	///releases all blocks, the nodes must not be used anymore
+	void clear();
+	///takes ownership of a block of 'capacity' nodes, of which the first 'numNodes' are in use. The previous blocks are released
+	void adoptBlock(btDbvtNode* block, int capacity, int numNodes);
+};
+
 ///The btDbvt class implements a fast dynamic bounding volume tree based on axis aligned bounding boxes (aabb tree).
 ///This btDbvt is used for soft body collision detection and for the btDbvtBroadphase. It has a fast insert, remove and update of nodes.
 ///Unlike the btQuantizedBvh, nodes can be dynamically moved around, which allows for change in topology of the underlying data structure.
@@ -300,10 +322,18 @@ struct btDbvt
 
 	// Fields
 	btDbvtNode* m_root;
-	btDbvtNode* m_free;
+	//internal nodes are only referenced by the tree itself, so optimizeNodeLayout can move them
+	btDbvtNodePool m_internalNodes;
+	//leaves are handed out by insert and keep their address until remove
+	btDbvtNodePool m_leafNodes;
 	int m_lkhd;
 	int m_leaves;
 	unsigned m_opath;
+	///optimizeIncremental calls optimizeNodeLayout once computeLayoutFragmentation exceeds this percentage.
+	///It is only measured after as many internal nodes were reallocated since the last measurement,
+	///optimizeTopDown and optimizeBottomUp always relayout. 0 disables the relayout
+	int m_relayoutPercent;
+	int m_internalNodesSinceLayout;
 
 	btAlignedObjectArray<sStkNN> m_stkStack;
 
@@ -315,6 +345,13 @@ struct btDbvt
 	void optimizeBottomUp();
 	void optimizeTopDown(int bu_treshold = 128);
 	void optimizeIncremental(int passes);
+	///moves the internal nodes into one contiguous block in depth-first order, so traversals walk memory mostly forward
+	void optimizeNodeLayout();
+	///percentage of the internal nodes whose first internal child isn't stored right after them, 0 after optimizeNodeLayout
+	int computeLayoutFragmentation() const;
+	///recomputes the volumes of all internal nodes from their children, after the volumes of many leaves were set directly.
+	///The tree structure is kept, so large leaf motions lower its quality until it is optimized
+	void refit();
 	btDbvtNode* insert(const btDbvtVolume& box, void* data);
 	void update(btDbvtNode* leaf, int lookahead = -1);
 	void update(btDbvtNode* leaf, btDbvtVolume& volume);
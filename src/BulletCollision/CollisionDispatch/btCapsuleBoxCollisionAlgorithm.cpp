@@ -0,0 +1,324 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2018 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btCapsuleBoxCollisionAlgorithm.h"
+#include "btCapsuleCapsuleCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
+#include "BulletCollision/CollisionShapes/btCapsuleShape.h"
+#include "BulletCollision/CollisionShapes/btBoxShape.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+
+//a segment within this (sine of the angle) of a face plane gets a contact at both ends of its part above the face
+#define BT_CAPSULE_BOX_PARALLEL_SIN btScalar(0.3)
+
+btCapsuleBoxCollisionAlgorithm::btCapsuleBoxCollisionAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* col0Wrap, const btCollisionObjectWrapper* col1Wrap, bool isSwapped)
+	: btActivatingCollisionAlgorithm(ci, col0Wrap, col1Wrap),
+	  m_ownManifold(false),
+	  m_manifoldPtr(mf),
+	  m_isSwapped(isSwapped)
+{
+	const btCollisionObjectWrapper* capsuleObjWrap = m_isSwapped ? col1Wrap : col0Wrap;
+	const btCollisionObjectWrapper* boxObjWrap = m_isSwapped ? col0Wrap : col1Wrap;
+
+	if (!m_manifoldPtr && m_dispatcher->needsCollision(capsuleObjWrap->getCollisionObject(), boxObjWrap->getCollisionObject()))
+	{
+		m_manifoldPtr = m_dispatcher->getNewManifold(capsuleObjWrap->getCollisionObject(), boxObjWrap->getCollisionObject());
+		m_ownManifold = true;
+	}
+}
+
+btCapsuleBoxCollisionAlgorithm::~btCapsuleBoxCollisionAlgorithm()
+{
+	if (m_ownManifold)
+	{
+		if (m_manifoldPtr)
+			m_dispatcher->releaseManifold(m_manifoldPtr);
+	}
+}
+
+static btScalar boxSquaredDistance(const btVector3& p, const btVector3& extents)
+{
+	btScalar sqrDistance = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		btScalar d = btFabs(p[i]) - extents[i];
+		if (d > 0)
+			sqrDistance += d * d;
+	}
+	return sqrDistance;
+}
+
+//returns the parameter t in [-hlen, hlen] of the point of the segment center + dir * t closest to the box [-extents, extents].
+//The squared distance is a quadratic in t between the parameters where the segment crosses a face plane, so it is minimized
+//in closed form on each of those (at most 7) intervals.
+static btScalar segmentBoxClosestParameter(const btVector3& center, const btVector3& dir, btScalar hlen, const btVector3& extents, btScalar& sqrDistance)
+{
+	btScalar breaks[8];
+	int numBreaks = 0;
+	breaks[numBreaks++] = -hlen;
+	for (int i = 0; i < 3; i++)
+	{
+		if (dir[i] != btScalar(0.))
+		{
+			for (int s = -1; s <= 1; s += 2)
+			{
+				btScalar t = (s * extents[i] - center[i]) / dir[i];
+				if (t > -hlen && t < hlen)
+					breaks[numBreaks++] = t;
+			}
+		}
+	}
+	breaks[numBreaks++] = hlen;
+	for (int i = 1; i < numBreaks; i++)
+	{
+		for (int j = i; j > 0 && breaks[j] < breaks[j - 1]; j--)
+			btSwap(breaks[j], breaks[j - 1]);
+	}
+
+	btScalar bestT = -hlen;
+	sqrDistance = BT_LARGE_FLOAT;
+	for (int k = 0; k + 1 < numBreaks; k++)
+	{
+		const btScalar t0 = breaks[k];
+		const btScalar t1 = breaks[k + 1];
+		const btVector3 mid = center + dir * (btScalar(0.5) * (t0 + t1));
+		btScalar a = 0;
+		btScalar b = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			if (mid[i] > extents[i])
+			{
+				a += dir[i] * dir[i];
+				b += dir[i] * (center[i] - extents[i]);
+			}
+			else if (mid[i] < -extents[i])
+			{
+				a += dir[i] * dir[i];
+				b += dir[i] * (center[i] + extents[i]);
+			}
+		}
+		btScalar t = a > btScalar(0.) ? btClamped(-b / a, t0, t1) : t0;
+		btScalar d = boxSquaredDistance(center + dir * t, extents);
+		if (d < sqrDistance)
+		{
+			sqrDistance = d;
+			bestT = t;
+		}
+	}
+	return bestT;
+}
+
+struct btCapsuleBoxContactAdder
+{
+	const btTransform& m_boxTrans;
+	btScalar m_threshold;
+	btManifoldResult* m_resultOut;
+
+	btCapsuleBoxContactAdder(const btTransform& boxTrans, btScalar threshold, btManifoldResult* resultOut)
+		: m_boxTrans(boxTrans),
+		  m_threshold(threshold),
+		  m_resultOut(resultOut)
+	{
+	}
+
+	//the manifold is (capsule, box), so the normal and point are given on the box, in box space
+	void addContact(const btVector3& normalOnBox, const btVector3& pointOnBox, btScalar distance)
+	{
+		if (distance < m_threshold)
+		{
+			m_resultOut->addContactPoint(m_boxTrans.getBasis() * normalOnBox, m_boxTrans * pointOnBox, distance);
+		}
+	}
+
+	//contacts of the segment against face 'axis' on side 'sign', closestT is used if no part of the segment is above the face
+	void addFaceContacts(const btVector3& center, const btVector3& dir, btScalar hlen, btScalar radius, const btVector3& extents, int axis, btScalar sign, btScalar closestT)
+	{
+		btScalar t0 = -hlen;
+		btScalar t1 = hlen;
+		for (int j = 0; j < 3; j++)
+		{
+			if (j == axis)
+				continue;
+			if (dir[j] != btScalar(0.))
+			{
+				btScalar ta = (-extents[j] - center[j]) / dir[j];
+				btScalar tb = (extents[j] - center[j]) / dir[j];
+				if (ta > tb)
+					btSwap(ta, tb);
+				t0 = btMax(t0, ta);
+				t1 = btMin(t1, tb);
+			}
+			else if (btFabs(center[j]) > extents[j])
+			{
+				t1 = t0 - 1;
+			}
+		}
+		if (t0 > t1)
+		{
+			t0 = t1 = closestT;
+		}
+
+		btVector3 normal(0, 0, 0);
+		normal[axis] = sign;
+		const btScalar height0 = sign * (center[axis] + dir[axis] * t0);
+		const btScalar height1 = sign * (center[axis] + dir[axis] * t1);
+		const bool parallel = btFabs(dir[axis]) < BT_CAPSULE_BOX_PARALLEL_SIN;
+		for (int i = 0; i < 2; i++)
+		{
+			//without the parallel case only the deepest end touches
+			if (!parallel && (i ? height1 >= height0 : height0 > height1))
+				continue;
+			btVector3 point = center + dir * (i ? t1 : t0);
+			btScalar distance = sign * point[axis] - extents[axis] - radius;
+			point[axis] = sign * extents[axis];
+			addContact(normal, point, distance);
+		}
+	}
+};
+
+void btCapsuleBoxCollisionAlgorithm::processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)dispatchInfo;
+	if (!m_manifoldPtr)
+		return;
+
+	const btCollisionObjectWrapper* capsuleObjWrap = m_isSwapped ? body1Wrap : body0Wrap;
+	const btCollisionObjectWrapper* boxObjWrap = m_isSwapped ? body0Wrap : body1Wrap;
+	const btCapsuleShape* capsule = (const btCapsuleShape*)capsuleObjWrap->getCollisionShape();
+	const btBoxShape* box = (const btBoxShape*)boxObjWrap->getCollisionShape();
+	const btTransform& boxTrans = boxObjWrap->getWorldTransform();
+	const btTransform& capsuleTrans = capsuleObjWrap->getWorldTransform();
+
+	resultOut->setPersistentManifold(m_manifoldPtr);
+
+	//capsule segment in box space
+	const btVector3 center = boxTrans.invXform(capsuleTrans.getOrigin());
+	const btVector3 dir = capsuleTrans.getBasis().getColumn(capsule->getUpAxis()) * boxTrans.getBasis();
+	const btScalar hlen = capsule->getHalfHeight();
+	const btScalar radius = capsule->getRadius();
+	const btVector3 extents = box->getHalfExtentsWithMargin();
+
+	btCapsuleBoxContactAdder adder(boxTrans, m_manifoldPtr->getContactBreakingThreshold() + resultOut->m_closestPointDistanceThreshold, resultOut);
+
+	btScalar sqrDistance;
+	const btScalar closestT = segmentBoxClosestParameter(center, dir, hlen, extents, sqrDistance);
+	if (sqrDistance > btScalar(0.))
+	{
+		//the segment is outside the box
+		const btVector3 pointOnSegment = center + dir * closestT;
+		btVector3 pointOnBox = pointOnSegment;
+		pointOnBox.setMax(-extents);
+		pointOnBox.setMin(extents);
+		const btScalar distance = btSqrt(sqrDistance);
+		if (distance - radius < adder.m_threshold)
+		{
+			int numOutside = 0;
+			int faceAxis = 0;
+			for (int i = 0; i < 3; i++)
+			{
+				if (btFabs(pointOnSegment[i]) > extents[i])
+				{
+					numOutside++;
+					faceAxis = i;
+				}
+			}
+			if (numOutside == 1)
+			{
+				adder.addFaceContacts(center, dir, hlen, radius, extents, faceAxis, pointOnSegment[faceAxis] > 0 ? btScalar(1.) : btScalar(-1.), closestT);
+			}
+			else
+			{
+				//closest to an edge or vertex of the box
+				adder.addContact((pointOnSegment - pointOnBox) / distance, pointOnBox, distance - radius);
+			}
+		}
+	}
+	else
+	{
+		//the segment touches the box, find the axis of least penetration among the face normals and the segment-edge directions
+		int bestFace = 0;
+		btScalar bestFaceOverlap = BT_LARGE_FLOAT;
+		for (int i = 0; i < 3; i++)
+		{
+			btScalar overlap = extents[i] + hlen * btFabs(dir[i]) + radius - btFabs(center[i]);
+			if (overlap < bestFaceOverlap)
+			{
+				bestFaceOverlap = overlap;
+				bestFace = i;
+			}
+		}
+		int bestEdge = -1;
+		btScalar bestEdgeOverlap = BT_LARGE_FLOAT;
+		btVector3 bestEdgeAxis;
+		for (int i = 0; i < 3; i++)
+		{
+			btVector3 edge(0, 0, 0);
+			edge[i] = 1;
+			btVector3 axis = dir.cross(edge);
+			btScalar len2 = axis.length2();
+			if (len2 < btScalar(1e-6))
+				continue;
+			axis /= btSqrt(len2);
+			if (axis.dot(center) < 0)
+				axis = -axis;
+			btScalar boxRadius = extents.dot(axis.absolute());
+			btScalar overlap = boxRadius + radius - axis.dot(center);
+			if (overlap < bestEdgeOverlap)
+			{
+				bestEdgeOverlap = overlap;
+				bestEdge = i;
+				bestEdgeAxis = axis;
+			}
+		}
+
+		//prefer faces, they give stable manifolds
+		if (bestEdge < 0 || bestEdgeOverlap > btScalar(0.95) * bestFaceOverlap - btScalar(1e-3))
+		{
+			adder.addFaceContacts(center, dir, hlen, radius, extents, bestFace, center[bestFace] >= 0 ? btScalar(1.) : btScalar(-1.), closestT);
+		}
+		else
+		{
+			//contact between the segment and the box edge that supports the box along the axis
+			btVector3 edgeCenter;
+			for (int i = 0; i < 3; i++)
+			{
+				edgeCenter[i] = i == bestEdge ? btScalar(0.) : (bestEdgeAxis[i] >= 0 ? extents[i] : -extents[i]);
+			}
+			btVector3 edgeDir(0, 0, 0);
+			edgeDir[bestEdge] = 1;
+			btVector3 ptsVector, offsetA, offsetB;
+			btScalar tA, tB;
+			btCapsuleCapsuleCollisionAlgorithm::segmentsClosestPoints(ptsVector, offsetA, offsetB, tA, tB, edgeCenter - center, dir, hlen, edgeDir, extents[bestEdge]);
+			adder.addContact(bestEdgeAxis, edgeCenter + offsetB, -bestEdgeOverlap);
+		}
+	}
+
+	if (m_ownManifold)
+	{
+		resultOut->refreshContactPoints();
+	}
+}
+
+btScalar btCapsuleBoxCollisionAlgorithm::calculateTimeOfImpact(btCollisionObject* col0, btCollisionObject* col1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)col0;
+	(void)col1;
+	(void)dispatchInfo;
+	(void)resultOut;
+
+	//not yet
+	return btScalar(1.);
+}
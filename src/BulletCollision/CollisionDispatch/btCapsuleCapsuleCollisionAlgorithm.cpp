@@ -0,0 +1,180 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2018 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btCapsuleCapsuleCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
+#include "BulletCollision/CollisionShapes/btCapsuleShape.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+
+//segments closer to parallel than this (cosine of the angle) get the extra end contacts
+#define BT_CAPSULE_PARALLEL_COS btScalar(0.95)
+
+btCapsuleCapsuleCollisionAlgorithm::btCapsuleCapsuleCollisionAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* col0Wrap, const btCollisionObjectWrapper* col1Wrap)
+	: btActivatingCollisionAlgorithm(ci, col0Wrap, col1Wrap),
+	  m_ownManifold(false),
+	  m_manifoldPtr(mf)
+{
+	if (!m_manifoldPtr)
+	{
+		m_manifoldPtr = m_dispatcher->getNewManifold(col0Wrap->getCollisionObject(), col1Wrap->getCollisionObject());
+		m_ownManifold = true;
+	}
+}
+
+btCapsuleCapsuleCollisionAlgorithm::~btCapsuleCapsuleCollisionAlgorithm()
+{
+	if (m_ownManifold)
+	{
+		if (m_manifoldPtr)
+			m_dispatcher->releaseManifold(m_manifoldPtr);
+	}
+}
+
+void btCapsuleCapsuleCollisionAlgorithm::segmentsClosestPoints(btVector3& ptsVector, btVector3& offsetA, btVector3& offsetB, btScalar& tA, btScalar& tB,
+															   const btVector3& translation, const btVector3& dirA, btScalar hlenA, const btVector3& dirB, btScalar hlenB)
+{
+	// compute the parameters of the closest points on each line segment
+
+	btScalar dirA_dot_dirB = btDot(dirA, dirB);
+	btScalar dirA_dot_trans = btDot(dirA, translation);
+	btScalar dirB_dot_trans = btDot(dirB, translation);
+
+	btScalar denom = 1.0f - dirA_dot_dirB * dirA_dot_dirB;
+
+	if (denom == 0.0f)
+	{
+		tA = 0.0f;
+	}
+	else
+	{
+		tA = btClamped((dirA_dot_trans - dirB_dot_trans * dirA_dot_dirB) / denom, -hlenA, hlenA);
+	}
+
+	tB = tA * dirA_dot_dirB - dirB_dot_trans;
+
+	if (tB < -hlenB)
+	{
+		tB = -hlenB;
+		tA = btClamped(tB * dirA_dot_dirB + dirA_dot_trans, -hlenA, hlenA);
+	}
+	else if (tB > hlenB)
+	{
+		tB = hlenB;
+		tA = btClamped(tB * dirA_dot_dirB + dirA_dot_trans, -hlenA, hlenA);
+	}
+
+	// compute the closest points relative to segment centers.
+
+	offsetA = dirA * tA;
+	offsetB = dirB * tB;
+
+	ptsVector = translation - offsetA + offsetB;
+}
+
+void btCapsuleCapsuleCollisionAlgorithm::addParallelContacts(const btVector3& centerA, const btVector3& dirA, btScalar hlenA, btScalar radiusA,
+															 const btVector3& centerB, const btVector3& dirB, btScalar hlenB, btScalar radiusB,
+															 const btVector3& normalOnB, btScalar threshold, btManifoldResult* resultOut)
+{
+	if (btFabs(dirA.dot(dirB)) < BT_CAPSULE_PARALLEL_COS)
+		return;
+
+	//the part of segment A that faces segment B
+	btScalar s0 = dirA.dot(centerB - dirB * hlenB - centerA);
+	btScalar s1 = dirA.dot(centerB + dirB * hlenB - centerA);
+	btScalar lo = btMax(-hlenA, btMin(s0, s1));
+	btScalar hi = btMin(hlenA, btMax(s0, s1));
+	if (hi - lo <= SIMD_EPSILON)
+		return;
+
+	for (int i = 0; i < 2; i++)
+	{
+		btVector3 pointOnA = centerA + dirA * (i ? hi : lo);
+		btScalar tB = btClamped(dirB.dot(pointOnA - centerB), -hlenB, hlenB);
+		btVector3 pointOnSegmentB = centerB + dirB * tB;
+		btVector3 diff = pointOnA - pointOnSegmentB;
+		btScalar lenSqr = diff.length2();
+		btScalar distance = btSqrt(lenSqr) - radiusA - radiusB;
+		if (distance < threshold)
+		{
+			btVector3 normal = lenSqr > (SIMD_EPSILON * SIMD_EPSILON) ? diff * btRecipSqrt(lenSqr) : normalOnB;
+			resultOut->addContactPoint(normal, pointOnSegmentB + normal * radiusB, distance);
+		}
+	}
+}
+
+void btCapsuleCapsuleCollisionAlgorithm::processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)dispatchInfo;
+
+	if (!m_manifoldPtr)
+		return;
+
+	resultOut->setPersistentManifold(m_manifoldPtr);
+
+	const btCapsuleShape* capsuleA = (const btCapsuleShape*)body0Wrap->getCollisionShape();
+	const btCapsuleShape* capsuleB = (const btCapsuleShape*)body1Wrap->getCollisionShape();
+	const btTransform& transA = body0Wrap->getWorldTransform();
+	const btTransform& transB = body1Wrap->getWorldTransform();
+
+	const btVector3 dirA = transA.getBasis().getColumn(capsuleA->getUpAxis());
+	const btVector3 dirB = transB.getBasis().getColumn(capsuleB->getUpAxis());
+	const btScalar hlenA = capsuleA->getHalfHeight();
+	const btScalar hlenB = capsuleB->getHalfHeight();
+	const btScalar radiusA = capsuleA->getRadius();
+	const btScalar radiusB = capsuleB->getRadius();
+	const btScalar threshold = m_manifoldPtr->getContactBreakingThreshold() + resultOut->m_closestPointDistanceThreshold;
+
+	btVector3 ptsVector;
+	btVector3 offsetA, offsetB;
+	btScalar tA, tB;
+	segmentsClosestPoints(ptsVector, offsetA, offsetB, tA, tB, transB.getOrigin() - transA.getOrigin(), dirA, hlenA, dirB, hlenB);
+
+	btScalar lenSqr = ptsVector.length2();
+	btScalar distance = btSqrt(lenSqr) - radiusA - radiusB;
+	if (distance < threshold)
+	{
+		btVector3 normalOnB;
+		if (lenSqr <= (SIMD_EPSILON * SIMD_EPSILON))
+		{
+			//degenerate case where 2 capsules are likely at the same location: take a vector tangential to 'dirA'
+			btVector3 q;
+			btPlaneSpace1(dirA, normalOnB, q);
+		}
+		else
+		{
+			normalOnB = ptsVector * -btRecipSqrt(lenSqr);
+		}
+		resultOut->addContactPoint(normalOnB, transB.getOrigin() + offsetB + normalOnB * radiusB, distance);
+
+		addParallelContacts(transA.getOrigin(), dirA, hlenA, radiusA, transB.getOrigin(), dirB, hlenB, radiusB, normalOnB, threshold, resultOut);
+	}
+
+	if (m_ownManifold)
+	{
+		resultOut->refreshContactPoints();
+	}
+}
+
+btScalar btCapsuleCapsuleCollisionAlgorithm::calculateTimeOfImpact(btCollisionObject* col0, btCollisionObject* col1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)col0;
+	(void)col1;
+	(void)dispatchInfo;
+	(void)resultOut;
+
+	//not yet
+	return btScalar(1.);
+}
@@ -0,0 +1,70 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2018 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_CAPSULE_CAPSULE_COLLISION_ALGORITHM_H
+#define BT_CAPSULE_CAPSULE_COLLISION_ALGORITHM_H
+
+#include "btActivatingCollisionAlgorithm.h"
+#include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
+#include "BulletCollision/CollisionDispatch/btCollisionCreateFunc.h"
+class btPersistentManifold;
+#include "btCollisionDispatcher.h"
+
+/// btCapsuleCapsuleCollisionAlgorithm provides closed form capsule-capsule collision detection.
+/// Besides the closest points of the two segments, (nearly) parallel capsules get a contact at each end of
+/// their overlap, so a capsule lying on another one has a full manifold after the first frame.
+class btCapsuleCapsuleCollisionAlgorithm : public btActivatingCollisionAlgorithm
+{
+	bool m_ownManifold;
+	btPersistentManifold* m_manifoldPtr;
+
+public:
+	btCapsuleCapsuleCollisionAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap);
+
+	virtual ~btCapsuleCapsuleCollisionAlgorithm();
+
+	virtual void processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut);
+
+	virtual btScalar calculateTimeOfImpact(btCollisionObject* body0, btCollisionObject* body1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut);
+
+	virtual void getAllContactManifolds(btManifoldArray& manifoldArray)
+	{
+		if (m_manifoldPtr && m_ownManifold)
+		{
+			manifoldArray.push_back(m_manifoldPtr);
+		}
+	}
+
+	///closest points of two segments given by their center, unit direction and half length, ptsVector goes from A to B
+	static void segmentsClosestPoints(btVector3& ptsVector, btVector3& offsetA, btVector3& offsetB, btScalar& tA, btScalar& tB,
+									  const btVector3& translation, const btVector3& dirA, btScalar hlenA, const btVector3& dirB, btScalar hlenB);
+
+	///adds a contact at each end of the overlap of two (nearly) parallel capsules, the closest point contact is not included.
+	///normalOnB is the normal of that closest point contact, used where the segments touch
+	static void addParallelContacts(const btVector3& centerA, const btVector3& dirA, btScalar hlenA, btScalar radiusA,
+									const btVector3& centerB, const btVector3& dirB, btScalar hlenB, btScalar radiusB,
+									const btVector3& normalOnB, btScalar threshold, btManifoldResult* resultOut);
+
+	struct CreateFunc : public btCollisionAlgorithmCreateFunc
+	{
+		virtual btCollisionAlgorithm* CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap)
+		{
+			void* mem = ci.m_dispatcher1->allocateCollisionAlgorithm(sizeof(btCapsuleCapsuleCollisionAlgorithm));
+			return new (mem) btCapsuleCapsuleCollisionAlgorithm(ci.m_manifold, ci, body0Wrap, body1Wrap);
+		}
+	};
+};
+
+#endif  //BT_CAPSULE_CAPSULE_COLLISION_ALGORITHM_H
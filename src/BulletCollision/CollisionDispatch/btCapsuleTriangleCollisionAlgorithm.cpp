@@ -0,0 +1,208 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2018 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btCapsuleTriangleCollisionAlgorithm.h"
+#include "btCapsuleCapsuleCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
+#include "BulletCollision/CollisionShapes/btCapsuleShape.h"
+#include "BulletCollision/CollisionShapes/btTriangleShape.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+
+//a segment within this (sine of the angle) of the triangle plane gets a contact at both ends of its part above the triangle
+#define BT_CAPSULE_TRIANGLE_PARALLEL_SIN btScalar(0.3)
+
+btCapsuleTriangleCollisionAlgorithm::btCapsuleTriangleCollisionAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool swapped)
+	: btActivatingCollisionAlgorithm(ci, body0Wrap, body1Wrap),
+	  m_ownManifold(false),
+	  m_manifoldPtr(mf),
+	  m_swapped(swapped)
+{
+	if (!m_manifoldPtr)
+	{
+		m_manifoldPtr = m_dispatcher->getNewManifold(body0Wrap->getCollisionObject(), body1Wrap->getCollisionObject());
+		m_ownManifold = true;
+	}
+}
+
+btCapsuleTriangleCollisionAlgorithm::~btCapsuleTriangleCollisionAlgorithm()
+{
+	if (m_ownManifold)
+	{
+		if (m_manifoldPtr)
+			m_dispatcher->releaseManifold(m_manifoldPtr);
+	}
+}
+
+struct btCapsuleTriangleContactAdder
+{
+	const btTransform& m_triTrans;
+	btScalar m_threshold;
+	bool m_swapped;
+	btManifoldResult* m_resultOut;
+
+	btCapsuleTriangleContactAdder(const btTransform& triTrans, btScalar threshold, bool swapped, btManifoldResult* resultOut)
+		: m_triTrans(triTrans),
+		  m_threshold(threshold),
+		  m_swapped(swapped),
+		  m_resultOut(resultOut)
+	{
+	}
+
+	//normal and point on the triangle, in triangle space
+	void addContact(const btVector3& normalOnTriangle, const btVector3& pointOnTriangle, btScalar distance)
+	{
+		if (distance >= m_threshold)
+			return;
+
+		const btVector3 normalOnB = m_triTrans.getBasis() * normalOnTriangle;
+		const btVector3 pointOnB = m_triTrans * pointOnTriangle;
+		if (m_swapped)
+		{
+			//the manifold is (triangle, capsule), give the normal and point on the capsule
+			m_resultOut->addContactPoint(-normalOnB, pointOnB + normalOnB * distance, distance);
+		}
+		else
+		{
+			m_resultOut->addContactPoint(normalOnB, pointOnB, distance);
+		}
+	}
+};
+
+void btCapsuleTriangleCollisionAlgorithm::processCollision(const btCollisionObjectWrapper* col0Wrap, const btCollisionObjectWrapper* col1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)dispatchInfo;
+	if (!m_manifoldPtr)
+		return;
+
+	const btCollisionObjectWrapper* capsuleObjWrap = m_swapped ? col1Wrap : col0Wrap;
+	const btCollisionObjectWrapper* triObjWrap = m_swapped ? col0Wrap : col1Wrap;
+	const btCapsuleShape* capsule = (const btCapsuleShape*)capsuleObjWrap->getCollisionShape();
+	const btTriangleShape* triangle = (const btTriangleShape*)triObjWrap->getCollisionShape();
+	const btTransform& triTrans = triObjWrap->getWorldTransform();
+	const btTransform& capsuleTrans = capsuleObjWrap->getWorldTransform();
+
+	resultOut->setPersistentManifold(m_manifoldPtr);
+
+	const btVector3* vertices = triangle->m_vertices1;
+	btVector3 triNormal = (vertices[1] - vertices[0]).cross(vertices[2] - vertices[0]);
+	const btScalar normalLength2 = triNormal.length2();
+	if (normalLength2 > SIMD_EPSILON * SIMD_EPSILON)
+	{
+		triNormal /= btSqrt(normalLength2);
+
+		//capsule segment in triangle space, the triangle margin is added to the capsule radius like the convex-convex path does
+		const btVector3 center = triTrans.invXform(capsuleTrans.getOrigin());
+		const btVector3 dir = capsuleTrans.getBasis().getColumn(capsule->getUpAxis()) * triTrans.getBasis();
+		const btScalar hlen = capsule->getHalfHeight();
+		const btScalar radius = capsule->getRadius() + triangle->getMargin();
+
+		btCapsuleTriangleContactAdder adder(triTrans, m_manifoldPtr->getContactBreakingThreshold() + resultOut->m_closestPointDistanceThreshold, m_swapped, resultOut);
+
+		//two-sided, the normal faces the capsule center
+		const btVector3 normal = triNormal.dot(center - vertices[0]) >= 0 ? triNormal : -triNormal;
+		const btScalar centerHeight = normal.dot(center - vertices[0]);
+		const btScalar dirHeight = normal.dot(dir);
+
+		//inward normals of the triangle edges, triNormal follows the winding
+		btVector3 edgeNormals[3];
+		for (int i = 0; i < 3; i++)
+		{
+			edgeNormals[i] = triNormal.cross(vertices[(i + 1) % 3] - vertices[i]);
+		}
+
+		//the segment part above the triangle
+		btScalar t0 = -hlen;
+		btScalar t1 = hlen;
+		for (int i = 0; i < 3; i++)
+		{
+			const btScalar a = edgeNormals[i].dot(center - vertices[i]);
+			const btScalar b = edgeNormals[i].dot(dir);
+			if (b > SIMD_EPSILON)
+			{
+				t0 = btMax(t0, -a / b);
+			}
+			else if (b < -SIMD_EPSILON)
+			{
+				t1 = btMin(t1, -a / b);
+			}
+			else if (a < 0)
+			{
+				t1 = t0 - 1;
+			}
+		}
+
+		//the closest edge points of the segment
+		btScalar edgeDistance2 = BT_LARGE_FLOAT;
+		btVector3 edgePtsVector(0, 0, 0);
+		btVector3 edgePoint(0, 0, 0);
+		for (int i = 0; i < 3; i++)
+		{
+			const btVector3 edge = vertices[(i + 1) % 3] - vertices[i];
+			const btScalar edgeLength = edge.length();
+			if (edgeLength < SIMD_EPSILON)
+				continue;
+			const btVector3 edgeCenter = (vertices[i] + vertices[(i + 1) % 3]) * btScalar(0.5);
+			btVector3 ptsVector, offsetA, offsetB;
+			btScalar tA, tB;
+			btCapsuleCapsuleCollisionAlgorithm::segmentsClosestPoints(ptsVector, offsetA, offsetB, tA, tB, edgeCenter - center, dir, hlen, edge / edgeLength, btScalar(0.5) * edgeLength);
+			if (ptsVector.length2() < edgeDistance2)
+			{
+				edgeDistance2 = ptsVector.length2();
+				edgePtsVector = ptsVector;
+				edgePoint = edgeCenter + offsetB;
+			}
+		}
+
+		if (t0 <= t1 && centerHeight + dirHeight * (dirHeight < 0 ? t1 : t0) <= btSqrt(edgeDistance2))
+		{
+			//the closest point is in the triangle
+			const bool parallel = btFabs(dirHeight) < BT_CAPSULE_TRIANGLE_PARALLEL_SIN;
+			for (int i = 0; i < 2; i++)
+			{
+				//without the parallel case only the deepest end touches
+				if (!parallel && (i ? dirHeight >= 0 : dirHeight < 0))
+					continue;
+				const btScalar t = i ? t1 : t0;
+				const btScalar height = centerHeight + dirHeight * t;
+				const btVector3 pointOnPlane = center + dir * t - normal * height;
+				adder.addContact(normal, pointOnPlane + normal * triangle->getMargin(), height - radius);
+			}
+		}
+		else if (edgeDistance2 < BT_LARGE_FLOAT)
+		{
+			//closest to an edge or vertex of the triangle
+			const btScalar distance = btSqrt(edgeDistance2);
+			const btVector3 edgeNormal = distance > SIMD_EPSILON ? edgePtsVector / -distance : normal;
+			adder.addContact(edgeNormal, edgePoint + edgeNormal * triangle->getMargin(), distance - radius);
+		}
+	}
+
+	if (m_ownManifold)
+	{
+		resultOut->refreshContactPoints();
+	}
+}
+
+btScalar btCapsuleTriangleCollisionAlgorithm::calculateTimeOfImpact(btCollisionObject* col0, btCollisionObject* col1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)col0;
+	(void)col1;
+	(void)dispatchInfo;
+	(void)resultOut;
+
+	//not yet
+	return btScalar(1.);
+}
@@ -213,10 +213,66 @@ public:
 	}
 };
 
+///gathers the sphere and capsule pairs into a btPrimitivePairBatch, all other pairs go through the default near callback
+class btPrimitiveBatchPairCallback : public btOverlapCallback
+{
+	const btDispatcherInfo& m_dispatchInfo;
+	btCollisionDispatcher* m_dispatcher;
+	btPrimitivePairBatch* m_batch;
+	btManifoldArray m_manifoldArray;
+
+public:
+	btPrimitiveBatchPairCallback(const btDispatcherInfo& dispatchInfo, btCollisionDispatcher* dispatcher, btPrimitivePairBatch* batch)
+		: m_dispatchInfo(dispatchInfo),
+		  m_dispatcher(dispatcher),
+		  m_batch(batch)
+	{
+	}
+
+	virtual ~btPrimitiveBatchPairCallback() {}
+
+	virtual bool processOverlap(btBroadphasePair& pair)
+	{
+		btCollisionObject* colObj0 = (btCollisionObject*)pair.m_pProxy0->m_clientObject;
+		btCollisionObject* colObj1 = (btCollisionObject*)pair.m_pProxy1->m_clientObject;
+		if (btPrimitivePairBatch::isSupportedShapeType(colObj0->getCollisionShape()->getShapeType()) &&
+			btPrimitivePairBatch::isSupportedShapeType(colObj1->getCollisionShape()->getShapeType()))
+		{
+			if (!m_dispatcher->needsCollision(colObj0, colObj1))
+				return false;
+
+			//the algorithm owns the manifold, some create it in their first processCollision
+			m_manifoldArray.resize(0);
+			if (pair.m_algorithm)
+			{
+				pair.m_algorithm->getAllContactManifolds(m_manifoldArray);
+			}
+			if (m_manifoldArray.size() == 1)
+			{
+				m_batch->addPair(colObj0, colObj1, m_manifoldArray[0]);
+				return false;
+			}
+		}
+		btCollisionDispatcher::defaultNearCallback(pair, *m_dispatcher, m_dispatchInfo);
+		return false;
+	}
+};
+
 void btCollisionDispatcher::dispatchAllCollisionPairs(btOverlappingPairCache* pairCache, const btDispatcherInfo& dispatchInfo, btDispatcher* dispatcher)
 {
 	//m_blockedForChanges = true;
 
+	if ((m_dispatcherFlags & CD_BATCH_PRIMITIVE_PAIRS) && m_nearCallback == defaultNearCallback && dispatchInfo.m_dispatchFunc == btDispatcherInfo::DISPATCH_DISCRETE)
+	{
+		btPrimitiveBatchPairCallback batchCallback(dispatchInfo, this, &m_primitivePairBatch);
+		{
+			BT_PROFILE("processAllOverlappingPairs");
+			pairCache->processAllOverlappingPairs(&batchCallback, dispatcher, dispatchInfo);
+		}
+		m_primitivePairBatch.processPairs();
+		return;
+	}
+
 	btCollisionPairCallback collisionCallback(dispatchInfo, this);
 
 	{
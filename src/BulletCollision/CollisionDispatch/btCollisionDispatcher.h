@@ -20,6 +20,7 @@ subject to the following restrictions:
 #include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
 
 #include "BulletCollision/CollisionDispatch/btManifoldResult.h"
+#include "BulletCollision/CollisionDispatch/btPrimitivePairBatch.h"
 
 #include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
 #include "LinearMath/btAlignedObjectArray.h"
@@ -58,6 +59,8 @@ protected:
 
 	btCollisionAlgorithmCreateFunc* m_doubleDispatchClosestPoints[MAX_BROADPHASE_COLLISION_TYPES][MAX_BROADPHASE_COLLISION_TYPES];
 
+	btPrimitivePairBatch m_primitivePairBatch;
+
 	btCollisionConfiguration* m_collisionConfiguration;
 
 public:
@@ -65,7 +68,10 @@ public:
 	{
 		CD_STATIC_STATIC_REPORTED = 1,
 		CD_USE_RELATIVE_CONTACT_BREAKING_THRESHOLD = 2,
-		CD_DISABLE_CONTACTPOOL_DYNAMIC_ALLOCATION = 4
+		CD_DISABLE_CONTACTPOOL_DYNAMIC_ALLOCATION = 4,
+		///sphere and capsule pairs are gathered during dispatchAllCollisionPairs and their contacts computed together
+		///by btPrimitivePairBatch, their collision algorithm only provides the manifold. Only used with the default near callback.
+		CD_BATCH_PRIMITIVE_PAIRS = 8
 	};
 
 	int getDispatcherFlags() const
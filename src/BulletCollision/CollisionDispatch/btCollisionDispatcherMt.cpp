@@ -124,6 +124,18 @@ struct CollisionDispatcherUpdater : public btIParallelForBody
 	}
 };
 
+struct btNewManifoldSortPredicate
+{
+	bool operator()(const btCollisionDispatcherMt::btNewManifold& a, const btCollisionDispatcherMt::btNewManifold& b) const
+	{
+		if (a.m_uid0 != b.m_uid0)
+			return a.m_uid0 < b.m_uid0;
+		if (a.m_uid1 != b.m_uid1)
+			return a.m_uid1 < b.m_uid1;
+		return a.m_order < b.m_order;
+	}
+};
+
 void btCollisionDispatcherMt::dispatchAllCollisionPairs(btOverlappingPairCache* pairCache, const btDispatcherInfo& info, btDispatcher* dispatcher)
 {
 	const int pairCount = pairCache->getNumOverlappingPairs();
@@ -137,23 +149,56 @@ void btCollisionDispatcherMt::dispatchAllCollisionPairs(btOverlappingPairCache*
 	updater.mDispatcher = this;
 	updater.mInfo = &info;
 
+	// the number of threads may have changed since the last dispatch
+	if (m_batchManifoldsPtr.size() < btGetTaskScheduler()->getNumThreads())
+	{
+		m_batchManifoldsPtr.resize(btGetTaskScheduler()->getNumThreads());
+	}
+
 	m_batchUpdating = true;
 	btParallelFor(0, pairCount, m_grainSize, updater);
 	m_batchUpdating = false;
 
 	// merge new manifolds, if any
+	const int numOldManifolds = m_manifoldsPtr.size();
+	m_newManifolds.resizeNoInitialize(0);
 	for (int i = 0; i < m_batchManifoldsPtr.size(); ++i)
 	{
 		btAlignedObjectArray<btPersistentManifold*>& batchManifoldsPtr = m_batchManifoldsPtr[i];
 
 		for (int j = 0; j < batchManifoldsPtr.size(); ++j)
 		{
-			m_manifoldsPtr.push_back(batchManifoldsPtr[j]);
+			if (info.m_deterministicOverlappingPairs)
+			{
+				const btPersistentManifold* manifold = batchManifoldsPtr[j];
+				btNewManifold newManifold;
+				newManifold.m_uid0 = manifold->getBody0()->getBroadphaseHandle() ? manifold->getBody0()->getBroadphaseHandle()->m_uniqueId : -1;
+				newManifold.m_uid1 = manifold->getBody1()->getBroadphaseHandle() ? manifold->getBody1()->getBroadphaseHandle()->m_uniqueId : -1;
+				newManifold.m_order = j;
+				newManifold.m_manifold = batchManifoldsPtr[j];
+				m_newManifolds.push_back(newManifold);
+			}
+			else
+			{
+				m_manifoldsPtr.push_back(batchManifoldsPtr[j]);
+			}
 		}
 
 		batchManifoldsPtr.resizeNoInitialize(0);
 	}
 
+	if (m_newManifolds.size())
+	{
+		// the thread a pair runs on depends on the scheduling, append the new manifolds in pair order instead.
+		// All manifolds of one pair are created by the same thread, in creation order
+		m_newManifolds.quickSort(btNewManifoldSortPredicate());
+		m_manifoldsPtr.resizeNoInitialize(numOldManifolds + m_newManifolds.size());
+		for (int i = 0; i < m_newManifolds.size(); ++i)
+		{
+			m_manifoldsPtr[numOldManifolds + i] = m_newManifolds[i].m_manifold;
+		}
+	}
+
 	// update the indices (used when releasing manifolds)
 	for (int i = 0; i < m_manifoldsPtr.size(); ++i)
 	{
@@ -19,9 +19,21 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
 #include "LinearMath/btThreads.h"
 
+///btCollisionDispatcherMt processes the overlapping pairs with btParallelFor.
+///Manifolds created during the dispatch are collected per thread. When btDispatcherInfo::m_deterministicOverlappingPairs
+///is set they are appended in the order of the broadphase proxy unique ids of their objects, so the manifold order
+///does not depend on the number of threads or the scheduling
 class btCollisionDispatcherMt : public btCollisionDispatcher
 {
 public:
+	struct btNewManifold
+	{
+		int m_uid0;
+		int m_uid1;
+		int m_order;
+		btPersistentManifold* m_manifold;
+	};
+
 	btCollisionDispatcherMt(btCollisionConfiguration* config, int grainSize = 40);
 
 	virtual btPersistentManifold* getNewManifold(const btCollisionObject* body0, const btCollisionObject* body1) BT_OVERRIDE;
@@ -31,6 +43,7 @@ public:
 
 protected:
 	btAlignedObjectArray<btAlignedObjectArray<btPersistentManifold*> > m_batchManifoldsPtr;
+	btAlignedObjectArray<btNewManifold> m_newManifolds;
 	bool m_batchUpdating;
 	int m_grainSize;
 };
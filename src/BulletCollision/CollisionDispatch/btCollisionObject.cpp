@@ -16,6 +16,7 @@ subject to the following restrictions:
 #include "btCollisionObject.h"
 #include "LinearMath/btSerializer.h"
 #include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
+#include "LinearMath/btThreads.h"
 
 btCollisionObject::btCollisionObject()
 	: m_interpolationLinearVelocity(0.f, 0.f, 0.f),
@@ -31,6 +32,10 @@ btCollisionObject::btCollisionObject()
 	  m_islandTag1(-1),
 	  m_companionId(-1),
 	  m_worldArrayIndex(-1),
+	  m_activeCollisionObjects(0),
+	  m_activeCollisionObjectsMutex(0),
+	  m_activeArrayIndex(-1),
+	  m_listedWhileSleeping(false),
 	  m_activationState1(1),
 	  m_deactivationTime(btScalar(0.)),
 	  m_friction(btScalar(0.5)),
@@ -61,12 +66,37 @@ btCollisionObject::~btCollisionObject()
 void btCollisionObject::setActivationState(int newState) const
 {
 	if ((m_activationState1 != DISABLE_DEACTIVATION) && (m_activationState1 != DISABLE_SIMULATION))
+	{
 		m_activationState1 = newState;
+		insertActiveCollisionObject();
+	}
 }
 
 void btCollisionObject::forceActivationState(int newState) const
 {
 	m_activationState1 = newState;
+	insertActiveCollisionObject();
+}
+
+void btCollisionObject::pushActiveCollisionObject(bool listedWhileSleeping) const
+{
+	if (m_activeCollisionObjects == 0)
+	{
+		m_listedWhileSleeping = m_listedWhileSleeping || listedWhileSleeping;
+		return;
+	}
+	//the unguarded checks in the callers are only a fast path, they are repeated while holding the lock
+	btMutexLock(m_activeCollisionObjectsMutex);
+	if (listedWhileSleeping)
+	{
+		m_listedWhileSleeping = true;
+	}
+	if (m_activeArrayIndex < 0)
+	{
+		m_activeArrayIndex = m_activeCollisionObjects->size();
+		m_activeCollisionObjects->push_back(const_cast<btCollisionObject*>(this));
+	}
+	btMutexUnlock(m_activeCollisionObjectsMutex);
 }
 
 void btCollisionObject::activate(bool forceActivation) const
@@ -28,6 +28,7 @@ subject to the following restrictions:
 struct btBroadphaseProxy;
 class btCollisionShape;
 struct btCollisionShapeData;
+class btSpinMutex;
 #include "LinearMath/btMotionState.h"
 #include "LinearMath/btAlignedAllocator.h"
 #include "LinearMath/btAlignedObjectArray.h"
@@ -79,6 +80,12 @@ protected:
 	int m_companionId;
 	int m_worldArrayIndex;  // index of object in world's collisionObjects array
 
+	///list of the awake objects of the world, objects insert themselves when their activation state leaves ISLAND_SLEEPING
+	btCollisionObjectArray* m_activeCollisionObjects;
+	btSpinMutex* m_activeCollisionObjectsMutex;  // guards m_activeCollisionObjects, objects can be woken from solver worker threads
+	mutable int m_activeArrayIndex;  // index of object in world's activeCollisionObjects array, -1 if not listed
+	mutable bool m_listedWhileSleeping;  // keeps an ISLAND_SLEEPING object listed until the dynamics world has visited it
+
 	mutable int m_activationState1;
 	mutable btScalar m_deactivationTime;
 
@@ -464,6 +471,57 @@ public:
 		m_worldArrayIndex = ix;
 	}
 
+	SIMD_FORCE_INLINE int getActiveArrayIndex() const
+	{
+		return m_activeArrayIndex;
+	}
+
+	// only should be called by CollisionWorld
+	void setActiveArrayIndex(int ix)
+	{
+		m_activeArrayIndex = ix;
+	}
+
+	// only should be called by CollisionWorld, inserts the object right away unless it is ISLAND_SLEEPING
+	void setActiveCollisionObjectArray(btCollisionObjectArray* activeCollisionObjects, btSpinMutex* activeCollisionObjectsMutex)
+	{
+		m_activeCollisionObjects = activeCollisionObjects;
+		m_activeCollisionObjectsMutex = activeCollisionObjectsMutex;
+		m_activeArrayIndex = -1;
+		insertActiveCollisionObject();
+	}
+
+	SIMD_FORCE_INLINE void insertActiveCollisionObject() const
+	{
+		if (m_activeCollisionObjects && m_activeArrayIndex < 0 && m_activationState1 != ISLAND_SLEEPING)
+		{
+			pushActiveCollisionObject(false);
+		}
+	}
+
+	///lists the object even though it is ISLAND_SLEEPING, for example when the velocity of a sleeping body was set
+	void insertSleepingCollisionObject() const
+	{
+		if (!m_listedWhileSleeping)
+		{
+			pushActiveCollisionObject(true);
+		}
+	}
+
+	///appends the object to the active list under the world's mutex, may be called from worker threads
+	void pushActiveCollisionObject(bool listedWhileSleeping) const;
+
+	SIMD_FORCE_INLINE bool isListedWhileSleeping() const
+	{
+		return m_listedWhileSleeping;
+	}
+
+	// only should be called by the dynamics world, once it has visited the object
+	void clearListedWhileSleeping()
+	{
+		m_listedWhileSleeping = false;
+	}
+
 	SIMD_FORCE_INLINE btScalar getHitFraction() const
 	{
 		return m_hitFraction;
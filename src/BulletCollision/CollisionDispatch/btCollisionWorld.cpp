@@ -90,6 +90,7 @@ btCollisionWorld::~btCollisionWorld()
 			getBroadphase()->destroyProxy(bp, m_dispatcher1);
 			collisionObject->setBroadphaseHandle(0);
 		}
+		collisionObject->setActiveCollisionObjectArray(0, 0);
 	}
 }
 
@@ -131,6 +132,7 @@ void btCollisionWorld::addCollisionObject(btCollisionObject* collisionObject, in
 
 	collisionObject->setWorldArrayIndex(m_collisionObjects.size());
 	m_collisionObjects.push_back(collisionObject);
+	collisionObject->setActiveCollisionObjectArray(&m_activeCollisionObjects, &m_activeCollisionObjectsMutex);
 
 	//calculate new AABB
 	btTransform trans = collisionObject->getWorldTransform();
@@ -198,18 +200,66 @@ void btCollisionWorld::updateAabbs()
 {
 	BT_PROFILE("updateAabbs");
 
-	btTransform predictedTrans;
-	for (int i = 0; i < m_collisionObjects.size(); i++)
-	{
-		btCollisionObject* colObj = m_collisionObjects[i];
-		btAssert(colObj->getWorldArrayIndex() == i);
+	updateActiveCollisionObjects();
 
-		//only update aabb of active objects
-		if (m_forceUpdateAllAabbs || colObj->isActive())
+	if (m_forceUpdateAllAabbs)
+	{
+		for (int i = 0; i < m_collisionObjects.size(); i++)
 		{
+			btCollisionObject* colObj = m_collisionObjects[i];
+			btAssert(colObj->getWorldArrayIndex() == i);
 			updateSingleAabb(colObj);
 		}
 	}
+	else
+	{
+		//only update aabb of active objects
+		for (int i = 0; i < m_activeCollisionObjects.size(); i++)
+		{
+			btCollisionObject* colObj = m_activeCollisionObjects[i];
+			if (colObj->isActive())
+			{
+				updateSingleAabb(colObj);
+			}
+		}
+	}
+}
+
+struct btWorldArrayIndexSortPredicate
+{
+	SIMD_FORCE_INLINE bool operator()(const btCollisionObject* lhs, const btCollisionObject* rhs) const
+	{
+		return lhs->getWorldArrayIndex() < rhs->getWorldArrayIndex();
+	}
+};
+
+void btCollisionWorld::updateActiveCollisionObjects()
+{
+	bool sorted = true;
+	int numActive = 0;
+	for (int i = 0; i < m_activeCollisionObjects.size(); i++)
+	{
+		btCollisionObject* colObj = m_activeCollisionObjects[i];
+		if (colObj->getActivationState() == ISLAND_SLEEPING && !colObj->isListedWhileSleeping())
+		{
+			colObj->setActiveArrayIndex(-1);
+			continue;
+		}
+		if (numActive && m_activeCollisionObjects[numActive - 1]->getWorldArrayIndex() > colObj->getWorldArrayIndex())
+		{
+			sorted = false;
+		}
+		m_activeCollisionObjects[numActive++] = colObj;
+	}
+	m_activeCollisionObjects.resize(numActive);
+	if (!sorted)
+	{
+		m_activeCollisionObjects.quickSort(btWorldArrayIndexSortPredicate());
+	}
+	for (int i = 0; i < numActive; i++)
+	{
+		m_activeCollisionObjects[i]->setActiveArrayIndex(i);
+	}
 }
 
 void btCollisionWorld::computeOverlappingPairs()
@@ -272,6 +322,19 @@ void btCollisionWorld::removeCollisionObject(btCollisionObject* collisionObject)
 		m_collisionObjects.remove(collisionObject);
 	}
 	collisionObject->setWorldArrayIndex(-1);
+
+	int iActive = collisionObject->getActiveArrayIndex();
+	if (iActive >= 0)
+	{
+		btAssert(collisionObject == m_activeCollisionObjects[iActive]);
+		m_activeCollisionObjects.swap(iActive, m_activeCollisionObjects.size() - 1);
+		m_activeCollisionObjects.pop_back();
+		if (iActive < m_activeCollisionObjects.size())
+		{
+			m_activeCollisionObjects[iActive]->setActiveArrayIndex(iActive);
+		}
+	}
+	collisionObject->setActiveCollisionObjectArray(0, 0);
 }
 
 void btCollisionWorld::rayTestSingle(const btTransform& rayFromTrans, const btTransform& rayToTrans,
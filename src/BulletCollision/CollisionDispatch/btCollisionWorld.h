@@ -80,6 +80,7 @@ class btSerializer;
 #include "btCollisionDispatcher.h"
 #include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
 #include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btThreads.h"
 
 ///CollisionWorld is interface and container for the collision detection
 class btCollisionWorld
@@ -87,6 +88,10 @@ class btCollisionWorld
 protected:
 	btAlignedObjectArray<btCollisionObject*> m_collisionObjects;
 
+	///objects that left ISLAND_SLEEPING since the last updateActiveCollisionObjects, so per-step loops skip sleeping objects
+	btCollisionObjectArray m_activeCollisionObjects;
+	btSpinMutex m_activeCollisionObjectsMutex;
+
 	btDispatcher* m_dispatcher1;
 
 	btDispatcherInfo m_dispatchInfo;
@@ -483,6 +488,17 @@ public:
 		return m_collisionObjects;
 	}
 
+	///all objects that are not ISLAND_SLEEPING, in collision object order. Objects that fell asleep since the last
+	///updateActiveCollisionObjects are still listed, so loops over this array keep checking the activation state
+	const btCollisionObjectArray& getActiveCollisionObjectArray() const
+	{
+		return m_activeCollisionObjects;
+	}
+
+	///removes the sleeping objects from the active collision object array and sorts it by world array index,
+	///this is called by updateAabbs
+	void updateActiveCollisionObjects();
+
 	virtual void removeCollisionObject(btCollisionObject* collisionObject);
 
 	virtual void performDiscreteCollisionDetection();
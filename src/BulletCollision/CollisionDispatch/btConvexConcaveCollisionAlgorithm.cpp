@@ -19,6 +19,7 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionShapes/btMultiSphereShape.h"
 #include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
 #include "BulletCollision/CollisionShapes/btConcaveShape.h"
+#include "BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
 #include "BulletCollision/CollisionDispatch/btManifoldResult.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletCollision/CollisionShapes/btTriangleShape.h"
@@ -28,6 +29,11 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
 #include "BulletCollision/CollisionShapes/btSdfCollisionShape.h"
 
+bool gBatchConvexConcaveTriangles = true;
+
+//the cached region extends the convex aabb by this fraction of its size on every side
+#define BT_TRIANGLE_CACHE_MARGIN btScalar(0.25)
+
 btConvexConcaveCollisionAlgorithm::btConvexConcaveCollisionAlgorithm(const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool isSwapped)
 	: btActivatingCollisionAlgorithm(ci, body0Wrap, body1Wrap),
 	  m_btConvexTriangleCallback(ci.m_dispatcher1, body0Wrap, body1Wrap, isSwapped),
@@ -48,7 +54,10 @@ void btConvexConcaveCollisionAlgorithm::getAllContactManifolds(btManifoldArray&
 }
 
 btConvexTriangleCallback::btConvexTriangleCallback(btDispatcher* dispatcher, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool isSwapped) : m_dispatcher(dispatcher),
-																																													 m_dispatchInfoPtr(0)
+																																													 m_dispatchInfoPtr(0),
+																																													 m_cachedShape(0),
+																																													 m_cachedMeshRevision(0),
+																																													 m_gatherTriangles(false)
 {
 	m_convexBodyWrap = isSwapped ? body1Wrap : body0Wrap;
 	m_triBodyWrap = isSwapped ? body0Wrap : body1Wrap;
@@ -70,10 +79,24 @@ btConvexTriangleCallback::~btConvexTriangleCallback()
 void btConvexTriangleCallback::clearCache()
 {
 	m_dispatcher->clearManifold(m_manifoldPtr);
+	m_cachedShape = 0;
 }
 
 void btConvexTriangleCallback::processTriangle(btVector3* triangle, int partId, int triangleIndex)
 {
+	if (m_gatherTriangles)
+	{
+		if (TestTriangleAgainstAabb2(triangle, m_cacheAabbMin, m_cacheAabbMax))
+		{
+			m_cachedVertices.push_back(triangle[0]);
+			m_cachedVertices.push_back(triangle[1]);
+			m_cachedVertices.push_back(triangle[2]);
+			m_cachedTriangleIds.push_back(partId);
+			m_cachedTriangleIds.push_back(triangleIndex);
+		}
+		return;
+	}
+
 	BT_PROFILE("btConvexTriangleCallback::processTriangle");
 
 	if (!TestTriangleAgainstAabb2(triangle, m_aabbMin, m_aabbMax))
@@ -117,34 +140,168 @@ void btConvexTriangleCallback::processTriangle(btVector3* triangle, int partId,
 		{
 			colAlgo = ci.m_dispatcher1->findAlgorithm(m_convexBodyWrap, &triObWrap, m_manifoldPtr, BT_CONTACT_POINT_ALGORITHMS);
 		}
-		const btCollisionObjectWrapper* tmpWrap = 0;
+		collideTriangle(colAlgo, &triObWrap, partId, triangleIndex);
 
-		if (m_resultOut->getBody0Internal() == m_triBodyWrap->getCollisionObject())
-		{
-			tmpWrap = m_resultOut->getBody0Wrap();
-			m_resultOut->setBody0Wrap(&triObWrap);
-			m_resultOut->setShapeIdentifiersA(partId, triangleIndex);
-		}
-		else
-		{
-			tmpWrap = m_resultOut->getBody1Wrap();
-			m_resultOut->setBody1Wrap(&triObWrap);
-			m_resultOut->setShapeIdentifiersB(partId, triangleIndex);
-		}
+		colAlgo->~btCollisionAlgorithm();
+		ci.m_dispatcher1->freeCollisionAlgorithm(colAlgo);
+	}
+}
+
+void btConvexTriangleCallback::collideTriangle(btCollisionAlgorithm* colAlgo, const btCollisionObjectWrapper* triObWrap, int partId, int triangleIndex)
+{
+	const btCollisionObjectWrapper* tmpWrap = 0;
+
+	if (m_resultOut->getBody0Internal() == m_triBodyWrap->getCollisionObject())
+	{
+		tmpWrap = m_resultOut->getBody0Wrap();
+		m_resultOut->setBody0Wrap(triObWrap);
+		m_resultOut->setShapeIdentifiersA(partId, triangleIndex);
+	}
+	else
+	{
+		tmpWrap = m_resultOut->getBody1Wrap();
+		m_resultOut->setBody1Wrap(triObWrap);
+		m_resultOut->setShapeIdentifiersB(partId, triangleIndex);
+	}
+
+	colAlgo->processCollision(m_convexBodyWrap, triObWrap, *m_dispatchInfoPtr, m_resultOut);
+
+	if (m_resultOut->getBody0Internal() == m_triBodyWrap->getCollisionObject())
+	{
+		m_resultOut->setBody0Wrap(tmpWrap);
+	}
+	else
+	{
+		m_resultOut->setBody1Wrap(tmpWrap);
+	}
+}
+
+void btConvexTriangleCallback::processTriangles(const btConcaveShape* concaveShape)
+{
+	//closest point queries create a manifold per triangle algorithm, they keep the per triangle path
+	if (!gBatchConvexConcaveTriangles || m_resultOut->m_closestPointDistanceThreshold > 0 || !m_convexBodyWrap->getCollisionShape()->isConvex())
+	{
+		concaveShape->processAllTriangles(this, m_aabbMin, m_aabbMax);
+		return;
+	}
 
-		colAlgo->processCollision(m_convexBodyWrap, &triObWrap, *m_dispatchInfoPtr, m_resultOut);
+	gatherTriangles(concaveShape);
+	processTriangleBatch();
+}
 
-		if (m_resultOut->getBody0Internal() == m_triBodyWrap->getCollisionObject())
+void btConvexTriangleCallback::gatherTriangles(const btConcaveShape* concaveShape)
+{
+	//only bvh triangle meshes are cached, their refits bump the mesh revision. Heightfields and other concave shapes
+	//can change in place without notice
+	const bool cacheable = concaveShape->getShapeType() == TRIANGLE_MESH_SHAPE_PROXYTYPE;
+	const int meshRevision = cacheable ? static_cast<const btBvhTriangleMeshShape*>(concaveShape)->getMeshRevision() : 0;
+	if (cacheable && concaveShape == m_cachedShape && meshRevision == m_cachedMeshRevision && concaveShape->getLocalScaling() == m_cachedScaling &&
+		m_cacheAabbMin.x() <= m_aabbMin.x() && m_cacheAabbMin.y() <= m_aabbMin.y() && m_cacheAabbMin.z() <= m_aabbMin.z() &&
+		m_cacheAabbMax.x() >= m_aabbMax.x() && m_cacheAabbMax.y() >= m_aabbMax.y() && m_cacheAabbMax.z() >= m_aabbMax.z())
+	{
+		return;
+	}
+
+	btVector3 cacheMargin(0, 0, 0);
+	if (cacheable)
+	{
+		cacheMargin = (m_aabbMax - m_aabbMin) * BT_TRIANGLE_CACHE_MARGIN;
+	}
+	m_cacheAabbMin = m_aabbMin - cacheMargin;
+	m_cacheAabbMax = m_aabbMax + cacheMargin;
+	m_cachedVertices.resize(0);
+	m_cachedTriangleIds.resize(0);
+
+	m_gatherTriangles = true;
+	concaveShape->processAllTriangles(this, m_cacheAabbMin, m_cacheAabbMax);
+	m_gatherTriangles = false;
+
+	m_cachedShape = cacheable ? concaveShape : 0;
+	m_cachedMeshRevision = meshRevision;
+	m_cachedScaling = concaveShape->getLocalScaling();
+}
+
+void btConvexTriangleCallback::processTriangleBatch()
+{
+	BT_PROFILE("btConvexTriangleCallback::processTriangleBatch");
+
+	const int numTriangles = m_cachedTriangleIds.size() / 2;
+	m_batch.resize(0);
+	for (int i = 0; i < numTriangles; i++)
+	{
+		if (TestTriangleAgainstAabb2(&m_cachedVertices[i * 3], m_aabbMin, m_aabbMax))
 		{
-			m_resultOut->setBody0Wrap(tmpWrap);
+			m_batch.push_back(i);
 		}
-		else
+	}
+	const int numBatched = m_batch.size();
+	if (!numBatched)
+		return;
+
+	//support points of the convex along both sides of every triangle normal, in one batched query
+	const btConvexShape* convex = static_cast<const btConvexShape*>(m_convexBodyWrap->getCollisionShape());
+	const btTransform convexInTriangleSpace = m_triBodyWrap->getWorldTransform().inverseTimes(m_convexBodyWrap->getWorldTransform());
+	const btMatrix3x3& convexBasis = convexInTriangleSpace.getBasis();
+	m_batchNormals.resize(numBatched);
+	m_supportDirections.resize(numBatched * 2);
+	m_supportVertices.resize(numBatched * 2);
+	for (int i = 0; i < numBatched; i++)
+	{
+		const btVector3* vertices = &m_cachedVertices[m_batch[i] * 3];
+		btVector3 normal = (vertices[1] - vertices[0]).cross(vertices[2] - vertices[0]);
+		const btScalar length2 = normal.length2();
+		//degenerate triangles get a zero normal and are never rejected
+		normal = length2 > SIMD_EPSILON * SIMD_EPSILON ? normal / btSqrt(length2) : btVector3(0, 0, 0);
+		m_batchNormals[i] = normal;
+		const btVector3 localNormal = normal * convexBasis;
+		m_supportDirections[i * 2] = localNormal;
+		m_supportDirections[i * 2 + 1] = -localNormal;
+	}
+	convex->batchedUnitVectorGetSupportingVertexWithoutMargin(&m_supportDirections[0], &m_supportVertices[0], numBatched * 2);
+
+	//the triangles are two-sided, a plane separates them when the whole convex, with margins and the contact breaking
+	//threshold, is on one side. The narrowphase would not report a contact for those
+	const btScalar slack = convex->getMargin() + m_collisionMarginTriangle + m_manifoldPtr->getContactBreakingThreshold();
+
+	btCollisionAlgorithmConstructionInfo ci;
+	ci.m_dispatcher1 = m_dispatcher;
+	btTriangleShape tm(btVector3(0, 0, 0), btVector3(0, 0, 0), btVector3(0, 0, 0));
+	tm.setMargin(m_collisionMarginTriangle);
+	btCollisionAlgorithm* colAlgo = 0;
+
+	for (int i = 0; i < numBatched; i++)
+	{
+		const int triangle = m_batch[i];
+		const btVector3* vertices = &m_cachedVertices[triangle * 3];
+		const btVector3& normal = m_batchNormals[i];
+		const btScalar planeDistance = normal.dot(vertices[0]);
+		const btScalar maxDistance = normal.dot(convexInTriangleSpace * m_supportVertices[i * 2]);
+		const btScalar minDistance = normal.dot(convexInTriangleSpace * m_supportVertices[i * 2 + 1]);
+		if (minDistance - slack > planeDistance || maxDistance + slack < planeDistance)
+			continue;
+
+		const int partId = m_cachedTriangleIds[triangle * 2];
+		const int triangleIndex = m_cachedTriangleIds[triangle * 2 + 1];
+		tm.m_vertices1[0] = vertices[0];
+		tm.m_vertices1[1] = vertices[1];
+		tm.m_vertices1[2] = vertices[2];
+		btCollisionObjectWrapper triObWrap(m_triBodyWrap, &tm, m_triBodyWrap->getCollisionObject(), m_triBodyWrap->getWorldTransform(), partId, triangleIndex);
+
+		//all triangles dispatch to the same algorithm, so one instance serves the batch. The only state it carries from one
+		//triangle to the next is btConvexConvexAlgorithm::m_satCache, the feature tried first by the hull-hull SAT. It is
+		//bounds checked and evaluated against the current triangle, so a feature left by another triangle only changes the
+		//order in which the axes are tested
+		if (!colAlgo)
 		{
-			m_resultOut->setBody1Wrap(tmpWrap);
+			colAlgo = m_dispatcher->findAlgorithm(m_convexBodyWrap, &triObWrap, m_manifoldPtr, BT_CONTACT_POINT_ALGORITHMS);
 		}
+		collideTriangle(colAlgo, &triObWrap, partId, triangleIndex);
+	}
 
+	if (colAlgo)
+	{
 		colAlgo->~btCollisionAlgorithm();
-		ci.m_dispatcher1->freeCollisionAlgorithm(colAlgo);
+		m_dispatcher->freeCollisionAlgorithm(colAlgo);
 	}
 }
 
@@ -191,23 +348,28 @@ void btConvexConcaveCollisionAlgorithm::processCollision(const btCollisionObject
 			if (convexBodyWrap->getCollisionShape()->isConvex())
 			{
 				btConvexShape* convex = (btConvexShape*)convexBodyWrap->getCollisionShape();
-				btAlignedObjectArray<btVector3> queryVertices;
+				btAlignedObjectArray<btVector3>& queryVertices = m_sdfQuery.m_points;
+				queryVertices.resize(0);
+
+				//query in SDF space using a single combined transform
+				btTransform convexToSdf = triBodyWrap->getWorldTransform().inverseTimes(convexBodyWrap->getWorldTransform());
 
 				if (convex->isPolyhedral())
 				{
 					btPolyhedralConvexShape* poly = (btPolyhedralConvexShape*)convex;
+					queryVertices.reserve(poly->getNumVertices() + 1);
 					for (int v = 0; v < poly->getNumVertices(); v++)
 					{
 						btVector3 vtx;
 						poly->getVertex(v, vtx);
-						queryVertices.push_back(vtx);
+						queryVertices.push_back(convexToSdf * vtx);
 					}
 				}
 				btScalar maxDist = SIMD_EPSILON;
 
 				if (convex->getShapeType() == SPHERE_SHAPE_PROXYTYPE)
 				{
-					queryVertices.push_back(btVector3(0, 0, 0));
+					queryVertices.push_back(convexToSdf.getOrigin());
 					btSphereShape* sphere = (btSphereShape*)convex;
 					maxDist = sphere->getRadius() + SIMD_EPSILON;
 				}
@@ -216,31 +378,28 @@ void btConvexConcaveCollisionAlgorithm::processCollision(const btCollisionObject
 					resultOut->setPersistentManifold(m_btConvexTriangleCallback.m_manifoldPtr);
 					//m_btConvexTriangleCallback.m_manifoldPtr->clearManifold();
 
-					btPolyhedralConvexShape* poly = (btPolyhedralConvexShape*)convex;
-					for (int v = 0; v < queryVertices.size(); v++)
-					{
-						const btVector3& vtx = queryVertices[v];
-						btVector3 vtxWorldSpace = convexBodyWrap->getWorldTransform() * vtx;
-						btVector3 vtxInSdf = triBodyWrap->getWorldTransform().invXform(vtxWorldSpace);
+					int numQueries = queryVertices.size();
+					m_sdfQuery.resize(numQueries);
+					sdfShape->queryPoints(&queryVertices[0], numQueries, &m_sdfQuery.m_distances[0], &m_sdfQuery.m_normals[0], &m_sdfQuery.m_hasResult[0], maxDist);
 
-						btVector3 normalLocal;
-						btScalar dist;
-						if (sdfShape->queryPoint(vtxInSdf, dist, normalLocal))
+					const btTransform& sdfTr = triBodyWrap->getWorldTransform();
+					for (int v = 0; v < numQueries; v++)
+					{
+						if (!m_sdfQuery.m_hasResult[v])
+							continue;
+						btScalar dist = m_sdfQuery.m_distances[v];
+						btVector3 normalLocal = m_sdfQuery.m_normals[v];
+						normalLocal.safeNormalize();
+						btVector3 normal = sdfTr.getBasis() * normalLocal;
+						btVector3 vtxWorldSpace = sdfTr * queryVertices[v];
+
+						if (convex->getShapeType() == SPHERE_SHAPE_PROXYTYPE)
 						{
-							if (dist <= maxDist)
-							{
-								normalLocal.safeNormalize();
-								btVector3 normal = triBodyWrap->getWorldTransform().getBasis() * normalLocal;
-
-								if (convex->getShapeType() == SPHERE_SHAPE_PROXYTYPE)
-								{
-									btSphereShape* sphere = (btSphereShape*)convex;
-									dist -= sphere->getRadius();
-									vtxWorldSpace -= sphere->getRadius() * normal;
-								}
-								resultOut->addContactPoint(normal, vtxWorldSpace - normal * dist, dist);
-							}
+							btSphereShape* sphere = (btSphereShape*)convex;
+							dist -= sphere->getRadius();
+							vtxWorldSpace -= sphere->getRadius() * normal;
 						}
+						resultOut->addContactPoint(normal, vtxWorldSpace - normal * dist, dist);
 					}
 					resultOut->refreshContactPoints();
 				}
@@ -259,7 +418,7 @@ void btConvexConcaveCollisionAlgorithm::processCollision(const btCollisionObject
 
 				m_btConvexTriangleCallback.m_manifoldPtr->setBodies(convexBodyWrap->getCollisionObject(), triBodyWrap->getCollisionObject());
 
-				concaveShape->processAllTriangles(&m_btConvexTriangleCallback, m_btConvexTriangleCallback.getAabbMin(), m_btConvexTriangleCallback.getAabbMax());
+				m_btConvexTriangleCallback.processTriangles(concaveShape);
 
 				resultOut->refreshContactPoints();
 
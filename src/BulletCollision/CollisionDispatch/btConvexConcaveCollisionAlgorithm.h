@@ -24,6 +24,14 @@ subject to the following restrictions:
 class btDispatcher;
 #include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
 #include "btCollisionCreateFunc.h"
+#include "BulletCollision/CollisionShapes/btSdfCollisionShape.h"
+class btConcaveShape;
+
+///when true (default), btConvexTriangleCallback gathers the overlapping triangles first and rejects the ones whose plane
+///separates them from the convex in one batched support query, before running the narrowphase on the others.
+///Triangles of btBvhTriangleMeshShape are cached per pair and reused while the convex stays in the cached region and
+///the shape's getMeshRevision is unchanged, so refitTree or partialRefitTree after editing vertices in place refetches them
+extern bool gBatchConvexConcaveTriangles;
 
 ///For each triangle in the concave mesh that overlaps with the AABB of a convex (m_convexProxy), processTriangle is called.
 ATTRIBUTE_ALIGNED16(class)
@@ -40,6 +48,28 @@ btConvexTriangleCallback : public btTriangleCallback
 	const btDispatcherInfo* m_dispatchInfoPtr;
 	btScalar m_collisionMarginTriangle;
 
+	//the triangles overlapping m_cacheAabbMin/Max, three vertices and a part id and triangle index each
+	btAlignedObjectArray<btVector3> m_cachedVertices;
+	btAlignedObjectArray<int> m_cachedTriangleIds;
+	btVector3 m_cacheAabbMin;
+	btVector3 m_cacheAabbMax;
+	const btConcaveShape* m_cachedShape;
+	btVector3 m_cachedScaling;
+	int m_cachedMeshRevision;
+	bool m_gatherTriangles;
+
+	//batch of triangles overlapping the convex aabb, with the plane normals and convex support points
+	btAlignedObjectArray<int> m_batch;
+	btAlignedObjectArray<btVector3> m_batchNormals;
+	btAlignedObjectArray<btVector3> m_supportDirections;
+	btAlignedObjectArray<btVector3> m_supportVertices;
+
+	void gatherTriangles(const btConcaveShape* concaveShape);
+
+	void processTriangleBatch();
+
+	void collideTriangle(btCollisionAlgorithm * colAlgo, const btCollisionObjectWrapper* triObWrap, int partId, int triangleIndex);
+
 public:
 	BT_DECLARE_ALIGNED_ALLOCATOR();
 
@@ -60,6 +90,10 @@ public:
 
 	virtual void processTriangle(btVector3 * triangle, int partId, int triangleIndex);
 
+	///runs the narrowphase for all triangles of concaveShape that overlap the convex, see gBatchConvexConcaveTriangles
+	void processTriangles(const btConcaveShape* concaveShape);
+
+	///removes the contact points of the manifold and drops the gathered triangles, they are fetched again on the next call
 	void clearCache();
 
 	SIMD_FORCE_INLINE const btVector3& getAabbMin() const
@@ -80,6 +114,8 @@ btConvexConcaveCollisionAlgorithm : public btActivatingCollisionAlgorithm
 
 	bool m_isSwapped;
 
+	btSdfQueryBuffer m_sdfQuery;
+
 public:
 	BT_DECLARE_ALIGNED_ALLOCATOR();
 
@@ -93,6 +129,7 @@ public:
 
 	virtual void getAllContactManifolds(btManifoldArray & manifoldArray);
 
+	///removes the contact points of this pair and the triangles cached for it, see btConvexTriangleCallback::clearCache
 	void clearCache();
 
 	struct CreateFunc : public btCollisionAlgorithmCreateFunc
@@ -492,7 +492,7 @@ void btConvexConvexAlgorithm ::processCollision(const btCollisionObjectWrapper*
 						*polyhedronA->getConvexPolyhedron(), *polyhedronB->getConvexPolyhedron(),
 						body0Wrap->getWorldTransform(),
 						body1Wrap->getWorldTransform(),
-						sepNormalWorldSpace, *resultOut);
+						sepNormalWorldSpace, *resultOut, &m_satCache);
 				}
 				else
 				{
@@ -47,6 +47,8 @@ class btConvexConvexAlgorithm : public btActivatingCollisionAlgorithm
 
 	btVertexArray worldVertsB1;
 	btVertexArray worldVertsB2;
+	///feature of the last hull-hull separating axis test, tried first in the next one
+	btPolyhedralSatCache m_satCache;
 
 	bool m_ownManifold;
 	btPersistentManifold* m_manifoldPtr;
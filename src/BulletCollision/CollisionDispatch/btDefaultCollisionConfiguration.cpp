@@ -28,6 +28,10 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionDispatch/btSphereBoxCollisionAlgorithm.h"
 #endif  //USE_BUGGY_SPHERE_BOX_ALGORITHM
 #include "BulletCollision/CollisionDispatch/btSphereTriangleCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btCapsuleCapsuleCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btCapsuleBoxCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btCapsuleTriangleCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btSdfSdfCollisionAlgorithm.h"
 #include "BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h"
 #include "BulletCollision/NarrowPhaseCollision/btMinkowskiPenetrationDepthSolver.h"
 #include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
@@ -83,6 +87,19 @@ btDefaultCollisionConfiguration::btDefaultCollisionConfiguration(const btDefault
 	m_triangleSphereCF = new (mem) btSphereTriangleCollisionAlgorithm::CreateFunc;
 	m_triangleSphereCF->m_swapped = true;
 
+	mem = btAlignedAlloc(sizeof(btCapsuleCapsuleCollisionAlgorithm::CreateFunc), 16);
+	m_capsuleCapsuleCF = new (mem) btCapsuleCapsuleCollisionAlgorithm::CreateFunc;
+	mem = btAlignedAlloc(sizeof(btCapsuleBoxCollisionAlgorithm::CreateFunc), 16);
+	m_capsuleBoxCF = new (mem) btCapsuleBoxCollisionAlgorithm::CreateFunc;
+	mem = btAlignedAlloc(sizeof(btCapsuleBoxCollisionAlgorithm::CreateFunc), 16);
+	m_boxCapsuleCF = new (mem) btCapsuleBoxCollisionAlgorithm::CreateFunc;
+	m_boxCapsuleCF->m_swapped = true;
+	mem = btAlignedAlloc(sizeof(btCapsuleTriangleCollisionAlgorithm::CreateFunc), 16);
+	m_capsuleTriangleCF = new (mem) btCapsuleTriangleCollisionAlgorithm::CreateFunc;
+	mem = btAlignedAlloc(sizeof(btCapsuleTriangleCollisionAlgorithm::CreateFunc), 16);
+	m_triangleCapsuleCF = new (mem) btCapsuleTriangleCollisionAlgorithm::CreateFunc;
+	m_triangleCapsuleCF->m_swapped = true;
+
 	mem = btAlignedAlloc(sizeof(btBoxBoxCollisionAlgorithm::CreateFunc), 16);
 	m_boxBoxCF = new (mem) btBoxBoxCollisionAlgorithm::CreateFunc;
 
@@ -93,16 +110,21 @@ btDefaultCollisionConfiguration::btDefaultCollisionConfiguration(const btDefault
 	m_planeConvexCF = new (mem) btConvexPlaneCollisionAlgorithm::CreateFunc;
 	m_planeConvexCF->m_swapped = true;
 
+	mem = btAlignedAlloc(sizeof(btSdfSdfCollisionAlgorithm::CreateFunc), 16);
+	m_sdfSdfCF = new (mem) btSdfSdfCollisionAlgorithm::CreateFunc;
+
 	///calculate maximum element size, big enough to fit any collision algorithm in the memory pool
 	int maxSize = sizeof(btConvexConvexAlgorithm);
 	int maxSize2 = sizeof(btConvexConcaveCollisionAlgorithm);
 	int maxSize3 = sizeof(btCompoundCollisionAlgorithm);
 	int maxSize4 = sizeof(btCompoundCompoundCollisionAlgorithm);
+	int maxSize5 = sizeof(btSdfSdfCollisionAlgorithm);
 
 	int collisionAlgorithmMaxElementSize = btMax(maxSize, constructionInfo.m_customCollisionAlgorithmMaxElementSize);
 	collisionAlgorithmMaxElementSize = btMax(collisionAlgorithmMaxElementSize, maxSize2);
 	collisionAlgorithmMaxElementSize = btMax(collisionAlgorithmMaxElementSize, maxSize3);
 	collisionAlgorithmMaxElementSize = btMax(collisionAlgorithmMaxElementSize, maxSize4);
+	collisionAlgorithmMaxElementSize = btMax(collisionAlgorithmMaxElementSize, maxSize5);
 
 	if (constructionInfo.m_persistentManifoldPool)
 	{
@@ -177,6 +199,16 @@ btDefaultCollisionConfiguration::~btDefaultCollisionConfiguration()
 	btAlignedFree(m_sphereTriangleCF);
 	m_triangleSphereCF->~btCollisionAlgorithmCreateFunc();
 	btAlignedFree(m_triangleSphereCF);
+	m_capsuleCapsuleCF->~btCollisionAlgorithmCreateFunc();
+	btAlignedFree(m_capsuleCapsuleCF);
+	m_capsuleBoxCF->~btCollisionAlgorithmCreateFunc();
+	btAlignedFree(m_capsuleBoxCF);
+	m_boxCapsuleCF->~btCollisionAlgorithmCreateFunc();
+	btAlignedFree(m_boxCapsuleCF);
+	m_capsuleTriangleCF->~btCollisionAlgorithmCreateFunc();
+	btAlignedFree(m_capsuleTriangleCF);
+	m_triangleCapsuleCF->~btCollisionAlgorithmCreateFunc();
+	btAlignedFree(m_triangleCapsuleCF);
 	m_boxBoxCF->~btCollisionAlgorithmCreateFunc();
 	btAlignedFree(m_boxBoxCF);
 
@@ -185,6 +217,9 @@ btDefaultCollisionConfiguration::~btDefaultCollisionConfiguration()
 	m_planeConvexCF->~btCollisionAlgorithmCreateFunc();
 	btAlignedFree(m_planeConvexCF);
 
+	m_sdfSdfCF->~btCollisionAlgorithmCreateFunc();
+	btAlignedFree(m_sdfSdfCF);
+
 	m_pdSolver->~btConvexPenetrationDepthSolver();
 
 	btAlignedFree(m_pdSolver);
@@ -218,6 +253,38 @@ btCollisionAlgorithmCreateFunc* btDefaultCollisionConfiguration::getClosestPoint
 		return m_triangleSphereCF;
 	}
 
+#ifndef BT_DISABLE_CAPSULE_CAPSULE_COLLIDER
+	if ((proxyType0 == CAPSULE_SHAPE_PROXYTYPE) && (proxyType1 == CAPSULE_SHAPE_PROXYTYPE))
+	{
+		return m_capsuleCapsuleCF;
+	}
+#endif  //BT_DISABLE_CAPSULE_CAPSULE_COLLIDER
+
+	if ((proxyType0 == CAPSULE_SHAPE_PROXYTYPE) && (proxyType1 == BOX_SHAPE_PROXYTYPE))
+	{
+		return m_capsuleBoxCF;
+	}
+
+	if ((proxyType0 == BOX_SHAPE_PROXYTYPE) && (proxyType1 == CAPSULE_SHAPE_PROXYTYPE))
+	{
+		return m_boxCapsuleCF;
+	}
+
+	if ((proxyType0 == CAPSULE_SHAPE_PROXYTYPE) && (proxyType1 == TRIANGLE_SHAPE_PROXYTYPE))
+	{
+		return m_capsuleTriangleCF;
+	}
+
+	if ((proxyType0 == TRIANGLE_SHAPE_PROXYTYPE) && (proxyType1 == CAPSULE_SHAPE_PROXYTYPE))
+	{
+		return m_triangleCapsuleCF;
+	}
+
+	if ((proxyType0 == SDF_SHAPE_PROXYTYPE) && (proxyType1 == SDF_SHAPE_PROXYTYPE))
+	{
+		return m_sdfSdfCF;
+	}
+
 	if (btBroadphaseProxy::isConvex(proxyType0) && (proxyType1 == STATIC_PLANE_PROXYTYPE))
 	{
 		return m_convexPlaneCF;
@@ -292,11 +359,43 @@ btCollisionAlgorithmCreateFunc* btDefaultCollisionConfiguration::getCollisionAlg
 		return m_triangleSphereCF;
 	}
 
+#ifndef BT_DISABLE_CAPSULE_CAPSULE_COLLIDER
+	if ((proxyType0 == CAPSULE_SHAPE_PROXYTYPE) && (proxyType1 == CAPSULE_SHAPE_PROXYTYPE))
+	{
+		return m_capsuleCapsuleCF;
+	}
+#endif  //BT_DISABLE_CAPSULE_CAPSULE_COLLIDER
+
+	if ((proxyType0 == CAPSULE_SHAPE_PROXYTYPE) && (proxyType1 == BOX_SHAPE_PROXYTYPE))
+	{
+		return m_capsuleBoxCF;
+	}
+
+	if ((proxyType0 == BOX_SHAPE_PROXYTYPE) && (proxyType1 == CAPSULE_SHAPE_PROXYTYPE))
+	{
+		return m_boxCapsuleCF;
+	}
+
+	if ((proxyType0 == CAPSULE_SHAPE_PROXYTYPE) && (proxyType1 == TRIANGLE_SHAPE_PROXYTYPE))
+	{
+		return m_capsuleTriangleCF;
+	}
+
+	if ((proxyType0 == TRIANGLE_SHAPE_PROXYTYPE) && (proxyType1 == CAPSULE_SHAPE_PROXYTYPE))
+	{
+		return m_triangleCapsuleCF;
+	}
+
 	if ((proxyType0 == BOX_SHAPE_PROXYTYPE) && (proxyType1 == BOX_SHAPE_PROXYTYPE))
 	{
 		return m_boxBoxCF;
 	}
 
+	if ((proxyType0 == SDF_SHAPE_PROXYTYPE) && (proxyType1 == SDF_SHAPE_PROXYTYPE))
+	{
+		return m_sdfSdfCF;
+	}
+
 	if (btBroadphaseProxy::isConvex(proxyType0) && (proxyType1 == STATIC_PLANE_PROXYTYPE))
 	{
 		return m_convexPlaneCF;
@@ -73,8 +73,14 @@ protected:
 	btCollisionAlgorithmCreateFunc* m_boxBoxCF;
 	btCollisionAlgorithmCreateFunc* m_sphereTriangleCF;
 	btCollisionAlgorithmCreateFunc* m_triangleSphereCF;
+	btCollisionAlgorithmCreateFunc* m_capsuleCapsuleCF;
+	btCollisionAlgorithmCreateFunc* m_capsuleBoxCF;
+	btCollisionAlgorithmCreateFunc* m_boxCapsuleCF;
+	btCollisionAlgorithmCreateFunc* m_capsuleTriangleCF;
+	btCollisionAlgorithmCreateFunc* m_triangleCapsuleCF;
 	btCollisionAlgorithmCreateFunc* m_planeConvexCF;
 	btCollisionAlgorithmCreateFunc* m_convexPlaneCF;
+	btCollisionAlgorithmCreateFunc* m_sdfSdfCF;
 
 public:
 	btDefaultCollisionConfiguration(const btDefaultCollisionConstructionInfo& constructionInfo = btDefaultCollisionConstructionInfo());
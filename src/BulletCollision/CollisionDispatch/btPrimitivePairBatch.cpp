@@ -0,0 +1,192 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2018 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btPrimitivePairBatch.h"
+#include "btCapsuleCapsuleCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+#include "BulletCollision/CollisionDispatch/btManifoldResult.h"
+#include "BulletCollision/CollisionShapes/btCapsuleShape.h"
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "LinearMath/btMinMax.h"
+#include "LinearMath/btQuickprof.h"
+
+bool btPrimitivePairBatch::isSupportedShapeType(int shapeType)
+{
+#ifdef BT_DISABLE_CAPSULE_CAPSULE_COLLIDER
+	return shapeType == SPHERE_SHAPE_PROXYTYPE;
+#else
+	return shapeType == SPHERE_SHAPE_PROXYTYPE || shapeType == CAPSULE_SHAPE_PROXYTYPE;
+#endif
+}
+
+void btPrimitivePairBatch::addPair(const btCollisionObject* obj0, const btCollisionObject* obj1, btPersistentManifold* manifold)
+{
+	const int i = m_numPairs++;
+	btBatchedPair& pair = m_pairs[i];
+	pair.m_obj0 = obj0;
+	pair.m_obj1 = obj1;
+	pair.m_manifold = manifold;
+	pair.m_spherePair = obj0->getCollisionShape()->getShapeType() == SPHERE_SHAPE_PROXYTYPE &&
+						obj1->getCollisionShape()->getShapeType() == SPHERE_SHAPE_PROXYTYPE;
+	pair.m_capsulePair = obj0->getCollisionShape()->getShapeType() == CAPSULE_SHAPE_PROXYTYPE &&
+						 obj1->getCollisionShape()->getShapeType() == CAPSULE_SHAPE_PROXYTYPE;
+
+	for (int j = 0; j < 2; j++)
+	{
+		const btCollisionObject* obj = j ? obj1 : obj0;
+		const btTransform& trans = obj->getWorldTransform();
+		btScalar halfLength = 0;
+		btScalar radius;
+		int upAxis = 1;
+		if (obj->getCollisionShape()->getShapeType() == CAPSULE_SHAPE_PROXYTYPE)
+		{
+			const btCapsuleShape* capsule = static_cast<const btCapsuleShape*>(obj->getCollisionShape());
+			upAxis = capsule->getUpAxis();
+			halfLength = capsule->getHalfHeight();
+			radius = capsule->getRadius();
+		}
+		else
+		{
+			radius = static_cast<const btSphereShape*>(obj->getCollisionShape())->getRadius();
+		}
+		const btMatrix3x3& basis = trans.getBasis();
+		btScalar(*center)[BLOCK_SIZE] = j ? m_centerB : m_centerA;
+		btScalar(*axis)[BLOCK_SIZE] = j ? m_axisB : m_axisA;
+		for (int k = 0; k < 3; k++)
+		{
+			center[k][i] = trans.getOrigin()[k];
+			axis[k][i] = basis[k][upAxis];
+		}
+		(j ? m_halfLengthB : m_halfLengthA)[i] = halfLength;
+		(j ? m_radiusB : m_radiusA)[i] = radius;
+	}
+
+	if (m_numPairs == BLOCK_SIZE)
+	{
+		processPairs();
+	}
+}
+
+//the segment-segment closest points of btCapsuleCapsuleCollisionAlgorithm::segmentsClosestPoints, with the branches replaced by selects
+void btPrimitivePairBatch::computeClosestPoints()
+{
+	const int numPairs = m_numPairs;
+	for (int i = 0; i < numPairs; i++)
+	{
+		const btScalar tx = m_centerB[0][i] - m_centerA[0][i];
+		const btScalar ty = m_centerB[1][i] - m_centerA[1][i];
+		const btScalar tz = m_centerB[2][i] - m_centerA[2][i];
+		const btScalar ux = m_axisA[0][i];
+		const btScalar uy = m_axisA[1][i];
+		const btScalar uz = m_axisA[2][i];
+		const btScalar vx = m_axisB[0][i];
+		const btScalar vy = m_axisB[1][i];
+		const btScalar vz = m_axisB[2][i];
+		const btScalar hA = m_halfLengthA[i];
+		const btScalar hB = m_halfLengthB[i];
+		const btScalar dirA_dot_dirB = ux * vx + uy * vy + uz * vz;
+		const btScalar dirA_dot_trans = ux * tx + uy * ty + uz * tz;
+		const btScalar dirB_dot_trans = vx * tx + vy * ty + vz * tz;
+
+		const btScalar denom = btScalar(1.) - dirA_dot_dirB * dirA_dot_dirB;
+		const btScalar safeDenom = denom != btScalar(0.) ? denom : btScalar(1.);
+		const btScalar tALine = (dirA_dot_trans - dirB_dot_trans * dirA_dot_dirB) / safeDenom;
+		btScalar tA = denom != btScalar(0.) ? btMin(btMax(tALine, -hA), hA) : btScalar(0.);
+
+		const btScalar tB = tA * dirA_dot_dirB - dirB_dot_trans;
+		const btScalar tBClamped = btMin(btMax(tB, -hB), hB);
+		const btScalar tAClamped = btMin(btMax(tBClamped * dirA_dot_dirB + dirA_dot_trans, -hA), hA);
+		tA = tBClamped != tB ? tAClamped : tA;
+
+		const btScalar x = tx - ux * tA + vx * tBClamped;
+		const btScalar y = ty - uy * tA + vy * tBClamped;
+		const btScalar z = tz - uz * tA + vz * tBClamped;
+		m_closest[0][i] = x;
+		m_closest[1][i] = y;
+		m_closest[2][i] = z;
+		m_paramB[i] = tBClamped;
+		m_distance[i] = btSqrt(x * x + y * y + z * z) - m_radiusA[i] - m_radiusB[i];
+	}
+}
+
+void btPrimitivePairBatch::processPairs()
+{
+	if (!m_numPairs)
+		return;
+
+	computeClosestPoints();
+
+	for (int i = 0; i < m_numPairs; i++)
+	{
+		const btBatchedPair& pair = m_pairs[i];
+		btPersistentManifold* manifold = pair.m_manifold;
+
+		//spheres only keep touching contacts (btSphereSphereCollisionAlgorithm), capsules anything within the breaking threshold.
+		//The default near callback has no closest point distance threshold
+		const btScalar dist = m_distance[i];
+		const bool addContact = pair.m_spherePair ? !(dist > btScalar(0.)) : dist < manifold->getContactBreakingThreshold();
+		if (!addContact)
+		{
+			//the existing contacts only need a refresh, done without a btManifoldResult
+			if (manifold->getNumContacts())
+			{
+				if (manifold->getBody0() != pair.m_obj0)
+				{
+					manifold->refreshContactPoints(pair.m_obj1->getWorldTransform(), pair.m_obj0->getWorldTransform());
+				}
+				else
+				{
+					manifold->refreshContactPoints(pair.m_obj0->getWorldTransform(), pair.m_obj1->getWorldTransform());
+				}
+			}
+			continue;
+		}
+
+		btCollisionObjectWrapper obj0Wrap(0, pair.m_obj0->getCollisionShape(), pair.m_obj0, pair.m_obj0->getWorldTransform(), -1, -1);
+		btCollisionObjectWrapper obj1Wrap(0, pair.m_obj1->getCollisionShape(), pair.m_obj1, pair.m_obj1->getWorldTransform(), -1, -1);
+		btManifoldResult resultOut(&obj0Wrap, &obj1Wrap);
+		resultOut.setPersistentManifold(manifold);
+
+		const btVector3 ptsVector(m_closest[0][i], m_closest[1][i], m_closest[2][i]);
+		const btScalar lenSqr = ptsVector.length2();
+		btVector3 normalOnB(1, 0, 0);
+		if (lenSqr > (SIMD_EPSILON * SIMD_EPSILON))
+		{
+			normalOnB = ptsVector * -btRecipSqrt(lenSqr);
+		}
+		else if (!pair.m_spherePair)
+		{
+			//degenerate case where 2 capsules are likely at the same location: take a vector tangential to the axis of A
+			btVector3 q;
+			btPlaneSpace1(btVector3(m_axisA[0][i], m_axisA[1][i], m_axisA[2][i]), normalOnB, q);
+		}
+		const btVector3 centerB(m_centerB[0][i], m_centerB[1][i], m_centerB[2][i]);
+		const btVector3 axisB(m_axisB[0][i], m_axisB[1][i], m_axisB[2][i]);
+		const btVector3 pointOnB = centerB + axisB * m_paramB[i] + normalOnB * m_radiusB[i];
+		resultOut.addContactPoint(normalOnB, pointOnB, dist);
+		if (pair.m_capsulePair)
+		{
+			const btVector3 centerA(m_centerA[0][i], m_centerA[1][i], m_centerA[2][i]);
+			const btVector3 axisA(m_axisA[0][i], m_axisA[1][i], m_axisA[2][i]);
+			btCapsuleCapsuleCollisionAlgorithm::addParallelContacts(centerA, axisA, m_halfLengthA[i], m_radiusA[i], centerB, axisB, m_halfLengthB[i], m_radiusB[i],
+																	 normalOnB, manifold->getContactBreakingThreshold(), &resultOut);
+		}
+		resultOut.refreshContactPoints();
+	}
+
+	m_numPairs = 0;
+}
@@ -0,0 +1,91 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2018 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_PRIMITIVE_PAIR_BATCH_H
+#define BT_PRIMITIVE_PAIR_BATCH_H
+
+#include "LinearMath/btScalar.h"
+
+class btCollisionObject;
+class btPersistentManifold;
+
+///btPrimitivePairBatch computes the contacts of many sphere and capsule pairs at once, used by btCollisionDispatcher
+///when CD_BATCH_PRIMITIVE_PAIRS is set. Every shape is reduced to a segment (center, unit axis and half length) with a
+///radius, a sphere being a segment of zero length, so all pair types share one closed form segment-segment routine.
+///The pair data is gathered in structure-of-arrays form and the routine runs as a branch-free loop over blocks of pairs,
+///which the compiler turns into SIMD code processing 4 or 8 pairs at a time. The contacts are then added to the
+///persistent manifolds of the pairs, with the same results as btSphereSphereCollisionAlgorithm,
+///btCapsuleCapsuleCollisionAlgorithm and the sphere-capsule path of btConvexConvexAlgorithm.
+class btPrimitivePairBatch
+{
+public:
+	///the pairs are processed in blocks of this size, so the gathered data and the manifolds stay in the cache
+	enum
+	{
+		BLOCK_SIZE = 64
+	};
+
+private:
+	struct btBatchedPair
+	{
+		const btCollisionObject* m_obj0;
+		const btCollisionObject* m_obj1;
+		btPersistentManifold* m_manifold;
+		bool m_spherePair;
+		bool m_capsulePair;
+	};
+
+	btBatchedPair m_pairs[BLOCK_SIZE];
+	int m_numPairs;
+
+	//structure-of-arrays input, one entry per pair
+	btScalar m_centerA[3][BLOCK_SIZE];
+	btScalar m_axisA[3][BLOCK_SIZE];
+	btScalar m_halfLengthA[BLOCK_SIZE];
+	btScalar m_radiusA[BLOCK_SIZE];
+	btScalar m_centerB[3][BLOCK_SIZE];
+	btScalar m_axisB[3][BLOCK_SIZE];
+	btScalar m_halfLengthB[BLOCK_SIZE];
+	btScalar m_radiusB[BLOCK_SIZE];
+
+	//output, the vector between the closest points of the segments, the segment parameter on B and the signed distance
+	btScalar m_closest[3][BLOCK_SIZE];
+	btScalar m_paramB[BLOCK_SIZE];
+	btScalar m_distance[BLOCK_SIZE];
+
+	void computeClosestPoints();
+
+public:
+	btPrimitivePairBatch()
+		: m_numPairs(0)
+	{
+	}
+
+	static bool isSupportedShapeType(int shapeType);
+
+	int getNumPairs() const
+	{
+		return m_numPairs;
+	}
+
+	///obj0 and obj1 must have a sphere or capsule shape, the manifold is the one owned by the collision algorithm of the pair.
+	///A full block is processed right away
+	void addPair(const btCollisionObject* obj0, const btCollisionObject* obj1, btPersistentManifold* manifold);
+
+	///computes the contacts of the pending pairs, adds them to their manifolds and empties the batch
+	void processPairs();
+};
+
+#endif  //BT_PRIMITIVE_PAIR_BATCH_H
@@ -0,0 +1,116 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2018 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btSdfSdfCollisionAlgorithm.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+#include "BulletCollision/CollisionDispatch/btManifoldResult.h"
+#include "LinearMath/btQuickprof.h"
+
+btSdfSdfCollisionAlgorithm::btSdfSdfCollisionAlgorithm(btPersistentManifold* mf, const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* col0Wrap, const btCollisionObjectWrapper* col1Wrap)
+	: btActivatingCollisionAlgorithm(ci, col0Wrap, col1Wrap),
+	  m_ownManifold(false),
+	  m_manifoldPtr(mf)
+{
+	if (!m_manifoldPtr)
+	{
+		m_manifoldPtr = m_dispatcher->getNewManifold(col0Wrap->getCollisionObject(), col1Wrap->getCollisionObject());
+		m_ownManifold = true;
+	}
+}
+
+btSdfSdfCollisionAlgorithm::~btSdfSdfCollisionAlgorithm()
+{
+	if (m_ownManifold)
+	{
+		if (m_manifoldPtr)
+			m_dispatcher->releaseManifold(m_manifoldPtr);
+	}
+}
+
+void btSdfSdfCollisionAlgorithm::sampleAgainst(const btCollisionObjectWrapper* samplesWrap, const btCollisionObjectWrapper* fieldWrap, bool fieldIsBodyB, btManifoldResult* resultOut)
+{
+	const btSdfCollisionShape* samplesShape = (const btSdfCollisionShape*)samplesWrap->getCollisionShape();
+	const btSdfCollisionShape* fieldShape = (const btSdfCollisionShape*)fieldWrap->getCollisionShape();
+
+	const btAlignedObjectArray<btVector3>& samples = samplesShape->getSurfaceSamples();
+	int numSamples = samples.size();
+	if (!numSamples)
+		return;
+
+	const btTransform& fieldTr = fieldWrap->getWorldTransform();
+	btTransform samplesToField = fieldTr.inverseTimes(samplesWrap->getWorldTransform());
+
+	m_query.resize(numSamples);
+	for (int i = 0; i < numSamples; i++)
+	{
+		m_query.m_points[i] = samplesToField * samples[i];
+	}
+	btScalar maxDist = samplesShape->getMargin() + fieldShape->getMargin() + resultOut->m_closestPointDistanceThreshold + SIMD_EPSILON;
+	if (!fieldShape->queryPoints(&m_query.m_points[0], numSamples, &m_query.m_distances[0], &m_query.m_normals[0], &m_query.m_hasResult[0], maxDist))
+		return;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		if (!m_query.m_hasResult[i])
+			continue;
+		btScalar dist = m_query.m_distances[i];
+		btVector3 normalLocal = m_query.m_normals[i];
+		normalLocal.safeNormalize();
+		btVector3 normal = fieldTr.getBasis() * normalLocal;
+		btVector3 ptWorld = fieldTr * m_query.m_points[i];
+		if (fieldIsBodyB)
+		{
+			//sample on A, closest point on B lies along the field normal
+			resultOut->addContactPoint(normal, ptWorld - normal * dist, dist);
+		}
+		else
+		{
+			//sample on B, the field of A pushes it out along -normalOnB
+			resultOut->addContactPoint(-normal, ptWorld, dist);
+		}
+	}
+}
+
+void btSdfSdfCollisionAlgorithm::processCollision(const btCollisionObjectWrapper* col0Wrap, const btCollisionObjectWrapper* col1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	BT_PROFILE("btSdfSdfCollisionAlgorithm::processCollision");
+	(void)dispatchInfo;
+
+	if (!m_manifoldPtr)
+		return;
+
+	resultOut->setPersistentManifold(m_manifoldPtr);
+
+	sampleAgainst(col0Wrap, col1Wrap, true, resultOut);
+	sampleAgainst(col1Wrap, col0Wrap, false, resultOut);
+
+	if (m_ownManifold)
+	{
+		resultOut->refreshContactPoints();
+	}
+}
+
+btScalar btSdfSdfCollisionAlgorithm::calculateTimeOfImpact(btCollisionObject* col0, btCollisionObject* col1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)col0;
+	(void)col1;
+	(void)dispatchInfo;
+	(void)resultOut;
+
+	//not yet
+	return btScalar(1.);
+}
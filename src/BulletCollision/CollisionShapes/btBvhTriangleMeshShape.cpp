@@ -25,6 +25,7 @@ btBvhTriangleMeshShape::btBvhTriangleMeshShape(btStridingMeshInterface* meshInte
 	: btTriangleMeshShape(meshInterface),
 	  m_bvh(0),
 	  m_triangleInfoMap(0),
+	  m_meshRevision(0),
 	  m_useQuantizedAabbCompression(useQuantizedAabbCompression),
 	  m_ownsBvh(false)
 {
@@ -44,6 +45,7 @@ btBvhTriangleMeshShape::btBvhTriangleMeshShape(btStridingMeshInterface* meshInte
 	: btTriangleMeshShape(meshInterface),
 	  m_bvh(0),
 	  m_triangleInfoMap(0),
+	  m_meshRevision(0),
 	  m_useQuantizedAabbCompression(useQuantizedAabbCompression),
 	  m_ownsBvh(false)
 {
@@ -66,6 +68,7 @@ btBvhTriangleMeshShape::btBvhTriangleMeshShape(btStridingMeshInterface* meshInte
 void btBvhTriangleMeshShape::partialRefitTree(const btVector3& aabbMin, const btVector3& aabbMax)
 {
 	m_bvh->refitPartial(m_meshInterface, aabbMin, aabbMax);
+	m_meshRevision++;
 
 	m_localAabbMin.setMin(aabbMin);
 	m_localAabbMax.setMax(aabbMax);
@@ -74,6 +77,7 @@ void btBvhTriangleMeshShape::partialRefitTree(const btVector3& aabbMin, const bt
 void btBvhTriangleMeshShape::refitTree(const btVector3& aabbMin, const btVector3& aabbMax)
 {
 	m_bvh->refit(m_meshInterface, aabbMin, aabbMax);
+	m_meshRevision++;
 
 	recalcLocalAabb();
 }
@@ -340,6 +344,7 @@ void btBvhTriangleMeshShape::buildOptimizedBvh()
 	//rebuild the bvh...
 	m_bvh->build(m_meshInterface, m_useQuantizedAabbCompression, m_localAabbMin, m_localAabbMax);
 	m_ownsBvh = true;
+	m_meshRevision++;
 }
 
 void btBvhTriangleMeshShape::setOptimizedBvh(btOptimizedBvh* bvh, const btVector3& scaling)
@@ -349,6 +354,7 @@ void btBvhTriangleMeshShape::setOptimizedBvh(btOptimizedBvh* bvh, const btVector
 
 	m_bvh = bvh;
 	m_ownsBvh = false;
+	m_meshRevision++;
 	// update the scaling without rebuilding the bvh
 	if ((getLocalScaling() - scaling).length2() > SIMD_EPSILON)
 	{
@@ -36,6 +36,7 @@ btBvhTriangleMeshShape : public btTriangleMeshShape
 {
 	btOptimizedBvh* m_bvh;
 	btTriangleInfoMap* m_triangleInfoMap;
+	int m_meshRevision;
 
 	bool m_useQuantizedAabbCompression;
 	bool m_ownsBvh;
@@ -70,6 +71,13 @@ public:
 	///for a fast incremental refit of parts of the tree. Note: the entire AABB of the tree will become more conservative, it never shrinks
 	void partialRefitTree(const btVector3& aabbMin, const btVector3& aabbMax);
 
+	///incremented whenever the bvh is built, replaced or refit, which is how in place changes of the mesh vertices
+	///are announced. Users that keep copies of triangles (see btConvexTriangleCallback) compare it to refetch them
+	int getMeshRevision() const
+	{
+		return m_meshRevision;
+	}
+
 	//debugging
 	virtual const char* getName() const { return "BVHTRIANGLEMESH"; }
 
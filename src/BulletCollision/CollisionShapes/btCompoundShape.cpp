@@ -104,6 +104,35 @@ void btCompoundShape::updateChildTransform(int childIndex, const btTransform& ne
 	}
 }
 
+void btCompoundShape::updateChildTransforms(int numChildren, const int* childIndices, const btTransform* newChildTransforms)
+{
+	for (int i = 0; i < numChildren; i++)
+	{
+		btCompoundShapeChild& child = m_children[childIndices ? childIndices[i] : i];
+		child.m_transform = newChildTransforms[i];
+
+		if (m_dynamicAabbTree)
+		{
+			//only the leaf volume is set here, the tree is refit below
+			btVector3 localAabbMin, localAabbMax;
+			child.m_childShape->getAabb(child.m_transform, localAabbMin, localAabbMax);
+			child.m_node->volume = btDbvtVolume::FromMM(localAabbMin, localAabbMax);
+		}
+	}
+
+	if (m_dynamicAabbTree && m_dynamicAabbTree->m_root)
+	{
+		m_dynamicAabbTree->refit();
+		//the leaves are the child aabbs, so the root volume is the local aabb
+		m_localAabbMin = m_dynamicAabbTree->m_root->volume.Mins();
+		m_localAabbMax = m_dynamicAabbTree->m_root->volume.Maxs();
+	}
+	else
+	{
+		recalculateLocalAabb();
+	}
+}
+
 void btCompoundShape::removeChildShapeByIndex(int childShapeIndex)
 {
 	m_updateRevision++;
@@ -296,6 +325,7 @@ void btCompoundShape::createAabbTreeFromChildren()
 			size_t index2 = index;
 			child.m_node = m_dynamicAabbTree->insert(bounds, reinterpret_cast<void*>(index2));
 		}
+		m_dynamicAabbTree->optimizeNodeLayout();
 	}
 }
 
@@ -109,6 +109,11 @@ public:
 	///set a new transform for a child, and update internal data structures (local aabb and dynamic tree)
 	void updateChildTransform(int childIndex, const btTransform& newChildTransform, bool shouldRecalculateLocalAabb = true);
 
+	///set new transforms for many children at once: child childIndices[i] (or child i when childIndices is 0) gets newChildTransforms[i].
+	///The dynamic tree is refit bottom-up and the local aabb recalculated once, instead of once per child. Like updateChildTransform,
+	///the update revision is unchanged, so the child algorithms cached by the compound collision algorithms stay valid
+	void updateChildTransforms(int numChildren, const int* childIndices, const btTransform* newChildTransforms);
+
 	btCompoundShapeChild* getChildList()
 	{
 		return &m_children[0];
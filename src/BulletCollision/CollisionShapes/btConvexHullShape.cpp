@@ -116,6 +116,8 @@ btVector3 btConvexHullShape::localGetSupportingVertex(const btVector3& vec) cons
 void btConvexHullShape::optimizeConvexHull()
 {
 	btConvexHullComputer conv;
+	//large point clouds skip the points that can't be on the hull, the resulting hull is the same
+	conv.m_flags = btConvexHullComputer::CHC_PREFILTER_POINTS;
 	conv.compute(&m_unscaledPoints[0].getX(), sizeof(btVector3), m_unscaledPoints.size(), 0.f, 0.f);
 	int numVerts = conv.vertices.size();
 	m_unscaledPoints.resize(0);
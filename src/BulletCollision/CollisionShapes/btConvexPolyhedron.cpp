@@ -58,11 +58,13 @@ struct btInternalEdge
 {
 	btInternalEdge()
 		: m_face0(-1),
-		  m_face1(-1)
+		  m_face1(-1),
+		  m_uniqueEdge(-1)
 	{
 	}
 	short int m_face0;
 	short int m_face1;
+	int m_uniqueEdge;
 };
 
 //
@@ -119,6 +121,7 @@ void btConvexPolyhedron::initialize()
 			edge.normalize();
 
 			bool found = false;
+			int uniqueEdge = m_uniqueEdges.size();
 
 			for (int p = 0; p < m_uniqueEdges.size(); p++)
 			{
@@ -126,6 +129,7 @@ void btConvexPolyhedron::initialize()
 					IsAlmostZero1(m_uniqueEdges[p] + edge))
 				{
 					found = true;
+					uniqueEdge = p;
 					break;
 				}
 			}
@@ -145,11 +149,49 @@ void btConvexPolyhedron::initialize()
 			{
 				btInternalEdge ed;
 				ed.m_face0 = i;
+				ed.m_uniqueEdge = uniqueEdge;
 				edges.insert(vp, ed);
 			}
 		}
 	}
 
+	//group the adjacent face pairs of all hull edges by unique edge
+	m_uniqueEdgeFacesOffset.resize(0);
+	m_uniqueEdgeFacesOffset.resize(m_uniqueEdges.size() + 1, 0);
+	for (int i = 0; i < edges.size(); i++)
+	{
+		m_uniqueEdgeFacesOffset[edges.getAtIndex(i)->m_uniqueEdge + 1]++;
+	}
+	for (int i = 0; i < m_uniqueEdges.size(); i++)
+	{
+		m_uniqueEdgeFacesOffset[i + 1] += m_uniqueEdgeFacesOffset[i];
+	}
+	btAlignedObjectArray<int> numEdgeFaces;
+	numEdgeFaces.resize(m_uniqueEdges.size(), 0);
+	m_edgeFaces.resize(2 * edges.size());
+	for (int i = 0; i < edges.size(); i++)
+	{
+		const btInternalEdge& ed = *edges.getAtIndex(i);
+		int face0 = ed.m_face0;
+		int face1 = ed.m_face1;
+		if (face1 >= 0)
+		{
+			const btVector3 normal0(m_faces[face0].m_plane[0], m_faces[face0].m_plane[1], m_faces[face0].m_plane[2]);
+			const btVector3 normal1(m_faces[face1].m_plane[0], m_faces[face1].m_plane[1], m_faces[face1].m_plane[2]);
+			if (normal0.cross(normal1).length2() < btScalar(1e-8))
+			{
+				face1 = -1;
+			}
+		}
+		if (face1 < 0)
+		{
+			face0 = -1;
+		}
+		int index = m_uniqueEdgeFacesOffset[ed.m_uniqueEdge] + numEdgeFaces[ed.m_uniqueEdge]++;
+		m_edgeFaces[2 * index] = face0;
+		m_edgeFaces[2 * index + 1] = face1;
+	}
+
 #ifdef USE_CONNECTED_FACES
 	for (int i = 0; i < m_faces.size(); i++)
 	{
@@ -279,20 +321,17 @@ void btConvexPolyhedron::project(const btTransform& trans, const btVector3& dir,
 	minProj = FLT_MAX;
 	maxProj = -FLT_MAX;
 	int numVerts = m_vertices.size();
-	for (int i = 0; i < numVerts; i++)
+	if (numVerts)
 	{
-		btVector3 pt = trans * m_vertices[i];
-		btScalar dp = pt.dot(dir);
-		if (dp < minProj)
-		{
-			minProj = dp;
-			witnesPtMin = pt;
-		}
-		if (dp > maxProj)
-		{
-			maxProj = dp;
-			witnesPtMax = pt;
-		}
+		//project the local vertices on the local direction, so minDot/maxDot can use SIMD
+		const btVector3 localDir = dir * trans.getBasis();
+		const btScalar offset = dir.dot(trans.getOrigin());
+		long minIndex = localDir.minDot(&m_vertices[0], numVerts, minProj);
+		long maxIndex = localDir.maxDot(&m_vertices[0], numVerts, maxProj);
+		minProj += offset;
+		maxProj += offset;
+		witnesPtMin = trans * m_vertices[minIndex];
+		witnesPtMax = trans * m_vertices[maxIndex];
 	}
 	if (minProj > maxProj)
 	{
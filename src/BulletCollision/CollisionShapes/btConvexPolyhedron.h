@@ -42,6 +42,11 @@ public:
 	btAlignedObjectArray<btVector3> m_vertices;
 	btAlignedObjectArray<btFace> m_faces;
 	btAlignedObjectArray<btVector3> m_uniqueEdges;
+	///for each unique edge, the pairs of faces adjacent to the hull edges with that direction, used to prune
+	///edge-edge axes with Gauss map arc tests. The pairs of unique edge i are m_edgeFaces[2*m_uniqueEdgeFacesOffset[i]..2*m_uniqueEdgeFacesOffset[i+1]),
+	///a pair of -1 marks an edge (open or between coplanar faces) that can't be pruned. Left empty by initialize2.
+	btAlignedObjectArray<int> m_uniqueEdgeFacesOffset;
+	btAlignedObjectArray<int> m_edgeFaces;
 
 	btVector3 m_localCenter;
 	btVector3 m_extents;
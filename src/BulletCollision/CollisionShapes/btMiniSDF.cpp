@@ -149,9 +149,44 @@ bool btMiniSDF::load(const char* data, int size)
 	}
 
 	m_isValid = (ds.m_currentOffset == ds.m_size);
+	if (m_isValid)
+	{
+		buildCellCoefficients();
+	}
 	return m_isValid;
 }
 
+void btMiniSDF::buildCellCoefficients()
+{
+	m_cellCoefficients.resize(m_cells.size());
+	m_cellIsValid.resize(m_cells.size());
+	for (int field_id = 0; field_id < m_cells.size(); field_id++)
+	{
+		const btAlignedObjectArray<btCell32>& cells = m_cells[field_id];
+		const btAlignedObjectArray<double>& nodes = m_nodes[field_id];
+		btAlignedObjectArray<double>& coefs = m_cellCoefficients[field_id];
+		btAlignedObjectArray<unsigned char>& valid = m_cellIsValid[field_id];
+		coefs.resize(cells.size() * 32);
+		valid.resize(cells.size());
+		for (int i = 0; i < cells.size(); i++)
+		{
+			unsigned char cellValid = 1;
+			for (int j = 0; j < 32; j++)
+			{
+				unsigned int v = cells[i].m_cells[j];
+				double c = (v < (unsigned int)nodes.size()) ? nodes[v] : DBL_MAX;
+				if (c == DBL_MAX)
+				{
+					cellValid = 0;
+					c = 0.;
+				}
+				coefs[i * 32 + j] = c;
+			}
+			valid[i] = cellValid;
+		}
+	}
+}
+
 unsigned int btMiniSDF::multiToSingleIndex(btMultiIndex const& ijk) const
 {
 	return m_resolution[1] * m_resolution[0] * ijk.ijk[2] + m_resolution[0] * ijk.ijk[1] + ijk.ijk[0];
@@ -439,13 +474,8 @@ btMiniSDF::shape_function_(btVector3 const& xi, btShapeGradients* gradient) cons
 	return res;
 }
 
-bool btMiniSDF::interpolate(unsigned int field_id, double& dist, btVector3 const& x,
-							btVector3* gradient) const
+bool btMiniSDF::locateCell(unsigned int field_id, btVector3 const& x, const double*& coefficients, btVector3& xi, btVector3& c0) const
 {
-	btAssert(m_isValid);
-	if (!m_isValid)
-		return false;
-
 	if (!m_domain.contains(x))
 		return false;
 
@@ -465,34 +495,43 @@ bool btMiniSDF::interpolate(unsigned int field_id, double& dist, btVector3 const
 	unsigned int i_ = m_cell_map[field_id][i];
 	if (i_ == UINT_MAX)
 		return false;
+	if (!m_cellIsValid[field_id][i_])
+		return false;
 
-	btAlignedBox3d sd = subdomain(i);
-	i = i_;
-	btVector3 d = sd.m_max - sd.m_min;  //.diagonal().eval();
+	btAlignedBox3d sd = subdomain(mui);
 
 	btVector3 denom = (sd.max() - sd.min());
-	btVector3 c0 = btVector3(2.0, 2.0, 2.0) / denom;
+	c0 = btVector3(2.0, 2.0, 2.0) / denom;
 	btVector3 c1 = (sd.max() + sd.min()) / denom;
-	btVector3 xi = (c0 * x - c1);
+	xi = (c0 * x - c1);
+	coefficients = &m_cellCoefficients[field_id][i_ * 32];
+	return true;
+}
+
+bool btMiniSDF::interpolate(unsigned int field_id, double& dist, btVector3 const& x,
+							btVector3* gradient) const
+{
+	btAssert(m_isValid);
+	if (!m_isValid)
+		return false;
+
+	const double* coefs = 0;
+	btVector3 xi, c0;
+	if (!locateCell(field_id, x, coefs, xi, c0))
+	{
+		if (gradient)
+			gradient->setZero();
+		return false;
+	}
 
-	btCell32 const& cell = m_cells[field_id][i];
 	if (!gradient)
 	{
-		//auto phi = m_coefficients[field_id][i].dot(shape_function_(xi, 0));
-		double phi = 0.0;
 		btShapeMatrix N = shape_function_(xi, 0);
+		double phi = 0.0;
 		for (unsigned int j = 0u; j < 32u; ++j)
 		{
-			unsigned int v = cell.m_cells[j];
-			double c = m_nodes[field_id][v];
-			if (c == DBL_MAX)
-			{
-				return false;
-				;
-			}
-			phi += c * N[j];
+			phi += coefs[j] * N[j];
 		}
-
 		dist = phi;
 		return true;
 	}
@@ -501,22 +540,66 @@ bool btMiniSDF::interpolate(unsigned int field_id, double& dist, btVector3 const
 	btShapeMatrix N = shape_function_(xi, &dN);
 
 	double phi = 0.0;
-	gradient->setZero();
+	double gx = 0.0, gy = 0.0, gz = 0.0;
 	for (unsigned int j = 0u; j < 32u; ++j)
 	{
-		unsigned int v = cell.m_cells[j];
-		double c = m_nodes[field_id][v];
-		if (c == DBL_MAX)
-		{
-			gradient->setZero();
-			return false;
-		}
+		double c = coefs[j];
 		phi += c * N[j];
-		(*gradient)[0] += c * dN(j, 0);
-		(*gradient)[1] += c * dN(j, 1);
-		(*gradient)[2] += c * dN(j, 2);
+		gx += c * dN(j, 0);
+		gy += c * dN(j, 1);
+		gz += c * dN(j, 2);
 	}
+	gradient->setValue(gx, gy, gz);
 	(*gradient) *= c0;
 	dist = phi;
 	return true;
 }
+
+int btMiniSDF::interpolateBatch(unsigned int field_id, const btVector3* points, int numPoints, btScalar* distOut, btVector3* gradientsOut, unsigned char* hasResultOut, btScalar maxDistance) const
+{
+	btAssert(m_isValid);
+	int numValid = 0;
+	if (!m_isValid)
+	{
+		for (int p = 0; p < numPoints; p++)
+			hasResultOut[p] = 0;
+		return 0;
+	}
+	btShapeGradients dN;
+	for (int p = 0; p < numPoints; p++)
+	{
+		const double* coefs = 0;
+		btVector3 xi, c0;
+		hasResultOut[p] = 0;
+		if (!locateCell(field_id, points[p], coefs, xi, c0))
+			continue;
+
+		//distance first, so the gradient is only evaluated for points that are close enough
+		btShapeMatrix N = shape_function_(xi, 0);
+		double phi = 0.0;
+		for (unsigned int j = 0u; j < 32u; ++j)
+		{
+			phi += coefs[j] * N[j];
+		}
+		if (phi > maxDistance)
+			continue;
+
+		if (gradientsOut)
+		{
+			shape_function_(xi, &dN);
+			double gx = 0.0, gy = 0.0, gz = 0.0;
+			for (unsigned int j = 0u; j < 32u; ++j)
+			{
+				double c = coefs[j];
+				gx += c * dN(j, 0);
+				gy += c * dN(j, 1);
+				gz += c * dN(j, 2);
+			}
+			gradientsOut[p].setValue(gx * c0[0], gy * c0[1], gz * c0[2]);
+		}
+		distOut[p] = phi;
+		hasResultOut[p] = 1;
+		numValid++;
+	}
+	return numValid;
+}
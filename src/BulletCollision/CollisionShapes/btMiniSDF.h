@@ -101,6 +101,12 @@ struct btMiniSDF
 	btAlignedObjectArray<btAlignedObjectArray<btCell32> > m_cells;
 	btAlignedObjectArray<btAlignedObjectArray<unsigned int> > m_cell_map;
 
+	///contiguous copy of the 32 node values of each cell (32 doubles per cell), built after loading
+	///so interpolation reads one block per cell instead of 32 scattered nodes
+	btAlignedObjectArray<btAlignedObjectArray<double> > m_cellCoefficients;
+	///0 if any node of the cell is undefined (DBL_MAX)
+	btAlignedObjectArray<btAlignedObjectArray<unsigned char> > m_cellIsValid;
+
 	btMiniSDF()
 		: m_isValid(false)
 	{
@@ -122,6 +128,15 @@ struct btMiniSDF
 	shape_function_(btVector3 const& xi, btShapeGradients* gradient = 0) const;
 
 	bool interpolate(unsigned int field_id, double& dist, btVector3 const& x, btVector3* gradient) const;
+
+	///evaluate numPoints points in one call. gradientsOut may be 0. hasResultOut[i] is 1 if points[i] has a valid distance
+	///not larger than maxDistance; gradients are only evaluated for those points. Returns the number of valid results
+	int interpolateBatch(unsigned int field_id, const btVector3* points, int numPoints, btScalar* distOut, btVector3* gradientsOut, unsigned char* hasResultOut, btScalar maxDistance = BT_LARGE_FLOAT) const;
+
+private:
+	void buildCellCoefficients();
+
+	bool locateCell(unsigned int field_id, btVector3 const& x, const double*& coefficients, btVector3& xi, btVector3& c0) const;
 };
 
 #endif  //MINISDF_H
@@ -70,6 +70,8 @@ bool btPolyhedralConvexShape::initializePolyhedralFeatures(int shiftVerticesByMa
 	}
 
 	btConvexHullComputer conv;
+	//large point clouds skip the points that can't be on the hull, the resulting hull is the same
+	conv.m_flags = btConvexHullComputer::CHC_PREFILTER_POINTS;
 
 	if (shiftVerticesByMargin)
 	{
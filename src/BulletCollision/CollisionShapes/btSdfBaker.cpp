@@ -0,0 +1,585 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2018 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btSdfBaker.h"
+#include "btStridingMeshInterface.h"
+#include "btTriangleCallback.h"
+#include "LinearMath/btThreads.h"
+#include "LinearMath/btQuickprof.h"
+#include <string.h>  //memcpy
+
+#define BT_SDF_BVH_LEAF_SIZE 4
+#define BT_SDF_BVH_MAX_DEPTH 128
+///clusters further away than this factor times their radius use the dipole approximation of the winding number
+#define BT_SDF_WINDING_FAR_FIELD 2.0
+
+struct btSdfTriangleCollector : public btInternalTriangleIndexCallback
+{
+	btAlignedObjectArray<btVector3>& m_vertices;
+
+	btSdfTriangleCollector(btAlignedObjectArray<btVector3>& vertices)
+		: m_vertices(vertices)
+	{
+	}
+
+	virtual void internalProcessTriangleIndex(btVector3* triangle, int partId, int triangleIndex)
+	{
+		(void)partId;
+		(void)triangleIndex;
+		m_vertices.push_back(triangle[0]);
+		m_vertices.push_back(triangle[1]);
+		m_vertices.push_back(triangle[2]);
+	}
+};
+
+struct btSdfBvhNode
+{
+	btVector3 m_aabbMin;
+	btVector3 m_aabbMax;
+	///sum of the area weighted normals of all triangles below this node
+	btVector3 m_areaNormal;
+	///area weighted centroid and the radius of a sphere around it bounding all triangles below this node
+	btVector3 m_center;
+	btScalar m_radius;
+	int m_firstTriangle;
+	///non-zero for leaf nodes. The left child of an internal node is the next node
+	int m_numTriangles;
+	int m_rightChild;
+};
+
+static btVector3 btClosestPointOnTriangle(const btVector3& p, const btVector3& a, const btVector3& b, const btVector3& c)
+{
+	btVector3 ab = b - a;
+	btVector3 ac = c - a;
+	btVector3 ap = p - a;
+	btScalar d1 = ab.dot(ap);
+	btScalar d2 = ac.dot(ap);
+	if (d1 <= btScalar(0) && d2 <= btScalar(0))
+		return a;
+
+	btVector3 bp = p - b;
+	btScalar d3 = ab.dot(bp);
+	btScalar d4 = ac.dot(bp);
+	if (d3 >= btScalar(0) && d4 <= d3)
+		return b;
+
+	btScalar vc = d1 * d4 - d3 * d2;
+	if (vc <= btScalar(0) && d1 >= btScalar(0) && d3 <= btScalar(0))
+	{
+		btScalar v = d1 / (d1 - d3);
+		return a + v * ab;
+	}
+
+	btVector3 cp = p - c;
+	btScalar d5 = ab.dot(cp);
+	btScalar d6 = ac.dot(cp);
+	if (d6 >= btScalar(0) && d5 <= d6)
+		return c;
+
+	btScalar vb = d5 * d2 - d1 * d6;
+	if (vb <= btScalar(0) && d2 >= btScalar(0) && d6 <= btScalar(0))
+	{
+		btScalar w = d2 / (d2 - d6);
+		return a + w * ac;
+	}
+
+	btScalar va = d3 * d6 - d5 * d4;
+	if (va <= btScalar(0) && (d4 - d3) >= btScalar(0) && (d5 - d6) >= btScalar(0))
+	{
+		btScalar w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		return b + w * (c - b);
+	}
+
+	btScalar denom = btScalar(1) / (va + vb + vc);
+	btScalar v = vb * denom;
+	btScalar w = vc * denom;
+	return a + ab * v + ac * w;
+}
+
+///signed solid angle of triangle abc seen from p (Van Oosterom and Strackee)
+static double btTriangleSolidAngle(const btVector3& p, const btVector3& a, const btVector3& b, const btVector3& c)
+{
+	btVector3 pa = a - p;
+	btVector3 pb = b - p;
+	btVector3 pc = c - p;
+	double la = pa.length();
+	double lb = pb.length();
+	double lc = pc.length();
+	double numer = pa.dot(pb.cross(pc));
+	double denom = la * lb * lc + pa.dot(pb) * lc + pb.dot(pc) * la + pc.dot(pa) * lb;
+	return 2.0 * atan2(numer, denom);
+}
+
+static btScalar btSdfAabbDistance2(const btVector3& p, const btVector3& aabbMin, const btVector3& aabbMax)
+{
+	btVector3 d(0, 0, 0);
+	for (int i = 0; i < 3; i++)
+	{
+		if (p[i] < aabbMin[i])
+			d[i] = aabbMin[i] - p[i];
+		else if (p[i] > aabbMax[i])
+			d[i] = p[i] - aabbMax[i];
+	}
+	return d.length2();
+}
+
+struct btSdfBvh
+{
+	btAlignedObjectArray<btVector3> m_vertices;
+	btAlignedObjectArray<btVector3> m_centroids;
+	btAlignedObjectArray<int> m_triangleIndices;
+	btAlignedObjectArray<btSdfBvhNode> m_nodes;
+
+	int numTriangles() const
+	{
+		return m_vertices.size() / 3;
+	}
+
+	///quickselect on the centroids so that the element at 'nth' is in sorted position along axis
+	void selectMedian(int begin, int end, int nth, int axis)
+	{
+		while (end - begin > 1)
+		{
+			btScalar pivot = m_centroids[m_triangleIndices[(begin + end) / 2]][axis];
+			int i = begin;
+			int j = end - 1;
+			while (i <= j)
+			{
+				while (m_centroids[m_triangleIndices[i]][axis] < pivot)
+					i++;
+				while (m_centroids[m_triangleIndices[j]][axis] > pivot)
+					j--;
+				if (i <= j)
+				{
+					m_triangleIndices.swap(i, j);
+					i++;
+					j--;
+				}
+			}
+			if (nth <= j)
+				end = j + 1;
+			else if (nth >= i)
+				begin = i;
+			else
+				break;
+		}
+	}
+
+	int buildNode(int begin, int end)
+	{
+		int nodeIndex = m_nodes.size();
+		m_nodes.expand();
+		btSdfBvhNode node;
+		node.m_aabbMin.setValue(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+		node.m_aabbMax.setValue(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+		node.m_areaNormal.setValue(0, 0, 0);
+		btVector3 centroidMin = node.m_aabbMin;
+		btVector3 centroidMax = node.m_aabbMax;
+		btVector3 weightedCenter(0, 0, 0);
+		btScalar totalArea = 0;
+		for (int i = begin; i < end; i++)
+		{
+			int t = m_triangleIndices[i];
+			const btVector3& a = m_vertices[t * 3];
+			const btVector3& b = m_vertices[t * 3 + 1];
+			const btVector3& c = m_vertices[t * 3 + 2];
+			node.m_aabbMin.setMin(a);
+			node.m_aabbMin.setMin(b);
+			node.m_aabbMin.setMin(c);
+			node.m_aabbMax.setMax(a);
+			node.m_aabbMax.setMax(b);
+			node.m_aabbMax.setMax(c);
+			centroidMin.setMin(m_centroids[t]);
+			centroidMax.setMax(m_centroids[t]);
+			btVector3 areaNormal = btScalar(0.5) * (b - a).cross(c - a);
+			btScalar area = areaNormal.length();
+			node.m_areaNormal += areaNormal;
+			weightedCenter += area * m_centroids[t];
+			totalArea += area;
+		}
+		node.m_center = totalArea > SIMD_EPSILON ? weightedCenter / totalArea : btScalar(0.5) * (node.m_aabbMin + node.m_aabbMax);
+		btScalar radius2 = 0;
+		for (int i = begin; i < end; i++)
+		{
+			int t = m_triangleIndices[i];
+			for (int v = 0; v < 3; v++)
+			{
+				radius2 = btMax(radius2, (m_vertices[t * 3 + v] - node.m_center).length2());
+			}
+		}
+		node.m_radius = btSqrt(radius2);
+		node.m_firstTriangle = begin;
+		node.m_numTriangles = 0;
+		node.m_rightChild = -1;
+
+		if (end - begin <= BT_SDF_BVH_LEAF_SIZE)
+		{
+			node.m_numTriangles = end - begin;
+			m_nodes[nodeIndex] = node;
+			return nodeIndex;
+		}
+
+		int axis = (centroidMax - centroidMin).maxAxis();
+		int mid = (begin + end) / 2;
+		selectMedian(begin, end, mid, axis);
+		m_nodes[nodeIndex] = node;
+
+		buildNode(begin, mid);
+		int right = buildNode(mid, end);
+		m_nodes[nodeIndex].m_rightChild = right;
+		return nodeIndex;
+	}
+
+	void build(const btStridingMeshInterface* mesh)
+	{
+		btSdfTriangleCollector collector(m_vertices);
+		btVector3 aabbMin(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+		btVector3 aabbMax(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+		mesh->InternalProcessAllTriangles(&collector, aabbMin, aabbMax);
+
+		int numTris = numTriangles();
+		m_centroids.resize(numTris);
+		m_triangleIndices.resize(numTris);
+		for (int t = 0; t < numTris; t++)
+		{
+			m_centroids[t] = (m_vertices[t * 3] + m_vertices[t * 3 + 1] + m_vertices[t * 3 + 2]) / btScalar(3);
+			m_triangleIndices[t] = t;
+		}
+		m_nodes.reserve(numTris / BT_SDF_BVH_LEAF_SIZE * 2 + 1);
+		if (numTris)
+		{
+			buildNode(0, numTris);
+		}
+	}
+
+	btScalar closestDistance(const btVector3& p) const
+	{
+		btScalar best2 = BT_LARGE_FLOAT;
+		int stack[BT_SDF_BVH_MAX_DEPTH];
+		int stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize)
+		{
+			const btSdfBvhNode& node = m_nodes[stack[--stackSize]];
+			if (btSdfAabbDistance2(p, node.m_aabbMin, node.m_aabbMax) >= best2)
+				continue;
+			if (node.m_numTriangles)
+			{
+				for (int i = node.m_firstTriangle; i < node.m_firstTriangle + node.m_numTriangles; i++)
+				{
+					int t = m_triangleIndices[i];
+					btVector3 closest = btClosestPointOnTriangle(p, m_vertices[t * 3], m_vertices[t * 3 + 1], m_vertices[t * 3 + 2]);
+					best2 = btMin(best2, (closest - p).length2());
+				}
+				continue;
+			}
+			int left = int(&node - &m_nodes[0]) + 1;
+			int right = node.m_rightChild;
+			btScalar dl = btSdfAabbDistance2(p, m_nodes[left].m_aabbMin, m_nodes[left].m_aabbMax);
+			btScalar dr = btSdfAabbDistance2(p, m_nodes[right].m_aabbMin, m_nodes[right].m_aabbMax);
+			//visit the nearest child first
+			if (dl < dr)
+			{
+				stack[stackSize++] = right;
+				stack[stackSize++] = left;
+			}
+			else
+			{
+				stack[stackSize++] = left;
+				stack[stackSize++] = right;
+			}
+		}
+		return btSqrt(best2);
+	}
+
+	///generalized winding number: close to 1 inside a closed mesh and 0 outside, robust to small holes
+	double windingNumber(const btVector3& p) const
+	{
+		double solidAngle = 0;
+		int stack[BT_SDF_BVH_MAX_DEPTH];
+		int stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize)
+		{
+			int nodeIndex = stack[--stackSize];
+			const btSdfBvhNode& node = m_nodes[nodeIndex];
+			if (node.m_numTriangles)
+			{
+				for (int i = node.m_firstTriangle; i < node.m_firstTriangle + node.m_numTriangles; i++)
+				{
+					int t = m_triangleIndices[i];
+					solidAngle += btTriangleSolidAngle(p, m_vertices[t * 3], m_vertices[t * 3 + 1], m_vertices[t * 3 + 2]);
+				}
+				continue;
+			}
+			btVector3 d = node.m_center - p;
+			double dist2 = d.length2();
+			double farDist = BT_SDF_WINDING_FAR_FIELD * node.m_radius;
+			if (dist2 > farDist * farDist)
+			{
+				//far field: the cluster acts as a single dipole
+				solidAngle += d.dot(node.m_areaNormal) / (dist2 * sqrt(dist2));
+				continue;
+			}
+			stack[stackSize++] = nodeIndex + 1;
+			stack[stackSize++] = node.m_rightChild;
+		}
+		return solidAngle / (4.0 * SIMD_PI);
+	}
+};
+
+///node numbering of the cubic Lagrange grid: first the cell corners, then two nodes on each x, y and z edge
+struct btSdfGridLayout
+{
+	unsigned int m_res[3];
+	btVector3 m_domainMin;
+	btVector3 m_cellSize;
+	unsigned int m_numVertexNodes;
+	unsigned int m_numXEdgeNodes;
+	unsigned int m_numYEdgeNodes;
+	unsigned int m_numZEdgeNodes;
+
+	void init(const unsigned int res[3], const btVector3& domainMin, const btVector3& cellSize)
+	{
+		m_res[0] = res[0];
+		m_res[1] = res[1];
+		m_res[2] = res[2];
+		m_domainMin = domainMin;
+		m_cellSize = cellSize;
+		m_numVertexNodes = (res[0] + 1) * (res[1] + 1) * (res[2] + 1);
+		m_numXEdgeNodes = 2 * res[0] * (res[1] + 1) * (res[2] + 1);
+		m_numYEdgeNodes = 2 * (res[0] + 1) * res[1] * (res[2] + 1);
+		m_numZEdgeNodes = 2 * (res[0] + 1) * (res[1] + 1) * res[2];
+	}
+
+	unsigned int numNodes() const
+	{
+		return m_numVertexNodes + m_numXEdgeNodes + m_numYEdgeNodes + m_numZEdgeNodes;
+	}
+
+	unsigned int vertexNode(unsigned int i, unsigned int j, unsigned int k) const
+	{
+		return i + (m_res[0] + 1) * (j + (m_res[1] + 1) * k);
+	}
+	unsigned int xEdgeNode(unsigned int i, unsigned int j, unsigned int k, unsigned int t) const
+	{
+		return m_numVertexNodes + 2 * (i + m_res[0] * (j + (m_res[1] + 1) * k)) + t;
+	}
+	unsigned int yEdgeNode(unsigned int i, unsigned int j, unsigned int k, unsigned int t) const
+	{
+		return m_numVertexNodes + m_numXEdgeNodes + 2 * (i + (m_res[0] + 1) * (j + m_res[1] * k)) + t;
+	}
+	unsigned int zEdgeNode(unsigned int i, unsigned int j, unsigned int k, unsigned int t) const
+	{
+		return m_numVertexNodes + m_numXEdgeNodes + m_numYEdgeNodes + 2 * (i + (m_res[0] + 1) * (j + (m_res[1] + 1) * k)) + t;
+	}
+
+	btVector3 nodePosition(unsigned int n) const
+	{
+		btScalar third = btScalar(1) / btScalar(3);
+		btScalar x, y, z;
+		if (n < m_numVertexNodes)
+		{
+			x = btScalar(n % (m_res[0] + 1));
+			y = btScalar((n / (m_res[0] + 1)) % (m_res[1] + 1));
+			z = btScalar(n / ((m_res[0] + 1) * (m_res[1] + 1)));
+		}
+		else if ((n -= m_numVertexNodes) < m_numXEdgeNodes)
+		{
+			unsigned int e = n / 2;
+			x = btScalar(e % m_res[0]) + btScalar(n % 2 + 1) * third;
+			y = btScalar((e / m_res[0]) % (m_res[1] + 1));
+			z = btScalar(e / (m_res[0] * (m_res[1] + 1)));
+		}
+		else if ((n -= m_numXEdgeNodes) < m_numYEdgeNodes)
+		{
+			unsigned int e = n / 2;
+			x = btScalar(e % (m_res[0] + 1));
+			y = btScalar((e / (m_res[0] + 1)) % m_res[1]) + btScalar(n % 2 + 1) * third;
+			z = btScalar(e / ((m_res[0] + 1) * m_res[1]));
+		}
+		else
+		{
+			n -= m_numYEdgeNodes;
+			unsigned int e = n / 2;
+			x = btScalar(e % (m_res[0] + 1));
+			y = btScalar((e / (m_res[0] + 1)) % (m_res[1] + 1));
+			z = btScalar(e / ((m_res[0] + 1) * (m_res[1] + 1))) + btScalar(n % 2 + 1) * third;
+		}
+		return m_domainMin + btVector3(x, y, z) * m_cellSize;
+	}
+
+	///the 32 node indices of a cell, in the order of btMiniSDF::shape_function_
+	void cellNodes(unsigned int i, unsigned int j, unsigned int k, unsigned int nodes[32]) const
+	{
+		for (unsigned int c = 0; c < 8; c++)
+		{
+			nodes[c] = vertexNode(i + (c & 1), j + ((c >> 1) & 1), k + ((c >> 2) & 1));
+		}
+		for (unsigned int m = 0; m < 8; m++)
+		{
+			unsigned int t = m & 1;
+			unsigned int q = m >> 1;
+			nodes[8 + m] = xEdgeNode(i, j + (q >> 1), k + (q & 1), t);
+			nodes[16 + m] = yEdgeNode(i + (q & 1), j, k + (q >> 1), t);
+			nodes[24 + m] = zEdgeNode(i + (q >> 1), j + (q & 1), k, t);
+		}
+	}
+};
+
+struct btSdfBakeNodesLoop : public btIParallelForBody
+{
+	const btSdfBvh* m_bvh;
+	const btSdfGridLayout* m_layout;
+	double* m_values;
+
+	virtual void forLoop(int iBegin, int iEnd) const
+	{
+		for (int n = iBegin; n < iEnd; n++)
+		{
+			btVector3 p = m_layout->nodePosition(n);
+			double dist = m_bvh->closestDistance(p);
+			double winding = m_bvh->windingNumber(p);
+			m_values[n] = (winding > 0.5) ? -dist : dist;
+		}
+	}
+};
+
+template <class T>
+static void btSdfWrite(btAlignedObjectArray<char>& out, const T* values, int count)
+{
+	int bytes = int(sizeof(T)) * count;
+	if (!bytes)
+		return;
+	int offset = out.size();
+	out.resize(offset + bytes);
+	memcpy(&out[offset], values, bytes);
+}
+
+template <class T>
+static void btSdfWrite(btAlignedObjectArray<char>& out, const T& value)
+{
+	btSdfWrite(out, &value, 1);
+}
+
+bool btSdfBaker::bake(const btStridingMeshInterface* mesh, const btSdfBakeSettings& settings, btAlignedObjectArray<char>& sdfDataOut)
+{
+	BT_PROFILE("btSdfBaker::bake");
+	sdfDataOut.resize(0);
+	if (!mesh || settings.m_resolution[0] <= 0 || settings.m_resolution[1] <= 0 || settings.m_resolution[2] <= 0)
+		return false;
+
+	btSdfBvh bvh;
+	{
+		BT_PROFILE("buildBvh");
+		bvh.build(mesh);
+	}
+	if (!bvh.numTriangles())
+		return false;
+
+	btVector3 domainMin = bvh.m_nodes[0].m_aabbMin;
+	btVector3 domainMax = bvh.m_nodes[0].m_aabbMax;
+	if (settings.m_useCustomDomain)
+	{
+		domainMin = settings.m_domainMin;
+		domainMax = settings.m_domainMax;
+	}
+	else
+	{
+		btVector3 extent = domainMax - domainMin;
+		btScalar pad = settings.m_padding * extent[extent.maxAxis()];
+		pad = btMax(pad, SIMD_EPSILON);
+		domainMin -= btVector3(pad, pad, pad);
+		domainMax += btVector3(pad, pad, pad);
+	}
+	btVector3 extent = domainMax - domainMin;
+	if (extent[extent.minAxis()] <= btScalar(0))
+		return false;
+
+	unsigned int res[3] = {(unsigned int)settings.m_resolution[0], (unsigned int)settings.m_resolution[1], (unsigned int)settings.m_resolution[2]};
+	btVector3 cellSize = extent / btVector3(btScalar(res[0]), btScalar(res[1]), btScalar(res[2]));
+	btSdfGridLayout layout;
+	layout.init(res, domainMin, cellSize);
+
+	unsigned int numCells = res[0] * res[1] * res[2];
+	unsigned int numNodes = layout.numNodes();
+	btAlignedObjectArray<double> values;
+	values.resize(numNodes);
+	{
+		BT_PROFILE("evaluateNodes");
+		btSdfBakeNodesLoop loop;
+		loop.m_bvh = &bvh;
+		loop.m_layout = &layout;
+		loop.m_values = &values[0];
+#if BT_THREADSAFE
+		if (btGetTaskScheduler())
+		{
+			btParallelFor(0, int(numNodes), btMax(1, settings.m_grainSize), loop);
+		}
+		else
+#endif
+		{
+			loop.forLoop(0, int(numNodes));
+		}
+	}
+
+	//same layout as btMiniSDF::load expects
+	unsigned long long int totalBytes = 6 * 8 + 3 * 4 + 6 * 8 + 2 * 8 + 3 * (8 + 8) + 8ull * numNodes + (32ull * 4 + 4) * numCells;
+	if (totalBytes > 0x7fffffffull)
+		return false;
+	sdfDataOut.reserve(int(totalBytes));
+
+	double domain[6] = {domainMin[0], domainMin[1], domainMin[2], domainMax[0], domainMax[1], domainMax[2]};
+	btSdfWrite(sdfDataOut, domain, 6);
+	btSdfWrite(sdfDataOut, res, 3);
+	double cellSizeD[3] = {cellSize[0], cellSize[1], cellSize[2]};
+	btSdfWrite(sdfDataOut, cellSizeD, 3);
+	double invCellSize[3] = {1.0 / cellSizeD[0], 1.0 / cellSizeD[1], 1.0 / cellSizeD[2]};
+	btSdfWrite(sdfDataOut, invCellSize, 3);
+	unsigned long long int count = numCells;
+	btSdfWrite(sdfDataOut, count);
+	unsigned long long int numFields = 1;
+	btSdfWrite(sdfDataOut, numFields);
+
+	btSdfWrite(sdfDataOut, numFields);
+	count = numNodes;
+	btSdfWrite(sdfDataOut, count);
+	btSdfWrite(sdfDataOut, &values[0], numNodes);
+
+	btSdfWrite(sdfDataOut, numFields);
+	count = numCells;
+	btSdfWrite(sdfDataOut, count);
+	for (unsigned int k = 0; k < res[2]; k++)
+	{
+		for (unsigned int j = 0; j < res[1]; j++)
+		{
+			for (unsigned int i = 0; i < res[0]; i++)
+			{
+				unsigned int nodes[32];
+				layout.cellNodes(i, j, k, nodes);
+				btSdfWrite(sdfDataOut, nodes, 32);
+			}
+		}
+	}
+
+	btSdfWrite(sdfDataOut, numFields);
+	count = numCells;
+	btSdfWrite(sdfDataOut, count);
+	for (unsigned int c = 0; c < numCells; c++)
+	{
+		btSdfWrite(sdfDataOut, c);
+	}
+	return true;
+}
@@ -0,0 +1,61 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2018 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_SDF_BAKER_H
+#define BT_SDF_BAKER_H
+
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+class btStridingMeshInterface;
+
+struct btSdfBakeSettings
+{
+	///number of grid cells along each axis
+	int m_resolution[3];
+	///the domain is the mesh bounds grown by m_padding times the largest extent, unless m_useCustomDomain is set
+	btScalar m_padding;
+	bool m_useCustomDomain;
+	btVector3 m_domainMin;
+	btVector3 m_domainMax;
+	///grid nodes per btParallelFor task
+	int m_grainSize;
+
+	btSdfBakeSettings()
+		: m_padding(0.1),
+		  m_useCustomDomain(false),
+		  m_domainMin(0, 0, 0),
+		  m_domainMax(0, 0, 0),
+		  m_grainSize(256)
+	{
+		m_resolution[0] = 32;
+		m_resolution[1] = 32;
+		m_resolution[2] = 32;
+	}
+};
+
+///btSdfBaker computes a signed distance field from a closed triangle mesh, in the same cubic Lagrange
+///layout that btMiniSDF::load reads (Discregrid .cdf), so no external tool is needed.
+///Unsigned distances use a closest-triangle query on a bounding volume hierarchy, the sign comes from
+///the generalized winding number (with a far-field dipole approximation), and the grid nodes are
+///evaluated with btParallelFor, so it uses the worker threads of the current btITaskScheduler.
+class btSdfBaker
+{
+public:
+	///serializes the field into sdfDataOut, ready for btSdfCollisionShape::initializeSDF or to be written as a .cdf file
+	static bool bake(const btStridingMeshInterface* mesh, const btSdfBakeSettings& settings, btAlignedObjectArray<char>& sdfDataOut);
+};
+
+#endif  //BT_SDF_BAKER_H
@@ -7,6 +7,7 @@ struct btSdfCollisionShapeInternalData
 	btVector3 m_localScaling;
 	btScalar m_margin;
 	btMiniSDF m_sdf;
+	btAlignedObjectArray<btVector3> m_surfaceSamples;
 
 	btSdfCollisionShapeInternalData()
 		: m_localScaling(1, 1, 1),
@@ -18,8 +19,51 @@ struct btSdfCollisionShapeInternalData
 bool btSdfCollisionShape::initializeSDF(const char* sdfData, int sizeInBytes)
 {
 	bool valid = m_data->m_sdf.load(sdfData, sizeInBytes);
+	m_data->m_surfaceSamples.resize(0);
+	if (valid)
+	{
+		computeSurfaceSamples();
+	}
 	return valid;
 }
+
+void btSdfCollisionShape::computeSurfaceSamples()
+{
+	const btMiniSDF& sdf = m_data->m_sdf;
+	btScalar halfDiagonal = btScalar(0.5) * sdf.m_cell_size.length();
+	btMultiIndex mi;
+	for (mi.ijk[2] = 0; mi.ijk[2] < sdf.m_resolution[2]; mi.ijk[2]++)
+	{
+		for (mi.ijk[1] = 0; mi.ijk[1] < sdf.m_resolution[1]; mi.ijk[1]++)
+		{
+			for (mi.ijk[0] = 0; mi.ijk[0] < sdf.m_resolution[0]; mi.ijk[0]++)
+			{
+				btAlignedBox3d box = sdf.subdomain(mi);
+				btVector3 center = btScalar(0.5) * (box.min() + box.max());
+				double dist;
+				btVector3 grad;
+				if (!sdf.interpolate(0, dist, center, &grad))
+					continue;
+				if (btFabs(btScalar(dist)) > halfDiagonal)
+					continue;
+				btScalar len2 = grad.length2();
+				if (len2 < SIMD_EPSILON)
+					continue;
+				//one Newton step towards the zero level set
+				btVector3 pt = center - grad * (btScalar(dist) / len2);
+				if (box.contains(pt))
+				{
+					m_data->m_surfaceSamples.push_back(pt);
+				}
+			}
+		}
+	}
+}
+
+const btAlignedObjectArray<btVector3>& btSdfCollisionShape::getSurfaceSamples() const
+{
+	return m_data->m_surfaceSamples;
+}
 btSdfCollisionShape::btSdfCollisionShape()
 {
 	m_shapeType = SDF_SHAPE_PROXYTYPE;
@@ -90,3 +134,9 @@ bool btSdfCollisionShape::queryPoint(const btVector3& ptInSDF, btScalar& distOut
 	}
 	return hasResult;
 }
+
+int btSdfCollisionShape::queryPoints(const btVector3* ptsInSDF, int numPoints, btScalar* distOut, btVector3* normalsOut, unsigned char* hasResultOut, btScalar maxDistance) const
+{
+	int field = 0;
+	return m_data->m_sdf.interpolateBatch(field, ptsInSDF, numPoints, distOut, normalsOut, hasResultOut, maxDistance);
+}
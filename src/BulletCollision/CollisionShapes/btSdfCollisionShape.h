@@ -2,11 +2,31 @@
 #define BT_SDF_COLLISION_SHAPE_H
 
 #include "btConcaveShape.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+///scratch storage for batched SDF queries. Owned by a collision algorithm so it is reused between frames.
+struct btSdfQueryBuffer
+{
+	btAlignedObjectArray<btVector3> m_points;
+	btAlignedObjectArray<btVector3> m_normals;
+	btAlignedObjectArray<btScalar> m_distances;
+	btAlignedObjectArray<unsigned char> m_hasResult;
+
+	void resize(int numPoints)
+	{
+		m_points.resizeNoInitialize(numPoints);
+		m_normals.resizeNoInitialize(numPoints);
+		m_distances.resizeNoInitialize(numPoints);
+		m_hasResult.resizeNoInitialize(numPoints);
+	}
+};
 
 class btSdfCollisionShape : public btConcaveShape
 {
 	struct btSdfCollisionShapeInternalData* m_data;
 
+	void computeSurfaceSamples();
+
 public:
 	btSdfCollisionShape();
 	virtual ~btSdfCollisionShape();
@@ -24,6 +44,14 @@ public:
 	virtual void processAllTriangles(btTriangleCallback* callback, const btVector3& aabbMin, const btVector3& aabbMax) const;
 
 	bool queryPoint(const btVector3& ptInSDF, btScalar& distOut, btVector3& normal);
+
+	///batched version of queryPoint. hasResultOut[i] is set to 1 when distOut[i] and normalsOut[i] are valid,
+	///points further than maxDistance from the surface are skipped. Returns the number of points with a result
+	int queryPoints(const btVector3* ptsInSDF, int numPoints, btScalar* distOut, btVector3* normalsOut, unsigned char* hasResultOut, btScalar maxDistance = BT_LARGE_FLOAT) const;
+
+	///points (in local SDF space) on the zero level set, one per grid cell crossing the surface.
+	///Used to sample this field against another SDF. Computed in initializeSDF.
+	const btAlignedObjectArray<btVector3>& getSurfaceSamples() const;
 };
 
 #endif  //BT_SDF_COLLISION_SHAPE_H
@@ -25,6 +25,7 @@ subject to the following restrictions:
 int gExpectedNbTests = 0;
 int gActualNbTests = 0;
 bool gUseInternalObject = true;
+bool gUseGaussMapPruning = true;
 
 // Clips a face to the back of a plane
 void btPolyhedralContactClipping::clipFace(const btVertexArray& pVtxIn, btVertexArray& ppVtxOut, const btVector3& planeNormalWS, btScalar planeEqWS)
@@ -233,10 +234,49 @@ SIMD_FORCE_INLINE void btSegmentsClosestPoints(
 	ptsVector = translation - offsetA + offsetB;
 }
 
-bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, btVector3& sep, btDiscreteCollisionDetectorInterface::Result& resultOut)
+//returns true if the arc a-b and the arc c-d intersect on the unit sphere (Gauss map)
+static inline bool IsMinkowskiFace(const btVector3& a, const btVector3& b, const btVector3& c, const btVector3& d)
+{
+	const btVector3 bxa = b.cross(a);
+	const btVector3 dxc = d.cross(c);
+	const btScalar cba = c.dot(bxa);
+	const btScalar dba = d.dot(bxa);
+	const btScalar adc = a.dot(dxc);
+	const btScalar bdc = b.dot(dxc);
+	return cba * dba < 0 && adc * bdc < 0 && cba * bdc > 0;
+}
+
+//the cross product of unique edges e0 and e1 can only be a face normal of the Minkowski difference A-B (and thus
+//a candidate separating axis) if the Gauss map arcs of some pair of hull edges with those directions intersect
+static bool IsMinkowskiEdgePair(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, int e0, int e1, const btVertexArray& worldNormalsA, const btVertexArray& worldNormalsB)
+{
+	for (int i = hullA.m_uniqueEdgeFacesOffset[e0]; i < hullA.m_uniqueEdgeFacesOffset[e0 + 1]; i++)
+	{
+		const int faceA0 = hullA.m_edgeFaces[2 * i];
+		const int faceA1 = hullA.m_edgeFaces[2 * i + 1];
+		if (faceA0 < 0)
+			return true;
+		for (int j = hullB.m_uniqueEdgeFacesOffset[e1]; j < hullB.m_uniqueEdgeFacesOffset[e1 + 1]; j++)
+		{
+			const int faceB0 = hullB.m_edgeFaces[2 * j];
+			const int faceB1 = hullB.m_edgeFaces[2 * j + 1];
+			if (faceB0 < 0)
+				return true;
+			if (IsMinkowskiFace(worldNormalsA[faceA0], worldNormalsA[faceA1], -worldNormalsB[faceB0], -worldNormalsB[faceB1]))
+				return true;
+		}
+	}
+	return false;
+}
+
+bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, btVector3& sep, btDiscreteCollisionDetectorInterface::Result& resultOut, btPolyhedralSatCache* cache)
 {
 	gActualSATPairTests++;
 
+	btPolyhedralSatCache tmpCache;
+	if (!cache)
+		cache = &tmpCache;
+
 	//#ifdef TEST_INTERNAL_OBJECTS
 	const btVector3 c0 = transA * hullA.m_localCenter;
 	const btVector3 c1 = transB * hullB.m_localCenter;
@@ -247,11 +287,108 @@ bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& h
 	int curPlaneTests = 0;
 
 	int numFacesA = hullA.m_faces.size();
+	int numFacesB = hullB.m_faces.size();
+	int numEdgesA = hullA.m_uniqueEdges.size();
+	int numEdgesB = hullB.m_uniqueEdges.size();
+
+	int minFeatureType = btPolyhedralSatCache::BT_SAT_NONE;
+	int minFeatureA = -1;
+	int minFeatureB = -1;
+	btVector3 worldEdgeA;
+	btVector3 worldEdgeB;
+	btVector3 witnessPointA(0, 0, 0), witnessPointB(0, 0, 0);
+
+	// Try the feature that separated the hulls, or had the least penetration, in the previous call first.
+	// If it still separates we are done, otherwise its depth culls most of the other axes early.
+	int cachedType = btPolyhedralSatCache::BT_SAT_NONE;
+	int cachedA = -1;
+	int cachedB = -1;
+	{
+		btVector3 axis;
+		btVector3 WorldEdge0, WorldEdge1;
+		const int featureA = cache->m_featureA;
+		const int featureB = cache->m_featureB;
+		switch (cache->m_featureType)
+		{
+			case btPolyhedralSatCache::BT_SAT_FACE_A:
+				if (featureA >= 0 && featureA < numFacesA)
+				{
+					const btFace& face = hullA.m_faces[featureA];
+					axis = transA.getBasis() * btVector3(face.m_plane[0], face.m_plane[1], face.m_plane[2]);
+					cachedType = cache->m_featureType;
+				}
+				break;
+			case btPolyhedralSatCache::BT_SAT_FACE_B:
+				if (featureB >= 0 && featureB < numFacesB)
+				{
+					const btFace& face = hullB.m_faces[featureB];
+					axis = transB.getBasis() * btVector3(face.m_plane[0], face.m_plane[1], face.m_plane[2]);
+					cachedType = cache->m_featureType;
+				}
+				break;
+			case btPolyhedralSatCache::BT_SAT_EDGE_EDGE:
+				if (featureA >= 0 && featureA < numEdgesA && featureB >= 0 && featureB < numEdgesB)
+				{
+					WorldEdge0 = transA.getBasis() * hullA.m_uniqueEdges[featureA];
+					WorldEdge1 = transB.getBasis() * hullB.m_uniqueEdges[featureB];
+					axis = WorldEdge0.cross(WorldEdge1);
+					if (!IsAlmostZero(axis))
+					{
+						axis.normalize();
+						cachedType = cache->m_featureType;
+					}
+				}
+				break;
+			default:
+				break;
+		}
+
+		if (cachedType != btPolyhedralSatCache::BT_SAT_NONE)
+		{
+			cachedA = featureA;
+			cachedB = featureB;
+			if (DeltaC2.dot(axis) < 0)
+				axis *= -1.f;
+
+			btScalar d;
+			btVector3 wA, wB;
+			if (!TestSepAxis(hullA, hullB, transA, transB, axis, d, wA, wB))
+				return false;
+
+			dmin = d;
+			sep = axis;
+			minFeatureType = cachedType;
+			minFeatureA = featureA;
+			minFeatureB = featureB;
+			if (cachedType == btPolyhedralSatCache::BT_SAT_EDGE_EDGE)
+			{
+				worldEdgeA = WorldEdge0;
+				worldEdgeB = WorldEdge1;
+				witnessPointA = wA;
+				witnessPointB = wB;
+			}
+		}
+	}
+
+	// Gauss map pruning needs the face adjacency of the unique edges (see btConvexPolyhedron::initialize)
+	const bool pruneEdges = gUseGaussMapPruning &&
+							hullA.m_uniqueEdgeFacesOffset.size() == numEdgesA + 1 &&
+							hullB.m_uniqueEdgeFacesOffset.size() == numEdgesB + 1;
+	if (pruneEdges)
+	{
+		cache->m_worldNormalsA.resize(numFacesA);
+		cache->m_worldNormalsB.resize(numFacesB);
+	}
+
 	// Test normals from hullA
 	for (int i = 0; i < numFacesA; i++)
 	{
 		const btVector3 Normal(hullA.m_faces[i].m_plane[0], hullA.m_faces[i].m_plane[1], hullA.m_faces[i].m_plane[2]);
 		btVector3 faceANormalWS = transA.getBasis() * Normal;
+		if (pruneEdges)
+			cache->m_worldNormalsA[i] = faceANormalWS;
+		if (cachedType == btPolyhedralSatCache::BT_SAT_FACE_A && i == cachedA)
+			continue;
 		if (DeltaC2.dot(faceANormalWS) < 0)
 			faceANormalWS *= -1.f;
 
@@ -266,21 +403,32 @@ bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& h
 		btScalar d;
 		btVector3 wA, wB;
 		if (!TestSepAxis(hullA, hullB, transA, transB, faceANormalWS, d, wA, wB))
+		{
+			cache->m_featureType = btPolyhedralSatCache::BT_SAT_FACE_A;
+			cache->m_featureA = i;
+			cache->m_featureB = -1;
 			return false;
+		}
 
 		if (d < dmin)
 		{
 			dmin = d;
 			sep = faceANormalWS;
+			minFeatureType = btPolyhedralSatCache::BT_SAT_FACE_A;
+			minFeatureA = i;
+			minFeatureB = -1;
 		}
 	}
 
-	int numFacesB = hullB.m_faces.size();
 	// Test normals from hullB
 	for (int i = 0; i < numFacesB; i++)
 	{
 		const btVector3 Normal(hullB.m_faces[i].m_plane[0], hullB.m_faces[i].m_plane[1], hullB.m_faces[i].m_plane[2]);
 		btVector3 WorldNormal = transB.getBasis() * Normal;
+		if (pruneEdges)
+			cache->m_worldNormalsB[i] = WorldNormal;
+		if (cachedType == btPolyhedralSatCache::BT_SAT_FACE_B && i == cachedB)
+			continue;
 		if (DeltaC2.dot(WorldNormal) < 0)
 			WorldNormal *= -1.f;
 
@@ -295,30 +443,36 @@ bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& h
 		btScalar d;
 		btVector3 wA, wB;
 		if (!TestSepAxis(hullA, hullB, transA, transB, WorldNormal, d, wA, wB))
+		{
+			cache->m_featureType = btPolyhedralSatCache::BT_SAT_FACE_B;
+			cache->m_featureA = -1;
+			cache->m_featureB = i;
 			return false;
+		}
 
 		if (d < dmin)
 		{
 			dmin = d;
 			sep = WorldNormal;
+			minFeatureType = btPolyhedralSatCache::BT_SAT_FACE_B;
+			minFeatureA = -1;
+			minFeatureB = i;
 		}
 	}
 
-	btVector3 edgeAstart, edgeAend, edgeBstart, edgeBend;
-	int edgeA = -1;
-	int edgeB = -1;
-	btVector3 worldEdgeA;
-	btVector3 worldEdgeB;
-	btVector3 witnessPointA(0, 0, 0), witnessPointB(0, 0, 0);
-
 	int curEdgeEdge = 0;
 	// Test edges
-	for (int e0 = 0; e0 < hullA.m_uniqueEdges.size(); e0++)
+	for (int e0 = 0; e0 < numEdgesA; e0++)
 	{
 		const btVector3 edge0 = hullA.m_uniqueEdges[e0];
 		const btVector3 WorldEdge0 = transA.getBasis() * edge0;
-		for (int e1 = 0; e1 < hullB.m_uniqueEdges.size(); e1++)
+		for (int e1 = 0; e1 < numEdgesB; e1++)
 		{
+			if (cachedType == btPolyhedralSatCache::BT_SAT_EDGE_EDGE && e0 == cachedA && e1 == cachedB)
+				continue;
+			if (pruneEdges && !IsMinkowskiEdgePair(hullA, hullB, e0, e1, cache->m_worldNormalsA, cache->m_worldNormalsB))
+				continue;
+
 			const btVector3 edge1 = hullB.m_uniqueEdges[e1];
 			const btVector3 WorldEdge1 = transB.getBasis() * edge1;
 
@@ -340,14 +494,20 @@ bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& h
 				btScalar dist;
 				btVector3 wA, wB;
 				if (!TestSepAxis(hullA, hullB, transA, transB, Cross, dist, wA, wB))
+				{
+					cache->m_featureType = btPolyhedralSatCache::BT_SAT_EDGE_EDGE;
+					cache->m_featureA = e0;
+					cache->m_featureB = e1;
 					return false;
+				}
 
 				if (dist < dmin)
 				{
 					dmin = dist;
 					sep = Cross;
-					edgeA = e0;
-					edgeB = e1;
+					minFeatureType = btPolyhedralSatCache::BT_SAT_EDGE_EDGE;
+					minFeatureA = e0;
+					minFeatureB = e1;
 					worldEdgeA = WorldEdge0;
 					worldEdgeB = WorldEdge1;
 					witnessPointA = wA;
@@ -357,7 +517,11 @@ bool btPolyhedralContactClipping::findSeparatingAxis(const btConvexPolyhedron& h
 		}
 	}
 
-	if (edgeA >= 0 && edgeB >= 0)
+	cache->m_featureType = minFeatureType;
+	cache->m_featureA = minFeatureA;
+	cache->m_featureB = minFeatureB;
+
+	if (minFeatureType == btPolyhedralSatCache::BT_SAT_EDGE_EDGE)
 	{
 		//		printf("edge-edge\n");
 		//add an edge-edge contact
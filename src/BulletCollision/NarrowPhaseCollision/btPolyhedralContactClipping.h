@@ -26,6 +26,35 @@ class btConvexPolyhedron;
 
 typedef btAlignedObjectArray<btVector3> btVertexArray;
 
+///btPolyhedralSatCache remembers the feature (face or edge pair) that gave the separating axis, or the axis of
+///minimum penetration, of the last findSeparatingAxis call for a pair, so the next call can try it first.
+///Keep one per pair of hulls, for example in the collision algorithm.
+struct btPolyhedralSatCache
+{
+	enum btSatFeatureType
+	{
+		BT_SAT_NONE = 0,
+		BT_SAT_FACE_A,
+		BT_SAT_FACE_B,
+		BT_SAT_EDGE_EDGE
+	};
+
+	int m_featureType;
+	int m_featureA;
+	int m_featureB;
+
+	///world space face normals, used internally as scratch memory
+	btVertexArray m_worldNormalsA;
+	btVertexArray m_worldNormalsB;
+
+	btPolyhedralSatCache()
+		: m_featureType(BT_SAT_NONE),
+		  m_featureA(-1),
+		  m_featureB(-1)
+	{
+	}
+};
+
 // Clips a face to the back of a plane
 struct btPolyhedralContactClipping
 {
@@ -33,7 +62,7 @@ struct btPolyhedralContactClipping
 
 	static void clipFaceAgainstHull(const btVector3& separatingNormal, const btConvexPolyhedron& hullA, const btTransform& transA, btVertexArray& worldVertsB1, btVertexArray& worldVertsB2, const btScalar minDist, btScalar maxDist, btDiscreteCollisionDetectorInterface::Result& resultOut);
 
-	static bool findSeparatingAxis(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, btVector3& sep, btDiscreteCollisionDetectorInterface::Result& resultOut);
+	static bool findSeparatingAxis(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, btVector3& sep, btDiscreteCollisionDetectorInterface::Result& resultOut, btPolyhedralSatCache* cache = 0);
 
 	///the clipFace method is used internally
 	static void clipFace(const btVertexArray& pVtxIn, btVertexArray& ppVtxOut, const btVector3& planeNormalWS, btScalar planeEqWS);
@@ -32,6 +32,8 @@ enum btSolverMode
 	SOLVER_ALLOW_ZERO_LENGTH_FRICTION_DIRECTIONS = 1024,
 	SOLVER_DISABLE_IMPLICIT_CONE_FRICTION = 2048,
 	SOLVER_USE_ARTICULATED_WARMSTARTING = 4096,
+	///the multithreaded solvers give the same result for any number of threads, see btDiscreteDynamicsWorldMt
+	SOLVER_DETERMINISTIC_PARALLEL = 8192,
 };
 
 struct btContactSolverInfoData
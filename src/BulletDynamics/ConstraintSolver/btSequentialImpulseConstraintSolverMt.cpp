@@ -34,6 +34,7 @@ btSequentialImpulseConstraintSolverMt::btSequentialImpulseConstraintSolverMt()
 	m_numFrictionDirections = 1;
 	m_useBatching = false;
 	m_useObsoleteJointConstraints = false;
+	m_deterministic = false;
 }
 
 btSequentialImpulseConstraintSolverMt::~btSequentialImpulseConstraintSolverMt()
@@ -522,6 +523,17 @@ void btSequentialImpulseConstraintSolverMt::allocAllContactConstraints(btPersist
 	}
 	else
 	{
+		if (m_deterministic)
+		{
+			// dynamic bodies already have a solver body, give the kinematic ones theirs in manifold order
+			for (int i = 0; i < numManifolds; ++i)
+			{
+				btCollisionObject* colObj0 = (btCollisionObject*)manifoldPtr[i]->getBody0();
+				btCollisionObject* colObj1 = (btCollisionObject*)manifoldPtr[i]->getBody1();
+				getOrInitSolverBodyThreadsafe(*colObj0, infoGlobal.m_timeStep);
+				getOrInitSolverBodyThreadsafe(*colObj1, infoGlobal.m_timeStep);
+			}
+		}
 		// may alter ordering of bodies which affects determinism
 		CollectContactManifoldCachedInfoLoop loop(this, &cachedInfoArray[0], manifoldPtr, infoGlobal);
 		int grainSize = 200;
@@ -836,6 +848,7 @@ btScalar btSequentialImpulseConstraintSolverMt::solveGroupCacheFriendlySetup(
 	btIDebugDraw* debugDrawer)
 {
 	m_numFrictionDirections = (infoGlobal.m_solverMode & SOLVER_USE_2_FRICTION_DIRECTIONS) ? 2 : 1;
+	m_deterministic = (infoGlobal.m_solverMode & SOLVER_DETERMINISTIC_PARALLEL) != 0;
 	m_useBatching = false;
 	if (numManifolds >= s_minimumContactManifoldsForBatching &&
 		(s_allowNestedParallelForLoops || !btThreadsAreRunning()))
@@ -911,7 +924,7 @@ void btSequentialImpulseConstraintSolverMt::solveGroupCacheFriendlySplitImpulseI
 					int iPhase = batchedCons.m_phaseOrder[iiPhase];
 					const btBatchedConstraints::Range& phase = batchedCons.m_phases[iPhase];
 					int grainSize = batchedCons.m_phaseGrainSize[iPhase];
-					leastSquaresResidual += btParallelSum(phase.begin, phase.end, grainSize, loop);
+					leastSquaresResidual += parallelSumBatches(phase.begin, phase.end, grainSize, loop);
 				}
 			}
 			else
@@ -1201,6 +1214,46 @@ void btSequentialImpulseConstraintSolverMt::randomizeConstraintOrdering(int iter
 	}
 }
 
+struct BatchResidualsLoop : public btIParallelForBody
+{
+	const btIParallelSumBody* m_body;
+	btScalar* m_residuals;
+
+	BatchResidualsLoop(const btIParallelSumBody* body, btScalar* residuals)
+	{
+		m_body = body;
+		m_residuals = residuals;
+	}
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		for (int iBatch = iBegin; iBatch < iEnd; ++iBatch)
+		{
+			m_residuals[iBatch] = m_body->sumLoop(iBatch, iBatch + 1);
+		}
+	}
+};
+
+btScalar btSequentialImpulseConstraintSolverMt::parallelSumBatches(int batchBegin, int batchEnd, int grainSize, const btIParallelSumBody& body)
+{
+	if (!m_deterministic)
+	{
+		return btParallelSum(batchBegin, batchEnd, grainSize, body);
+	}
+	// how the batches are split into tasks depends on the number of threads, sum them in batch order instead
+	if (m_batchResiduals.size() < batchEnd)
+	{
+		m_batchResiduals.resizeNoInitialize(batchEnd);
+	}
+	BatchResidualsLoop loop(&body, &m_batchResiduals[0]);
+	btParallelFor(batchBegin, batchEnd, grainSize, loop);
+	btScalar sum = 0;
+	for (int iBatch = batchBegin; iBatch < batchEnd; ++iBatch)
+	{
+		sum += m_batchResiduals[iBatch];
+	}
+	return sum;
+}
+
 struct JointSolverLoop : public btIParallelSumBody
 {
 	btSequentialImpulseConstraintSolverMt* m_solver;
@@ -1237,7 +1290,7 @@ btScalar btSequentialImpulseConstraintSolverMt::resolveAllJointConstraints(int i
 		int iPhase = batchedCons.m_phaseOrder[iiPhase];
 		const btBatchedConstraints::Range& phase = batchedCons.m_phases[iPhase];
 		int grainSize = 1;
-		leastSquaresResidual += btParallelSum(phase.begin, phase.end, grainSize, loop);
+		leastSquaresResidual += parallelSumBatches(phase.begin, phase.end, grainSize, loop);
 	}
 	return leastSquaresResidual;
 }
@@ -1276,7 +1329,7 @@ btScalar btSequentialImpulseConstraintSolverMt::resolveAllContactConstraints()
 		int iPhase = batchedCons.m_phaseOrder[iiPhase];
 		const btBatchedConstraints::Range& phase = batchedCons.m_phases[iPhase];
 		int grainSize = batchedCons.m_phaseGrainSize[iPhase];
-		leastSquaresResidual += btParallelSum(phase.begin, phase.end, grainSize, loop);
+		leastSquaresResidual += parallelSumBatches(phase.begin, phase.end, grainSize, loop);
 	}
 	return leastSquaresResidual;
 }
@@ -1315,7 +1368,7 @@ btScalar btSequentialImpulseConstraintSolverMt::resolveAllContactFrictionConstra
 		int iPhase = batchedCons.m_phaseOrder[iiPhase];
 		const btBatchedConstraints::Range& phase = batchedCons.m_phases[iPhase];
 		int grainSize = batchedCons.m_phaseGrainSize[iPhase];
-		leastSquaresResidual += btParallelSum(phase.begin, phase.end, grainSize, loop);
+		leastSquaresResidual += parallelSumBatches(phase.begin, phase.end, grainSize, loop);
 	}
 	return leastSquaresResidual;
 }
@@ -1354,7 +1407,7 @@ btScalar btSequentialImpulseConstraintSolverMt::resolveAllContactConstraintsInte
 		int iPhase = batchedCons.m_phaseOrder[iiPhase];
 		const btBatchedConstraints::Range& phase = batchedCons.m_phases[iPhase];
 		int grainSize = 1;
-		leastSquaresResidual += btParallelSum(phase.begin, phase.end, grainSize, loop);
+		leastSquaresResidual += parallelSumBatches(phase.begin, phase.end, grainSize, loop);
 	}
 	return leastSquaresResidual;
 }
@@ -1414,7 +1467,7 @@ btScalar btSequentialImpulseConstraintSolverMt::resolveAllRollingFrictionConstra
 			int iPhase = batchedCons.m_phaseOrder[iiPhase];
 			const btBatchedConstraints::Range& phase = batchedCons.m_phases[iPhase];
 			int grainSize = 1;
-			leastSquaresResidual += btParallelSum(phase.begin, phase.end, grainSize, loop);
+			leastSquaresResidual += parallelSumBatches(phase.begin, phase.end, grainSize, loop);
 		}
 	}
 	else
@@ -51,7 +51,9 @@ subject to the following restrictions:
 ///  Note that a non-zero leastSquaresResidualThreshold could possibly affect the determinism of the simulation
 ///  if the task scheduler's parallelSum operation is non-deterministic. The parallelSum operation can be non-deterministic
 ///  because floating point addition is not associative due to rounding errors.
-///  The task scheduler can and should ensure that the result of any parallelSum operation is deterministic.
+///  With the SOLVER_DETERMINISTIC_PARALLEL flag the residual of every batch is stored and the batches are summed in
+///  order, and kinematic bodies get their solver body in manifold order, so the result does not depend on the number
+///  of threads.
 ///
 ATTRIBUTE_ALIGNED16(class)
 btSequentialImpulseConstraintSolverMt : public btSequentialImpulseConstraintSolver
@@ -100,6 +102,8 @@ protected:
 	int m_numFrictionDirections;
 	bool m_useBatching;
 	bool m_useObsoleteJointConstraints;
+	bool m_deterministic;
+	btAlignedObjectArray<btScalar> m_batchResiduals;  // residual per batch, summed in order by parallelSumBatches
 	btAlignedObjectArray<btContactManifoldCachedInfo> m_manifoldCachedInfoArray;
 	btAlignedObjectArray<int> m_rollingFrictionIndexTable;  // lookup table mapping contact index to rolling friction index
 	btSpinMutex m_bodySolverArrayMutex;
@@ -124,6 +128,7 @@ protected:
 	void allocAllContactConstraints(btPersistentManifold * *manifoldPtr, int numManifolds, const btContactSolverInfo& infoGlobal);
 	void setupAllContactConstraints(const btContactSolverInfo& infoGlobal);
 	void randomizeBatchedConstraintOrdering(btBatchedConstraints * batchedConstraints);
+	btScalar parallelSumBatches(int batchBegin, int batchEnd, int grainSize, const btIParallelSumBody& body);
 
 public:
 	BT_DECLARE_ALIGNED_ALLOCATOR();
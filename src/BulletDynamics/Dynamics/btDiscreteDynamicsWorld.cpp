@@ -193,6 +193,7 @@ btDiscreteDynamicsWorld::btDiscreteDynamicsWorld(btDispatcher* dispatcher, btBro
 	  m_sortedConstraints(),
 	  m_solverIslandCallback(NULL),
 	  m_constraintSolver(constraintSolver),
+	  m_useRigidBodyStateArrays(false),
 	  m_gravity(0, -10, 0),
 	  m_localTime(0),
 	  m_fixedTimeStep(0),
@@ -251,9 +252,9 @@ void btDiscreteDynamicsWorld::saveKinematicState(btScalar timeStep)
 	///would like to iterate over m_nonStaticRigidBodies, but unfortunately old API allows
 	///to switch status _after_ adding kinematic objects to the world
 	///fix it for Bullet 3.x release
-	for (int i = 0; i < m_collisionObjects.size(); i++)
+	for (int i = 0; i < m_activeCollisionObjects.size(); i++)
 	{
-		btCollisionObject* colObj = m_collisionObjects[i];
+		btCollisionObject* colObj = m_activeCollisionObjects[i];
 		btRigidBody* body = btRigidBody::upcast(colObj);
 		if (body && body->getActivationState() != ISLAND_SLEEPING)
 		{
@@ -321,11 +322,11 @@ void btDiscreteDynamicsWorld::clearForces()
 ///apply gravity, call this once per timestep
 void btDiscreteDynamicsWorld::applyGravity()
 {
-	///@todo: iterate over awake simulation islands!
-	for (int i = 0; i < m_nonStaticRigidBodies.size(); i++)
+	//sleeping bodies are not listed, static bodies ignore gravity
+	for (int i = 0; i < m_activeCollisionObjects.size(); i++)
 	{
-		btRigidBody* body = m_nonStaticRigidBodies[i];
-		if (body->isActive())
+		btRigidBody* body = btRigidBody::upcast(m_activeCollisionObjects[i]);
+		if (body && body->isActive())
 		{
 			body->applyGravity();
 		}
@@ -370,10 +371,10 @@ void btDiscreteDynamicsWorld::synchronizeMotionStates()
 	else
 	{
 		//iterate over all active rigid bodies
-		for (int i = 0; i < m_nonStaticRigidBodies.size(); i++)
+		for (int i = 0; i < m_activeCollisionObjects.size(); i++)
 		{
-			btRigidBody* body = m_nonStaticRigidBodies[i];
-			if (body->isActive())
+			btRigidBody* body = btRigidBody::upcast(m_activeCollisionObjects[i]);
+			if (body && body->isActive())
 				synchronizeSingleMotionState(body);
 		}
 	}
@@ -591,40 +592,60 @@ void btDiscreteDynamicsWorld::updateActions(btScalar timeStep)
 	}
 }
 
+static void updateRigidBodyActivationState(btRigidBody* body, btScalar timeStep)
+{
+	body->updateDeactivation(timeStep);
+
+	if (body->wantsSleeping())
+	{
+		if (body->isStaticOrKinematicObject())
+		{
+			body->setActivationState(ISLAND_SLEEPING);
+		}
+		else
+		{
+			if (body->getActivationState() == ACTIVE_TAG)
+				body->setActivationState(WANTS_DEACTIVATION);
+			if (body->getActivationState() == ISLAND_SLEEPING)
+			{
+				body->setAngularVelocity(btVector3(0, 0, 0));
+				body->setLinearVelocity(btVector3(0, 0, 0));
+			}
+		}
+	}
+	else
+	{
+		if (body->getActivationState() != DISABLE_DEACTIVATION)
+			body->setActivationState(ACTIVE_TAG);
+	}
+}
+
 void btDiscreteDynamicsWorld::updateActivationState(btScalar timeStep)
 {
 	BT_PROFILE("updateActivationState");
 
-	for (int i = 0; i < m_nonStaticRigidBodies.size(); i++)
+	if (gDisableDeactivation || (gDeactivationTime == btScalar(0.)))
 	{
-		btRigidBody* body = m_nonStaticRigidBodies[i];
-		if (body)
+		//deactivation is disabled globally, every sleeping body has to wake up
+		for (int i = 0; i < m_nonStaticRigidBodies.size(); i++)
 		{
-			body->updateDeactivation(timeStep);
+			btRigidBody* body = m_nonStaticRigidBodies[i];
+			body->clearListedWhileSleeping();
+			updateRigidBodyActivationState(body, timeStep);
+		}
+		return;
+	}
 
-			if (body->wantsSleeping())
-			{
-				if (body->isStaticOrKinematicObject())
-				{
-					body->setActivationState(ISLAND_SLEEPING);
-				}
-				else
-				{
-					if (body->getActivationState() == ACTIVE_TAG)
-						body->setActivationState(WANTS_DEACTIVATION);
-					if (body->getActivationState() == ISLAND_SLEEPING)
-					{
-						body->setAngularVelocity(btVector3(0, 0, 0));
-						body->setLinearVelocity(btVector3(0, 0, 0));
-					}
-				}
-			}
-			else
-			{
-				if (body->getActivationState() != DISABLE_DEACTIVATION)
-					body->setActivationState(ACTIVE_TAG);
-			}
+	//bodies that fell asleep during this step are still listed, so their velocities get cleared,
+	//and so are sleeping bodies whose velocity was set since the last step
+	for (int i = 0; i < m_activeCollisionObjects.size(); i++)
+	{
+		btRigidBody* body = btRigidBody::upcast(m_activeCollisionObjects[i]);
+		if (body && !body->isStaticObject())
+		{
+			updateRigidBodyActivationState(body, timeStep);
 		}
+		m_activeCollisionObjects[i]->clearListedWhileSleeping();
 	}
 }
 
@@ -934,9 +955,23 @@ void btDiscreteDynamicsWorld::createPredictiveContacts(btScalar timeStep)
 {
 	BT_PROFILE("createPredictiveContacts");
 	releasePredictiveContacts();
-	if (m_nonStaticRigidBodies.size() > 0)
+	updateActiveRigidBodies();
+	if (m_activeRigidBodies.size() > 0)
 	{
-		createPredictiveContactsInternal(&m_nonStaticRigidBodies[0], m_nonStaticRigidBodies.size(), timeStep);
+		createPredictiveContactsInternal(&m_activeRigidBodies[0], m_activeRigidBodies.size(), timeStep);
+	}
+}
+
+void btDiscreteDynamicsWorld::updateActiveRigidBodies()
+{
+	m_activeRigidBodies.resize(0);
+	for (int i = 0; i < m_activeCollisionObjects.size(); i++)
+	{
+		btRigidBody* body = btRigidBody::upcast(m_activeCollisionObjects[i]);
+		if (body && body->isActive() && !body->isStaticOrKinematicObject())
+		{
+			m_activeRigidBodies.push_back(body);
+		}
 	}
 }
 
@@ -1036,12 +1071,41 @@ void btDiscreteDynamicsWorld::integrateTransformsInternal(btRigidBody** bodies,
 	}
 }
 
+void btDiscreteDynamicsWorld::integrateTransformsStateArrays(btScalar timeStep)
+{
+	m_rigidBodyStates.m_bodies.copyFromArray(m_activeRigidBodies);
+	m_rigidBodyStates.predictIntegratedTransforms(timeStep);
+
+	btTransform predictedTrans;
+	for (int i = 0; i < m_rigidBodyStates.size(); i++)
+	{
+		btRigidBody* body = m_rigidBodyStates.m_bodies[i];
+		if (getDispatchInfo().m_useContinuous && body->getCcdSquareMotionThreshold() && body->getCcdSquareMotionThreshold() < m_rigidBodyStates.getPredictedSquareMotion(i))
+		{
+			//CCD motion clamping sweeps against the bodies moved so far, keep the order of the per body path
+			integrateTransformsInternal(&m_rigidBodyStates.m_bodies[i], 1, timeStep);
+			continue;
+		}
+		body->setHitFraction(1.f);
+		m_rigidBodyStates.getPredictedTransform(i, predictedTrans);
+		body->proceedToTransform(predictedTrans);
+	}
+}
+
 void btDiscreteDynamicsWorld::integrateTransforms(btScalar timeStep)
 {
 	BT_PROFILE("integrateTransforms");
-	if (m_nonStaticRigidBodies.size() > 0)
+	updateActiveRigidBodies();
+	if (m_activeRigidBodies.size() > 0)
 	{
-		integrateTransformsInternal(&m_nonStaticRigidBodies[0], m_nonStaticRigidBodies.size(), timeStep);
+		if (m_useRigidBodyStateArrays)
+		{
+			integrateTransformsStateArrays(timeStep);
+		}
+		else
+		{
+			integrateTransformsInternal(&m_activeRigidBodies[0], m_activeRigidBodies.size(), timeStep);
+		}
 	}
 
 	///this should probably be switched on by default, but it is not well tested yet
@@ -1083,10 +1147,25 @@ void btDiscreteDynamicsWorld::integrateTransforms(btScalar timeStep)
 void btDiscreteDynamicsWorld::predictUnconstraintMotion(btScalar timeStep)
 {
 	BT_PROFILE("predictUnconstraintMotion");
-	for (int i = 0; i < m_nonStaticRigidBodies.size(); i++)
+	//sleeping bodies have zero velocity, their predicted transform is their world transform
+	if (m_useRigidBodyStateArrays)
 	{
-		btRigidBody* body = m_nonStaticRigidBodies[i];
-		if (!body->isStaticOrKinematicObject())
+		m_rigidBodyStates.m_bodies.resize(0);
+		for (int i = 0; i < m_activeCollisionObjects.size(); i++)
+		{
+			btRigidBody* body = btRigidBody::upcast(m_activeCollisionObjects[i]);
+			if (body && !body->isStaticOrKinematicObject())
+			{
+				m_rigidBodyStates.m_bodies.push_back(body);
+			}
+		}
+		m_rigidBodyStates.predictUnconstraintMotion(timeStep);
+		return;
+	}
+	for (int i = 0; i < m_activeCollisionObjects.size(); i++)
+	{
+		btRigidBody* body = btRigidBody::upcast(m_activeCollisionObjects[i]);
+		if (body && !body->isStaticOrKinematicObject())
 		{
 			//don't integrate/update velocities here, it happens in the constraint solver
 
@@ -1459,3 +1538,98 @@ void btDiscreteDynamicsWorld::serialize(btSerializer* serializer)
 
 	serializer->finishSerialization();
 }
+
+unsigned int btDiscreteDynamicsWorld::hashState(unsigned int hash, const void* data, int numBytes)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (int i = 0; i < numBytes; i++)
+	{
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+unsigned int btDiscreteDynamicsWorld::hashCollisionObjectState(unsigned int hash, const btCollisionObject* colObj)
+{
+	const btTransform& trans = colObj->getWorldTransform();
+	hash = hashVector3(hash, trans.getBasis()[0]);
+	hash = hashVector3(hash, trans.getBasis()[1]);
+	hash = hashVector3(hash, trans.getBasis()[2]);
+	hash = hashVector3(hash, trans.getOrigin());
+	if (const btRigidBody* body = btRigidBody::upcast(colObj))
+	{
+		hash = hashVector3(hash, body->getLinearVelocity());
+		hash = hashVector3(hash, body->getAngularVelocity());
+	}
+	return hash;
+}
+
+struct btCollisionObjectStateHashLoop : public btIParallelForBody
+{
+	const btCollisionObjectArray* m_collisionObjects;
+	unsigned int* m_stateHashes;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			m_stateHashes[i] = btDiscreteDynamicsWorld::hashCollisionObjectState(2166136261u, (*m_collisionObjects)[i]);
+		}
+	}
+};
+
+unsigned int btDiscreteDynamicsWorld::computeStateHash(btAlignedObjectArray<unsigned int>& stateHashes) const
+{
+	BT_PROFILE("computeStateHash");
+	const int numObjects = m_collisionObjects.size();
+	stateHashes.resizeNoInitialize(numObjects);
+	if (numObjects)
+	{
+		btCollisionObjectStateHashLoop loop;
+		loop.m_collisionObjects = &m_collisionObjects;
+		loop.m_stateHashes = &stateHashes[0];
+#if BT_THREADSAFE
+		if (btGetTaskScheduler())
+		{
+			btParallelFor(0, numObjects, 64, loop);
+		}
+		else
+#endif
+		{
+			loop.forLoop(0, numObjects);
+		}
+	}
+
+	unsigned int hash = 2166136261u;
+	if (numObjects)
+	{
+		hash = hashState(hash, &stateHashes[0], numObjects * sizeof(unsigned int));
+	}
+	const int numManifolds = m_dispatcher1->getNumManifolds();
+	for (int i = 0; i < numManifolds; i++)
+	{
+		const btPersistentManifold* manifold = m_dispatcher1->getManifoldByIndexInternal(i);
+		const int ids[3] = {manifold->getBody0()->getWorldArrayIndex(), manifold->getBody1()->getWorldArrayIndex(), manifold->getNumContacts()};
+		hash = hashState(hash, ids, sizeof(ids));
+		for (int j = 0; j < manifold->getNumContacts(); j++)
+		{
+			const btManifoldPoint& pt = manifold->getContactPoint(j);
+			hash = hashVector3(hash, pt.m_positionWorldOnB);
+			hash = hashVector3(hash, pt.m_normalWorldOnB);
+			hash = hashState(hash, &pt.m_distance1, sizeof(btScalar));
+			hash = hashState(hash, &pt.m_appliedImpulse, sizeof(btScalar));
+		}
+	}
+	return hash;
+}
+
+int btDiscreteDynamicsWorld::findFirstStateDivergence(const btAlignedObjectArray<unsigned int>& stateHashesA, const btAlignedObjectArray<unsigned int>& stateHashesB)
+{
+	const int numHashes = btMin(stateHashesA.size(), stateHashesB.size());
+	for (int i = 0; i < numHashes; i++)
+	{
+		if (stateHashesA[i] != stateHashesB[i])
+			return i;
+	}
+	return stateHashesA.size() == stateHashesB.size() ? -1 : numHashes;
+}
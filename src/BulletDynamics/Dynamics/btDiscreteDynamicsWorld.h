@@ -30,6 +30,7 @@ struct InplaceSolverIslandCallback;
 
 #include "LinearMath/btAlignedObjectArray.h"
 #include "LinearMath/btThreads.h"
+#include "btRigidBodyStateArrays.h"
 
 ///btDiscreteDynamicsWorld provides discrete rigid body simulation
 ///those classes replace the obsolete CcdPhysicsEnvironment/CcdPhysicsController
@@ -47,6 +48,12 @@ protected:
 	btAlignedObjectArray<btTypedConstraint*> m_constraints;
 
 	btAlignedObjectArray<btRigidBody*> m_nonStaticRigidBodies;
+	///awake dynamic rigid bodies, gathered from the active collision objects for integrateTransforms and createPredictiveContacts
+	btAlignedObjectArray<btRigidBody*> m_activeRigidBodies;
+
+	///structure of arrays copy of the awake body state, used by predictUnconstraintMotion and integrateTransforms when enabled
+	btRigidBodyStateArrays m_rigidBodyStates;
+	bool m_useRigidBodyStateArrays;
 
 	btVector3 m_gravity;
 
@@ -72,6 +79,9 @@ protected:
 	virtual void predictUnconstraintMotion(btScalar timeStep);
 
 	void integrateTransformsInternal(btRigidBody * *bodies, int numBodies, btScalar timeStep);  // can be called in parallel
+
+	void updateActiveRigidBodies();
+	void integrateTransformsStateArrays(btScalar timeStep);
 	virtual void integrateTransforms(btScalar timeStep);
 
 	virtual void calculateSimulationIslands();
@@ -229,7 +239,39 @@ public:
 	{
 		return m_latencyMotionStateInterpolation;
 	}
+
+	///Damp and integrate the awake bodies in predictUnconstraintMotion and integrateTransforms with loops over a
+	///structure of arrays (see btRigidBodyStateArrays) instead of one body at a time. Off by default.
+	///btDiscreteDynamicsWorldMt runs these passes single threaded when it is enabled.
+	void setUseRigidBodyStateArrays(bool useStateArrays)
+	{
+		m_useRigidBodyStateArrays = useStateArrays;
+	}
+	bool getUseRigidBodyStateArrays() const
+	{
+		return m_useRigidBodyStateArrays;
+	}
     
+	///Cheap hash of the simulation state, to check determinism and replays without serializing the world.
+	///stateHashes gets one hash per collision object (world transform, and velocities of rigid bodies), in collision
+	///object order, computed with btParallelFor when a task scheduler is set. The returned hash combines them with
+	///the contact points of all manifolds. Call it after every step and compare with findFirstStateDivergence
+	virtual unsigned int computeStateHash(btAlignedObjectArray<unsigned int>& stateHashes) const;
+
+	///returns the first index at which two arrays of state hashes differ, or -1 if they are equal
+	static int findFirstStateDivergence(const btAlignedObjectArray<unsigned int>& stateHashesA, const btAlignedObjectArray<unsigned int>& stateHashesB);
+
+	///Fowler/Noll/Vo hash of raw bytes, start with hash 2166136261
+	static unsigned int hashState(unsigned int hash, const void* data, int numBytes);
+
+	///hashes x, y and z only, the unused w component of a btVector3 is not part of the state
+	static unsigned int hashVector3(unsigned int hash, const btVector3& v)
+	{
+		return hashState(hash, v.m_floats, 3 * sizeof(btScalar));
+	}
+
+	static unsigned int hashCollisionObjectState(unsigned int hash, const btCollisionObject* colObj);
+
     btAlignedObjectArray<btRigidBody*>& getNonStaticRigidBodies()
     {
         return m_nonStaticRigidBodies;
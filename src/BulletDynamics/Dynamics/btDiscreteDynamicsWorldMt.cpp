@@ -125,6 +125,11 @@ btScalar btConstraintSolverPoolMt::solveGroup(btCollisionObject** bodies,
 											  btDispatcher* dispatcher)
 {
 	ThreadSolver* ts = getAndLockThreadSolver();
+	if ((info.m_solverMode & SOLVER_DETERMINISTIC_PARALLEL) && (info.m_solverMode & SOLVER_RANDMIZE_ORDER))
+	{
+		// which solver of the pool gets the group depends on the thread, restart the random sequence
+		ts->solver->reset();
+	}
 	ts->solver->solveGroup(bodies, numBodies, manifolds, numManifolds, constraints, numConstraints, info, debugDrawer, dispatcher);
 	ts->mutex.unlock();
 	return 0.0f;
@@ -182,6 +187,13 @@ void btDiscreteDynamicsWorldMt::solveConstraints(btContactSolverInfo& solverInfo
 	solverParams.m_solverPool = m_constraintSolver;
 	solverParams.m_solverMt = m_constraintSolverMt;
 	solverParams.m_solverInfo = &solverInfo;
+	btContactSolverInfo deterministicSolverInfo;
+	if (getDispatchInfo().m_deterministicOverlappingPairs && !(solverInfo.m_solverMode & SOLVER_DETERMINISTIC_PARALLEL))
+	{
+		deterministicSolverInfo = solverInfo;
+		deterministicSolverInfo.m_solverMode |= SOLVER_DETERMINISTIC_PARALLEL;
+		solverParams.m_solverInfo = &deterministicSolverInfo;
+	}
 	solverParams.m_debugDrawer = m_debugDrawer;
 	solverParams.m_dispatcher = getCollisionWorld()->getDispatcher();
 	im->buildAndProcessIslands(getCollisionWorld()->getDispatcher(), getCollisionWorld(), m_constraints, solverParams);
@@ -192,14 +204,14 @@ void btDiscreteDynamicsWorldMt::solveConstraints(btContactSolverInfo& solverInfo
 struct UpdaterUnconstrainedMotion : public btIParallelForBody
 {
 	btScalar timeStep;
-	btRigidBody** rigidBodies;
+	btCollisionObject** collisionObjects;
 
 	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
 	{
 		for (int i = iBegin; i < iEnd; ++i)
 		{
-			btRigidBody* body = rigidBodies[i];
-			if (!body->isStaticOrKinematicObject())
+			btRigidBody* body = btRigidBody::upcast(collisionObjects[i]);
+			if (body && !body->isStaticOrKinematicObject())
 			{
 				//don't integrate/update velocities here, it happens in the constraint solver
 				body->applyDamping(timeStep);
@@ -211,43 +223,61 @@ struct UpdaterUnconstrainedMotion : public btIParallelForBody
 
 void btDiscreteDynamicsWorldMt::predictUnconstraintMotion(btScalar timeStep)
 {
+	if (m_useRigidBodyStateArrays)
+	{
+		btDiscreteDynamicsWorld::predictUnconstraintMotion(timeStep);
+		return;
+	}
 	BT_PROFILE("predictUnconstraintMotion");
-	if (m_nonStaticRigidBodies.size() > 0)
+	if (m_activeCollisionObjects.size() > 0)
 	{
 		UpdaterUnconstrainedMotion update;
 		update.timeStep = timeStep;
-		update.rigidBodies = &m_nonStaticRigidBodies[0];
+		update.collisionObjects = &m_activeCollisionObjects[0];
 		int grainSize = 50;  // num of iterations per task for task scheduler
-		btParallelFor(0, m_nonStaticRigidBodies.size(), grainSize, update);
+		btParallelFor(0, m_activeCollisionObjects.size(), grainSize, update);
 	}
 }
 
 void btDiscreteDynamicsWorldMt::createPredictiveContacts(btScalar timeStep)
 {
 	BT_PROFILE("createPredictiveContacts");
+	if (getDispatchInfo().m_deterministicOverlappingPairs)
+	{
+		// the predictive manifolds are appended in the order the threads create them
+		btDiscreteDynamicsWorld::createPredictiveContacts(timeStep);
+		return;
+	}
 	releasePredictiveContacts();
-	if (m_nonStaticRigidBodies.size() > 0)
+	updateActiveRigidBodies();
+	if (m_activeRigidBodies.size() > 0)
 	{
 		UpdaterCreatePredictiveContacts update;
 		update.world = this;
 		update.timeStep = timeStep;
-		update.rigidBodies = &m_nonStaticRigidBodies[0];
+		update.rigidBodies = &m_activeRigidBodies[0];
 		int grainSize = 50;  // num of iterations per task for task scheduler
-		btParallelFor(0, m_nonStaticRigidBodies.size(), grainSize, update);
+		btParallelFor(0, m_activeRigidBodies.size(), grainSize, update);
 	}
 }
 
 void btDiscreteDynamicsWorldMt::integrateTransforms(btScalar timeStep)
 {
+	if (m_useRigidBodyStateArrays)
+	{
+		btDiscreteDynamicsWorld::integrateTransforms(timeStep);
+		return;
+	}
 	BT_PROFILE("integrateTransforms");
-	if (m_nonStaticRigidBodies.size() > 0)
+	updateActiveRigidBodies();
+	if (m_activeRigidBodies.size() > 0)
 	{
 		UpdaterIntegrateTransforms update;
 		update.world = this;
 		update.timeStep = timeStep;
-		update.rigidBodies = &m_nonStaticRigidBodies[0];
+		update.rigidBodies = &m_activeRigidBodies[0];
 		int grainSize = 50;  // num of iterations per task for task scheduler
-		btParallelFor(0, m_nonStaticRigidBodies.size(), grainSize, update);
+		btParallelFor(0, m_activeRigidBodies.size(), grainSize, update);
 	}
 }
 
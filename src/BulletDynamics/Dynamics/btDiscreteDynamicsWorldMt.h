@@ -79,6 +79,14 @@ private:
 ///     - integrateTransforms
 ///     - createPredictiveContacts
 ///
+///  By default the results depend on the number of threads and the scheduling: new contact manifolds are merged
+///  in the order the threads create them and the solver residuals are summed per task.
+///  Set getDispatchInfo().m_deterministicOverlappingPairs for results that are bit-identical for any number of threads:
+///     - btCollisionDispatcherMt appends new manifolds in pair order
+///     - createPredictiveContacts runs on the calling thread
+///     - the solvers get the SOLVER_DETERMINISTIC_PARALLEL flag: ordered residual sums in
+///       btSequentialImpulseConstraintSolverMt, and the random order of SOLVER_RANDMIZE_ORDER restarts for every island
+///
 ATTRIBUTE_ALIGNED16(class)
 btDiscreteDynamicsWorldMt : public btDiscreteDynamicsWorld
 {
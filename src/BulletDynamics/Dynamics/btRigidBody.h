@@ -92,6 +92,9 @@ class btRigidBody : public btCollisionObject
 
 	int m_debugBodyId;
 
+	//damps and integrates the velocities in place of applyDamping
+	friend class btRigidBodyStateArrays;
+
 protected:
 	ATTRIBUTE_ALIGNED16(btVector3 m_deltaLinearVelocity);
 	btVector3 m_deltaAngularVelocity;
@@ -408,12 +411,20 @@ public:
 	{
 		m_updateRevision++;
 		m_linearVelocity = lin_vel;
+		//the next step clears the velocity of a body that is still sleeping, so it has to be listed
+		//static and kinematic velocities are never cleared, and the solver writes those back from worker threads
+		if (m_activationState1 == ISLAND_SLEEPING && !isStaticOrKinematicObject())
+			insertSleepingCollisionObject();
 	}
 
 	inline void setAngularVelocity(const btVector3& ang_vel)
 	{
 		m_updateRevision++;
 		m_angularVelocity = ang_vel;
+		//the next step clears the velocity of a body that is still sleeping, so it has to be listed
+		//static and kinematic velocities are never cleared, and the solver writes those back from worker threads
+		if (m_activationState1 == ISLAND_SLEEPING && !isStaticOrKinematicObject())
+			insertSleepingCollisionObject();
 	}
 
 	btVector3 getVelocityInLocalPoint(const btVector3& rel_pos) const
@@ -0,0 +1,151 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btRigidBodyStateArrays.h"
+#include "btRigidBody.h"
+#include "LinearMath/btTransformUtil.h"
+
+void btRigidBodyStateArrays::resizeArrays()
+{
+	int numBodies = m_bodies.size();
+	m_origins.resizeNoInitialize(numBodies);
+	m_orientations.resizeNoInitialize(numBodies);
+	m_linearVelocities.resizeNoInitialize(numBodies);
+	m_angularVelocities.resizeNoInitialize(numBodies);
+	m_linearDampings.resizeNoInitialize(numBodies);
+	m_angularDampings.resizeNoInitialize(numBodies);
+	m_predictedOrigins.resizeNoInitialize(numBodies);
+	m_predictedOrientations.resizeNoInitialize(numBodies);
+}
+
+void btRigidBodyStateArrays::gatherState(int index)
+{
+	const btRigidBody* body = m_bodies[index];
+	m_origins[index] = body->getWorldTransform().getOrigin();
+	m_orientations[index] = body->getWorldTransform().getRotation();
+	m_linearVelocities[index] = body->m_linearVelocity;
+	m_angularVelocities[index] = body->m_angularVelocity;
+}
+
+void btRigidBodyStateArrays::applyDamping(btScalar timeStep)
+{
+	for (int i = 0; i < m_linearVelocities.size(); i++)
+	{
+		m_linearVelocities[i] *= btPow(btScalar(1) - m_linearDampings[i], timeStep);
+	}
+	for (int i = 0; i < m_angularVelocities.size(); i++)
+	{
+		m_angularVelocities[i] *= btPow(btScalar(1) - m_angularDampings[i], timeStep);
+	}
+}
+
+void btRigidBodyStateArrays::integrate(btScalar timeStep)
+{
+	for (int i = 0; i < m_origins.size(); i++)
+	{
+		m_predictedOrigins[i] = m_origins[i] + m_linearVelocities[i] * timeStep;
+	}
+
+	//exponential map, see btTransformUtil::integrateTransform
+	for (int i = 0; i < m_orientations.size(); i++)
+	{
+		const btVector3& angvel = m_angularVelocities[i];
+		btVector3 axis;
+		btScalar fAngle2 = angvel.length2();
+		btScalar fAngle = 0;
+		if (fAngle2 > SIMD_EPSILON)
+		{
+			fAngle = btSqrt(fAngle2);
+		}
+
+		//limit the angular motion
+		if (fAngle * timeStep > ANGULAR_MOTION_THRESHOLD)
+		{
+			fAngle = ANGULAR_MOTION_THRESHOLD / timeStep;
+		}
+
+		if (fAngle < btScalar(0.001))
+		{
+			// use Taylor's expansions of sync function
+			axis = angvel * (btScalar(0.5) * timeStep - (timeStep * timeStep * timeStep) * (btScalar(0.020833333333)) * fAngle * fAngle);
+		}
+		else
+		{
+			// sync(fAngle) = sin(c*fAngle)/t
+			axis = angvel * (btSin(btScalar(0.5) * fAngle * timeStep) / fAngle);
+		}
+		btQuaternion dorn(axis.x(), axis.y(), axis.z(), btCos(fAngle * timeStep * btScalar(0.5)));
+
+		btQuaternion predictedOrn = dorn * m_orientations[i];
+		predictedOrn.safeNormalize();
+		m_predictedOrientations[i] = predictedOrn;
+	}
+}
+
+void btRigidBodyStateArrays::predictUnconstraintMotion(btScalar timeStep)
+{
+	resizeArrays();
+	for (int i = 0; i < m_bodies.size(); i++)
+	{
+		btRigidBody* body = m_bodies[i];
+		if (body->m_additionalDamping)
+		{
+			//the additional damping depends on the damped velocities, keep it on the body
+			body->applyDamping(timeStep);
+			m_linearDampings[i] = btScalar(0);
+			m_angularDampings[i] = btScalar(0);
+		}
+		else
+		{
+			m_linearDampings[i] = body->m_linearDamping;
+			m_angularDampings[i] = body->m_angularDamping;
+		}
+		gatherState(i);
+	}
+	applyDamping(timeStep);
+	integrate(timeStep);
+
+	for (int i = 0; i < m_bodies.size(); i++)
+	{
+		btRigidBody* body = m_bodies[i];
+		body->m_linearVelocity = m_linearVelocities[i];
+		body->m_angularVelocity = m_angularVelocities[i];
+		getPredictedTransform(i, body->getInterpolationWorldTransform());
+	}
+}
+
+void btRigidBodyStateArrays::predictIntegratedTransforms(btScalar timeStep)
+{
+	resizeArrays();
+	for (int i = 0; i < m_bodies.size(); i++)
+	{
+		gatherState(i);
+	}
+	integrate(timeStep);
+}
+
+void btRigidBodyStateArrays::getPredictedTransform(int index, btTransform& predictedTransform) const
+{
+	predictedTransform.setOrigin(m_predictedOrigins[index]);
+	const btQuaternion& predictedOrn = m_predictedOrientations[index];
+	if (predictedOrn.length2() > SIMD_EPSILON)
+	{
+		predictedTransform.setRotation(predictedOrn);
+	}
+	else
+	{
+		predictedTransform.setBasis(m_bodies[index]->getWorldTransform().getBasis());
+	}
+}
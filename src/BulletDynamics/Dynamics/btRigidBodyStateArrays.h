@@ -0,0 +1,72 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_RIGID_BODY_STATE_ARRAYS_H
+#define BT_RIGID_BODY_STATE_ARRAYS_H
+
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btQuaternion.h"
+#include "LinearMath/btTransform.h"
+
+class btRigidBody;
+
+///btRigidBodyStateArrays stores the state read by predictUnconstraintMotion and integrateTransforms as a structure of arrays.
+///A pass gathers the state of m_bodies once, damps and integrates it with loops over the separate aligned arrays,
+///and writes the results back. The btRigidBody objects remain the owners of the state.
+///Enable it with btDiscreteDynamicsWorld::setUseRigidBodyStateArrays, the results are bit for bit the same as without.
+class btRigidBodyStateArrays
+{
+	btAlignedObjectArray<btVector3> m_origins;
+	btAlignedObjectArray<btQuaternion> m_orientations;
+	btAlignedObjectArray<btVector3> m_linearVelocities;
+	btAlignedObjectArray<btVector3> m_angularVelocities;
+	btAlignedObjectArray<btScalar> m_linearDampings;
+	btAlignedObjectArray<btScalar> m_angularDampings;
+
+	btAlignedObjectArray<btVector3> m_predictedOrigins;
+	btAlignedObjectArray<btQuaternion> m_predictedOrientations;
+
+	void resizeArrays();
+	void gatherState(int index);
+	void applyDamping(btScalar timeStep);
+	void integrate(btScalar timeStep);
+
+public:
+	///the bodies to process, the caller fills it before each pass
+	btAlignedObjectArray<btRigidBody*> m_bodies;
+
+	int size() const
+	{
+		return m_bodies.size();
+	}
+
+	///same as btRigidBody::applyDamping followed by btRigidBody::predictIntegratedTransform into the interpolation
+	///world transform, for each body
+	void predictUnconstraintMotion(btScalar timeStep);
+
+	///gathers the world transforms and velocities, and computes the transforms btRigidBody::predictIntegratedTransform
+	///would return, without changing the bodies
+	void predictIntegratedTransforms(btScalar timeStep);
+
+	void getPredictedTransform(int index, btTransform& predictedTransform) const;
+
+	///squared distance the body at index moves to its predicted transform
+	btScalar getPredictedSquareMotion(int index) const
+	{
+		return (m_predictedOrigins[index] - m_origins[index]).length2();
+	}
+};
+
+#endif  //BT_RIGID_BODY_STATE_ARRAYS_H
@@ -717,6 +717,82 @@ btScalar *btMultiBody::getJointTorqueMultiDof(int i)
 	return &m_links[i].m_jointTorque[0];
 }
 
+void btMultiBody::setJointImplicitPD(int i, btScalar targetPos, btScalar targetVel, btScalar kp, btScalar kd)
+{
+	btAssert(m_links[i].m_jointType == btMultibodyLink::eRevolute || m_links[i].m_jointType == btMultibodyLink::ePrismatic);
+	setJointImplicitPDMultiDof(i, &targetPos, &targetVel, &kp, &kd);
+}
+
+void btMultiBody::setJointImplicitPDMultiDof(int i, const btScalar *targetPos, const btScalar *targetVel, const btScalar *kp, const btScalar *kd)
+{
+	btMultibodyLink &link = m_links[i];
+	btAssert(link.m_jointType == btMultibodyLink::eRevolute || link.m_jointType == btMultibodyLink::ePrismatic || link.m_jointType == btMultibodyLink::eSpherical);
+	for (int pos = 0; pos < link.m_posVarCount; ++pos)
+	{
+		link.m_implicitPDTargetPos[pos] = targetPos[pos];
+	}
+	for (int dof = 0; dof < link.m_dofCount; ++dof)
+	{
+		link.m_implicitPDTargetVel[dof] = targetVel[dof];
+		link.m_implicitPDKp[dof] = kp[dof];
+		link.m_implicitPDKd[dof] = kd[dof];
+	}
+	link.m_hasImplicitPD = true;
+}
+
+void btMultiBody::clearJointImplicitPD(int i)
+{
+	m_links[i].m_hasImplicitPD = false;
+}
+
+int btMultiBody::calcJointImplicitPD(int i, btScalar dt, btScalar *torque, btScalar *inertia) const
+{
+	const btMultibodyLink &link = m_links[i];
+	const btScalar *jointVel = &m_realBuf[6 + link.m_dofOffset];
+	btScalar posError[3];
+	switch (link.m_jointType)
+	{
+		case btMultibodyLink::ePrismatic:
+		case btMultibodyLink::eRevolute:
+		{
+			posError[0] = link.m_implicitPDTargetPos[0] - link.m_jointPos[0];
+			break;
+		}
+		case btMultibodyLink::eSpherical:
+		{
+			//rotation vector of the relative rotation, in the local frame like btMultiBodySphericalJointMotor
+			btQuaternion currentQuat(link.m_jointPos[0], link.m_jointPos[1], link.m_jointPos[2], link.m_jointPos[3]);
+			btQuaternion targetQuat(link.m_implicitPDTargetPos[0], link.m_implicitPDTargetPos[1], link.m_implicitPDTargetPos[2], link.m_implicitPDTargetPos[3]);
+			btQuaternion relRot = currentQuat.inverse() * targetQuat;
+			if (relRot.w() < 0)
+			{
+				relRot = -relRot;
+			}
+			btVector3 axis(relRot.x(), relRot.y(), relRot.z());
+			btScalar sinHalfAngle = axis.length();
+			btScalar scale = sinHalfAngle > SIMD_EPSILON ? btScalar(2) * btAtan2(sinHalfAngle, relRot.w()) / sinHalfAngle : btScalar(2);
+			posError[0] = axis[0] * scale;
+			posError[1] = axis[1] * scale;
+			posError[2] = axis[2] * scale;
+			break;
+		}
+		default:
+		{
+			return 0;
+		}
+	}
+	//the PD torque is evaluated at the end of the step: q1 = q0 + dt * qd1, qd1 = qd0 + dt * qdd,
+	//which leaves an explicit torque plus a term (kp * dt^2 + kd * dt) * qdd added to the joint inertia
+	for (int dof = 0; dof < link.m_dofCount; ++dof)
+	{
+		btScalar kp = link.m_implicitPDKp[dof];
+		btScalar kd = link.m_implicitPDKd[dof];
+		torque[dof] = kp * (posError[dof] - dt * jointVel[dof]) + kd * (link.m_implicitPDTargetVel[dof] - jointVel[dof]);
+		inertia[dof] = kp * dt * dt + kd * dt;
+	}
+	return link.m_dofCount;
+}
+
 inline btMatrix3x3 outerProduct(const btVector3 &v0, const btVector3 &v1)  //renamed it from vecMulVecTranspose (http://en.wikipedia.org/wiki/Outer_product); maybe it should be moved to btVector3 like dot and cross?
 {
 	btVector3 row0 = btVector3(
@@ -1003,6 +1079,23 @@ void btMultiBody::computeAccelerationsArticulatedBodyAlgorithmMultiDof(btScalar
 			}
 		}
 
+		//implicit joint PD: the extra joint inertia also goes into invD, so the
+		//constraint solver sees the same (implicit) response
+		if (m_links[i].m_hasImplicitPD && dt > 0)
+		{
+			btScalar implicitTorque[3];
+			btScalar implicitInertia[3];
+			int numImplicitDofs = calcJointImplicitPD(i, dt, implicitTorque, implicitInertia);
+			for (int dof = 0; dof < numImplicitDofs; ++dof)
+			{
+				if (!isConstraintPass)
+				{
+					Y[m_links[i].m_dofOffset + dof] += implicitTorque[dof];
+				}
+				D[dof * m_links[i].m_dofCount + dof] += implicitInertia[dof];
+			}
+		}
+
 		btScalar *invDi = &invD[m_links[i].m_dofOffset * m_links[i].m_dofOffset];
 		switch (m_links[i].m_jointType)
 		{
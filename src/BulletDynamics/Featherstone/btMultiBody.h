@@ -351,6 +351,15 @@ public:
 	btScalar getJointTorque(int i) const;
 	btScalar *getJointTorqueMultiDof(int i);
 
+	///Implicit joint PD control (stable PD), integrated in the articulated body algorithm at O(n) cost.
+	///The torque kp * (targetPos - q) + kd * (targetVel - qd) is evaluated at the end of the step, which
+	///keeps high gains stable at large time steps. Unlike addJointTorque, the setting persists until
+	///clearJointImplicitPD. Use kp = 0 for implicit joint damping. Supports revolute, prismatic and
+	///spherical joints (target quaternion x,y,z,w and 3 gains per local axis); it is ignored with RK4 integration.
+	void setJointImplicitPD(int i, btScalar targetPos, btScalar targetVel, btScalar kp, btScalar kd);
+	void setJointImplicitPDMultiDof(int i, const btScalar *targetPos, const btScalar *targetVel, const btScalar *kp, const btScalar *kd);
+	void clearJointImplicitPD(int i);
+
 	//
 	// dynamics routines.
 	//
@@ -404,6 +413,14 @@ public:
 			m_deltaV[dof] += delta_vee[dof] * multiplier;
 		}
 	}
+	void applyDeltaVeeMultiDof2Sparse(const btScalar *delta_vee, const int *dofIndices, int numDofIndices, btScalar multiplier)
+	{
+		for (int i = 0; i < numDofIndices; ++i)
+		{
+			int dof = dofIndices[i];
+			m_deltaV[dof] += delta_vee[dof] * multiplier;
+		}
+	}
 	void processDeltaVeeMultiDof2()
 	{
 		applyDeltaVeeMultiDof(&m_deltaV[0], 1);
@@ -683,6 +700,9 @@ private:
 
 	void mulMatrix(btScalar * pA, btScalar * pB, int rowsA, int colsA, int rowsB, int colsB, btScalar *pC) const;
 
+	//explicit torque and added joint inertia of the implicit PD of link i, returns the number of dofs
+	int calcJointImplicitPD(int i, btScalar dt, btScalar *torque, btScalar *inertia) const;
+
 private:
 	btMultiBodyLinkCollider *m_baseCollider;  //can be NULL
 	const char *m_baseName;                   //memory needs to be manager by user!
@@ -220,6 +220,13 @@ btScalar btMultiBodyConstraintSolver::solveGroupCacheFriendlySetup(btCollisionOb
 
 	btScalar val = btSequentialImpulseConstraintSolver::solveGroupCacheFriendlySetup(bodies, numBodies, manifoldPtr, numManifolds, constraints, numConstraints, infoGlobal, debugDrawer);
 
+	m_data.m_sparseDofIndices.resize(0);
+	buildSparseJacobianRows(m_multiBodyNonContactConstraints);
+	buildSparseJacobianRows(m_multiBodyNormalContactConstraints);
+	buildSparseJacobianRows(m_multiBodyFrictionContactConstraints);
+	buildSparseJacobianRows(m_multiBodyTorsionalFrictionContactConstraints);
+	buildSparseJacobianRows(m_multiBodySpinningFrictionContactConstraints);
+
 	return val;
 }
 
@@ -229,6 +236,95 @@ void btMultiBodyConstraintSolver::applyDeltaVee(btScalar* delta_vee, btScalar im
 		m_data.m_deltaVelocities[velocityIndex + i] += delta_vee[i] * impulse;
 }
 
+void btMultiBodyConstraintSolver::buildSparseJacobianRows(btMultiBodyConstraintArray& constraintRows)
+{
+	for (int i = 0; i < constraintRows.size(); i++)
+	{
+		btMultiBodySolverConstraint& c = constraintRows[i];
+		if (c.m_multiBodyA)
+		{
+			appendSparseDofIndices(c.m_jacAindex, c.m_multiBodyA->getNumDofs() + 6, c.m_sparseAindex, c.m_jacAnumNonZero, c.m_responseAnumNonZero);
+		}
+		if (c.m_multiBodyB)
+		{
+			appendSparseDofIndices(c.m_jacBindex, c.m_multiBodyB->getNumDofs() + 6, c.m_sparseBindex, c.m_jacBnumNonZero, c.m_responseBnumNonZero);
+		}
+	}
+}
+
+void btMultiBodyConstraintSolver::appendSparseDofIndices(int jacIndex, int ndof, int& sparseIndex, int& jacNumNonZero, int& responseNumNonZero)
+{
+	//a Jacobian row is only nonzero for the base and the joints between the link and the base.
+	//The response of a fixed base tree only reaches that path and the subtrees hanging off it,
+	//so for long chains and branched robots both are much shorter than the number of dofs
+	sparseIndex = m_data.m_sparseDofIndices.size();
+	const btScalar* jac = &m_data.m_jacobians[jacIndex];
+	const btScalar* response = &m_data.m_deltaVelocitiesUnitImpulse[jacIndex];
+	jacNumNonZero = 0;
+	for (int i = 0; i < ndof; ++i)
+	{
+		if (jac[i] != btScalar(0) || !m_useSparseJacobianRows)
+		{
+			m_data.m_sparseDofIndices.push_back(i);
+			jacNumNonZero++;
+		}
+	}
+	responseNumNonZero = 0;
+	for (int i = 0; i < ndof; ++i)
+	{
+		if (response[i] != btScalar(0) || !m_useSparseJacobianRows)
+		{
+			m_data.m_sparseDofIndices.push_back(i);
+			responseNumNonZero++;
+		}
+	}
+}
+
+btScalar btMultiBodyConstraintSolver::sparseJacobianDotDeltaVee(int jacIndex, int velocityIndex, int sparseIndex, int jacNumNonZero) const
+{
+	btScalar result = 0;
+	if (jacNumNonZero)
+	{
+		const btScalar* jac = &m_data.m_jacobians[jacIndex];
+		const btScalar* deltaVee = &m_data.m_deltaVelocities[velocityIndex];
+		const int* dofIndices = &m_data.m_sparseDofIndices[sparseIndex];
+		for (int i = 0; i < jacNumNonZero; ++i)
+		{
+			int dof = dofIndices[i];
+			result += jac[dof] * deltaVee[dof];
+		}
+	}
+	return result;
+}
+
+void btMultiBodyConstraintSolver::applySparseDeltaVee(btMultiBody* multiBody, int jacIndex, btScalar impulse, int velocityIndex, int sparseIndex, int jacNumNonZero, int responseNumNonZero)
+{
+	btScalar* response = &m_data.m_deltaVelocitiesUnitImpulse[jacIndex];
+	int ndof = multiBody->getNumDofs() + 6;
+	if (responseNumNonZero == ndof)
+	{
+		//floating base: the response is dense anyway
+		applyDeltaVee(response, impulse, velocityIndex, ndof);
+#ifdef DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+		multiBody->applyDeltaVeeMultiDof2(response, impulse);
+#endif  //DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+		return;
+	}
+	if (responseNumNonZero)
+	{
+		btScalar* deltaVee = &m_data.m_deltaVelocities[velocityIndex];
+		const int* dofIndices = &m_data.m_sparseDofIndices[sparseIndex + jacNumNonZero];
+		for (int i = 0; i < responseNumNonZero; ++i)
+		{
+			int dof = dofIndices[i];
+			deltaVee[dof] += response[dof] * impulse;
+		}
+#ifdef DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+		multiBody->applyDeltaVeeMultiDof2Sparse(response, dofIndices, responseNumNonZero, impulse);
+#endif  //DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+	}
+}
+
 btScalar btMultiBodyConstraintSolver::resolveSingleConstraintRowGeneric(const btMultiBodySolverConstraint& c)
 {
 	btScalar deltaImpulse = c.m_rhs - btScalar(c.m_appliedImpulse) * c.m_cfm;
@@ -236,14 +332,10 @@ btScalar btMultiBodyConstraintSolver::resolveSingleConstraintRowGeneric(const bt
 	btScalar deltaVelBDotn = 0;
 	btSolverBody* bodyA = 0;
 	btSolverBody* bodyB = 0;
-	int ndofA = 0;
-	int ndofB = 0;
 
 	if (c.m_multiBodyA)
 	{
-		ndofA = c.m_multiBodyA->getNumDofs() + 6;
-		for (int i = 0; i < ndofA; ++i)
-			deltaVelADotn += m_data.m_jacobians[c.m_jacAindex + i] * m_data.m_deltaVelocities[c.m_deltaVelAindex + i];
+		deltaVelADotn += sparseJacobianDotDeltaVee(c.m_jacAindex, c.m_deltaVelAindex, c.m_sparseAindex, c.m_jacAnumNonZero);
 	}
 	else if (c.m_solverBodyIdA >= 0)
 	{
@@ -253,9 +345,7 @@ btScalar btMultiBodyConstraintSolver::resolveSingleConstraintRowGeneric(const bt
 
 	if (c.m_multiBodyB)
 	{
-		ndofB = c.m_multiBodyB->getNumDofs() + 6;
-		for (int i = 0; i < ndofB; ++i)
-			deltaVelBDotn += m_data.m_jacobians[c.m_jacBindex + i] * m_data.m_deltaVelocities[c.m_deltaVelBindex + i];
+		deltaVelBDotn += sparseJacobianDotDeltaVee(c.m_jacBindex, c.m_deltaVelBindex, c.m_sparseBindex, c.m_jacBnumNonZero);
 	}
 	else if (c.m_solverBodyIdB >= 0)
 	{
@@ -284,12 +374,7 @@ btScalar btMultiBodyConstraintSolver::resolveSingleConstraintRowGeneric(const bt
 
 	if (c.m_multiBodyA)
 	{
-		applyDeltaVee(&m_data.m_deltaVelocitiesUnitImpulse[c.m_jacAindex], deltaImpulse, c.m_deltaVelAindex, ndofA);
-#ifdef DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
-		//note: update of the actual velocities (below) in the multibody does not have to happen now since m_deltaVelocities can be applied after all iterations
-		//it would make the multibody solver more like the regular one with m_deltaVelocities being equivalent to btSolverBody::m_deltaLinearVelocity/m_deltaAngularVelocity
-		c.m_multiBodyA->applyDeltaVeeMultiDof2(&m_data.m_deltaVelocitiesUnitImpulse[c.m_jacAindex], deltaImpulse);
-#endif  //DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+		applySparseDeltaVee(c.m_multiBodyA, c.m_jacAindex, deltaImpulse, c.m_deltaVelAindex, c.m_sparseAindex, c.m_jacAnumNonZero, c.m_responseAnumNonZero);
 	}
 	else if (c.m_solverBodyIdA >= 0)
 	{
@@ -297,12 +382,7 @@ btScalar btMultiBodyConstraintSolver::resolveSingleConstraintRowGeneric(const bt
 	}
 	if (c.m_multiBodyB)
 	{
-		applyDeltaVee(&m_data.m_deltaVelocitiesUnitImpulse[c.m_jacBindex], deltaImpulse, c.m_deltaVelBindex, ndofB);
-#ifdef DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
-		//note: update of the actual velocities (below) in the multibody does not have to happen now since m_deltaVelocities can be applied after all iterations
-		//it would make the multibody solver more like the regular one with m_deltaVelocities being equivalent to btSolverBody::m_deltaLinearVelocity/m_deltaAngularVelocity
-		c.m_multiBodyB->applyDeltaVeeMultiDof2(&m_data.m_deltaVelocitiesUnitImpulse[c.m_jacBindex], deltaImpulse);
-#endif  //DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+		applySparseDeltaVee(c.m_multiBodyB, c.m_jacBindex, deltaImpulse, c.m_deltaVelBindex, c.m_sparseBindex, c.m_jacBnumNonZero, c.m_responseBnumNonZero);
 	}
 	else if (c.m_solverBodyIdB >= 0)
 	{
@@ -314,8 +394,6 @@ btScalar btMultiBodyConstraintSolver::resolveSingleConstraintRowGeneric(const bt
 
 btScalar btMultiBodyConstraintSolver::resolveConeFrictionConstraintRows(const btMultiBodySolverConstraint& cA1, const btMultiBodySolverConstraint& cB)
 {
-	int ndofA = 0;
-	int ndofB = 0;
 	btSolverBody* bodyA = 0;
 	btSolverBody* bodyB = 0;
 	btScalar deltaImpulseB = 0.f;
@@ -326,9 +404,7 @@ btScalar btMultiBodyConstraintSolver::resolveConeFrictionConstraintRows(const bt
 		btScalar deltaVelBDotn = 0;
 		if (cB.m_multiBodyA)
 		{
-			ndofA = cB.m_multiBodyA->getNumDofs() + 6;
-			for (int i = 0; i < ndofA; ++i)
-				deltaVelADotn += m_data.m_jacobians[cB.m_jacAindex + i] * m_data.m_deltaVelocities[cB.m_deltaVelAindex + i];
+			deltaVelADotn += sparseJacobianDotDeltaVee(cB.m_jacAindex, cB.m_deltaVelAindex, cB.m_sparseAindex, cB.m_jacAnumNonZero);
 		}
 		else if (cB.m_solverBodyIdA >= 0)
 		{
@@ -338,9 +414,7 @@ btScalar btMultiBodyConstraintSolver::resolveConeFrictionConstraintRows(const bt
 
 		if (cB.m_multiBodyB)
 		{
-			ndofB = cB.m_multiBodyB->getNumDofs() + 6;
-			for (int i = 0; i < ndofB; ++i)
-				deltaVelBDotn += m_data.m_jacobians[cB.m_jacBindex + i] * m_data.m_deltaVelocities[cB.m_deltaVelBindex + i];
+			deltaVelBDotn += sparseJacobianDotDeltaVee(cB.m_jacBindex, cB.m_deltaVelBindex, cB.m_sparseBindex, cB.m_jacBnumNonZero);
 		}
 		else if (cB.m_solverBodyIdB >= 0)
 		{
@@ -363,9 +437,7 @@ btScalar btMultiBodyConstraintSolver::resolveConeFrictionConstraintRows(const bt
 			btScalar deltaVelBDotn = 0;
 			if (cA.m_multiBodyA)
 			{
-				ndofA = cA.m_multiBodyA->getNumDofs() + 6;
-				for (int i = 0; i < ndofA; ++i)
-					deltaVelADotn += m_data.m_jacobians[cA.m_jacAindex + i] * m_data.m_deltaVelocities[cA.m_deltaVelAindex + i];
+				deltaVelADotn += sparseJacobianDotDeltaVee(cA.m_jacAindex, cA.m_deltaVelAindex, cA.m_sparseAindex, cA.m_jacAnumNonZero);
 			}
 			else if (cA.m_solverBodyIdA >= 0)
 			{
@@ -375,9 +447,7 @@ btScalar btMultiBodyConstraintSolver::resolveConeFrictionConstraintRows(const bt
 
 			if (cA.m_multiBodyB)
 			{
-				ndofB = cA.m_multiBodyB->getNumDofs() + 6;
-				for (int i = 0; i < ndofB; ++i)
-					deltaVelBDotn += m_data.m_jacobians[cA.m_jacBindex + i] * m_data.m_deltaVelocities[cA.m_deltaVelBindex + i];
+				deltaVelBDotn += sparseJacobianDotDeltaVee(cA.m_jacBindex, cA.m_deltaVelBindex, cA.m_sparseBindex, cA.m_jacBnumNonZero);
 			}
 			else if (cA.m_solverBodyIdB >= 0)
 			{
@@ -439,12 +509,7 @@ btScalar btMultiBodyConstraintSolver::resolveConeFrictionConstraintRows(const bt
 
 	if (cA.m_multiBodyA)
 	{
-		applyDeltaVee(&m_data.m_deltaVelocitiesUnitImpulse[cA.m_jacAindex], deltaImpulseA, cA.m_deltaVelAindex, ndofA);
-#ifdef DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
-		//note: update of the actual velocities (below) in the multibody does not have to happen now since m_deltaVelocities can be applied after all iterations
-		//it would make the multibody solver more like the regular one with m_deltaVelocities being equivalent to btSolverBody::m_deltaLinearVelocity/m_deltaAngularVelocity
-		cA.m_multiBodyA->applyDeltaVeeMultiDof2(&m_data.m_deltaVelocitiesUnitImpulse[cA.m_jacAindex], deltaImpulseA);
-#endif  //DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+		applySparseDeltaVee(cA.m_multiBodyA, cA.m_jacAindex, deltaImpulseA, cA.m_deltaVelAindex, cA.m_sparseAindex, cA.m_jacAnumNonZero, cA.m_responseAnumNonZero);
 	}
 	else if (cA.m_solverBodyIdA >= 0)
 	{
@@ -452,12 +517,7 @@ btScalar btMultiBodyConstraintSolver::resolveConeFrictionConstraintRows(const bt
 	}
 	if (cA.m_multiBodyB)
 	{
-		applyDeltaVee(&m_data.m_deltaVelocitiesUnitImpulse[cA.m_jacBindex], deltaImpulseA, cA.m_deltaVelBindex, ndofB);
-#ifdef DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
-		//note: update of the actual velocities (below) in the multibody does not have to happen now since m_deltaVelocities can be applied after all iterations
-		//it would make the multibody solver more like the regular one with m_deltaVelocities being equivalent to btSolverBody::m_deltaLinearVelocity/m_deltaAngularVelocity
-		cA.m_multiBodyB->applyDeltaVeeMultiDof2(&m_data.m_deltaVelocitiesUnitImpulse[cA.m_jacBindex], deltaImpulseA);
-#endif  //DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+		applySparseDeltaVee(cA.m_multiBodyB, cA.m_jacBindex, deltaImpulseA, cA.m_deltaVelBindex, cA.m_sparseBindex, cA.m_jacBnumNonZero, cA.m_responseBnumNonZero);
 	}
 	else if (cA.m_solverBodyIdB >= 0)
 	{
@@ -466,12 +526,7 @@ btScalar btMultiBodyConstraintSolver::resolveConeFrictionConstraintRows(const bt
 
 	if (cB.m_multiBodyA)
 	{
-		applyDeltaVee(&m_data.m_deltaVelocitiesUnitImpulse[cB.m_jacAindex], deltaImpulseB, cB.m_deltaVelAindex, ndofA);
-#ifdef DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
-		//note: update of the actual velocities (below) in the multibody does not have to happen now since m_deltaVelocities can be applied after all iterations
-		//it would make the multibody solver more like the regular one with m_deltaVelocities being equivalent to btSolverBody::m_deltaLinearVelocity/m_deltaAngularVelocity
-		cB.m_multiBodyA->applyDeltaVeeMultiDof2(&m_data.m_deltaVelocitiesUnitImpulse[cB.m_jacAindex], deltaImpulseB);
-#endif  //DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+		applySparseDeltaVee(cB.m_multiBodyA, cB.m_jacAindex, deltaImpulseB, cB.m_deltaVelAindex, cB.m_sparseAindex, cB.m_jacAnumNonZero, cB.m_responseAnumNonZero);
 	}
 	else if (cB.m_solverBodyIdA >= 0)
 	{
@@ -479,12 +534,7 @@ btScalar btMultiBodyConstraintSolver::resolveConeFrictionConstraintRows(const bt
 	}
 	if (cB.m_multiBodyB)
 	{
-		applyDeltaVee(&m_data.m_deltaVelocitiesUnitImpulse[cB.m_jacBindex], deltaImpulseB, cB.m_deltaVelBindex, ndofB);
-#ifdef DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
-		//note: update of the actual velocities (below) in the multibody does not have to happen now since m_deltaVelocities can be applied after all iterations
-		//it would make the multibody solver more like the regular one with m_deltaVelocities being equivalent to btSolverBody::m_deltaLinearVelocity/m_deltaAngularVelocity
-		cB.m_multiBodyB->applyDeltaVeeMultiDof2(&m_data.m_deltaVelocitiesUnitImpulse[cB.m_jacBindex], deltaImpulseB);
-#endif  //DIRECTLY_UPDATE_VELOCITY_DURING_SOLVER_ITERATIONS
+		applySparseDeltaVee(cB.m_multiBodyB, cB.m_jacBindex, deltaImpulseB, cB.m_deltaVelBindex, cB.m_sparseBindex, cB.m_jacBnumNonZero, cB.m_responseBnumNonZero);
 	}
 	else if (cB.m_solverBodyIdB >= 0)
 	{
@@ -42,6 +42,9 @@ protected:
 	btMultiBodyConstraint** m_tmpMultiBodyConstraints;
 	int m_tmpNumMultiBodyConstraints;
 
+	//when false every row lists all dofs, which gives the dense reference iterations
+	bool m_useSparseJacobianRows;
+
 	btScalar resolveSingleConstraintRowGeneric(const btMultiBodySolverConstraint& c);
 
 	//solve 2 friction directions and clamp against the implicit friction cone
@@ -86,11 +89,33 @@ protected:
 	//	virtual btScalar solveGroupCacheFriendlyIterations(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer);
 	virtual btScalar solveSingleIteration(int iteration, btCollisionObject** bodies, int numBodies, btPersistentManifold** manifoldPtr, int numManifolds, btTypedConstraint** constraints, int numConstraints, const btContactSolverInfo& infoGlobal, btIDebugDraw* debugDrawer);
 	void applyDeltaVee(btScalar * deltaV, btScalar impulse, int velocityIndex, int ndof);
+
+	//the solver iterations only visit the nonzero entries of the Jacobian and response rows
+	void buildSparseJacobianRows(btMultiBodyConstraintArray & constraintRows);
+	void appendSparseDofIndices(int jacIndex, int ndof, int& sparseIndex, int& jacNumNonZero, int& responseNumNonZero);
+	btScalar sparseJacobianDotDeltaVee(int jacIndex, int velocityIndex, int sparseIndex, int jacNumNonZero) const;
+	void applySparseDeltaVee(btMultiBody * multiBody, int jacIndex, btScalar impulse, int velocityIndex, int sparseIndex, int jacNumNonZero, int responseNumNonZero);
 	void writeBackSolverBodyToMultiBody(btMultiBodySolverConstraint & constraint, btScalar deltaTime);
 
 public:
 	BT_DECLARE_ALIGNED_ALLOCATOR();
 
+	btMultiBodyConstraintSolver()
+		: m_tmpMultiBodyConstraints(0),
+		  m_tmpNumMultiBodyConstraints(0),
+		  m_useSparseJacobianRows(true)
+	{
+	}
+
+	void setUseSparseJacobianRows(bool useSparse)
+	{
+		m_useSparseJacobianRows = useSparse;
+	}
+	bool getUseSparseJacobianRows() const
+	{
+		return m_useSparseJacobianRows;
+	}
+
 	///this method should not be called, it was just used during porting/integration of Featherstone btMultiBody, providing backwards compatibility but no support for btMultiBodyConstraint (only contact constraints)
 	virtual btScalar solveGroup(btCollisionObject * *bodies, int numBodies, btPersistentManifold** manifold, int numManifolds, btTypedConstraint** constraints, int numConstraints, const btContactSolverInfo& info, btIDebugDraw* debugDrawer, btDispatcher* dispatcher);
 	virtual btScalar solveGroupCacheFriendlyFinish(btCollisionObject * *bodies, int numBodies, const btContactSolverInfo& infoGlobal);
@@ -872,3 +872,57 @@ void btMultiBodyDynamicsWorld::serializeMultiBodies(btSerializer* serializer)
 //{
 //    m_islandManager->setSplitIslands(split);
 //}
+
+unsigned int btMultiBodyDynamicsWorld::hashMultiBodyState(unsigned int hash, const btMultiBody* multiBody)
+{
+	const btVector3& basePos = multiBody->getBasePos();
+	const btQuaternion& baseRot = multiBody->getWorldToBaseRot();
+	hash = hashVector3(hash, basePos);
+	hash = hashState(hash, &baseRot, sizeof(btQuaternion));
+	hash = hashState(hash, multiBody->getVelocityVector(), (6 + multiBody->getNumDofs()) * sizeof(btScalar));
+	for (int i = 0; i < multiBody->getNumLinks(); i++)
+	{
+		hash = hashState(hash, multiBody->getJointPosMultiDof(i), multiBody->getLink(i).m_posVarCount * sizeof(btScalar));
+	}
+	return hash;
+}
+
+struct btMultiBodyStateHashLoop : public btIParallelForBody
+{
+	const btAlignedObjectArray<btMultiBody*>* m_multiBodies;
+	unsigned int* m_stateHashes;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			m_stateHashes[i] = btMultiBodyDynamicsWorld::hashMultiBodyState(2166136261u, (*m_multiBodies)[i]);
+		}
+	}
+};
+
+unsigned int btMultiBodyDynamicsWorld::computeStateHash(btAlignedObjectArray<unsigned int>& stateHashes) const
+{
+	unsigned int hash = btDiscreteDynamicsWorld::computeStateHash(stateHashes);
+	const int numObjects = stateHashes.size();
+	const int numMultiBodies = m_multiBodies.size();
+	stateHashes.resizeNoInitialize(numObjects + numMultiBodies);
+	if (numMultiBodies)
+	{
+		btMultiBodyStateHashLoop loop;
+		loop.m_multiBodies = &m_multiBodies;
+		loop.m_stateHashes = &stateHashes[numObjects];
+#if BT_THREADSAFE
+		if (btGetTaskScheduler())
+		{
+			btParallelFor(0, numMultiBodies, 16, loop);
+		}
+		else
+#endif
+		{
+			loop.forLoop(0, numMultiBodies);
+		}
+		hash = hashState(hash, &stateHashes[numObjects], numMultiBodies * sizeof(unsigned int));
+	}
+	return hash;
+}
@@ -113,6 +113,11 @@ public:
 	virtual void applyGravity();
 
 	virtual void serialize(btSerializer* serializer);
+
+	///appends one hash per multibody (base state, q and qdot) after the collision object hashes of the base class
+	virtual unsigned int computeStateHash(btAlignedObjectArray<unsigned int>& stateHashes) const;
+	static unsigned int hashMultiBodyState(unsigned int hash, const btMultiBody* multiBody);
+
 	virtual void setMultiBodyConstraintSolver(btMultiBodyConstraintSolver* solver);
 	virtual void setConstraintSolver(btConstraintSolver* solver);
 	virtual void getAnalyticsData(btAlignedObjectArray<struct btSolverAnalyticsData>& m_islandAnalyticsData) const;
@@ -151,6 +151,14 @@ struct btMultibodyLink
 	btScalar m_jointMaxForce;     //todo: implement this internally. It is unused for now, it is set by a URDF loader.
 	btScalar m_jointMaxVelocity;  //todo: implement this internally. It is unused for now, it is set by a URDF loader.
 
+	//implicit joint PD control, see btMultiBody::setJointImplicitPD. Revolute and prismatic joints use index 0,
+	//spherical joints use 3 gains per local axis and a target quaternion (x,y,z,w).
+	bool m_hasImplicitPD;
+	btScalar m_implicitPDKp[3];
+	btScalar m_implicitPDKd[3];
+	btScalar m_implicitPDTargetPos[4];
+	btScalar m_implicitPDTargetVel[3];
+
 	// ctor: set some sensible defaults
 	btMultibodyLink()
 		: m_mass(1),
@@ -172,7 +180,8 @@ struct btMultibodyLink
 		  m_jointLowerLimit(0),
 		  m_jointUpperLimit(0),
 		  m_jointMaxForce(0),
-		  m_jointMaxVelocity(0)
+		  m_jointMaxVelocity(0),
+		  m_hasImplicitPD(false)
 	{
 		m_inertiaLocal.setValue(1, 1, 1);
 		setAxisTop(0, 0., 0., 0.);
@@ -189,6 +198,14 @@ struct btMultibodyLink
 		m_jointPos[0] = m_jointPos[1] = m_jointPos[2] = m_jointPos[4] = m_jointPos[5] = m_jointPos[6] = 0.f;
 		m_jointPos[3] = 1.f;  //"quat.w"
 		m_jointTorque[0] = m_jointTorque[1] = m_jointTorque[2] = m_jointTorque[3] = m_jointTorque[4] = m_jointTorque[5] = 0.f;
+		for (int dof = 0; dof < 3; dof++)
+		{
+			m_implicitPDKp[dof] = 0.f;
+			m_implicitPDKd[dof] = 0.f;
+			m_implicitPDTargetPos[dof] = 0.f;
+			m_implicitPDTargetVel[dof] = 0.f;
+		}
+		m_implicitPDTargetPos[3] = 1.f;
 		m_cachedWorldTransform.setIdentity();
 	}
 
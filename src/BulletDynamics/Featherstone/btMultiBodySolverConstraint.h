@@ -39,6 +39,16 @@ btMultiBodySolverConstraint
 	int m_deltaVelBindex;
 	int m_jacBindex;
 
+	//sparsity of the Jacobian rows, filled in by btMultiBodyConstraintSolver after setup: m_data.m_sparseDofIndices
+	//holds at m_sparseAindex the m_jacAnumNonZero dofs where the Jacobian of A is nonzero (the dofs along
+	//the path from the link to the base), followed by the m_responseAnumNonZero dofs where its unit impulse response is nonzero
+	int m_sparseAindex;
+	int m_jacAnumNonZero;
+	int m_responseAnumNonZero;
+	int m_sparseBindex;
+	int m_jacBnumNonZero;
+	int m_responseBnumNonZero;
+
 	btVector3 m_relpos1CrossNormal;
 	btVector3 m_contactNormal1;
 	btVector3 m_relpos2CrossNormal;
@@ -18,6 +18,7 @@ subject to the following restrictions:
 #include "btAlignedObjectArray.h"
 #include "btMinMax.h"
 #include "btVector3.h"
+#include "btThreads.h"
 
 #ifdef __GNUC__
 #include <stdint.h>
@@ -826,10 +827,21 @@ private:
 
 	bool shiftFace(Face* face, btScalar amount, btAlignedObjectArray<Vertex*> stack);
 
+	void quantize(const void* coords, bool doubleCoords, int stride, int count, bool parallel, btAlignedObjectArray<Point32>& points);
+
+	static void prefilterPoints(btAlignedObjectArray<Point32>& points, bool parallel);
+
 public:
 	Vertex* vertexList;
 
-	void compute(const void* coords, bool doubleCoords, int stride, int count);
+	// flags are btConvexHullComputer::CHC_* values
+	void compute(const void* coords, bool doubleCoords, int stride, int count, int flags = 0);
+
+	// builds the hull of already quantized points, the array is sorted in place
+	void computeFromPoints(btAlignedObjectArray<Point32>& points);
+
+	// appends the quantized points of all hull vertices
+	void collectHullPoints(btAlignedObjectArray<Point32>& points);
 
 	btVector3 getCoordinates(const Vertex* v);
 
@@ -1953,11 +1965,121 @@ public:
 	}
 };
 
-void btConvexHullInternal::compute(const void* coords, bool doubleCoords, int stride, int count)
+// points per task in the accelerated loops
+#define BT_CONVEX_HULL_GRAIN_SIZE 16384
+
+static void btConvexHullParallelFor(bool parallel, int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+{
+#if BT_THREADSAFE
+	if (parallel && btGetTaskScheduler())
+	{
+		btParallelFor(iBegin, iEnd, grainSize, body);
+		return;
+	}
+#endif
+	body.forLoop(iBegin, iEnd);
+}
+
+static int btConvexHullGetNumThreads()
+{
+#if BT_THREADSAFE
+	if (btGetTaskScheduler())
+	{
+		return btGetTaskScheduler()->getNumThreads();
+	}
+#endif
+	return 1;
+}
+
+static inline btVector3 btConvexHullLoadPoint(const char* ptr, bool doubleCoords)
+{
+	if (doubleCoords)
+	{
+		const double* v = (const double*)ptr;
+		return btVector3((btScalar)v[0], (btScalar)v[1], (btScalar)v[2]);
+	}
+	const float* v = (const float*)ptr;
+	return btVector3(v[0], v[1], v[2]);
+}
+
+struct btConvexHullBoundsLoop : public btIParallelForBody
+{
+	const char* m_coords;
+	bool m_doubleCoords;
+	int m_stride;
+	int m_count;
+	btVector3* m_chunkMin;
+	btVector3* m_chunkMax;
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		for (int c = iBegin; c < iEnd; c++)
+		{
+			btVector3 min(btScalar(1e30), btScalar(1e30), btScalar(1e30)), max(btScalar(-1e30), btScalar(-1e30), btScalar(-1e30));
+			int end = btMin(m_count, (c + 1) * BT_CONVEX_HULL_GRAIN_SIZE);
+			for (int i = c * BT_CONVEX_HULL_GRAIN_SIZE; i < end; i++)
+			{
+				btVector3 p = btConvexHullLoadPoint(m_coords + i * m_stride, m_doubleCoords);
+				min.setMin(p);
+				max.setMax(p);
+			}
+			m_chunkMin[c] = min;
+			m_chunkMax[c] = max;
+		}
+	}
+};
+
+struct btConvexHullQuantizeLoop : public btIParallelForBody
+{
+	const char* m_coords;
+	bool m_doubleCoords;
+	int m_stride;
+	btVector3 m_center;
+	btVector3 m_scale;
+	int m_minAxis;
+	int m_medAxis;
+	int m_maxAxis;
+	btConvexHullInternal::Point32* m_points;
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			btVector3 p = (btConvexHullLoadPoint(m_coords + i * m_stride, m_doubleCoords) - m_center) * m_scale;
+			m_points[i].x = (int32_t)p[m_medAxis];
+			m_points[i].y = (int32_t)p[m_maxAxis];
+			m_points[i].z = (int32_t)p[m_minAxis];
+			m_points[i].index = i;
+		}
+	}
+};
+
+void btConvexHullInternal::quantize(const void* coords, bool doubleCoords, int stride, int count, bool parallel, btAlignedObjectArray<Point32>& points)
 {
 	btVector3 min(btScalar(1e30), btScalar(1e30), btScalar(1e30)), max(btScalar(-1e30), btScalar(-1e30), btScalar(-1e30));
 	const char* ptr = (const char*)coords;
-	if (doubleCoords)
+	if (parallel)
+	{
+		int numChunks = (count + BT_CONVEX_HULL_GRAIN_SIZE - 1) / BT_CONVEX_HULL_GRAIN_SIZE;
+		btAlignedObjectArray<btVector3> chunkMin;
+		btAlignedObjectArray<btVector3> chunkMax;
+		chunkMin.resize(numChunks);
+		chunkMax.resize(numChunks);
+		btConvexHullBoundsLoop loop;
+		loop.m_coords = ptr;
+		loop.m_doubleCoords = doubleCoords;
+		loop.m_stride = stride;
+		loop.m_count = count;
+		loop.m_chunkMin = &chunkMin[0];
+		loop.m_chunkMax = &chunkMax[0];
+		btConvexHullParallelFor(true, 0, numChunks, 1, loop);
+		for (int c = 0; c < numChunks; c++)
+		{
+			min.setMin(chunkMin[c]);
+			max.setMax(chunkMax[c]);
+		}
+	}
+	else if (doubleCoords)
 	{
 		for (int i = 0; i < count; i++)
 		{
@@ -2011,10 +2133,23 @@ void btConvexHullInternal::compute(const void* coords, bool doubleCoords, int st
 
 	center = (min + max) * btScalar(0.5);
 
-	btAlignedObjectArray<Point32> points;
 	points.resize(count);
 	ptr = (const char*)coords;
-	if (doubleCoords)
+	if (parallel)
+	{
+		btConvexHullQuantizeLoop loop;
+		loop.m_coords = ptr;
+		loop.m_doubleCoords = doubleCoords;
+		loop.m_stride = stride;
+		loop.m_center = center;
+		loop.m_scale = s;
+		loop.m_minAxis = minAxis;
+		loop.m_medAxis = medAxis;
+		loop.m_maxAxis = maxAxis;
+		loop.m_points = &points[0];
+		btConvexHullParallelFor(true, 0, count, BT_CONVEX_HULL_GRAIN_SIZE, loop);
+	}
+	else if (doubleCoords)
 	{
 		for (int i = 0; i < count; i++)
 		{
@@ -2042,6 +2177,303 @@ void btConvexHullInternal::compute(const void* coords, bool doubleCoords, int st
 			points[i].index = i;
 		}
 	}
+}
+
+// the 13 directions (-1, 0, 1)^3 / +-, so 26 extreme points are searched
+#define BT_CONVEX_HULL_NUM_DIRECTIONS 13
+
+static const int btConvexHullDirections[BT_CONVEX_HULL_NUM_DIRECTIONS][3] = {
+	{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, 1, 0}, {1, -1, 0}, {1, 0, 1}, {1, 0, -1}, {0, 1, 1}, {0, 1, -1}, {1, 1, 1}, {1, 1, -1}, {1, -1, 1}, {1, -1, -1}};
+
+struct btConvexHullExtremesLoop : public btIParallelForBody
+{
+	const btConvexHullInternal::Point32* m_points;
+	int m_count;
+	// per chunk, index of the minimum and maximum point along each direction
+	int* m_chunkExtremes;
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		for (int c = iBegin; c < iEnd; c++)
+		{
+			int begin = c * BT_CONVEX_HULL_GRAIN_SIZE;
+			int end = btMin(m_count, begin + BT_CONVEX_HULL_GRAIN_SIZE);
+			int64_t minDot[BT_CONVEX_HULL_NUM_DIRECTIONS];
+			int64_t maxDot[BT_CONVEX_HULL_NUM_DIRECTIONS];
+			int* extremes = m_chunkExtremes + c * 2 * BT_CONVEX_HULL_NUM_DIRECTIONS;
+			for (int d = 0; d < BT_CONVEX_HULL_NUM_DIRECTIONS; d++)
+			{
+				minDot[d] = maxDot[d] = (int64_t)btConvexHullDirections[d][0] * m_points[begin].x + (int64_t)btConvexHullDirections[d][1] * m_points[begin].y + (int64_t)btConvexHullDirections[d][2] * m_points[begin].z;
+				extremes[2 * d] = extremes[2 * d + 1] = begin;
+			}
+			for (int i = begin + 1; i < end; i++)
+			{
+				const btConvexHullInternal::Point32& p = m_points[i];
+				for (int d = 0; d < BT_CONVEX_HULL_NUM_DIRECTIONS; d++)
+				{
+					int64_t dot = (int64_t)btConvexHullDirections[d][0] * p.x + (int64_t)btConvexHullDirections[d][1] * p.y + (int64_t)btConvexHullDirections[d][2] * p.z;
+					if (dot < minDot[d])
+					{
+						minDot[d] = dot;
+						extremes[2 * d] = i;
+					}
+					if (dot > maxDot[d])
+					{
+						maxDot[d] = dot;
+						extremes[2 * d + 1] = i;
+					}
+				}
+			}
+		}
+	}
+};
+
+struct btConvexHullPlane
+{
+	int64_t n[3];
+	int64_t d;
+};
+
+struct btConvexHullClassifyLoop : public btIParallelForBody
+{
+	const btConvexHullInternal::Point32* m_points;
+	const btConvexHullPlane* m_planes;
+	int m_numPlanes;
+	unsigned char* m_keep;
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			const btConvexHullInternal::Point32& p = m_points[i];
+			unsigned char keep = 0;
+			for (int j = 0; j < m_numPlanes; j++)
+			{
+				const btConvexHullPlane& plane = m_planes[j];
+				if (plane.n[0] * p.x + plane.n[1] * p.y + plane.n[2] * p.z >= plane.d)
+				{
+					keep = 1;
+					break;
+				}
+			}
+			m_keep[i] = keep;
+		}
+	}
+};
+
+static int64_t btConvexHullGcd(int64_t a, int64_t b)
+{
+	while (b)
+	{
+		int64_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+// Akl-Toussaint heuristic on the quantized points: the hull of the 26 extreme points along fixed directions is an
+// inner polytope of the full hull. Points strictly inside all of its faces can not be on the hull, and because the
+// test uses the same integer coordinates as the hull itself, removing them leaves the result unchanged.
+void btConvexHullInternal::prefilterPoints(btAlignedObjectArray<Point32>& points, bool parallel)
+{
+	int count = points.size();
+	if (count < 4)
+	{
+		// no polytope with interior, and no chunk to seed the extreme points from
+		return;
+	}
+	int numChunks = (count + BT_CONVEX_HULL_GRAIN_SIZE - 1) / BT_CONVEX_HULL_GRAIN_SIZE;
+	btAlignedObjectArray<int> chunkExtremes;
+	chunkExtremes.resize(numChunks * 2 * BT_CONVEX_HULL_NUM_DIRECTIONS);
+	btConvexHullExtremesLoop extremesLoop;
+	extremesLoop.m_points = &points[0];
+	extremesLoop.m_count = count;
+	extremesLoop.m_chunkExtremes = &chunkExtremes[0];
+	btConvexHullParallelFor(parallel, 0, numChunks, 1, extremesLoop);
+
+	// merge the chunks, the direction dot products are recomputed so that ties go to the first chunk
+	btAlignedObjectArray<Point64> extremes;
+	for (int k = 0; k < 2 * BT_CONVEX_HULL_NUM_DIRECTIONS; k++)
+	{
+		const int* dir = btConvexHullDirections[k >> 1];
+		int64_t sign = (k & 1) ? 1 : -1;
+		int best = chunkExtremes[k];
+		int64_t bestDot = sign * (dir[0] * (int64_t)points[best].x + dir[1] * (int64_t)points[best].y + dir[2] * (int64_t)points[best].z);
+		for (int c = 1; c < numChunks; c++)
+		{
+			int i = chunkExtremes[c * 2 * BT_CONVEX_HULL_NUM_DIRECTIONS + k];
+			int64_t dot = sign * (dir[0] * (int64_t)points[i].x + dir[1] * (int64_t)points[i].y + dir[2] * (int64_t)points[i].z);
+			if (dot > bestDot)
+			{
+				bestDot = dot;
+				best = i;
+			}
+		}
+		Point64 p(points[best].x, points[best].y, points[best].z);
+		bool duplicate = false;
+		for (int j = 0; j < extremes.size() && !duplicate; j++)
+		{
+			duplicate = (extremes[j].x == p.x) && (extremes[j].y == p.y) && (extremes[j].z == p.z);
+		}
+		if (!duplicate)
+		{
+			extremes.push_back(p);
+		}
+	}
+
+	// faces of the inner polytope: every plane through three extreme points that has all of them on one side
+	btAlignedObjectArray<btConvexHullPlane> planes;
+	int numExtremes = extremes.size();
+	for (int a = 0; a < numExtremes; a++)
+	{
+		for (int b = a + 1; b < numExtremes; b++)
+		{
+			for (int c = b + 1; c < numExtremes; c++)
+			{
+				Point64 u(extremes[b].x - extremes[a].x, extremes[b].y - extremes[a].y, extremes[b].z - extremes[a].z);
+				Point64 v(extremes[c].x - extremes[a].x, extremes[c].y - extremes[a].y, extremes[c].z - extremes[a].z);
+				Point64 n(u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x);
+				if (n.isZero())
+				{
+					continue;
+				}
+				int64_t g = btConvexHullGcd(btConvexHullGcd(n.x < 0 ? -n.x : n.x, n.y < 0 ? -n.y : n.y), n.z < 0 ? -n.z : n.z);
+				n = Point64(n.x / g, n.y / g, n.z / g);
+				int64_t d = n.dot(extremes[a]);
+				bool above = false;
+				bool below = false;
+				for (int j = 0; j < numExtremes; j++)
+				{
+					int64_t dot = n.dot(extremes[j]);
+					above = above || (dot > d);
+					below = below || (dot < d);
+				}
+				if (above && below)
+				{
+					continue;
+				}
+				if (!above && !below)
+				{
+					// all extreme points are coplanar, the inner polytope has no interior
+					return;
+				}
+				if (above)
+				{
+					n = Point64(-n.x, -n.y, -n.z);
+					d = -d;
+				}
+				bool duplicate = false;
+				for (int j = 0; j < planes.size() && !duplicate; j++)
+				{
+					duplicate = (planes[j].n[0] == n.x) && (planes[j].n[1] == n.y) && (planes[j].n[2] == n.z);
+				}
+				if (!duplicate)
+				{
+					btConvexHullPlane plane;
+					plane.n[0] = n.x;
+					plane.n[1] = n.y;
+					plane.n[2] = n.z;
+					plane.d = d;
+					planes.push_back(plane);
+				}
+			}
+		}
+	}
+	if (planes.size() < 4)
+	{
+		return;
+	}
+
+	btAlignedObjectArray<unsigned char> keep;
+	keep.resize(count);
+	btConvexHullClassifyLoop classifyLoop;
+	classifyLoop.m_points = &points[0];
+	classifyLoop.m_planes = &planes[0];
+	classifyLoop.m_numPlanes = planes.size();
+	classifyLoop.m_keep = &keep[0];
+	btConvexHullParallelFor(parallel, 0, count, BT_CONVEX_HULL_GRAIN_SIZE, classifyLoop);
+
+	int kept = 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (keep[i])
+		{
+			points[kept++] = points[i];
+		}
+	}
+	points.resize(kept);
+}
+
+struct btConvexHullChunkLoop : public btIParallelForBody
+{
+	const btConvexHullInternal::Point32* m_points;
+	int m_count;
+	int m_chunkSize;
+	btAlignedObjectArray<btConvexHullInternal::Point32>* m_chunkHullPoints;
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		for (int c = iBegin; c < iEnd; c++)
+		{
+			int begin = c * m_chunkSize;
+			int end = btMin(m_count, begin + m_chunkSize);
+			btAlignedObjectArray<btConvexHullInternal::Point32> points;
+			points.resize(end - begin);
+			for (int i = begin; i < end; i++)
+			{
+				points[i - begin] = m_points[i];
+			}
+			btConvexHullInternal hull;
+			hull.computeFromPoints(points);
+			m_chunkHullPoints[c].resize(0);
+			hull.collectHullPoints(m_chunkHullPoints[c]);
+		}
+	}
+};
+
+void btConvexHullInternal::compute(const void* coords, bool doubleCoords, int stride, int count, int flags)
+{
+	bool parallel = (flags & btConvexHullComputer::CHC_PARALLEL) != 0;
+	btAlignedObjectArray<Point32> points;
+	quantize(coords, doubleCoords, stride, count, parallel, points);
+
+	if (flags & btConvexHullComputer::CHC_PREFILTER_POINTS)
+	{
+		prefilterPoints(points, parallel);
+	}
+
+	// the hull of the union of the chunk hulls is the hull of all points, the chunk hulls are built concurrently
+	int numThreads = btConvexHullGetNumThreads();
+	if (parallel && numThreads > 1 && points.size() >= 2 * BT_CONVEX_HULL_GRAIN_SIZE)
+	{
+		int numChunks = btMin(2 * numThreads, points.size() / BT_CONVEX_HULL_GRAIN_SIZE);
+		int chunkSize = (points.size() + numChunks - 1) / numChunks;
+		btAlignedObjectArray<btAlignedObjectArray<Point32> > chunkHullPoints;
+		chunkHullPoints.resize(numChunks);
+		btConvexHullChunkLoop loop;
+		loop.m_points = &points[0];
+		loop.m_count = points.size();
+		loop.m_chunkSize = chunkSize;
+		loop.m_chunkHullPoints = &chunkHullPoints[0];
+		btConvexHullParallelFor(true, 0, numChunks, 1, loop);
+
+		points.resize(0);
+		for (int c = 0; c < numChunks; c++)
+		{
+			for (int i = 0; i < chunkHullPoints[c].size(); i++)
+			{
+				points.push_back(chunkHullPoints[c][i]);
+			}
+		}
+	}
+
+	computeFromPoints(points);
+}
+
+void btConvexHullInternal::computeFromPoints(btAlignedObjectArray<Point32>& points)
+{
+	int count = points.size();
 	points.quickSort(pointCmp());
 
 	vertexPool.reset();
@@ -2074,6 +2506,39 @@ void btConvexHullInternal::compute(const void* coords, bool doubleCoords, int st
 #endif
 }
 
+void btConvexHullInternal::collectHullPoints(btAlignedObjectArray<Point32>& points)
+{
+	if (!vertexList)
+	{
+		return;
+	}
+	btAlignedObjectArray<Vertex*> stack;
+	vertexList->copy = 0;
+	stack.push_back(vertexList);
+	for (int i = 0; i < stack.size(); i++)
+	{
+		Vertex* v = stack[i];
+		points.push_back(v->point);
+		Edge* e = v->edges;
+		if (e)
+		{
+			do
+			{
+				if (e->target->copy < 0)
+				{
+					e->target->copy = 0;
+					stack.push_back(e->target);
+				}
+				e = e->next;
+			} while (e != v->edges);
+		}
+	}
+	for (int i = 0; i < stack.size(); i++)
+	{
+		stack[i]->copy = -1;
+	}
+}
+
 btVector3 btConvexHullInternal::toBtVector(const Point32& v)
 {
 	btVector3 p;
@@ -2661,7 +3126,7 @@ btScalar btConvexHullComputer::compute(const void* coords, bool doubleCoords, in
 	}
 
 	btConvexHullInternal hull;
-	hull.compute(coords, doubleCoords, stride, count);
+	hull.compute(coords, doubleCoords, stride, count, (count >= m_minAcceleratedPointCount) ? m_flags : 0);
 
 	btScalar shift = 0;
 	if ((shrink > 0) && ((shift = hull.shrink(shrink, shrinkClamp)) < 0))
@@ -2756,3 +3221,38 @@ btScalar btConvexHullComputer::compute(const void* coords, bool doubleCoords, in
 
 	return shift;
 }
+
+struct btConvexHullBatchLoop : public btIParallelForBody
+{
+	btConvexHullComputer::BatchItem* m_items;
+	btConvexHullComputer* m_hulls;
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			btConvexHullComputer::BatchItem& item = m_items[i];
+			if (item.m_doubleCoords)
+			{
+				item.m_shift = m_hulls[i].compute((const double*)item.m_coords, item.m_stride, item.m_count, item.m_shrink, item.m_shrinkClamp);
+			}
+			else
+			{
+				item.m_shift = m_hulls[i].compute((const float*)item.m_coords, item.m_stride, item.m_count, item.m_shrink, item.m_shrinkClamp);
+			}
+		}
+	}
+};
+
+void btConvexHullComputer::computeBatch(BatchItem* items, btConvexHullComputer* hulls, int numItems, int grainSize)
+{
+	if (numItems <= 0)
+	{
+		return;
+	}
+	btConvexHullBatchLoop loop;
+	loop.m_items = items;
+	loop.m_hulls = hulls;
+	btConvexHullParallelFor(true, 0, numItems, btMax(1, grainSize), loop);
+}
+
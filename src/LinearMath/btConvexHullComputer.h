@@ -27,6 +27,22 @@ private:
 	btScalar compute(const void* coords, bool doubleCoords, int stride, int count, btScalar shrink, btScalar shrinkClamp);
 
 public:
+	enum
+	{
+		// discard points inside the polytope spanned by 26 extreme points before building the hull (exact, same hull)
+		CHC_PREFILTER_POINTS = 1,
+		// quantize/filter the input with btParallelFor and build hulls of point chunks concurrently before the final merge
+		CHC_PARALLEL = 2
+	};
+
+	// combination of CHC_* flags, only used for inputs of at least m_minAcceleratedPointCount points
+	int m_flags;
+	int m_minAcceleratedPointCount;
+
+	btConvexHullComputer() : m_flags(0), m_minAcceleratedPointCount(4096)
+	{
+	}
+
 	class Edge
 	{
 	private:
@@ -94,6 +110,27 @@ public:
 	{
 		return compute(coords, true, stride, count, shrink, shrinkClamp);
 	}
+
+	// one independent input of computeBatch
+	struct BatchItem
+	{
+		const void* m_coords;
+		bool m_doubleCoords;
+		int m_stride;
+		int m_count;
+		btScalar m_shrink;
+		btScalar m_shrinkClamp;
+		// output, the value returned by compute
+		btScalar m_shift;
+
+		BatchItem() : m_coords(0), m_doubleCoords(false), m_stride(0), m_count(0), m_shrink(0), m_shrinkClamp(0), m_shift(0)
+		{
+		}
+	};
+
+	// Computes hulls[i] from items[i] for all numItems inputs, spread over the threads of the current btITaskScheduler
+	// (serially when there is none). Each hull uses its own m_flags.
+	static void computeBatch(BatchItem* items, btConvexHullComputer* hulls, int numItems, int grainSize = 1);
 };
 
 #endif  //BT_CONVEX_HULL_COMPUTER_H
@@ -23,6 +23,7 @@ subject to the following restrictions:
 #include <memory.h>
 #endif
 #include <string.h>
+#include <stdio.h>
 
 extern char sBulletDNAstr[];
 extern int sBulletDNAlen;
@@ -60,6 +61,9 @@ enum btSerializationFlags
 	BT_SERIALIZE_NO_TRIANGLEINFOMAP = 2,
 	BT_SERIALIZE_NO_DUPLICATE_ASSERT = 4,
 	BT_SERIALIZE_CONTACT_MANIFOLDS = 8,
+	///keep the chunks in the serializer arena after finishSerialization instead of copying them into one contiguous buffer.
+	///getBufferPointer returns 0, use writeToSink or detachSnapshot instead.
+	BT_SERIALIZE_STREAMING = 16,
 };
 
 class btSerializer
@@ -121,6 +125,8 @@ public:
 #define BT_DYNAMICSWORLD_CODE BT_MAKE_ID('D', 'W', 'L', 'D')
 #define BT_CONTACTMANIFOLD_CODE BT_MAKE_ID('C', 'O', 'N', 'T')
 #define BT_DNA_CODE BT_MAKE_ID('D', 'N', 'A', '1')
+///chunk without DNA type that only aligns the following chunks, readers skip it
+#define BT_PADDING_CODE BT_MAKE_ID('P', 'A', 'D', 'S')
 
 struct btPointerUid
 {
@@ -151,6 +157,83 @@ struct btBulletSerializedArrays
 	btAlignedObjectArray<struct btSoftBodyDoubleData*> m_softBodyDoubleData;
 };
 
+///btSerializerSink receives the serialized byte stream, see btDefaultSerializer::writeToSink
+class btSerializerSink
+{
+public:
+	virtual ~btSerializerSink() {}
+
+	///returns false on failure, the remaining data is not written
+	virtual bool write(const void* data, int numBytes) = 0;
+};
+
+class btFileSerializerSink : public btSerializerSink
+{
+	FILE* m_file;
+
+public:
+	btFileSerializerSink(FILE* file)
+		: m_file(file)
+	{
+	}
+
+	virtual bool write(const void* data, int numBytes)
+	{
+		if (numBytes == 0)
+			return true;
+		return fwrite(data, numBytes, 1, m_file) == 1;
+	}
+};
+
+///write the header followed by all chunks (chunk header and data), in allocation order
+SIMD_FORCE_INLINE bool btWriteSerializedChunks(btSerializerSink& sink, const unsigned char* header, const btAlignedObjectArray<btChunk*>& chunkPtrs)
+{
+	if (!sink.write(header, BT_HEADER_LENGTH))
+		return false;
+	for (int i = 0; i < chunkPtrs.size(); i++)
+	{
+		if (!sink.write(chunkPtrs[i], int(sizeof(btChunk)) + chunkPtrs[i]->m_length))
+			return false;
+	}
+	return true;
+}
+
+///btSerializedSnapshot owns the chunks of a finished BT_SERIALIZE_STREAMING serialization.
+///It doesn't reference the serialized objects anymore, so it can be written from another thread while the simulation continues.
+class btSerializedSnapshot
+{
+	friend class btDefaultSerializer;
+
+	btAlignedObjectArray<unsigned char*> m_blocks;
+	btAlignedObjectArray<btChunk*> m_chunkPtrs;
+	unsigned char m_header[BT_HEADER_LENGTH];
+	int m_sizeInBytes;
+
+	btSerializedSnapshot()
+		: m_sizeInBytes(0)
+	{
+	}
+
+public:
+	~btSerializedSnapshot()
+	{
+		for (int i = 0; i < m_blocks.size(); i++)
+		{
+			btAlignedFree(m_blocks[i]);
+		}
+	}
+
+	int getSizeInBytes() const
+	{
+		return m_sizeInBytes;
+	}
+
+	bool writeToSink(btSerializerSink& sink) const
+	{
+		return btWriteSerializedChunks(sink, m_header, m_chunkPtrs);
+	}
+};
+
 ///The btDefaultSerializer is the main Bullet serialization class.
 ///The constructor takes an optional argument for backwards compatibility, it is recommended to leave this empty/zero.
 class btDefaultSerializer : public btSerializer
@@ -180,7 +263,51 @@ protected:
 
 	btAlignedObjectArray<btChunk*> m_chunkPtrs;
 
+	///without a fixed buffer, chunks are sub-allocated from large blocks instead of one btAlignedAlloc per chunk
+	btAlignedObjectArray<unsigned char*> m_arenaBlocks;
+	int m_arenaBlockSize;
+	int m_arenaBlockUsed;
+
 protected:
+	unsigned char* arenaAlloc(size_t size)
+	{
+		//keep chunks 16 byte aligned, like the btAlignedAlloc they replace
+		int alignedSize = (int(size) + 15) & ~15;
+		if (alignedSize > m_arenaBlockSize / 4)
+		{
+			//large chunks get their own block, the partially used block stays the current one
+			unsigned char* block = (unsigned char*)btAlignedAlloc(alignedSize, 16);
+			m_arenaBlocks.push_back(block);
+			if (m_arenaBlocks.size() > 1)
+			{
+				m_arenaBlocks.swap(m_arenaBlocks.size() - 2, m_arenaBlocks.size() - 1);
+			}
+			else
+			{
+				m_arenaBlockUsed = m_arenaBlockSize;
+			}
+			return block;
+		}
+		if (m_arenaBlocks.size() == 0 || m_arenaBlockUsed + alignedSize > m_arenaBlockSize)
+		{
+			m_arenaBlocks.push_back((unsigned char*)btAlignedAlloc(m_arenaBlockSize, 16));
+			m_arenaBlockUsed = 0;
+		}
+		unsigned char* ptr = m_arenaBlocks[m_arenaBlocks.size() - 1] + m_arenaBlockUsed;
+		m_arenaBlockUsed += alignedSize;
+		return ptr;
+	}
+
+	void clearArena()
+	{
+		for (int i = 0; i < m_arenaBlocks.size(); i++)
+		{
+			btAlignedFree(m_arenaBlocks[i]);
+		}
+		m_arenaBlocks.clear();
+		m_arenaBlockUsed = 0;
+	}
+
 	virtual void* findPointer(void* oldPtr)
 	{
 		void** ptr = m_chunkP.find(oldPtr);
@@ -371,7 +498,9 @@ public:
 		  m_currentSize(0),
 		  m_dna(0),
 		  m_dnaLength(0),
-		  m_serializationFlags(0)
+		  m_serializationFlags(0),
+		  m_arenaBlockSize(256 * 1024),
+		  m_arenaBlockUsed(0)
 	{
 		if (buffer == 0)
 		{
@@ -422,6 +551,7 @@ public:
 			btAlignedFree(m_buffer);
 		if (m_dna)
 			btAlignedFree(m_dna);
+		clearArena();
 	}
 
 	static int getMemoryDnaSizeInBytes()
@@ -487,38 +617,78 @@ public:
 	virtual void startSerialization()
 	{
 		m_uniqueIdGenerator = 1;
+		if (!m_totalSize && m_arenaBlocks.size())
+		{
+			//chunks of a previous streaming serialization that wasn't detached
+			m_chunkPtrs.clear();
+			clearArena();
+			m_currentSize = 0;
+		}
 		if (m_totalSize)
 		{
 			unsigned char* buffer = internalAlloc(BT_HEADER_LENGTH);
 			writeHeader(buffer);
 		}
+		insertPaddingChunk();
+	}
+
+	///With 64 bit pointers the 12 byte header leaves the first chunk payload at 4 mod 8. A padding chunk moves it to
+	///a multiple of 8, and allocate keeps the following payloads there, so a loader can use the structs in place.
+	void insertPaddingChunk()
+	{
+		if ((BT_HEADER_LENGTH + sizeof(btChunk)) & 7)
+		{
+			//the first payload follows the header and two chunk headers
+			const int paddingLength = (8 - ((BT_HEADER_LENGTH + 2 * int(sizeof(btChunk))) & 7)) & 7;
+			unsigned char* ptr = internalAlloc(sizeof(btChunk) + paddingLength);
+			memset(ptr + sizeof(btChunk), 0, paddingLength);
+			btChunk* chunk = (btChunk*)ptr;
+			//not a unique id generated by getUniquePointer, so no struct can point at it
+			btPointerUid uid;
+			uid.m_uniqueIds[0] = -1;
+			uid.m_uniqueIds[1] = -1;
+			chunk->m_chunkCode = BT_PADDING_CODE;
+			chunk->m_length = paddingLength;
+			chunk->m_oldPtr = uid.m_ptr;
+			chunk->m_dna_nr = -1;
+			chunk->m_number = 0;
+			m_chunkPtrs.push_back(chunk);
+		}
 	}
 
 	virtual void finishSerialization()
 	{
 		writeDNA();
 
-		//if we didn't pre-allocate a buffer, we need to create a contiguous buffer now
-		int mysize = 0;
+		bool keepChunks = false;
 		if (!m_totalSize)
 		{
 			if (m_buffer)
 				btAlignedFree(m_buffer);
+			m_buffer = 0;
 
 			m_currentSize += BT_HEADER_LENGTH;
-			m_buffer = (unsigned char*)btAlignedAlloc(m_currentSize, 16);
 
-			unsigned char* currentPtr = m_buffer;
-			writeHeader(m_buffer);
-			currentPtr += BT_HEADER_LENGTH;
-			mysize += BT_HEADER_LENGTH;
-			for (int i = 0; i < m_chunkPtrs.size(); i++)
+			if (m_serializationFlags & BT_SERIALIZE_STREAMING)
 			{
-				int curLength = sizeof(btChunk) + m_chunkPtrs[i]->m_length;
-				memcpy(currentPtr, m_chunkPtrs[i], curLength);
-				btAlignedFree(m_chunkPtrs[i]);
-				currentPtr += curLength;
-				mysize += curLength;
+				//the chunks stay in the arena, see writeToSink and detachSnapshot
+				keepChunks = true;
+			}
+			else
+			{
+				//if we didn't pre-allocate a buffer, we need to create a contiguous buffer now
+				m_buffer = (unsigned char*)btAlignedAlloc(m_currentSize, 16);
+
+				unsigned char* currentPtr = m_buffer;
+				writeHeader(m_buffer);
+				currentPtr += BT_HEADER_LENGTH;
+				for (int i = 0; i < m_chunkPtrs.size(); i++)
+				{
+					int curLength = sizeof(btChunk) + m_chunkPtrs[i]->m_length;
+					memcpy(currentPtr, m_chunkPtrs[i], curLength);
+					currentPtr += curLength;
+				}
+				clearArena();
 			}
 		}
 
@@ -531,7 +701,47 @@ public:
 		m_chunkP.clear();
 		m_nameMap.clear();
 		m_uniquePointers.clear();
+		if (!keepChunks)
+		{
+			m_chunkPtrs.clear();
+		}
+	}
+
+	///Writes the serialized data to a sink. In BT_SERIALIZE_STREAMING mode the chunks are written directly from the arena,
+	///without creating a contiguous copy first. Call after finishSerialization (or after serializing a world).
+	bool writeToSink(btSerializerSink& sink) const
+	{
+		if (m_buffer)
+		{
+			return sink.write(m_buffer, m_currentSize);
+		}
+		unsigned char header[BT_HEADER_LENGTH];
+		writeHeader(header);
+		return btWriteSerializedChunks(sink, header, m_chunkPtrs);
+	}
+
+	///Transfers the chunks of a finished BT_SERIALIZE_STREAMING serialization to a snapshot, owned by the caller.
+	///The serializer can be reused or deleted while the snapshot is written, for example on a background thread.
+	btSerializedSnapshot* detachSnapshot()
+	{
+		btAssert(!m_totalSize && !m_buffer);
+		btSerializedSnapshot* snapshot = new btSerializedSnapshot();
+		writeHeader(snapshot->m_header);
+		snapshot->m_sizeInBytes = m_currentSize;
+		snapshot->m_blocks.copyFromArray(m_arenaBlocks);
+		snapshot->m_chunkPtrs.copyFromArray(m_chunkPtrs);
+		m_arenaBlocks.clear();
+		m_arenaBlockUsed = 0;
 		m_chunkPtrs.clear();
+		m_currentSize = 0;
+		return snapshot;
+	}
+
+	///block size used for chunk allocation when no fixed buffer is provided
+	void setArenaBlockSize(int blockSize)
+	{
+		btAssert(blockSize > 0);
+		m_arenaBlockSize = blockSize;
 	}
 
 	virtual void* getUniquePointer(void* oldPtr)
@@ -600,7 +810,7 @@ public:
 		}
 		else
 		{
-			ptr = (unsigned char*)btAlignedAlloc(size, 16);
+			ptr = arenaAlloc(size);
 			m_currentSize += int(size);
 		}
 		return ptr;
@@ -608,14 +818,19 @@ public:
 
 	virtual btChunk* allocate(size_t size, int numElements)
 	{
-		unsigned char* ptr = internalAlloc(int(size) * numElements + sizeof(btChunk));
+		//pad the chunk to a multiple of 8 bytes, so the next chunk payload stays 8 byte aligned in the file.
+		//Readers use m_number to count the elements and skip the zero padding
+		const int length = int(size) * numElements;
+		const int paddedLength = ((length + int(sizeof(btChunk)) + 7) & ~7) - int(sizeof(btChunk));
+		unsigned char* ptr = internalAlloc(paddedLength + sizeof(btChunk));
 
 		unsigned char* data = ptr + sizeof(btChunk);
+		memset(data + length, 0, paddedLength - length);
 
 		btChunk* chunk = (btChunk*)ptr;
 		chunk->m_chunkCode = 0;
 		chunk->m_oldPtr = data;
-		chunk->m_length = int(size) * numElements;
+		chunk->m_length = paddedLength;
 		chunk->m_number = numElements;
 
 		m_chunkPtrs.push_back(chunk);
@@ -25,10 +25,15 @@
 #include "BulletCollision/CollisionDispatch/btCollisionDispatcher.cpp"
 #include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.cpp"
 #include "BulletCollision/CollisionDispatch/btConvexPlaneCollisionAlgorithm.cpp"
+#include "BulletCollision/CollisionDispatch/btPrimitivePairBatch.cpp"
+#include "BulletCollision/CollisionDispatch/btSdfSdfCollisionAlgorithm.cpp"
 #include "BulletCollision/CollisionDispatch/btSphereSphereCollisionAlgorithm.cpp"
 #include "BulletCollision/CollisionDispatch/btCollisionObject.cpp"
 #include "BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.cpp"
 #include "BulletCollision/CollisionDispatch/btSphereTriangleCollisionAlgorithm.cpp"
+#include "BulletCollision/CollisionDispatch/btCapsuleCapsuleCollisionAlgorithm.cpp"
+#include "BulletCollision/CollisionDispatch/btCapsuleBoxCollisionAlgorithm.cpp"
+#include "BulletCollision/CollisionDispatch/btCapsuleTriangleCollisionAlgorithm.cpp"
 #include "BulletCollision/CollisionDispatch/btCollisionWorld.cpp"
 #include "BulletCollision/CollisionDispatch/btEmptyCollisionAlgorithm.cpp"
 #include "BulletCollision/CollisionDispatch/btUnionFind.cpp"
@@ -83,6 +88,7 @@
 #include "BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.cpp"
 #include "BulletCollision/CollisionShapes/btSdfCollisionShape.cpp"
 #include "BulletCollision/CollisionShapes/btMiniSDF.cpp"
+#include "BulletCollision/CollisionShapes/btSdfBaker.cpp"
 #include "BulletCollision/CollisionShapes/btUniformScalingShape.cpp"
 #include "BulletCollision/Gimpact/btContactProcessing.cpp"
 #include "BulletCollision/Gimpact/btGImpactQuantizedBvh.cpp"
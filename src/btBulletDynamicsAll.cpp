@@ -1,5 +1,6 @@
 #include "BulletDynamics/Dynamics/btDiscreteDynamicsWorld.cpp"
 #include "BulletDynamics/Dynamics/btRigidBody.cpp"
+#include "BulletDynamics/Dynamics/btRigidBodyStateArrays.cpp"
 #include "BulletDynamics/Dynamics/btSimulationIslandManagerMt.cpp"
 #include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.cpp"
 #include "BulletDynamics/Dynamics/btSimpleDynamicsWorld.cpp"
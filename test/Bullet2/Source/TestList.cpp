@@ -39,6 +39,15 @@
 #include "Test_3x3getRot.h"
 
 #include "Test_btDbvt.h"
+#include "Test_sdfBake.h"
+#include "Test_convexHull.h"
+#include "Test_dbvtLayout.h"
+#include "Test_satHull.h"
+#include "Test_primitiveBatch.h"
+#include "Test_capsuleCollision.h"
+#include "Test_compoundUpdate.h"
+#include "Test_convexMesh.h"
+#include "Test_sleepingBodies.h"
 #include "Test_quat_aos_neon.h"
 
 #include "LinearMath/btScalar.h"
@@ -89,6 +98,15 @@ TestDesc gTestList[] =
 		ENTRY("3x3getRot", Test_3x3getRot),
 
 		ENTRY("btDbvt", Test_btDbvt),
+		ENTRY("sdfBake", Test_sdfBake),
+		ENTRY("convexHull", Test_convexHull),
+		ENTRY("dbvtLayout", Test_dbvtLayout),
+		ENTRY("satHull", Test_satHull),
+		ENTRY("primitiveBatch", Test_primitiveBatch),
+		ENTRY("capsuleCollision", Test_capsuleCollision),
+		ENTRY("compoundUpdate", Test_compoundUpdate),
+		ENTRY("convexMesh", Test_convexMesh),
+		ENTRY("sleepingBodies", Test_sleepingBodies),
 		ENTRY("quat_aos_neon", Test_quat_aos_neon),
 
 		{NULL, NULL}};
@@ -0,0 +1,153 @@
+//
+//  Test_capsuleCollision.cpp
+//  BulletTest
+//
+//  Narrowphase microbenchmark for capsule-capsule, capsule-box and capsule-triangle pairs. Every pair type runs a set of
+//  random configurations through btConvexConvexAlgorithm (GJK/EPA) and through the dedicated capsule algorithm of
+//  btDefaultCollisionConfiguration, and checks that both find the same closest distance.
+//
+
+#include "LinearMath/btScalar.h"
+#if defined(BT_USE_SSE_IN_API) || defined(BT_USE_NEON)
+
+#include "Test_capsuleCollision.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h>
+#include <BulletCollision/CollisionDispatch/btConvexConvexAlgorithm.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+#include <BulletCollision/CollisionDispatch/btManifoldResult.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btCapsuleShape.h>
+#include <BulletCollision/CollisionShapes/btTriangleShape.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
+
+#define NUM_CONFIGURATIONS 2048
+#define NUM_ITERATIONS 64
+//closest distance difference allowed between GJK/EPA and the closed form, the box and triangle margins round the GJK shapes
+#define DISTANCE_TOLERANCE 0.03f
+//deeper configurations are skipped, EPA and the dedicated algorithms may push out along different axes
+#define MAX_PENETRATION 0.1f
+
+static btTransform randomTransform(btScalar range)
+{
+	btTransform trans;
+	trans.setRotation(btQuaternion(RANDF_m1p1 * SIMD_PI, RANDF_m1p1 * SIMD_PI, RANDF_m1p1 * SIMD_PI));
+	trans.setOrigin(btVector3(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1) * range);
+	return trans;
+}
+
+//runs all configurations of one shape pair, returns the time spent in processCollision
+static double processConfigurations(btCollisionShape* shapeA, btCollisionShape* shapeB, const btAlignedObjectArray<btTransform>& transforms, bool convexConvex,
+									btAlignedObjectArray<btScalar>& distances, int& numContacts)
+{
+	btDefaultCollisionConfiguration configuration;
+	btCollisionDispatcher dispatcher(&configuration);
+	btGjkEpaPenetrationDepthSolver pdSolver;
+	btConvexConvexAlgorithm::CreateFunc convexConvexCF(&pdSolver);
+	if (convexConvex)
+	{
+		dispatcher.registerCollisionCreateFunc(shapeA->getShapeType(), shapeB->getShapeType(), &convexConvexCF);
+	}
+
+	btCollisionObject objA;
+	btCollisionObject objB;
+	objA.setCollisionShape(shapeA);
+	objB.setCollisionShape(shapeB);
+	btDispatcherInfo dispatchInfo;
+	btManifoldArray manifolds;
+
+	uint64_t ticks = 0;
+	numContacts = 0;
+	for (int i = 0; i < transforms.size(); i += 2)
+	{
+		objA.setWorldTransform(transforms[i]);
+		objB.setWorldTransform(transforms[i + 1]);
+		btCollisionObjectWrapper wrapA(0, shapeA, &objA, objA.getWorldTransform(), -1, -1);
+		btCollisionObjectWrapper wrapB(0, shapeB, &objB, objB.getWorldTransform(), -1, -1);
+		btCollisionAlgorithm* algorithm = dispatcher.findAlgorithm(&wrapA, &wrapB, 0, BT_CONTACT_POINT_ALGORITHMS);
+		btManifoldResult result(&wrapA, &wrapB);
+
+		uint64_t startTime = ReadTicks();
+		for (int j = 0; j < NUM_ITERATIONS; j++)
+		{
+			algorithm->processCollision(&wrapA, &wrapB, dispatchInfo, &result);
+		}
+		ticks += ReadTicks() - startTime;
+
+		btScalar distance = BT_LARGE_FLOAT;
+		manifolds.resize(0);
+		algorithm->getAllContactManifolds(manifolds);
+		for (int m = 0; m < manifolds.size(); m++)
+		{
+			numContacts += manifolds[m]->getNumContacts();
+			for (int c = 0; c < manifolds[m]->getNumContacts(); c++)
+			{
+				distance = btMin(distance, manifolds[m]->getContactPoint(c).getDistance());
+			}
+		}
+		distances.push_back(distance);
+
+		algorithm->~btCollisionAlgorithm();
+		dispatcher.freeCollisionAlgorithm(algorithm);
+	}
+	return TicksToSeconds(ticks);
+}
+
+static int testShapePair(const char* name, btCollisionShape* shapeA, btCollisionShape* shapeB)
+{
+	btAlignedObjectArray<btTransform> transforms;
+	for (int i = 0; i < NUM_CONFIGURATIONS; i++)
+	{
+		transforms.push_back(randomTransform(0.f));
+		transforms.push_back(randomTransform(1.2f));
+	}
+
+	btAlignedObjectArray<btScalar> distances[2];
+	int numContacts[2];
+	double seconds[2];
+	for (int dedicated = 0; dedicated < 2; dedicated++)
+	{
+		seconds[dedicated] = processConfigurations(shapeA, shapeB, transforms, !dedicated, distances[dedicated], numContacts[dedicated]);
+	}
+
+	int numTouching = 0;
+	for (int i = 0; i < NUM_CONFIGURATIONS; i++)
+	{
+		const btScalar gjkDistance = distances[0][i];
+		const btScalar distance = distances[1][i];
+		if (gjkDistance == BT_LARGE_FLOAT || distance == BT_LARGE_FLOAT || gjkDistance < -MAX_PENETRATION)
+			continue;
+		numTouching++;
+		if (btFabs(gjkDistance - distance) > DISTANCE_TOLERANCE)
+		{
+			vlog("Error - capsuleCollision: %s configuration %d has distance %f instead of %f\n", name, i, distance, gjkDistance);
+			return 1;
+		}
+	}
+	vlog("  %-16s %4d touching\tgjk %8.4f s %5d contacts\tdedicated %8.4f s %5d contacts\n", name, numTouching, seconds[0], numContacts[0], seconds[1], numContacts[1]);
+	return 0;
+}
+
+int Test_capsuleCollision(void)
+{
+	srand(4521);
+	btCapsuleShape capsule(0.3f, 1.0f);
+	btCapsuleShapeX capsuleX(0.25f, 0.8f);
+	btBoxShape box(btVector3(0.6f, 0.4f, 0.5f));
+	btTriangleShape triangle(btVector3(-1.f, 0.f, -1.f), btVector3(1.2f, 0.f, -0.8f), btVector3(0.f, 0.1f, 1.1f));
+
+	vlog("Timing (seconds) for %d configurations, %d iterations each:\n", NUM_CONFIGURATIONS, NUM_ITERATIONS);
+	int errors = 0;
+	errors += testShapePair("capsule-capsule", &capsule, &capsuleX);
+	errors += testShapePair("capsule-box", &capsule, &box);
+	errors += testShapePair("box-capsule", &box, &capsuleX);
+	errors += testShapePair("capsule-triangle", &capsuleX, &triangle);
+	errors += testShapePair("triangle-capsule", &triangle, &capsule);
+	return errors;
+}
+#endif  //BT_USE_SSE_IN_API
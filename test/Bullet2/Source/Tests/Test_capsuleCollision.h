@@ -0,0 +1,20 @@
+//
+//  Test_capsuleCollision.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_capsuleCollision_h
+#define BulletTest_Test_capsuleCollision_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_capsuleCollision(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,131 @@
+//
+//  Test_compoundUpdate.cpp
+//  BulletTest
+//
+//  Animates all children of a large btCompoundShape, once through updateChildTransform per child and once through
+//  the batched updateChildTransforms. Both must give the same local aabb and the same dynamic tree overlaps.
+//
+
+#include "LinearMath/btScalar.h"
+#if defined(BT_USE_SSE_IN_API) || defined(BT_USE_NEON)
+
+#include "Test_compoundUpdate.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+
+#include <BulletCollision/BroadphaseCollision/btDbvt.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+
+#define NUM_CHILDREN_PER_AXIS 8
+#define NUM_FRAMES 64
+#define NUM_QUERIES 64
+
+struct CountOverlaps : btDbvt::ICollide
+{
+	int m_count;
+
+	CountOverlaps() : m_count(0) {}
+
+	virtual void Process(const btDbvtNode* leaf)
+	{
+		m_count += leaf->dataAsInt + 1;
+	}
+};
+
+static void animate(btAlignedObjectArray<btTransform>& transforms, int frame)
+{
+	int index = 0;
+	for (int x = 0; x < NUM_CHILDREN_PER_AXIS; x++)
+	{
+		for (int y = 0; y < NUM_CHILDREN_PER_AXIS; y++)
+		{
+			for (int z = 0; z < NUM_CHILDREN_PER_AXIS; z++)
+			{
+				const btScalar phase = btScalar(0.1) * frame + btScalar(0.37) * index;
+				btTransform& trans = transforms[index++];
+				trans.setRotation(btQuaternion(btVector3(x + 1, y, z).normalized(), btSin(phase)));
+				trans.setOrigin(btVector3(x, y, z) * 1.5f + btVector3(btSin(phase), btCos(phase), btSin(2.f * phase)) * 0.5f);
+			}
+		}
+	}
+}
+
+int Test_compoundUpdate(void)
+{
+	btBoxShape box(btVector3(0.5f, 0.3f, 0.4f));
+	btAlignedObjectArray<btTransform> transforms;
+	transforms.resize(NUM_CHILDREN_PER_AXIS * NUM_CHILDREN_PER_AXIS * NUM_CHILDREN_PER_AXIS);
+	animate(transforms, 0);
+
+	btAlignedObjectArray<btDbvtVolume> queries;
+	for (int i = 0; i < NUM_QUERIES; i++)
+	{
+		const btVector3 center = btVector3(RANDF_01, RANDF_01, RANDF_01) * (NUM_CHILDREN_PER_AXIS * 1.5f);
+		queries.push_back(btDbvtVolume::FromCE(center, btVector3(1.f, 1.f, 1.f) + btVector3(RANDF_01, RANDF_01, RANDF_01)));
+	}
+
+	double seconds[2];
+	btVector3 aabbMin[2], aabbMax[2];
+	int overlaps[2];
+	vlog("Timing (seconds) for %d frames of %d children:\n", NUM_FRAMES, transforms.size());
+	for (int batched = 0; batched < 2; batched++)
+	{
+		btCompoundShape compound;
+		for (int i = 0; i < transforms.size(); i++)
+		{
+			compound.addChildShape(transforms[i], &box);
+		}
+		const int revision = compound.getUpdateRevision();
+
+		uint64_t ticks = 0;
+		for (int frame = 1; frame <= NUM_FRAMES; frame++)
+		{
+			animate(transforms, frame);
+			uint64_t startTime = ReadTicks();
+			if (batched)
+			{
+				compound.updateChildTransforms(transforms.size(), 0, &transforms[0]);
+			}
+			else
+			{
+				for (int i = 0; i < transforms.size(); i++)
+				{
+					compound.updateChildTransform(i, transforms[i]);
+				}
+			}
+			ticks += ReadTicks() - startTime;
+		}
+		seconds[batched] = TicksToSeconds(ticks);
+
+		if (compound.getUpdateRevision() != revision)
+		{
+			vlog("Error - compoundUpdate: the update revision changed\n");
+			return 1;
+		}
+		compound.getAabb(btTransform::getIdentity(), aabbMin[batched], aabbMax[batched]);
+		CountOverlaps counter;
+		for (int i = 0; i < queries.size(); i++)
+		{
+			compound.getDynamicAabbTree()->collideTV(compound.getDynamicAabbTree()->m_root, queries[i], counter);
+		}
+		overlaps[batched] = counter.m_count;
+	}
+	vlog("  updateChildTransform\t%10.4f\n", seconds[0]);
+	vlog("  updateChildTransforms\t%10.4f\n", seconds[1]);
+
+	if (aabbMin[0] != aabbMin[1] || aabbMax[0] != aabbMax[1])
+	{
+		vlog("Error - compoundUpdate: the local aabb differs\n");
+		return 1;
+	}
+	if (overlaps[0] != overlaps[1])
+	{
+		vlog("Error - compoundUpdate: %d tree overlaps instead of %d\n", overlaps[1], overlaps[0]);
+		return 1;
+	}
+	return 0;
+}
+#endif  //BT_USE_SSE_IN_API
@@ -0,0 +1,20 @@
+//
+//  Test_compoundUpdate.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_compoundUpdate_h
+#define BulletTest_Test_compoundUpdate_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_compoundUpdate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+//
+//  Test_convexHull.cpp
+//  BulletTest
+//
+//  Measures btConvexHullComputer throughput on 1k to 1M point clouds (inside a ball and on a sphere)
+//  with and without the CHC_PREFILTER_POINTS / CHC_PARALLEL paths, and for a batch of small hulls.
+//  The accelerated paths must produce the same hull as the plain one.
+//
+
+#include "LinearMath/btScalar.h"
+#if defined(BT_USE_SSE_IN_API) || defined(BT_USE_NEON)
+
+#include "Test_convexHull.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+
+#include <LinearMath/btConvexHullComputer.h>
+
+#define NUM_BATCH_HULLS 2000
+#define NUM_BATCH_POINTS 200
+
+static void makePointCloud(btAlignedObjectArray<btVector3>& points, int count, bool onSurface)
+{
+	points.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		btVector3 p;
+		do
+		{
+			p.setValue(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1);
+		} while (p.length2() > 1 || p.length2() < 1e-6);
+		if (onSurface)
+		{
+			p.normalize();
+		}
+		points[i] = p;
+	}
+}
+
+int Test_convexHull(void)
+{
+	static const int flags[] = {0, btConvexHullComputer::CHC_PREFILTER_POINTS, btConvexHullComputer::CHC_PREFILTER_POINTS | btConvexHullComputer::CHC_PARALLEL};
+	static const char* flagNames[] = {"plain", "prefilter", "prefilter+parallel"};
+
+	vlog("Timing (million points per second):\n");
+	vlog("      points\t   cloud\t%10s\t%10s\t%10s\n", flagNames[0], flagNames[1], flagNames[2]);
+	for (int count = 1000; count <= 1000000; count *= 10)
+	{
+		for (int surface = 0; surface < 2; surface++)
+		{
+			btAlignedObjectArray<btVector3> points;
+			makePointCloud(points, count, surface != 0);
+
+			double rate[3];
+			int numVertices[3];
+			int numFaces[3];
+			for (int f = 0; f < 3; f++)
+			{
+				btConvexHullComputer hull;
+				hull.m_flags = flags[f];
+				hull.m_minAcceleratedPointCount = 0;
+				uint64_t startTime = ReadTicks();
+				hull.compute(&points[0].x(), sizeof(btVector3), count, 0, 0);
+				uint64_t time = ReadTicks() - startTime;
+				rate[f] = count / btMax(TicksToSeconds(time), 1e-9) * 1e-6;
+				numVertices[f] = hull.vertices.size();
+				numFaces[f] = hull.faces.size();
+			}
+			vlog("  %10d\t%8s\t%10.3f\t%10.3f\t%10.3f\n", count, surface ? "sphere" : "ball", rate[0], rate[1], rate[2]);
+
+			for (int f = 1; f < 3; f++)
+			{
+				if (numVertices[f] != numVertices[0] || numFaces[f] != numFaces[0])
+				{
+					vlog("Error - convexHull %s gives %d vertices %d faces instead of %d %d\n", flagNames[f], numVertices[f], numFaces[f], numVertices[0], numFaces[0]);
+					return 1;
+				}
+			}
+		}
+	}
+
+	btAlignedObjectArray<btVector3> points;
+	makePointCloud(points, NUM_BATCH_HULLS * NUM_BATCH_POINTS, false);
+	btAlignedObjectArray<btConvexHullComputer> hulls;
+	btAlignedObjectArray<btConvexHullComputer::BatchItem> items;
+	hulls.resize(NUM_BATCH_HULLS);
+	items.resize(NUM_BATCH_HULLS);
+	for (int i = 0; i < NUM_BATCH_HULLS; i++)
+	{
+		items[i].m_coords = &points[i * NUM_BATCH_POINTS].x();
+		items[i].m_doubleCoords = (sizeof(btScalar) == sizeof(double));
+		items[i].m_stride = sizeof(btVector3);
+		items[i].m_count = NUM_BATCH_POINTS;
+	}
+
+	uint64_t startTime = ReadTicks();
+	for (int i = 0; i < NUM_BATCH_HULLS; i++)
+	{
+		btConvexHullComputer hull;
+		hull.compute(&points[i * NUM_BATCH_POINTS].x(), sizeof(btVector3), NUM_BATCH_POINTS, 0, 0);
+	}
+	uint64_t loopTime = ReadTicks() - startTime;
+
+	startTime = ReadTicks();
+	btConvexHullComputer::computeBatch(&items[0], &hulls[0], NUM_BATCH_HULLS, 16);
+	uint64_t batchTime = ReadTicks() - startTime;
+
+	vlog("  %d hulls of %d points: loop %.4f s, computeBatch %.4f s\n", NUM_BATCH_HULLS, NUM_BATCH_POINTS, TicksToSeconds(loopTime), TicksToSeconds(batchTime));
+	for (int i = 0; i < NUM_BATCH_HULLS; i++)
+	{
+		if (hulls[i].vertices.size() < 4)
+		{
+			vlog("Error - convexHull batch item %d has %d vertices\n", i, hulls[i].vertices.size());
+			return 1;
+		}
+	}
+	return 0;
+}
+#endif  //BT_USE_SSE_IN_API
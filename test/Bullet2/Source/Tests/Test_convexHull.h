@@ -0,0 +1,20 @@
+//
+//  Test_convexHull.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_convexHull_h
+#define BulletTest_Test_convexHull_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_convexHull(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
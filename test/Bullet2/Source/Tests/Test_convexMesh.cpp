@@ -0,0 +1,171 @@
+//
+//  Test_convexMesh.cpp
+//  BulletTest
+//
+//  Convex shapes sliding over a dense bumpy btBvhTriangleMeshShape through btConvexConcaveCollisionAlgorithm, once with
+//  every overlapping triangle sent to the narrowphase and once with the cached and batched triangle path of
+//  gBatchConvexConcaveTriangles. Both must find the same contacts.
+//
+
+#include "LinearMath/btScalar.h"
+#if defined(BT_USE_SSE_IN_API) || defined(BT_USE_NEON)
+
+#include "Test_convexMesh.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h>
+#include <BulletCollision/CollisionDispatch/btConvexConcaveCollisionAlgorithm.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+#include <BulletCollision/CollisionDispatch/btManifoldResult.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btCapsuleShape.h>
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+
+#define GRID_SIZE 96
+#define GRID_SPACING 0.25f
+#define NUM_BODIES 64
+#define NUM_FRAMES 128
+#define DISTANCE_TOLERANCE 0.0001f
+
+static btScalar groundHeight(btScalar x, btScalar z)
+{
+	return btScalar(0.15) * btSin(x * btScalar(1.3)) * btCos(z * btScalar(1.7)) + btScalar(0.05) * btSin(x * btScalar(5.1) + z * btScalar(3.3));
+}
+
+static btTransform bodyTransform(int body, int frame)
+{
+	const btScalar phase = btScalar(0.37) * body;
+	const btScalar extent = GRID_SIZE * GRID_SPACING;
+	const btScalar x = (btScalar(0.1) + btScalar(0.8) * (body % 8) / 7.f) * extent + btSin(phase + frame * btScalar(0.02));
+	const btScalar z = (btScalar(0.1) + btScalar(0.8) * (body / 8) / 7.f) * extent + btCos(phase + frame * btScalar(0.015));
+	btTransform trans;
+	trans.setRotation(btQuaternion(phase + frame * btScalar(0.01), btScalar(0.2) * btSin(phase), btScalar(0.1)));
+	trans.setOrigin(btVector3(x, groundHeight(x, z) + btScalar(0.3), z));
+	return trans;
+}
+
+int Test_convexMesh(void)
+{
+	btTriangleMesh mesh;
+	for (int i = 0; i < GRID_SIZE; i++)
+	{
+		for (int j = 0; j < GRID_SIZE; j++)
+		{
+			btVector3 v[4];
+			for (int k = 0; k < 4; k++)
+			{
+				const btScalar x = (i + (k & 1)) * GRID_SPACING;
+				const btScalar z = (j + (k >> 1)) * GRID_SPACING;
+				v[k].setValue(x, groundHeight(x, z), z);
+			}
+			mesh.addTriangle(v[0], v[1], v[2]);
+			mesh.addTriangle(v[1], v[3], v[2]);
+		}
+	}
+	btBvhTriangleMeshShape meshShape(&mesh, true);
+
+	btBoxShape box(btVector3(0.4f, 0.3f, 0.35f));
+	btSphereShape sphere(0.35f);
+	btCapsuleShape capsule(0.25f, 0.6f);
+	btConvexHullShape hull;
+	for (int i = 0; i < 12; i++)
+	{
+		hull.addPoint(btVector3(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1) * btScalar(0.4), false);
+	}
+	hull.recalcLocalAabb();
+	btCollisionShape* shapes[4] = {&box, &sphere, &capsule, &hull};
+
+	btDefaultCollisionConfiguration configuration;
+	btCollisionDispatcher dispatcher(&configuration);
+	btDispatcherInfo dispatchInfo;
+	btCollisionObject meshObj;
+	meshObj.setCollisionShape(&meshShape);
+	btCollisionObjectWrapper meshWrap(0, &meshShape, &meshObj, meshObj.getWorldTransform(), -1, -1);
+
+	double seconds[2];
+	btAlignedObjectArray<int> contacts[2];
+	btAlignedObjectArray<btScalar> distances[2];
+	btManifoldArray manifolds;
+	const bool batchTriangles = gBatchConvexConcaveTriangles;
+	vlog("Timing (seconds) for %d frames of %d convex shapes on %d triangles:\n", NUM_FRAMES, NUM_BODIES, GRID_SIZE * GRID_SIZE * 2);
+	for (int batched = 0; batched < 2; batched++)
+	{
+		gBatchConvexConcaveTriangles = batched != 0;
+		btCollisionObject bodies[NUM_BODIES];
+		btCollisionAlgorithm* algorithms[NUM_BODIES];
+		for (int i = 0; i < NUM_BODIES; i++)
+		{
+			bodies[i].setCollisionShape(shapes[i % 4]);
+			bodies[i].setWorldTransform(bodyTransform(i, 0));
+			btCollisionObjectWrapper wrap(0, shapes[i % 4], &bodies[i], bodies[i].getWorldTransform(), -1, -1);
+			algorithms[i] = dispatcher.findAlgorithm(&wrap, &meshWrap, 0, BT_CONTACT_POINT_ALGORITHMS);
+		}
+
+		uint64_t ticks = 0;
+		for (int frame = 0; frame < NUM_FRAMES; frame++)
+		{
+			for (int i = 0; i < NUM_BODIES; i++)
+			{
+				bodies[i].setWorldTransform(bodyTransform(i, frame));
+			}
+			uint64_t startTime = ReadTicks();
+			for (int i = 0; i < NUM_BODIES; i++)
+			{
+				btCollisionObjectWrapper wrap(0, shapes[i % 4], &bodies[i], bodies[i].getWorldTransform(), -1, -1);
+				btManifoldResult result(&wrap, &meshWrap);
+				algorithms[i]->processCollision(&wrap, &meshWrap, dispatchInfo, &result);
+			}
+			ticks += ReadTicks() - startTime;
+
+			for (int i = 0; i < NUM_BODIES; i++)
+			{
+				int numContacts = 0;
+				btScalar distance = BT_LARGE_FLOAT;
+				manifolds.resize(0);
+				algorithms[i]->getAllContactManifolds(manifolds);
+				for (int m = 0; m < manifolds.size(); m++)
+				{
+					numContacts += manifolds[m]->getNumContacts();
+					for (int c = 0; c < manifolds[m]->getNumContacts(); c++)
+					{
+						distance = btMin(distance, manifolds[m]->getContactPoint(c).getDistance());
+					}
+				}
+				contacts[batched].push_back(numContacts);
+				distances[batched].push_back(distance);
+			}
+		}
+		seconds[batched] = TicksToSeconds(ticks);
+
+		for (int i = 0; i < NUM_BODIES; i++)
+		{
+			algorithms[i]->~btCollisionAlgorithm();
+			dispatcher.freeCollisionAlgorithm(algorithms[i]);
+		}
+	}
+	gBatchConvexConcaveTriangles = batchTriangles;
+
+	int numContacts = 0;
+	for (int i = 0; i < contacts[0].size(); i++)
+	{
+		numContacts += contacts[0][i];
+		if (contacts[0][i] != contacts[1][i] || btFabs(distances[0][i] - distances[1][i]) > DISTANCE_TOLERANCE)
+		{
+			vlog("Error - convexMesh: body %d frame %d has %d contacts at %f instead of %d at %f\n", i % NUM_BODIES, i / NUM_BODIES,
+				 contacts[1][i], distances[1][i], contacts[0][i], distances[0][i]);
+			return 1;
+		}
+	}
+	vlog("  per triangle\t%10.4f\n", seconds[0]);
+	vlog("  batched\t%10.4f\n", seconds[1]);
+	vlog("  %d contacts\n", numContacts);
+	return 0;
+}
+#endif  //BT_USE_SSE_IN_API
@@ -0,0 +1,20 @@
+//
+//  Test_convexMesh.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_convexMesh_h
+#define BulletTest_Test_convexMesh_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_convexMesh(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,140 @@
+//
+//  Test_dbvtLayout.cpp
+//  BulletTest
+//
+//  Measures btDbvt traversals (collideTT self, collideTV, rayTest) on a tree whose internal nodes were
+//  scattered by many teleport updates, before and after btDbvt::optimizeNodeLayout. Both layouts must
+//  report the same overlaps, and every leaf must still be reachable through its parent pointers.
+//
+
+#include "LinearMath/btScalar.h"
+#if defined(BT_USE_SSE_IN_API) || defined(BT_USE_NEON)
+
+#include "Test_dbvtLayout.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+
+#include <BulletCollision/BroadphaseCollision/btDbvt.h>
+
+#define NUM_LEAVES 65536
+#define NUM_TELEPORTS (NUM_LEAVES * 4)
+#define NUM_COLLIDE_TT 8
+#define NUM_COLLIDE_TV 65536
+#define NUM_RAYS 65536
+#define WORLD_SCALE 400.f
+
+struct CountPolicy : btDbvt::ICollide
+{
+	CountPolicy() : m_count(0) {}
+	void Process(const btDbvtNode*, const btDbvtNode*) { ++m_count; }
+	void Process(const btDbvtNode*) { ++m_count; }
+	int m_count;
+};
+
+static btDbvtVolume randVolume()
+{
+	btVector3 center(RANDF_m1p1 * WORLD_SCALE, RANDF_m1p1 * WORLD_SCALE, RANDF_m1p1 * WORLD_SCALE);
+	btVector3 extents(1 + RANDF_01 * 4, 1 + RANDF_01 * 4, 1 + RANDF_01 * 4);
+	return btDbvtVolume::FromCE(center, extents);
+}
+
+static bool checkParents(const btDbvtNode* node)
+{
+	if (node->isleaf())
+		return true;
+	for (int i = 0; i < 2; i++)
+	{
+		if (node->childs[i]->parent != node || !checkParents(node->childs[i]))
+			return false;
+	}
+	return true;
+}
+
+int Test_dbvtLayout(void)
+{
+	srand(380843);
+	btDbvt dbvt;
+	dbvt.m_relayoutPercent = 0;
+	btAlignedObjectArray<btDbvtNode*> leaves;
+	leaves.resize(NUM_LEAVES);
+	for (int i = 0; i < NUM_LEAVES; i++)
+	{
+		leaves[i] = dbvt.insert(randVolume(), 0);
+	}
+	dbvt.optimizeTopDown();
+	for (int i = 0; i < NUM_TELEPORTS; i++)
+	{
+		btDbvtVolume volume = randVolume();
+		dbvt.update(leaves[rand() % NUM_LEAVES], volume);
+	}
+
+	btAlignedObjectArray<btDbvtVolume> queries;
+	btAlignedObjectArray<btVector3> rayFrom;
+	btAlignedObjectArray<btVector3> rayTo;
+	queries.resize(NUM_COLLIDE_TV);
+	rayFrom.resize(NUM_RAYS);
+	rayTo.resize(NUM_RAYS);
+	for (int i = 0; i < NUM_COLLIDE_TV; i++)
+	{
+		queries[i] = randVolume();
+	}
+	for (int i = 0; i < NUM_RAYS; i++)
+	{
+		rayFrom[i].setValue(RANDF_m1p1 * WORLD_SCALE, RANDF_m1p1 * WORLD_SCALE, RANDF_m1p1 * WORLD_SCALE);
+		rayTo[i].setValue(RANDF_m1p1 * WORLD_SCALE, RANDF_m1p1 * WORLD_SCALE, RANDF_m1p1 * WORLD_SCALE);
+	}
+
+	int counts[2][3];
+	vlog("Timing (seconds), %d leaves:\n", NUM_LEAVES);
+	vlog("      layout\tcollideTT self\t collideTV\t   rayTest\n");
+	for (int layout = 0; layout < 2; layout++)
+	{
+		if (layout)
+		{
+			uint64_t startTime = ReadTicks();
+			dbvt.optimizeNodeLayout();
+			vlog("  optimizeNodeLayout: %.4f s\n", TicksToSeconds(ReadTicks() - startTime));
+			if (!checkParents(dbvt.m_root))
+			{
+				vlog("Error - dbvtLayout: broken parent pointers after optimizeNodeLayout\n");
+				return 1;
+			}
+		}
+		CountPolicy policies[3];
+		uint64_t startTime = ReadTicks();
+		for (int i = 0; i < NUM_COLLIDE_TT; i++)
+		{
+			dbvt.collideTT(dbvt.m_root, dbvt.m_root, policies[0]);
+		}
+		uint64_t collideTTTime = ReadTicks() - startTime;
+		startTime = ReadTicks();
+		for (int i = 0; i < NUM_COLLIDE_TV; i++)
+		{
+			dbvt.collideTV(dbvt.m_root, queries[i], policies[1]);
+		}
+		uint64_t collideTVTime = ReadTicks() - startTime;
+		startTime = ReadTicks();
+		for (int i = 0; i < NUM_RAYS; i++)
+		{
+			btDbvt::rayTest(dbvt.m_root, rayFrom[i], rayTo[i], policies[2]);
+		}
+		uint64_t rayTime = ReadTicks() - startTime;
+		vlog("  %10s\t%14.4f\t%10.4f\t%10.4f\n", layout ? "depth-first" : "fragmented", TicksToSeconds(collideTTTime), TicksToSeconds(collideTVTime), TicksToSeconds(rayTime));
+		for (int j = 0; j < 3; j++)
+		{
+			counts[layout][j] = policies[j].m_count;
+		}
+	}
+	for (int j = 0; j < 3; j++)
+	{
+		if (counts[0][j] != counts[1][j])
+		{
+			vlog("Error - dbvtLayout: query %d reports %d overlaps after the layout instead of %d\n", j, counts[1][j], counts[0][j]);
+			return 1;
+		}
+	}
+	return 0;
+}
+#endif  //BT_USE_SSE_IN_API
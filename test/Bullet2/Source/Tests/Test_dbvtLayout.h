@@ -0,0 +1,20 @@
+//
+//  Test_dbvtLayout.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_dbvtLayout_h
+#define BulletTest_Test_dbvtLayout_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_dbvtLayout(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
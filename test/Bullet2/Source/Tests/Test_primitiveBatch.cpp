@@ -0,0 +1,143 @@
+//
+//  Test_primitiveBatch.cpp
+//  BulletTest
+//
+//  Measures btCollisionDispatcher::dispatchAllCollisionPairs on a packed grid of spheres and capsules
+//  (a few tens of thousands of touching pairs) with and without CD_BATCH_PRIMITIVE_PAIRS. Both modes
+//  must leave the same contacts in the manifolds.
+//
+
+#include "LinearMath/btScalar.h"
+#if defined(BT_USE_SSE_IN_API) || defined(BT_USE_NEON)
+
+#include "Test_primitiveBatch.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+#include <BulletCollision/CollisionShapes/btCapsuleShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
+
+#define GRID_SIZE 24
+#define GRID_SPACING 0.95f
+#define NUM_DISPATCHES 32
+
+struct PrimitiveScene
+{
+	btDefaultCollisionConfiguration m_configuration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btCollisionWorld m_world;
+	btSphereShape m_sphere;
+	btCapsuleShape m_capsule;
+	btCapsuleShapeX m_capsuleX;
+	btAlignedObjectArray<btCollisionObject*> m_objects;
+
+	PrimitiveScene()
+		: m_dispatcher(&m_configuration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_configuration),
+		  m_sphere(0.5f),
+		  m_capsule(0.3f, 0.4f),
+		  m_capsuleX(0.25f, 0.5f)
+	{
+		srand(9121);
+		btCollisionShape* shapes[3] = {&m_sphere, &m_capsule, &m_capsuleX};
+		for (int x = 0; x < GRID_SIZE; x++)
+		{
+			for (int y = 0; y < GRID_SIZE; y++)
+			{
+				for (int z = 0; z < GRID_SIZE; z++)
+				{
+					btCollisionObject* obj = new btCollisionObject();
+					btTransform trans;
+					trans.setRotation(btQuaternion(RANDF_m1p1 * SIMD_PI, RANDF_m1p1 * SIMD_PI, RANDF_m1p1 * SIMD_PI));
+					trans.setOrigin(btVector3(x, y, z) * GRID_SPACING + btVector3(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1) * 0.05f);
+					obj->setWorldTransform(trans);
+					obj->setCollisionShape(shapes[rand() % 3]);
+					m_world.addCollisionObject(obj);
+					m_objects.push_back(obj);
+				}
+			}
+		}
+	}
+
+	~PrimitiveScene()
+	{
+		for (int i = 0; i < m_objects.size(); i++)
+		{
+			m_world.removeCollisionObject(m_objects[i]);
+			delete m_objects[i];
+		}
+	}
+};
+
+int Test_primitiveBatch(void)
+{
+	double seconds[2];
+	btAlignedObjectArray<int> numContacts[2];
+	btAlignedObjectArray<btScalar> distances[2];
+	int numPairs = 0;
+
+	vlog("Timing (seconds) for %d dispatches:\n", NUM_DISPATCHES);
+	for (int batched = 0; batched < 2; batched++)
+	{
+		PrimitiveScene* scene = new PrimitiveScene();
+		btCollisionDispatcher& dispatcher = scene->m_dispatcher;
+		//the first pass creates the algorithms and their manifolds
+		scene->m_world.performDiscreteCollisionDetection();
+		if (batched)
+		{
+			dispatcher.setDispatcherFlags(dispatcher.getDispatcherFlags() | btCollisionDispatcher::CD_BATCH_PRIMITIVE_PAIRS);
+		}
+		numPairs = scene->m_broadphase.getOverlappingPairCache()->getNumOverlappingPairs();
+
+		uint64_t startTime = ReadTicks();
+		for (int i = 0; i < NUM_DISPATCHES; i++)
+		{
+			dispatcher.dispatchAllCollisionPairs(scene->m_broadphase.getOverlappingPairCache(), scene->m_world.getDispatchInfo(), &dispatcher);
+		}
+		seconds[batched] = TicksToSeconds(ReadTicks() - startTime);
+
+		for (int i = 0; i < dispatcher.getNumManifolds(); i++)
+		{
+			const btPersistentManifold* manifold = dispatcher.getManifoldByIndexInternal(i);
+			numContacts[batched].push_back(manifold->getNumContacts());
+			for (int j = 0; j < manifold->getNumContacts(); j++)
+			{
+				distances[batched].push_back(manifold->getContactPoint(j).getDistance());
+			}
+		}
+		delete scene;
+	}
+	vlog("  %d overlapping pairs, %d manifolds\n", numPairs, numContacts[0].size());
+	vlog("  per pair algorithms\t%10.4f\n", seconds[0]);
+	vlog("           batched\t%10.4f\n", seconds[1]);
+
+	if (numContacts[0].size() != numContacts[1].size() || distances[0].size() != distances[1].size())
+	{
+		vlog("Error - primitiveBatch: %d manifolds with %d contacts instead of %d with %d\n", numContacts[1].size(), distances[1].size(), numContacts[0].size(), distances[0].size());
+		return 1;
+	}
+	for (int i = 0; i < numContacts[0].size(); i++)
+	{
+		if (numContacts[0][i] != numContacts[1][i])
+		{
+			vlog("Error - primitiveBatch: manifold %d has %d contacts instead of %d\n", i, numContacts[1][i], numContacts[0][i]);
+			return 1;
+		}
+	}
+	for (int i = 0; i < distances[0].size(); i++)
+	{
+		if (btFabs(distances[0][i] - distances[1][i]) > 1e-5f)
+		{
+			vlog("Error - primitiveBatch: contact %d has distance %f instead of %f\n", i, distances[1][i], distances[0][i]);
+			return 1;
+		}
+	}
+	return 0;
+}
+#endif  //BT_USE_SSE_IN_API
@@ -0,0 +1,20 @@
+//
+//  Test_primitiveBatch.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_primitiveBatch_h
+#define BulletTest_Test_primitiveBatch_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_primitiveBatch(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+//
+//  Test_satHull.cpp
+//  BulletTest
+//
+//  Measures btPolyhedralContactClipping::findSeparatingAxis on stacks of convex hulls (about the size
+//  of VHACD parts) that rock and bob a little every frame, with the full edge-edge search, with
+//  Gauss map pruning, and with pruning plus a btPolyhedralSatCache per pair. All three must agree
+//  on which pairs overlap and on the penetration depth along the returned axis.
+//
+
+#include "LinearMath/btScalar.h"
+#if defined(BT_USE_SSE_IN_API) || defined(BT_USE_NEON)
+
+#include "Test_satHull.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <BulletCollision/CollisionShapes/btConvexPolyhedron.h>
+#include <BulletCollision/NarrowPhaseCollision/btPolyhedralContactClipping.h>
+
+extern bool gUseGaussMapPruning;
+
+#define NUM_SHAPES 16
+#define NUM_HULL_POINTS 24
+#define NUM_STACKS 64
+#define STACK_HEIGHT 8
+#define NUM_FRAMES 64
+#define LEVEL_SPACING 0.9f
+
+struct NullResult : btDiscreteCollisionDetectorInterface::Result
+{
+	void setShapeIdentifiersA(int, int) {}
+	void setShapeIdentifiersB(int, int) {}
+	void addContactPoint(const btVector3&, const btVector3&, btScalar) {}
+};
+
+static btScalar overlapDepth(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, const btVector3& axis)
+{
+	btScalar minA, maxA, minB, maxB;
+	btVector3 w0, w1;
+	hullA.project(transA, axis, minA, maxA, w0, w1);
+	hullB.project(transB, axis, minB, maxB, w0, w1);
+	return btMin(maxA - minB, maxB - minA);
+}
+
+static btTransform bodyTransform(int stack, int level, int frame)
+{
+	btScalar phase = btScalar(stack * 7 + level * 3);
+	btScalar t = btScalar(frame) * 0.05f;
+	btQuaternion rotation(btVector3(0, 1, 0), phase + t);
+	rotation *= btQuaternion(btVector3(1, 0, 0), 0.2f * btSin(phase + 2 * t));
+	btVector3 origin(btScalar(stack % 8) * 4, level * LEVEL_SPACING + 0.1f * btSin(phase + 3 * t), btScalar(stack / 8) * 4);
+	return btTransform(rotation, origin);
+}
+
+int Test_satHull(void)
+{
+	srand(77141);
+	btAlignedObjectArray<btConvexHullShape*> shapes;
+	int numFaces = 0;
+	int numEdges = 0;
+	for (int i = 0; i < NUM_SHAPES; i++)
+	{
+		btConvexHullShape* shape = new btConvexHullShape();
+		for (int j = 0; j < NUM_HULL_POINTS; j++)
+		{
+			btVector3 p;
+			do
+			{
+				p.setValue(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1);
+			} while (p.length2() > 1 || p.length2() < 1e-6);
+			p.normalize();
+			shape->addPoint(p * btVector3(0.6f, 0.5f, 0.6f), false);
+		}
+		shape->recalcLocalAabb();
+		shape->initializePolyhedralFeatures();
+		numFaces += shape->getConvexPolyhedron()->m_faces.size();
+		numEdges += shape->getConvexPolyhedron()->m_uniqueEdges.size();
+		shapes.push_back(shape);
+	}
+
+	const int numPairs = NUM_STACKS * (STACK_HEIGHT - 1);
+	btAlignedObjectArray<btPolyhedralSatCache> caches;
+	caches.resize(numPairs);
+	btAlignedObjectArray<int> overlaps[3];
+	btAlignedObjectArray<btScalar> depths[3];
+	static const char* modeNames[] = {"full", "pruned", "pruned+cache"};
+	NullResult result;
+
+	vlog("%d pairs x %d frames, %.1f faces and %.1f unique edges per hull\n", numPairs, NUM_FRAMES, btScalar(numFaces) / NUM_SHAPES, btScalar(numEdges) / NUM_SHAPES);
+	vlog("Timing (seconds):\n");
+	for (int mode = 0; mode < 3; mode++)
+	{
+		gUseGaussMapPruning = mode > 0;
+		overlaps[mode].resize(numPairs * NUM_FRAMES);
+		depths[mode].resize(numPairs * NUM_FRAMES);
+		uint64_t startTime = ReadTicks();
+		for (int frame = 0; frame < NUM_FRAMES; frame++)
+		{
+			for (int stack = 0; stack < NUM_STACKS; stack++)
+			{
+				for (int level = 0; level < STACK_HEIGHT - 1; level++)
+				{
+					int pair = stack * (STACK_HEIGHT - 1) + level;
+					const btConvexPolyhedron& hullA = *shapes[(stack + level) % NUM_SHAPES]->getConvexPolyhedron();
+					const btConvexPolyhedron& hullB = *shapes[(stack + level + 1) % NUM_SHAPES]->getConvexPolyhedron();
+					btTransform transA = bodyTransform(stack, level, frame);
+					btTransform transB = bodyTransform(stack, level + 1, frame);
+					btVector3 sep(0, 1, 0);
+					bool overlap = btPolyhedralContactClipping::findSeparatingAxis(hullA, hullB, transA, transB, sep, result, mode == 2 ? &caches[pair] : 0);
+					overlaps[mode][frame * numPairs + pair] = overlap;
+					depths[mode][frame * numPairs + pair] = overlap ? overlapDepth(hullA, hullB, transA, transB, sep) : 0;
+				}
+			}
+		}
+		vlog("  %12s\t%10.4f\n", modeNames[mode], TicksToSeconds(ReadTicks() - startTime));
+	}
+	gUseGaussMapPruning = true;
+
+	int numOverlaps = 0;
+	for (int i = 0; i < numPairs * NUM_FRAMES; i++)
+	{
+		numOverlaps += overlaps[0][i];
+		for (int mode = 1; mode < 3; mode++)
+		{
+			if (overlaps[mode][i] != overlaps[0][i] || btFabs(depths[mode][i] - depths[0][i]) > 1e-4f)
+			{
+				vlog("Error - satHull: %s reports overlap %d depth %f for pair %d instead of %d depth %f\n", modeNames[mode], overlaps[mode][i], depths[mode][i], i, overlaps[0][i], depths[0][i]);
+				return 1;
+			}
+		}
+	}
+	vlog("  %d of %d pair tests overlap\n", numOverlaps, numPairs * NUM_FRAMES);
+
+	for (int i = 0; i < shapes.size(); i++)
+	{
+		delete shapes[i];
+	}
+	return 0;
+}
+#endif  //BT_USE_SSE_IN_API
@@ -0,0 +1,20 @@
+//
+//  Test_satHull.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_satHull_h
+#define BulletTest_Test_satHull_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_satHull(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,100 @@
+//
+//  Test_sdfBake.cpp
+//  BulletTest
+//
+//  Bakes a signed distance field of a tessellated sphere at increasing grid resolutions,
+//  checks it against the analytic distance and reports the build time per resolution.
+//
+
+#include "LinearMath/btScalar.h"
+#if defined(BT_USE_SSE_IN_API) || defined(BT_USE_NEON)
+
+#include "Test_sdfBake.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+#include <BulletCollision/CollisionShapes/btSdfBaker.h>
+#include <BulletCollision/CollisionShapes/btMiniSDF.h>
+
+#define SPHERE_RADIUS 1.0
+#define NUM_QUERIES 10000
+
+static btVector3 spherePoint(int i, int j, int numSlices, int numStacks)
+{
+	if (j == 0)
+		return btVector3(0, 0, -SPHERE_RADIUS);
+	if (j == numStacks)
+		return btVector3(0, 0, SPHERE_RADIUS);
+	btScalar theta = SIMD_PI * j / numStacks - SIMD_HALF_PI;
+	btScalar phi = SIMD_2_PI * i / numSlices;
+	return SPHERE_RADIUS * btVector3(btCos(theta) * btCos(phi), btCos(theta) * btSin(phi), btSin(theta));
+}
+
+int Test_sdfBake(void)
+{
+	const int numSlices = 64;
+	const int numStacks = 32;
+	btTriangleMesh mesh;
+	for (int i = 0; i < numSlices; i++)
+	{
+		for (int j = 0; j < numStacks; j++)
+		{
+			btVector3 a = spherePoint(i, j, numSlices, numStacks);
+			btVector3 b = spherePoint(i + 1, j, numSlices, numStacks);
+			btVector3 c = spherePoint(i + 1, j + 1, numSlices, numStacks);
+			btVector3 d = spherePoint(i, j + 1, numSlices, numStacks);
+			if (j > 0)
+				mesh.addTriangle(a, b, c);
+			if (j < numStacks - 1)
+				mesh.addTriangle(a, c, d);
+		}
+	}
+
+	vlog("Timing:\n");
+	vlog("  resolution\t  seconds\t max error\n");
+	for (int res = 8; res <= 32; res *= 2)
+	{
+		btSdfBakeSettings settings;
+		settings.m_resolution[0] = settings.m_resolution[1] = settings.m_resolution[2] = res;
+
+		btAlignedObjectArray<char> sdfData;
+		uint64_t startTime = ReadTicks();
+		bool baked = btSdfBaker::bake(&mesh, settings, sdfData);
+		uint64_t bakeTime = ReadTicks() - startTime;
+
+		btMiniSDF sdf;
+		if (!baked || !sdf.load(&sdfData[0], sdfData.size()))
+		{
+			vlog("Error - sdfBake failed to bake or load resolution %d\n", res);
+			return 1;
+		}
+
+		double maxError = 0;
+		for (int i = 0; i < NUM_QUERIES; i++)
+		{
+			btVector3 p(RANDF_m1p1, RANDF_m1p1, RANDF_m1p1);
+			p *= 1.1 * SPHERE_RADIUS;
+			double dist;
+			if (!sdf.interpolate(0, dist, p, 0))
+			{
+				vlog("Error - sdfBake query outside of the baked domain\n");
+				return 1;
+			}
+			double expected = p.length() - SPHERE_RADIUS;
+			maxError = btMax(maxError, fabs(dist - expected));
+		}
+		vlog("  %10d\t%9.4f\t%10.6f\n", res, TicksToSeconds(bakeTime), maxError);
+
+		//tessellation and interpolation error are both well below one cell
+		if (maxError > (2.2 * SPHERE_RADIUS) / res)
+		{
+			vlog("Error - sdfBake distance error %f too large at resolution %d\n", maxError, res);
+			return 1;
+		}
+	}
+	return 0;
+}
+#endif  //BT_USE_SSE_IN_API
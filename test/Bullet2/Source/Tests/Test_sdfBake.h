@@ -0,0 +1,20 @@
+//
+//  Test_sdfBake.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_sdfBake_h
+#define BulletTest_Test_sdfBake_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_sdfBake(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
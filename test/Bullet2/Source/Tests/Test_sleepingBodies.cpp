@@ -0,0 +1,120 @@
+//
+//  Test_sleepingBodies.cpp
+//  BulletTest
+//
+//  Steps a world of about a million spheres of which only one in twenty is awake, and the same awake spheres on their
+//  own. The per-step loops only visit the active collision objects, so both worlds should take about the same time per
+//  step, apart from the broadphase and island management. The awake spheres must end up at the same place in both
+//  worlds and the sleeping ones must not move.
+//
+
+#include "LinearMath/btScalar.h"
+#if defined(BT_USE_SSE_IN_API) || defined(BT_USE_NEON)
+
+#include "Test_sleepingBodies.h"
+#include "Utils.h"
+#include "main.h"
+#include <math.h>
+#include <stdlib.h>
+
+#include <btBulletDynamicsCommon.h>
+
+#define GRID_SIZE_X 128
+#define GRID_SIZE_Y 64
+#define GRID_SIZE_Z 128
+#define AWAKE_STRIDE 20
+#define NUM_STEPS 32
+
+static btVector3 gridPosition(int index)
+{
+	const int x = index % GRID_SIZE_X;
+	const int y = (index / GRID_SIZE_X) % GRID_SIZE_Y;
+	const int z = index / (GRID_SIZE_X * GRID_SIZE_Y);
+	return btVector3(btScalar(x), btScalar(y), btScalar(z)) * btScalar(3.);
+}
+
+//adds one sphere per grid cell, or only the awake ones, returns the time per step
+static double simulate(bool awakeOnly, btSphereShape* sphere, btAlignedObjectArray<btVector3>& positions)
+{
+	const int numBodies = GRID_SIZE_X * GRID_SIZE_Y * GRID_SIZE_Z;
+	btDefaultCollisionConfiguration configuration;
+	btCollisionDispatcher dispatcher(&configuration);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &configuration);
+	world.setForceUpdateAllAabbs(false);
+	world.setGravity(btVector3(0, 0, 0));
+
+	btVector3 inertia;
+	sphere->calculateLocalInertia(1, inertia);
+	btAlignedObjectArray<btRigidBody*> bodies;
+	for (int i = 0; i < numBodies; i++)
+	{
+		const bool awake = (i % AWAKE_STRIDE) == 0;
+		if (awakeOnly && !awake)
+			continue;
+		btRigidBody* body = new btRigidBody(1, 0, sphere, inertia);
+		body->getWorldTransform().setOrigin(gridPosition(i));
+		if (awake)
+		{
+			body->setActivationState(DISABLE_DEACTIVATION);
+			body->setLinearVelocity(btVector3(btSin(btScalar(i)), btCos(btScalar(i)), btScalar(0.5)));
+			body->setAngularVelocity(btVector3(0, 1, 0));
+		}
+		else
+		{
+			body->forceActivationState(ISLAND_SLEEPING);
+		}
+		world.addRigidBody(body);
+		bodies.push_back(body);
+	}
+
+	uint64_t ticks = 0;
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		uint64_t startTime = ReadTicks();
+		world.stepSimulation(btScalar(1. / 60.), 0);
+		ticks += ReadTicks() - startTime;
+	}
+
+	for (int i = 0; i < bodies.size(); i++)
+	{
+		positions.push_back(bodies[i]->getWorldTransform().getOrigin());
+		world.removeRigidBody(bodies[i]);
+		delete bodies[i];
+	}
+	return TicksToSeconds(ticks) / NUM_STEPS;
+}
+
+int Test_sleepingBodies(void)
+{
+	btSphereShape sphere(0.5f);
+	const int numBodies = GRID_SIZE_X * GRID_SIZE_Y * GRID_SIZE_Z;
+	btAlignedObjectArray<btVector3> positions[2];
+	double seconds[2];
+	vlog("Timing (seconds per step) for %d steps, one awake body in %d:\n", NUM_STEPS, AWAKE_STRIDE);
+	for (int awakeOnly = 0; awakeOnly < 2; awakeOnly++)
+	{
+		seconds[awakeOnly] = simulate(awakeOnly != 0, &sphere, positions[awakeOnly]);
+	}
+
+	int awakeIndex = 0;
+	for (int i = 0; i < numBodies; i++)
+	{
+		const bool awake = (i % AWAKE_STRIDE) == 0;
+		if (!awake && positions[0][i] != gridPosition(i))
+		{
+			vlog("Error - sleepingBodies: sleeping body %d moved\n", i);
+			return 1;
+		}
+		if (awake && positions[0][i] != positions[1][awakeIndex++])
+		{
+			vlog("Error - sleepingBodies: awake body %d differs from the awake only world\n", i);
+			return 1;
+		}
+	}
+	vlog("  %d bodies\t%10.6f\n", numBodies, seconds[0]);
+	vlog("  %d awake bodies\t%10.6f\n", positions[1].size(), seconds[1]);
+	return 0;
+}
+#endif  //BT_USE_SSE_IN_API
@@ -0,0 +1,20 @@
+//
+//  Test_sleepingBodies.h
+//  BulletTest
+//
+
+#ifndef BulletTest_Test_sleepingBodies_h
+#define BulletTest_Test_sleepingBodies_h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	int Test_sleepingBodies(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,228 @@
+
+#include <btBulletDynamicsCommon.h>
+#include <gtest/gtest.h>
+
+static const btScalar TIME_STEP = btScalar(1. / 60.);
+static const int MAX_STEPS_TO_SLEEP = 600;
+
+extern int gNumClampedCcdMotions;
+
+//a row of spheres floating without gravity, so they come to rest and fall asleep on their own
+struct SleepingScene
+{
+	btDefaultCollisionConfiguration m_configuration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btSequentialImpulseConstraintSolver m_solver;
+	btDiscreteDynamicsWorld m_world;
+	btSphereShape m_sphereShape;
+	btAlignedObjectArray<btRigidBody*> m_bodies;
+
+	SleepingScene()
+		: m_dispatcher(&m_configuration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_solver, &m_configuration),
+		  m_sphereShape(btScalar(0.5))
+	{
+		m_world.setGravity(btVector3(0, 0, 0));
+		for (int i = 0; i < 4; i++)
+		{
+			btVector3 localInertia;
+			m_sphereShape.calculateLocalInertia(1, localInertia);
+			btRigidBody::btRigidBodyConstructionInfo rbci(1, 0, &m_sphereShape, localInertia);
+			rbci.m_startWorldTransform.setOrigin(btVector3(btScalar(2 * i), 0, 0));
+			btRigidBody* body = new btRigidBody(rbci);
+			m_world.addRigidBody(body);
+			m_bodies.push_back(body);
+		}
+	}
+
+	~SleepingScene()
+	{
+		for (int i = 0; i < m_bodies.size(); i++)
+		{
+			m_world.removeRigidBody(m_bodies[i]);
+			delete m_bodies[i];
+		}
+	}
+
+	bool allSleeping() const
+	{
+		for (int i = 0; i < m_bodies.size(); i++)
+		{
+			if (m_bodies[i]->getActivationState() != ISLAND_SLEEPING)
+				return false;
+		}
+		return true;
+	}
+
+	//steps until every body sleeps, plus a few steps so the world drops them from its awake list
+	bool stepUntilSleeping()
+	{
+		for (int step = 0; step < MAX_STEPS_TO_SLEEP; step++)
+		{
+			m_world.stepSimulation(TIME_STEP, 0);
+			if (allSleeping())
+			{
+				for (int i = 0; i < 3; i++)
+				{
+					m_world.stepSimulation(TIME_STEP, 0);
+				}
+				return allSleeping();
+			}
+		}
+		return false;
+	}
+};
+
+TEST(BulletDynamicsTest, SleepingBodyVelocityIsCleared)
+{
+	SleepingScene scene;
+	ASSERT_TRUE(scene.stepUntilSleeping());
+
+	//setting a velocity without activate() leaves the body asleep, and the next step clears the velocity
+	btRigidBody* body = scene.m_bodies[1];
+	const btVector3 origin = body->getWorldTransform().getOrigin();
+	body->setLinearVelocity(btVector3(1, 0, 0));
+	body->setAngularVelocity(btVector3(0, 1, 0));
+	scene.m_world.stepSimulation(TIME_STEP, 0);
+
+	EXPECT_EQ(ISLAND_SLEEPING, body->getActivationState());
+	EXPECT_EQ(btScalar(0), body->getLinearVelocity().length());
+	EXPECT_EQ(btScalar(0), body->getAngularVelocity().length());
+	EXPECT_EQ(btScalar(0), (body->getWorldTransform().getOrigin() - origin).length());
+}
+
+TEST(BulletDynamicsTest, DisableDeactivationWakesSleepingBodies)
+{
+	SleepingScene scene;
+	ASSERT_TRUE(scene.stepUntilSleeping());
+
+	gDisableDeactivation = true;
+	scene.m_world.stepSimulation(TIME_STEP, 0);
+	gDisableDeactivation = false;
+
+	for (int i = 0; i < scene.m_bodies.size(); i++)
+	{
+		EXPECT_EQ(ACTIVE_TAG, scene.m_bodies[i]->getActivationState()) << "body " << i;
+	}
+}
+
+TEST(BulletDynamicsTest, ZeroDeactivationTimeWakesSleepingBodies)
+{
+	SleepingScene scene;
+	ASSERT_TRUE(scene.stepUntilSleeping());
+
+	const btScalar deactivationTime = gDeactivationTime;
+	gDeactivationTime = btScalar(0.);
+	scene.m_world.stepSimulation(TIME_STEP, 0);
+	gDeactivationTime = deactivationTime;
+
+	for (int i = 0; i < scene.m_bodies.size(); i++)
+	{
+		EXPECT_EQ(ACTIVE_TAG, scene.m_bodies[i]->getActivationState()) << "body " << i;
+	}
+}
+
+//boxes and spheres thrown onto a ground box with damping, additional damping and CCD, stepped with or without state arrays
+struct ThrownBodiesScene
+{
+	btDefaultCollisionConfiguration m_configuration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btSequentialImpulseConstraintSolver m_solver;
+	btDiscreteDynamicsWorld m_world;
+	btBoxShape m_groundShape;
+	btBoxShape m_boxShape;
+	btSphereShape m_sphereShape;
+	btAlignedObjectArray<btRigidBody*> m_bodies;
+
+	ThrownBodiesScene(bool useStateArrays)
+		: m_dispatcher(&m_configuration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_solver, &m_configuration),
+		  m_groundShape(btVector3(50, 1, 50)),
+		  m_boxShape(btVector3(btScalar(0.5), btScalar(0.25), btScalar(0.75))),
+		  m_sphereShape(btScalar(0.4))
+	{
+		m_world.setUseRigidBodyStateArrays(useStateArrays);
+		btRigidBody::btRigidBodyConstructionInfo groundInfo(0, 0, &m_groundShape);
+		groundInfo.m_startWorldTransform.setOrigin(btVector3(0, -1, 0));
+		addBody(groundInfo);
+
+		srand(1234);
+		for (int i = 0; i < 64; i++)
+		{
+			btCollisionShape* shape = (i & 1) ? (btCollisionShape*)&m_sphereShape : (btCollisionShape*)&m_boxShape;
+			btVector3 localInertia;
+			shape->calculateLocalInertia(1, localInertia);
+			btRigidBody::btRigidBodyConstructionInfo info(1, 0, shape, localInertia);
+			info.m_startWorldTransform.setOrigin(btVector3(btScalar(i % 8) * 2, btScalar(2 + i / 8), btScalar(0)));
+			info.m_startWorldTransform.setRotation(btQuaternion(btScalar(i), btScalar(0.3) * i, btScalar(0.1)));
+			info.m_linearDamping = btScalar(0.05) * (i % 4);
+			info.m_angularDamping = btScalar(0.1) * (i % 3);
+			info.m_additionalDamping = (i % 5) == 0;
+			btRigidBody* body = addBody(info);
+			body->setLinearVelocity(btVector3(randomScalar(), randomScalar(), randomScalar()) * 4);
+			body->setAngularVelocity(btVector3(randomScalar(), randomScalar(), randomScalar()) * 10);
+			if ((i % 7) == 0)
+			{
+				body->setCcdMotionThreshold(btScalar(0.01));
+				body->setCcdSweptSphereRadius(btScalar(0.2));
+				body->setLinearVelocity(btVector3(0, -60, 0));
+			}
+		}
+	}
+
+	~ThrownBodiesScene()
+	{
+		for (int i = 0; i < m_bodies.size(); i++)
+		{
+			m_world.removeRigidBody(m_bodies[i]);
+			delete m_bodies[i];
+		}
+	}
+
+	static btScalar randomScalar()
+	{
+		return btScalar(rand()) / btScalar(RAND_MAX) - btScalar(0.5);
+	}
+
+	btRigidBody* addBody(const btRigidBody::btRigidBodyConstructionInfo& info)
+	{
+		btRigidBody* body = new btRigidBody(info);
+		m_world.addRigidBody(body);
+		m_bodies.push_back(body);
+		return body;
+	}
+};
+
+TEST(BulletDynamicsTest, RigidBodyStateArraysMatchPerBodyPath)
+{
+	ThrownBodiesScene perBody(false);
+	ThrownBodiesScene stateArrays(true);
+	btAlignedObjectArray<unsigned int> perBodyHashes;
+	btAlignedObjectArray<unsigned int> stateArraysHashes;
+	for (int step = 0; step < 240; step++)
+	{
+		perBody.m_world.stepSimulation(TIME_STEP, 0);
+		stateArrays.m_world.stepSimulation(TIME_STEP, 0);
+		unsigned int perBodyHash = perBody.m_world.computeStateHash(perBodyHashes);
+		unsigned int stateArraysHash = stateArrays.m_world.computeStateHash(stateArraysHashes);
+		ASSERT_EQ(-1, btDiscreteDynamicsWorld::findFirstStateDivergence(perBodyHashes, stateArraysHashes)) << "step " << step;
+		ASSERT_EQ(perBodyHash, stateArraysHash) << "step " << step;
+	}
+	for (int i = 0; i < perBody.m_bodies.size(); i++)
+	{
+		const btRigidBody* a = perBody.m_bodies[i];
+		const btRigidBody* b = stateArrays.m_bodies[i];
+		EXPECT_TRUE(a->getInterpolationWorldTransform().getOrigin() == b->getInterpolationWorldTransform().getOrigin()) << "body " << i;
+		EXPECT_TRUE(a->getInterpolationWorldTransform().getBasis() == b->getInterpolationWorldTransform().getBasis()) << "body " << i;
+	}
+	//the scene exercises CCD motion clamping
+	EXPECT_GT(gNumClampedCcdMotions, 0);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
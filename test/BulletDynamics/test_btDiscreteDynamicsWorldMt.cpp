@@ -0,0 +1,150 @@
+
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <LinearMath/btThreads.h>
+#include <gtest/gtest.h>
+
+static const int NUM_STEPS = 240;
+static const int MAX_NUM_THREADS = 8;
+
+//a stack of boxes and a pile of spheres and capsules on a ground plane, with a kinematic paddle sweeping through
+//and a chain of hinged boxes, hashes the world state after every step
+static unsigned int simulate(int numThreads, btAlignedObjectArray<unsigned int>& stateHashes)
+{
+	btGetTaskScheduler()->setNumThreads(numThreads);
+
+	btDefaultCollisionConstructionInfo cci;
+	cci.m_defaultMaxPersistentManifoldPoolSize = 8192;
+	btDefaultCollisionConfiguration configuration(cci);
+	btCollisionDispatcherMt dispatcher(&configuration, 8);
+	btDbvtBroadphase broadphase;
+	btConstraintSolverPoolMt solverPool(MAX_NUM_THREADS);
+	btSequentialImpulseConstraintSolverMt solverMt;
+	btDiscreteDynamicsWorldMt world(&dispatcher, &broadphase, &solverPool, &solverMt, &configuration);
+	world.getDispatchInfo().m_deterministicOverlappingPairs = true;
+	world.getSolverInfo().m_solverMode |= SOLVER_RANDMIZE_ORDER;
+	world.getSolverInfo().m_leastSquaresResidualThreshold = btScalar(1e-6);
+
+	btStaticPlaneShape groundShape(btVector3(0, 1, 0), 0);
+	btBoxShape boxShape(btVector3(btScalar(0.5), btScalar(0.5), btScalar(0.5)));
+	btSphereShape sphereShape(btScalar(0.4));
+	btCapsuleShape capsuleShape(btScalar(0.3), btScalar(0.6));
+	btBoxShape paddleShape(btVector3(btScalar(0.2), 2, 6));
+
+	btAlignedObjectArray<btRigidBody*> bodies;
+	bodies.push_back(new btRigidBody(0, 0, &groundShape));
+	world.addRigidBody(bodies[0]);
+
+	btDefaultMotionState paddleState(btTransform(btQuaternion::getIdentity(), btVector3(-6, 2, 0)));
+	btRigidBody* paddle = new btRigidBody(0, &paddleState, &paddleShape);
+	paddle->setCollisionFlags(paddle->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+	paddle->setActivationState(DISABLE_DEACTIVATION);
+	bodies.push_back(paddle);
+	world.addRigidBody(paddle);
+
+	btVector3 inertia;
+	for (int y = 0; y < 8; y++)
+	{
+		for (int x = 0; x < 8 - y; x++)
+		{
+			for (int z = 0; z < 2; z++)
+			{
+				boxShape.calculateLocalInertia(1, inertia);
+				btRigidBody* body = new btRigidBody(1, 0, &boxShape, inertia);
+				body->getWorldTransform().setOrigin(btVector3(x + btScalar(0.5) * y - 4, btScalar(0.5) + y, btScalar(1.1) * z - 2));
+				bodies.push_back(body);
+				world.addRigidBody(body);
+			}
+		}
+	}
+	for (int i = 0; i < 96; i++)
+	{
+		btCollisionShape* shape = (i & 1) ? (btCollisionShape*)&sphereShape : (btCollisionShape*)&capsuleShape;
+		shape->calculateLocalInertia(1, inertia);
+		btRigidBody* body = new btRigidBody(1, 0, shape, inertia);
+		body->getWorldTransform().setOrigin(btVector3(btScalar(i % 6) - 3, btScalar(2 + i / 12), btScalar((i / 6) % 2) + btScalar(2.5) + btScalar(0.1) * (i % 3)));
+		bodies.push_back(body);
+		world.addRigidBody(body);
+	}
+	btAlignedObjectArray<btTypedConstraint*> constraints;
+	btRigidBody* previous = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		boxShape.calculateLocalInertia(1, inertia);
+		btRigidBody* body = new btRigidBody(1, 0, &boxShape, inertia);
+		body->getWorldTransform().setOrigin(btVector3(btScalar(1.2) * i - 4, 6, -6));
+		bodies.push_back(body);
+		world.addRigidBody(body);
+		if (previous)
+		{
+			btHingeConstraint* hinge = new btHingeConstraint(*previous, *body, btVector3(btScalar(0.6), 0, 0), btVector3(btScalar(-0.6), 0, 0), btVector3(0, 0, 1), btVector3(0, 0, 1));
+			constraints.push_back(hinge);
+			world.addConstraint(hinge, true);
+		}
+		previous = body;
+	}
+
+	unsigned int hash = 2166136261u;
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		paddleState.setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(-6 + btScalar(0.05) * step, 2, 0)));
+		world.stepSimulation(btScalar(1.) / btScalar(60.), 1, btScalar(1.) / btScalar(60.));
+		const unsigned int stateHash = world.computeStateHash(stateHashes);
+		hash = btDiscreteDynamicsWorld::hashState(hash, &stateHash, sizeof(stateHash));
+	}
+
+	for (int i = 0; i < constraints.size(); i++)
+	{
+		world.removeConstraint(constraints[i]);
+		delete constraints[i];
+	}
+	for (int i = 0; i < bodies.size(); i++)
+	{
+		world.removeRigidBody(bodies[i]);
+		delete bodies[i];
+	}
+	return hash;
+}
+
+GTEST_TEST(BulletDynamics, DiscreteDynamicsWorldMtDeterminism)
+{
+	btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+	if (!scheduler)
+	{
+		//without BT_THREADSAFE the threads can only be compared to themselves
+		scheduler = btGetSequentialTaskScheduler();
+	}
+	btSetTaskScheduler(scheduler);
+	const int maxNumThreads = btMin(scheduler->getMaxNumThreads(), MAX_NUM_THREADS);
+	const int batchingThreshold = btSequentialImpulseConstraintSolverMt::s_minimumContactManifoldsForBatching;
+	//let the pile go through the batched parallel solver
+	btSequentialImpulseConstraintSolverMt::s_minimumContactManifoldsForBatching = 50;
+
+	btAlignedObjectArray<unsigned int> stateHashes;
+	const unsigned int hash = simulate(1, stateHashes);
+	for (int numThreads = 1; numThreads <= maxNumThreads; numThreads++)
+	{
+		for (int run = 0; run < 2; run++)
+		{
+			btAlignedObjectArray<unsigned int> threadedStateHashes;
+			EXPECT_EQ(hash, simulate(numThreads, threadedStateHashes))
+				<< "with " << numThreads << " threads, first diverging body " << btDiscreteDynamicsWorld::findFirstStateDivergence(stateHashes, threadedStateHashes);
+		}
+	}
+
+	btSequentialImpulseConstraintSolverMt::s_minimumContactManifoldsForBatching = batchingThreshold;
+	btSetTaskScheduler(btGetSequentialTaskScheduler());
+	if (scheduler != btGetSequentialTaskScheduler())
+	{
+		delete scheduler;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,201 @@
+
+#include <btBulletDynamicsCommon.h>
+#include <BulletDynamics/Featherstone/btMultiBody.h>
+#include <BulletDynamics/Featherstone/btMultiBodyConstraintSolver.h>
+#include <BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h>
+#include <BulletDynamics/Featherstone/btMultiBodyJointLimitConstraint.h>
+#include <BulletDynamics/Featherstone/btMultiBodyLinkCollider.h>
+#include <gtest/gtest.h>
+
+static const int NUM_STEPS = 480;
+static const int NUM_BRANCH_LINKS = 4;
+static const btScalar LINK_HALF_LENGTH = btScalar(0.25);
+static const btScalar STATE_TOLERANCE = btScalar(1e-5);
+
+//exposes the number of dof indices the solver iterates over, summed over all rows
+class btMultiBodyConstraintSolverProbe : public btMultiBodyConstraintSolver
+{
+public:
+	int getNumSparseDofIndices() const
+	{
+		return m_data.m_sparseDofIndices.size();
+	}
+};
+
+//a fixed base tree with two hinged branches that swing down onto the ground against joint limits,
+//and a floating base body with one link that falls next to it
+struct MultiBodyScene
+{
+	btDefaultCollisionConfiguration m_configuration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btMultiBodyConstraintSolverProbe m_solver;
+	btMultiBodyDynamicsWorld m_world;
+	btBoxShape m_groundShape;
+	btBoxShape m_linkShape;
+	btRigidBody* m_ground;
+	btAlignedObjectArray<btMultiBody*> m_multiBodies;
+	btAlignedObjectArray<btMultiBodyConstraint*> m_limits;
+	btAlignedObjectArray<btMultiBodyLinkCollider*> m_colliders;
+	int m_maxNumSparseDofIndices;
+	int m_maxNumManifolds;
+
+	MultiBodyScene(bool useSparse)
+		: m_dispatcher(&m_configuration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_solver, &m_configuration),
+		  m_groundShape(btVector3(10, btScalar(0.5), 10)),
+		  m_linkShape(btVector3(LINK_HALF_LENGTH, btScalar(0.05), btScalar(0.05))),
+		  m_maxNumSparseDofIndices(0),
+		  m_maxNumManifolds(0)
+	{
+		m_solver.setUseSparseJacobianRows(useSparse);
+		m_world.setGravity(btVector3(0, -10, 0));
+
+		m_ground = new btRigidBody(0, 0, &m_groundShape);
+		m_ground->setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(0, btScalar(-0.5), 0)));
+		m_world.addRigidBody(m_ground);
+
+		//fixed base, link i of each branch hangs off link i-1, branches point along +x and -x
+		btMultiBody* tree = new btMultiBody(2 * NUM_BRANCH_LINKS, 1, btVector3(1, 1, 1), true, false);
+		tree->setBasePos(btVector3(0, btScalar(1.2), 0));
+		for (int branch = 0; branch < 2; branch++)
+		{
+			btScalar dir = branch ? btScalar(-1) : btScalar(1);
+			for (int i = 0; i < NUM_BRANCH_LINKS; i++)
+			{
+				int link = branch * NUM_BRANCH_LINKS + i;
+				int parent = i ? link - 1 : -1;
+				btVector3 parentComToPivot = i ? btVector3(dir * LINK_HALF_LENGTH, 0, 0) : btVector3(0, 0, 0);
+				tree->setupRevolute(link, 1, btVector3(btScalar(0.01), btScalar(0.02), btScalar(0.02)), parent, btQuaternion::getIdentity(), btVector3(0, 0, 1),
+									parentComToPivot, btVector3(dir * LINK_HALF_LENGTH, 0, 0), true);
+			}
+		}
+		addMultiBody(tree);
+		for (int link = 0; link < tree->getNumLinks(); link++)
+		{
+			btMultiBodyConstraint* limit = new btMultiBodyJointLimitConstraint(tree, link, btScalar(-0.6), btScalar(0.6));
+			m_world.addMultiBodyConstraint(limit);
+			m_limits.push_back(limit);
+		}
+
+		btMultiBody* floating = new btMultiBody(1, 1, btVector3(btScalar(0.01), btScalar(0.02), btScalar(0.02)), false, false);
+		floating->setBasePos(btVector3(0, btScalar(0.5), 2));
+		floating->setWorldToBaseRot(btQuaternion(btVector3(1, 0, 0), btScalar(0.3)));
+		floating->setupRevolute(0, 1, btVector3(btScalar(0.01), btScalar(0.02), btScalar(0.02)), -1, btQuaternion::getIdentity(), btVector3(0, 1, 0),
+								btVector3(LINK_HALF_LENGTH, 0, 0), btVector3(LINK_HALF_LENGTH, 0, 0), true);
+		addMultiBody(floating);
+		floating->setJointVel(0, 2);
+		addCollider(floating, -1);
+	}
+
+	void addMultiBody(btMultiBody* multiBody)
+	{
+		multiBody->finalizeMultiDof();
+		m_world.addMultiBody(multiBody);
+		for (int link = 0; link < multiBody->getNumLinks(); link++)
+		{
+			addCollider(multiBody, link);
+		}
+		m_multiBodies.push_back(multiBody);
+	}
+
+	void addCollider(btMultiBody* multiBody, int link)
+	{
+		btMultiBodyLinkCollider* collider = new btMultiBodyLinkCollider(multiBody, link);
+		collider->setCollisionShape(&m_linkShape);
+		if (link < 0)
+		{
+			multiBody->setBaseCollider(collider);
+		}
+		else
+		{
+			multiBody->getLink(link).m_collider = collider;
+		}
+		m_world.addCollisionObject(collider, btBroadphaseProxy::DefaultFilter, btBroadphaseProxy::AllFilter);
+		m_colliders.push_back(collider);
+
+		btAlignedObjectArray<btQuaternion> worldToLocal;
+		btAlignedObjectArray<btVector3> localOrigin;
+		multiBody->forwardKinematics(worldToLocal, localOrigin);
+		multiBody->updateCollisionObjectWorldTransforms(worldToLocal, localOrigin);
+	}
+
+	~MultiBodyScene()
+	{
+		for (int i = 0; i < m_limits.size(); i++)
+		{
+			m_world.removeMultiBodyConstraint(m_limits[i]);
+			delete m_limits[i];
+		}
+		for (int i = 0; i < m_colliders.size(); i++)
+		{
+			m_world.removeCollisionObject(m_colliders[i]);
+			delete m_colliders[i];
+		}
+		for (int i = 0; i < m_multiBodies.size(); i++)
+		{
+			m_world.removeMultiBody(m_multiBodies[i]);
+			delete m_multiBodies[i];
+		}
+		m_world.removeRigidBody(m_ground);
+		delete m_ground;
+	}
+
+	void step()
+	{
+		m_world.stepSimulation(btScalar(1. / 240.), 0);
+		m_maxNumSparseDofIndices = btMax(m_maxNumSparseDofIndices, m_solver.getNumSparseDofIndices());
+		m_maxNumManifolds = btMax(m_maxNumManifolds, m_dispatcher.getNumManifolds());
+	}
+
+	void getState(btAlignedObjectArray<btScalar>& state) const
+	{
+		state.resize(0);
+		for (int i = 0; i < m_multiBodies.size(); i++)
+		{
+			const btMultiBody* mb = m_multiBodies[i];
+			for (int k = 0; k < 3; k++)
+			{
+				state.push_back(mb->getBasePos()[k]);
+				state.push_back(mb->getBaseVel()[k]);
+				state.push_back(mb->getBaseOmega()[k]);
+			}
+			for (int link = 0; link < mb->getNumLinks(); link++)
+			{
+				state.push_back(mb->getJointPos(link));
+				state.push_back(mb->getJointVel(link));
+			}
+		}
+	}
+};
+
+GTEST_TEST(btMultiBodyConstraintSolver, SparseRowsMatchDense)
+{
+	MultiBodyScene sparse(true);
+	MultiBodyScene dense(false);
+	btAlignedObjectArray<btScalar> sparseState;
+	btAlignedObjectArray<btScalar> denseState;
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		sparse.step();
+		dense.step();
+		sparse.getState(sparseState);
+		dense.getState(denseState);
+		ASSERT_EQ(denseState.size(), sparseState.size());
+		for (int i = 0; i < sparseState.size(); i++)
+		{
+			ASSERT_NEAR(denseState[i], sparseState[i], STATE_TOLERANCE) << "step " << step << " value " << i;
+		}
+	}
+
+	//the scene must have exercised contacts and limits, and the sparse rows must be shorter than the dense ones
+	EXPECT_GT(sparse.m_maxNumManifolds, 0);
+	EXPECT_GT(sparse.m_maxNumSparseDofIndices, 0);
+	EXPECT_LT(sparse.m_maxNumSparseDofIndices, dense.m_maxNumSparseDofIndices);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -37,6 +37,23 @@
 #define printf
 #endif
 
+/* renders a 64x48 TinyRenderer image and copies its colors, depths and segmentation mask */
+static void renderTinyRendererImage(b3PhysicsClientHandle sm, float viewMatrix[16], float projectionMatrix[16], int flags, unsigned char* rgba, float* depths, int* segmentationMask)
+{
+	struct b3CameraImageData imageData;
+	b3SharedMemoryCommandHandle command = b3InitRequestCameraImage(sm);
+	b3RequestCameraImageSetPixelResolution(command, 64, 48);
+	b3RequestCameraImageSetCameraMatrices(command, viewMatrix, projectionMatrix);
+	b3RequestCameraImageSelectRenderer(command, ER_TINY_RENDERER);
+	b3RequestCameraImageSetFlags(command, flags);
+	ASSERT_EQ(b3GetStatusType(b3SubmitClientCommandAndWaitStatus(sm, command)), CMD_CAMERA_IMAGE_COMPLETED);
+	b3GetCameraImageData(sm, &imageData);
+	ASSERT_EQ(imageData.m_pixelWidth * imageData.m_pixelHeight, 64 * 48);
+	memcpy(rgba, imageData.m_rgbColorData, 64 * 48 * 4);
+	memcpy(depths, imageData.m_depthValues, 64 * 48 * sizeof(float));
+	memcpy(segmentationMask, imageData.m_segmentationMaskValues, 64 * 48 * sizeof(int));
+}
+
 void testSharedMemory(b3PhysicsClientHandle sm)
 {
 	int i, dofCount, posVarCount, ret, numJoints;
@@ -213,6 +230,129 @@ void testSharedMemory(b3PhysicsClientHandle sm)
 			}
 		}
 
+		{
+			struct b3BatchedActualStateData stateData;
+			b3SharedMemoryCommandHandle command = b3RequestBatchedActualStateCommandInit(sm, &bodyIndex, 1, BATCHED_STATE_ALL_FIELDS);
+			b3SharedMemoryStatusHandle statusHandle = b3SubmitClientCommandAndWaitStatus(sm, command);
+			ASSERT_EQ(b3GetStatusType(statusHandle), CMD_BATCHED_ACTUAL_STATE_COMPLETED);
+			b3GetBatchedActualStateData(sm, &stateData);
+			ASSERT_EQ(stateData.m_numBodies, 1);
+			ASSERT_EQ(stateData.m_bodies[0].m_bodyUniqueId, bodyIndex);
+			ASSERT_EQ(stateData.m_bodies[0].m_numPositions, posVarCount);
+			ASSERT_EQ(stateData.m_bodies[0].m_numVelocities, dofCount);
+			ASSERT_EQ(stateData.m_bodies[0].m_numLinks, numJoints);
+			ASSERT_EQ(stateData.m_numValues, posVarCount + dofCount + 19 * numJoints);
+		}
+
+		{
+			struct b3StateSubscriptionData subscriptionData;
+			/* one record of all fields of r2d2 takes about 2.5 kB, so these overflow the 8 MB stream chunk */
+			int numOverflowSubSteps = 4096;
+			b3SharedMemoryCommandHandle command = b3StateSubscriptionCommandInit(sm);
+			b3SharedMemoryStatusHandle statusHandle;
+			b3StateSubscriptionSetBodies(sm, command, &bodyIndex, 1, BATCHED_STATE_JOINT_POSITIONS);
+			statusHandle = b3SubmitClientCommandAndWaitStatus(sm, command);
+			ASSERT_EQ(b3GetStatusType(statusHandle), CMD_STATE_SUBSCRIPTION_COMPLETED);
+
+			//the first step after subscribing sends the state of the body along with the step status
+			statusHandle = b3SubmitClientCommandAndWaitStatus(sm, b3InitStepSimulationCommand(sm));
+			ASSERT_EQ(b3GetStatusType(statusHandle), CMD_STEP_FORWARD_SIMULATION_COMPLETED);
+			b3GetStateSubscriptionData(sm, &subscriptionData);
+			ASSERT_EQ(subscriptionData.m_numRecords, 1);
+			ASSERT_EQ(subscriptionData.m_records[0].m_numBodies, 1);
+			ASSERT_EQ(subscriptionData.m_bodies[0].m_bodyUniqueId, bodyIndex);
+			ASSERT_EQ(subscriptionData.m_bodies[0].m_positionOffset, 0);
+
+			/* more internal steps than fit in the stream: the oldest records are dropped, the latest step still arrives */
+			command = b3StateSubscriptionCommandInit(sm);
+			b3StateSubscriptionSetBodies(sm, command, &bodyIndex, 1, BATCHED_STATE_ALL_FIELDS);
+			statusHandle = b3SubmitClientCommandAndWaitStatus(sm, command);
+			ASSERT_EQ(b3GetStatusType(statusHandle), CMD_STATE_SUBSCRIPTION_COMPLETED);
+			command = b3InitPhysicsParamCommand(sm);
+			b3PhysicsParamSetNumSubSteps(command, numOverflowSubSteps);
+			statusHandle = b3SubmitClientCommandAndWaitStatus(sm, command);
+			ASSERT_EQ(b3GetStatusType(statusHandle), CMD_CLIENT_COMMAND_COMPLETED);
+			statusHandle = b3SubmitClientCommandAndWaitStatus(sm, b3InitStepSimulationCommand(sm));
+			ASSERT_EQ(b3GetStatusType(statusHandle), CMD_STEP_FORWARD_SIMULATION_COMPLETED);
+			b3GetStateSubscriptionData(sm, &subscriptionData);
+			ASSERT_EQ(subscriptionData.m_numDroppedRecords > 0, 1);
+			ASSERT_EQ(subscriptionData.m_numRecords > 0, 1);
+			ASSERT_EQ(subscriptionData.m_records[0].m_firstBody, 0);
+			ASSERT_EQ(subscriptionData.m_bodies[0].m_positionOffset, 0);
+			ASSERT_EQ(subscriptionData.m_records[subscriptionData.m_numRecords - 1].m_simulationStep, numOverflowSubSteps - 1);
+			command = b3InitPhysicsParamCommand(sm);
+			b3PhysicsParamSetNumSubSteps(command, 0);
+			statusHandle = b3SubmitClientCommandAndWaitStatus(sm, command);
+			ASSERT_EQ(b3GetStatusType(statusHandle), CMD_CLIENT_COMMAND_COMPLETED);
+
+			command = b3StateSubscriptionCommandInit(sm);
+			b3StateSubscriptionSetBodies(sm, command, 0, 0, 0);
+			statusHandle = b3SubmitClientCommandAndWaitStatus(sm, command);
+			ASSERT_EQ(b3GetStatusType(statusHandle), CMD_STATE_SUBSCRIPTION_COMPLETED);
+		}
+
+		{
+			/* the saved file has to be complete when the status arrives, and failures have to be reported */
+			char header[7] = {0};
+			FILE* f;
+			b3SharedMemoryStatusHandle statusHandle = b3SubmitClientCommandAndWaitStatus(sm, b3SaveBulletCommandInit(sm, "test_save.bullet"));
+			ASSERT_EQ(b3GetStatusType(statusHandle), CMD_BULLET_SAVING_COMPLETED);
+			f = fopen("test_save.bullet", "rb");
+			ASSERT_EQ(f != 0, 1);
+			if (f)
+			{
+				ASSERT_EQ(fread(header, 1, 6, f), 6);
+				ASSERT_EQ(strcmp(header, "BULLET"), 0);
+				fclose(f);
+				remove("test_save.bullet");
+			}
+			statusHandle = b3SubmitClientCommandAndWaitStatus(sm, b3SaveBulletCommandInit(sm, "nonexistent_directory/test_save.bullet"));
+			ASSERT_EQ(b3GetStatusType(statusHandle), CMD_BULLET_SAVING_FAILED);
+		}
+
+		{
+			/* a background save lets the simulation step, and the file only appears under its name once complete */
+			char header[7] = {0};
+			FILE* f;
+			int statusType;
+			int numPolls = 0;
+			b3SharedMemoryCommandHandle command = b3SaveBulletCommandInit(sm, "test_save_background.bullet");
+			b3SharedMemoryStatusHandle statusHandle;
+			b3SaveBulletCommandSetInBackground(command);
+			statusHandle = b3SubmitClientCommandAndWaitStatus(sm, command);
+			statusType = b3GetStatusType(statusHandle);
+			while (statusType == CMD_BULLET_SAVING_PENDING && numPolls < 100000)
+			{
+				statusHandle = b3SubmitClientCommandAndWaitStatus(sm, b3InitStepSimulationCommand(sm));
+				ASSERT_EQ(b3GetStatusType(statusHandle), CMD_STEP_FORWARD_SIMULATION_COMPLETED);
+				statusHandle = b3SubmitClientCommandAndWaitStatus(sm, b3InitRequestSaveBulletStatusCommand(sm));
+				statusType = b3GetStatusType(statusHandle);
+				numPolls++;
+			}
+			ASSERT_EQ(statusType, CMD_BULLET_SAVING_COMPLETED);
+			ASSERT_EQ(fopen("test_save_background.bullet.tmp", "rb") == 0, 1);
+			f = fopen("test_save_background.bullet", "rb");
+			ASSERT_EQ(f != 0, 1);
+			if (f)
+			{
+				ASSERT_EQ(fread(header, 1, 6, f), 6);
+				ASSERT_EQ(strcmp(header, "BULLET"), 0);
+				fclose(f);
+				remove("test_save_background.bullet");
+			}
+
+			command = b3SaveBulletCommandInit(sm, "nonexistent_directory/test_save_background.bullet");
+			b3SaveBulletCommandSetInBackground(command);
+			statusHandle = b3SubmitClientCommandAndWaitStatus(sm, command);
+			statusType = b3GetStatusType(statusHandle);
+			while (statusType == CMD_BULLET_SAVING_PENDING)
+			{
+				statusHandle = b3SubmitClientCommandAndWaitStatus(sm, b3InitRequestSaveBulletStatusCommand(sm));
+				statusType = b3GetStatusType(statusHandle);
+			}
+			ASSERT_EQ(statusType, CMD_BULLET_SAVING_FAILED);
+		}
+
 		{
 #if 0
             b3SharedMemoryStatusHandle statusHandle;
@@ -256,6 +396,164 @@ void testSharedMemory(b3PhysicsClientHandle sm)
 			statusHandle = b3SubmitClientCommandAndWaitStatus(sm, command);
 		}
 
+		{
+			/* the depth and segmentation only path has to match the depth and segmentation of the fully shaded image */
+			static float depths[3][64 * 48];
+			static int segmentationMasks[3][64 * 48];
+			float viewMatrix[16];
+			float projectionMatrix[16];
+			float cameraPosition[3] = {10, -1.2, 0.6};
+			float cameraTargetPosition[3] = {10, 0, 0.3};
+			float cameraUp[3] = {0, 0, 1};
+			int mode;
+			int numSegmentedPixels = 0;
+			int numDifferences = 0;
+			int numReducedDifferences = 0;
+
+			{
+				b3SharedMemoryCommandHandle command = b3LoadUrdfCommandInit(sm, urdfFileName);
+				b3LoadUrdfCommandSetStartPosition(command, 10, 0, 0.5);
+				b3LoadUrdfCommandSetUseFixedBase(command, 1);
+				ASSERT_EQ(b3GetStatusType(b3SubmitClientCommandAndWaitStatus(sm, command)), CMD_URDF_LOADING_COMPLETED);
+			}
+			b3ComputeViewMatrixFromPositions(cameraPosition, cameraTargetPosition, cameraUp, viewMatrix);
+			b3ComputeProjectionMatrixFOV(60, 64.f / 48.f, 0.1f, 10.f, projectionMatrix);
+			for (mode = 0; mode < 3; mode++)
+			{
+				struct b3CameraImageData imageData;
+				b3SharedMemoryCommandHandle command = b3InitRequestCameraImage(sm);
+				b3RequestCameraImageSetPixelResolution(command, 64, 48);
+				b3RequestCameraImageSetCameraMatrices(command, viewMatrix, projectionMatrix);
+				b3RequestCameraImageSelectRenderer(command, ER_TINY_RENDERER);
+				if (mode > 0)
+				{
+					b3RequestCameraImageSetFlags(command, ER_DEPTH_AND_SEGMENTATION_ONLY | (mode == 2 ? ER_REDUCED_RESOLUTION : 0));
+				}
+				ASSERT_EQ(b3GetStatusType(b3SubmitClientCommandAndWaitStatus(sm, command)), CMD_CAMERA_IMAGE_COMPLETED);
+				b3GetCameraImageData(sm, &imageData);
+				ASSERT_EQ(imageData.m_pixelWidth * imageData.m_pixelHeight, 64 * 48);
+				for (i = 0; i < 64 * 48; i++)
+				{
+					depths[mode][i] = imageData.m_depthValues[i];
+					segmentationMasks[mode][i] = imageData.m_segmentationMaskValues[i];
+				}
+			}
+			for (i = 0; i < 64 * 48; i++)
+			{
+				float depthDifference = depths[1][i] - depths[0][i];
+				numSegmentedPixels += segmentationMasks[0][i] >= 0;
+				numDifferences += segmentationMasks[1][i] != segmentationMasks[0][i] || depthDifference > 1e-5f || depthDifference < -1e-5f;
+				numReducedDifferences += segmentationMasks[2][i] != segmentationMasks[0][i];
+			}
+			/* at full resolution the masks are identical, and the depths only differ by float rounding, because the
+			   depth only rasterizer interpolates incrementally: at most 1e-5 of the [0,1] depth range.
+			   The reduced resolution mask may differ along silhouettes, on fewer than a quarter of the segmented pixels */
+			ASSERT_EQ(numSegmentedPixels > 100, 1);
+			ASSERT_EQ(numDifferences, 0);
+			ASSERT_EQ(numReducedDifferences * 4 < numSegmentedPixels, 1);
+			b3Printf("depth and segmentation only: %d segmented pixels, %d differences, %d at reduced resolution\n", numSegmentedPixels, numDifferences, numReducedDifferences);
+		}
+
+		{
+			/* three r2d2 share their TinyRenderer models: recolouring one must leave the others unchanged. The third one
+			   stands behind the others, so parts of it are occluded. Removing a body and moving the camera must give the
+			   same image as rendering every object without culling, and the cached clip space vertices of the depth only
+			   path must follow the camera */
+			static unsigned char rgba[4][64 * 48 * 4];
+			static float depths[4][64 * 48];
+			static int masks[4][64 * 48];
+			float viewMatrix[16];
+			float otherViewMatrix[16];
+			float projectionMatrix[16];
+			float cameraPosition[3] = {20.75, -3, 1};
+			float otherCameraPosition[3] = {22, -2.5, 2};
+			float cameraTargetPosition[3] = {20.75, 0, 0.3};
+			float cameraUp[3] = {0, 0, 1};
+			double red[4] = {1, 0, 0, 1};
+			int r2d2[3];
+			int numPixels[2] = {0, 0};
+			int numRecoloured = 0;
+			int numDifferences = 0;
+
+			for (i = 0; i < 3; i++)
+			{
+				b3SharedMemoryStatusHandle statusHandle;
+				b3SharedMemoryCommandHandle command = b3LoadUrdfCommandInit(sm, urdfFileName);
+				b3LoadUrdfCommandSetStartPosition(command, i < 2 ? 20 + 1.5 * i : 21.5, i < 2 ? 0 : 1.5, 0.5);
+				b3LoadUrdfCommandSetUseFixedBase(command, 1);
+				statusHandle = b3SubmitClientCommandAndWaitStatus(sm, command);
+				ASSERT_EQ(b3GetStatusType(statusHandle), CMD_URDF_LOADING_COMPLETED);
+				r2d2[i] = b3GetStatusBodyIndex(statusHandle);
+			}
+			b3ComputeViewMatrixFromPositions(cameraPosition, cameraTargetPosition, cameraUp, viewMatrix);
+			b3ComputeViewMatrixFromPositions(otherCameraPosition, cameraTargetPosition, cameraUp, otherViewMatrix);
+			b3ComputeProjectionMatrixFOV(60, 64.f / 48.f, 0.1f, 10.f, projectionMatrix);
+
+			renderTinyRendererImage(sm, viewMatrix, projectionMatrix, 0, rgba[0], depths[0], masks[0]);
+			for (i = -1; i < b3GetNumJoints(sm, r2d2[0]); i++)
+			{
+				b3SharedMemoryCommandHandle command = b3InitUpdateVisualShape2(sm, r2d2[0], i, -1);
+				b3UpdateVisualShapeRGBAColor(command, red);
+				ASSERT_EQ(b3GetStatusType(b3SubmitClientCommandAndWaitStatus(sm, command)), CMD_VISUAL_SHAPE_UPDATE_COMPLETED);
+			}
+			renderTinyRendererImage(sm, viewMatrix, projectionMatrix, 0, rgba[1], depths[1], masks[1]);
+			for (i = 0; i < 64 * 48; i++)
+			{
+				int differs = memcmp(&rgba[1][i * 4], &rgba[0][i * 4], 4) != 0;
+				ASSERT_EQ(masks[1][i], masks[0][i]);
+				if (masks[0][i] >= 0 && (masks[0][i] & ((1 << 24) - 1)) == r2d2[0])
+				{
+					numPixels[0]++;
+					numRecoloured += differs;
+				}
+				if (masks[0][i] >= 0 && (masks[0][i] & ((1 << 24) - 1)) != r2d2[0])
+				{
+					numPixels[1]++;
+					numDifferences += differs;
+				}
+			}
+			ASSERT_EQ(numPixels[0] > 50, 1);
+			ASSERT_EQ(numPixels[1] > 50, 1);
+			ASSERT_EQ(numRecoloured * 2 > numPixels[0], 1);
+			ASSERT_EQ(numDifferences, 0);
+
+			/* the removed r2d2 releases its models, the others keep rendering with the shared ones */
+			ASSERT_EQ(b3GetStatusType(b3SubmitClientCommandAndWaitStatus(sm, b3InitRemoveBodyCommand(sm, r2d2[0]))), CMD_REMOVE_BODY_COMPLETED);
+			renderTinyRendererImage(sm, viewMatrix, projectionMatrix, 0, rgba[2], depths[2], masks[2]);
+			renderTinyRendererImage(sm, viewMatrix, projectionMatrix, ER_NO_CULLING, rgba[3], depths[3], masks[3]);
+			ASSERT_EQ(memcmp(rgba[2], rgba[3], sizeof(rgba[2])), 0);
+			ASSERT_EQ(memcmp(depths[2], depths[3], sizeof(depths[2])), 0);
+			ASSERT_EQ(memcmp(masks[2], masks[3], sizeof(masks[2])), 0);
+			numPixels[0] = 0;
+			numPixels[1] = 0;
+			for (i = 0; i < 64 * 48; i++)
+			{
+				numPixels[0] += masks[2][i] >= 0 && (masks[2][i] & ((1 << 24) - 1)) == r2d2[0];
+				numPixels[1] += masks[2][i] >= 0 && (masks[2][i] & ((1 << 24) - 1)) != r2d2[0];
+			}
+			ASSERT_EQ(numPixels[0], 0);
+			ASSERT_EQ(numPixels[1] > 50, 1);
+
+			/* the first render caches the clip space vertices for the first camera, the moved camera must not use them.
+			   The shaded render does not use the cache, see above for its depth tolerance */
+			renderTinyRendererImage(sm, viewMatrix, projectionMatrix, ER_DEPTH_AND_SEGMENTATION_ONLY, rgba[0], depths[0], masks[0]);
+			renderTinyRendererImage(sm, otherViewMatrix, projectionMatrix, ER_DEPTH_AND_SEGMENTATION_ONLY, rgba[1], depths[1], masks[1]);
+			renderTinyRendererImage(sm, otherViewMatrix, projectionMatrix, ER_DEPTH_AND_SEGMENTATION_ONLY | ER_NO_CULLING, rgba[2], depths[2], masks[2]);
+			renderTinyRendererImage(sm, otherViewMatrix, projectionMatrix, 0, rgba[3], depths[3], masks[3]);
+			ASSERT_EQ(memcmp(depths[1], depths[2], sizeof(depths[1])), 0);
+			ASSERT_EQ(memcmp(masks[1], masks[2], sizeof(masks[1])), 0);
+			numDifferences = 0;
+			numPixels[1] = 0;
+			for (i = 0; i < 64 * 48; i++)
+			{
+				float depthDifference = depths[1][i] - depths[3][i];
+				numPixels[1] += masks[1][i] >= 0;
+				numDifferences += masks[1][i] != masks[3][i] || depthDifference > 1e-5f || depthDifference < -1e-5f;
+			}
+			ASSERT_EQ(numPixels[1] > 50, 1);
+			ASSERT_EQ(numDifferences, 0);
+		}
+
 		if (b3CanSubmitCommand(sm))
 		{
 			b3SharedMemoryStatusHandle state = b3SubmitClientCommandAndWaitStatus(sm, b3RequestActualStateCommandInit(sm, bodyIndex));
@@ -0,0 +1,182 @@
+
+#include "btBulletDynamicsCommon.h"
+#include "../Extras/Serialize/BulletWorldImporter/btBulletWorldImporter.h"
+#include "../Extras/Serialize/BulletFileLoader/btBulletFile.h"
+#include <gtest/gtest.h>
+#include <stdio.h>
+
+//collects the streamed chunks, the way a file sink would write them
+class MemorySerializerSink : public btSerializerSink
+{
+public:
+	btAlignedObjectArray<char> m_data;
+
+	virtual bool write(const void* data, int numBytes)
+	{
+		int oldSize = m_data.size();
+		m_data.resize(oldSize + numBytes);
+		memcpy(&m_data[oldSize], data, numBytes);
+		return true;
+	}
+};
+
+struct SerializerScene
+{
+	btDefaultCollisionConfiguration m_configuration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btSequentialImpulseConstraintSolver m_solver;
+	btDiscreteDynamicsWorld m_world;
+	btBoxShape m_boxShape;
+	btAlignedObjectArray<btRigidBody*> m_bodies;
+
+	SerializerScene()
+		: m_dispatcher(&m_configuration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_solver, &m_configuration),
+		  m_boxShape(btVector3(0.5, 0.25, 1))
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			btVector3 localInertia;
+			m_boxShape.calculateLocalInertia(1, localInertia);
+			btRigidBody::btRigidBodyConstructionInfo rbci(1, 0, &m_boxShape, localInertia);
+			rbci.m_startWorldTransform.setOrigin(btVector3(btScalar(3 * i), btScalar(i), 0));
+			rbci.m_startWorldTransform.setRotation(btQuaternion(btVector3(0, 1, 0), btScalar(0.1 * i)));
+			btRigidBody* body = new btRigidBody(rbci);
+			m_world.addRigidBody(body);
+			m_bodies.push_back(body);
+		}
+	}
+
+	~SerializerScene()
+	{
+		for (int i = 0; i < m_bodies.size(); i++)
+		{
+			m_world.removeRigidBody(m_bodies[i]);
+			delete m_bodies[i];
+		}
+	}
+};
+
+static void expectSameBodies(const SerializerScene& scene, const btBulletWorldImporter& importer)
+{
+	ASSERT_EQ(scene.m_bodies.size(), importer.getNumRigidBodies());
+	for (int i = 0; i < scene.m_bodies.size(); i++)
+	{
+		const btTransform& expected = scene.m_bodies[i]->getWorldTransform();
+		const btTransform& loaded = importer.getRigidBodyByIndex(i)->getWorldTransform();
+		EXPECT_NEAR(0, (expected.getOrigin() - loaded.getOrigin()).length(), SIMD_EPSILON) << "body " << i;
+		EXPECT_NEAR(0, (expected.getBasis().getRow(0) - loaded.getBasis().getRow(0)).length(), SIMD_EPSILON) << "body " << i;
+		EXPECT_NEAR(0, (expected.getBasis().getRow(1) - loaded.getBasis().getRow(1)).length(), SIMD_EPSILON) << "body " << i;
+		EXPECT_NEAR(0, (expected.getBasis().getRow(2) - loaded.getBasis().getRow(2)).length(), SIMD_EPSILON) << "body " << i;
+	}
+}
+
+TEST(SerializerTest, DetachedSnapshotRoundTrip)
+{
+	SerializerScene scene;
+	btSerializedSnapshot* snapshot = 0;
+	int contiguousSize = 0;
+	MemorySerializerSink contiguous;
+	{
+		btDefaultSerializer ser;
+		scene.m_world.serialize(&ser);
+		contiguousSize = ser.getCurrentBufferSize();
+		contiguous.write(ser.getBufferPointer(), contiguousSize);
+	}
+	{
+		btDefaultSerializer ser;
+		ser.setSerializationFlags(ser.getSerializationFlags() | BT_SERIALIZE_STREAMING);
+		scene.m_world.serialize(&ser);
+		snapshot = ser.detachSnapshot();
+		ASSERT_TRUE(snapshot != 0);
+	}
+
+	//the serializer is gone and the world moves on, the snapshot still holds the state at serialization time
+	for (int i = 0; i < scene.m_bodies.size(); i++)
+	{
+		scene.m_bodies[i]->setLinearVelocity(btVector3(0, 0, 1));
+	}
+	MemorySerializerSink sink;
+	EXPECT_TRUE(snapshot->writeToSink(sink));
+	EXPECT_EQ(snapshot->getSizeInBytes(), sink.m_data.size());
+	delete snapshot;
+
+	//streaming writes the same bytes as the contiguous buffer
+	ASSERT_EQ(contiguousSize, sink.m_data.size());
+	EXPECT_EQ(0, memcmp(&contiguous.m_data[0], &sink.m_data[0], contiguousSize));
+
+	btBulletWorldImporter importer(0);
+	ASSERT_TRUE(importer.loadFileFromMemory(&sink.m_data[0], sink.m_data.size()));
+	expectSameBodies(scene, importer);
+	for (int i = 0; i < importer.getNumRigidBodies(); i++)
+	{
+		EXPECT_EQ(btScalar(0), btRigidBody::upcast(importer.getRigidBodyByIndex(i))->getLinearVelocity().length());
+	}
+	importer.deleteAllData();
+}
+
+//exposes the file buffer, to check which structs are used in place
+class InspectableBulletFile : public bParse::btBulletFile
+{
+public:
+	InspectableBulletFile(const char* fileName)
+		: bParse::btBulletFile(fileName)
+	{
+	}
+
+	bool isInFileBuffer(const void* ptr) const
+	{
+		return ((const char*)ptr >= mFileBuffer) && ((const char*)ptr < mFileBuffer + mFileLen);
+	}
+};
+
+TEST(SerializerTest, ZeroCopyUsesStructsInPlace)
+{
+	SerializerScene scene;
+	const char* fileName = "test_btSerializer_zerocopy.bullet";
+	{
+		btDefaultSerializer ser;
+		scene.m_world.serialize(&ser);
+		FILE* f = fopen(fileName, "wb");
+		ASSERT_TRUE(f != 0);
+		btFileSerializerSink sink(f);
+		EXPECT_TRUE(ser.writeToSink(sink));
+		fclose(f);
+	}
+
+	InspectableBulletFile* bulletFile = new InspectableBulletFile(fileName);
+	ASSERT_TRUE(bulletFile->ok());
+	bulletFile->parse(0);
+	ASSERT_TRUE(bulletFile->ok());
+	EXPECT_TRUE((bulletFile->getFlags() & bParse::FD_ZERO_COPY) != 0);
+
+	//the padded chunks put every struct on an 8 byte boundary, so none of them is copied
+	ASSERT_EQ(scene.m_bodies.size(), bulletFile->m_rigidBodies.size());
+	for (int i = 0; i < bulletFile->m_rigidBodies.size(); i++)
+	{
+		EXPECT_TRUE(bulletFile->isInFileBuffer(bulletFile->m_rigidBodies[i])) << "body " << i;
+		EXPECT_EQ(0, int((size_t)bulletFile->m_rigidBodies[i] & 7)) << "body " << i;
+	}
+	ASSERT_GT(bulletFile->m_collisionShapes.size(), 0);
+	for (int i = 0; i < bulletFile->m_collisionShapes.size(); i++)
+	{
+		EXPECT_TRUE(bulletFile->isInFileBuffer(bulletFile->m_collisionShapes[i])) << "shape " << i;
+	}
+	ASSERT_EQ(1, bulletFile->m_dynamicsWorldInfo.size());
+	EXPECT_TRUE(bulletFile->isInFileBuffer(bulletFile->m_dynamicsWorldInfo[0]));
+
+	//the pointers inside the structs were fixed up in place
+	btBulletWorldImporter importer(0);
+	ASSERT_TRUE(importer.convertAllObjects(bulletFile));
+	expectSameBodies(scene, importer);
+	importer.deleteAllData();
+	delete bulletFile;
+	remove(fileName);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
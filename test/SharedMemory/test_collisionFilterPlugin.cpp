@@ -0,0 +1,110 @@
+
+#include "SharedMemory/SharedMemoryPublic.h"
+#include "SharedMemory/plugins/b3PluginContext.h"
+#include "SharedMemory/plugins/b3PluginCollisionInterface.h"
+#include "SharedMemory/plugins/b3CollisionFilterTable.h"
+#include "SharedMemory/plugins/collisionFilterPlugin/collisionFilterPlugin.h"
+#include <gtest/gtest.h>
+#include <string.h>
+
+class CollisionFilterPluginTest : public ::testing::Test
+{
+protected:
+	b3PluginContext m_context;
+	b3PluginCollisionInterface* m_filter;
+
+	virtual void SetUp()
+	{
+		memset(&m_context, 0, sizeof(m_context));
+		ASSERT_EQ(SHARED_MEMORY_MAGIC_NUMBER, initPlugin_collisionFilterPlugin(&m_context));
+		m_filter = getCollisionInterface_collisionFilterPlugin(&m_context);
+		ASSERT_TRUE(m_filter != 0);
+	}
+
+	virtual void TearDown()
+	{
+		exitPlugin_collisionFilterPlugin(&m_context);
+	}
+
+	//group A collides with mask B but not the other way around, so the result depends on the filter mode
+	int needsCollision(int objectUniqueIdA, int linkIndexA, int objectUniqueIdB, int linkIndexB, int filterMode)
+	{
+		return m_filter->needsBroadphaseCollision(objectUniqueIdA, linkIndexA, 1, 1, objectUniqueIdB, linkIndexB, 2, 3, filterMode);
+	}
+};
+
+TEST_F(CollisionFilterPluginTest, GroupMaskFallback)
+{
+	EXPECT_FALSE(needsCollision(0, -1, 1, -1, B3_FILTER_GROUPAMASKB_AND_GROUPBMASKA));
+	EXPECT_TRUE(needsCollision(0, -1, 1, -1, B3_FILTER_GROUPAMASKB_OR_GROUPBMASKA));
+	EXPECT_EQ(0, m_filter->getNumRules());
+	EXPECT_EQ(0, m_filter->getFilterTable()->getNumRules());
+}
+
+TEST_F(CollisionFilterPluginTest, SetAndRemovePairRules)
+{
+	m_filter->setBroadphaseCollisionFilter(1, 0, 2, -1, true);
+	m_filter->setBroadphaseCollisionFilter(3, 5, 4, 1, false);
+	EXPECT_EQ(2, m_filter->getNumRules());
+
+	//pair rules override the group masks, in either order of the pair
+	EXPECT_TRUE(needsCollision(1, 2, 0, -1, B3_FILTER_GROUPAMASKB_AND_GROUPBMASKA));
+	EXPECT_TRUE(needsCollision(0, -1, 1, 2, B3_FILTER_GROUPAMASKB_AND_GROUPBMASKA));
+	EXPECT_FALSE(needsCollision(5, 1, 3, 4, B3_FILTER_GROUPAMASKB_OR_GROUPBMASKA));
+	EXPECT_FALSE(needsCollision(3, 4, 5, 1, B3_FILTER_GROUPAMASKB_OR_GROUPBMASKA));
+	//other links of the same bodies still use the group masks
+	EXPECT_FALSE(needsCollision(1, 2, 0, 0, B3_FILTER_GROUPAMASKB_AND_GROUPBMASKA));
+	EXPECT_TRUE(needsCollision(5, 1, 3, 3, B3_FILTER_GROUPAMASKB_OR_GROUPBMASKA));
+
+	//overwriting a rule replaces it
+	m_filter->setBroadphaseCollisionFilter(3, 5, 4, 1, true);
+	EXPECT_EQ(2, m_filter->getNumRules());
+	EXPECT_TRUE(needsCollision(5, 1, 3, 4, B3_FILTER_GROUPAMASKB_AND_GROUPBMASKA));
+
+	m_filter->removeBroadphaseCollisionFilter(0, 1, -1, 2);
+	EXPECT_EQ(1, m_filter->getNumRules());
+	EXPECT_FALSE(needsCollision(1, 2, 0, -1, B3_FILTER_GROUPAMASKB_AND_GROUPBMASKA));
+	EXPECT_TRUE(needsCollision(1, 2, 0, -1, B3_FILTER_GROUPAMASKB_OR_GROUPBMASKA));
+
+	m_filter->resetAll();
+	EXPECT_EQ(0, m_filter->getNumRules());
+	EXPECT_FALSE(needsCollision(5, 1, 3, 4, B3_FILTER_GROUPAMASKB_AND_GROUPBMASKA));
+}
+
+TEST_F(CollisionFilterPluginTest, FilterTableCompilesLazily)
+{
+	const b3CollisionFilterTable* table = m_filter->getFilterTable();
+	ASSERT_TRUE(table != 0);
+	EXPECT_FALSE(table->isDirty());
+
+	for (int i = 0; i < 100; i++)
+	{
+		m_filter->setBroadphaseCollisionFilter(i, i + 1, -1, 0, (i & 1) != 0);
+	}
+	m_filter->removeBroadphaseCollisionFilter(10, 11, -1, 0);
+	//no rebuild until the table is requested
+	EXPECT_TRUE(table->isDirty());
+	EXPECT_EQ(0, table->getNumRules());
+
+	EXPECT_EQ(table, m_filter->getFilterTable());
+	EXPECT_FALSE(table->isDirty());
+	EXPECT_EQ(99, table->getNumRules());
+	for (int i = 0; i < 100; i++)
+	{
+		int expected = (i == 10) ? B3_FILTER_RULE_NONE : ((i & 1) ? B3_FILTER_RULE_ENABLE : B3_FILTER_RULE_DISABLE);
+		EXPECT_EQ(expected, table->lookup(i, -1, i + 1, 0)) << "pair " << i;
+		EXPECT_EQ(expected, table->lookup(i + 1, 0, i, -1)) << "pair " << i;
+		EXPECT_EQ(B3_FILTER_RULE_NONE, table->lookup(i, 0, i + 1, -1)) << "pair " << i;
+	}
+
+	m_filter->resetAll();
+	EXPECT_TRUE(table->isDirty());
+	EXPECT_EQ(0, m_filter->getFilterTable()->getNumRules());
+	EXPECT_EQ(B3_FILTER_RULE_NONE, table->lookup(1, -1, 2, 0));
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,169 @@
+
+#include <btBulletCollisionCommon.h>
+#include <gtest/gtest.h>
+
+static const btScalar DEPTH_TOLERANCE = btScalar(1e-3);
+static const btScalar NORMAL_TOLERANCE = btScalar(1e-3);
+
+struct ContactCollector : public btCollisionWorld::ContactResultCallback
+{
+	btAlignedObjectArray<btScalar> m_depths;
+	btAlignedObjectArray<btVector3> m_normalsOnB;
+
+	virtual btScalar addSingleResult(btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1)
+	{
+		m_depths.push_back(cp.getDistance());
+		m_normalsOnB.push_back(cp.m_normalWorldOnB);
+		return 0;
+	}
+
+	btScalar getMinDepth() const
+	{
+		btScalar minDepth = BT_LARGE_FLOAT;
+		for (int i = 0; i < m_depths.size(); i++)
+		{
+			minDepth = btMin(minDepth, m_depths[i]);
+		}
+		return minDepth;
+	}
+};
+
+class CapsuleCollisionTest : public ::testing::Test
+{
+protected:
+	btDefaultCollisionConfiguration m_configuration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btCollisionWorld m_world;
+
+	CapsuleCollisionTest()
+		: m_dispatcher(&m_configuration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_configuration)
+	{
+	}
+
+	//contacts of shapeA at transA against shapeB at transB, normals point from B towards A
+	void collide(btCollisionShape* shapeA, const btTransform& transA, btCollisionShape* shapeB, const btTransform& transB, ContactCollector& result)
+	{
+		btCollisionObject objA;
+		objA.setCollisionShape(shapeA);
+		objA.setWorldTransform(transA);
+		btCollisionObject objB;
+		objB.setCollisionShape(shapeB);
+		objB.setWorldTransform(transB);
+		m_world.contactPairTest(&objA, &objB, result);
+	}
+
+	//checks every contact against the analytic depth and normal
+	void expectContacts(const ContactCollector& result, int minNumContacts, btScalar depth, const btVector3& normalOnB)
+	{
+		ASSERT_GE(result.m_depths.size(), minNumContacts);
+		for (int i = 0; i < result.m_depths.size(); i++)
+		{
+			EXPECT_NEAR(depth, result.m_depths[i], DEPTH_TOLERANCE) << "contact " << i;
+			EXPECT_NEAR(1, result.m_normalsOnB[i].dot(normalOnB), NORMAL_TOLERANCE) << "contact " << i;
+		}
+	}
+};
+
+static btTransform translation(btScalar x, btScalar y, btScalar z)
+{
+	return btTransform(btQuaternion::getIdentity(), btVector3(x, y, z));
+}
+
+TEST_F(CapsuleCollisionTest, CapsuleCapsuleCrossing)
+{
+	btCapsuleShape capsuleY(btScalar(0.5), 2);
+	btCapsuleShapeZ capsuleZ(btScalar(0.5), 2);
+	//segments cross at distance 0.8, the radii sum to 1
+	ContactCollector result;
+	collide(&capsuleY, translation(0, 0, 0), &capsuleZ, translation(btScalar(0.8), btScalar(0.3), btScalar(-0.4)), result);
+	expectContacts(result, 1, btScalar(-0.2), btVector3(-1, 0, 0));
+}
+
+TEST_F(CapsuleCollisionTest, CapsuleCapsuleParallel)
+{
+	btCapsuleShape capsuleA(btScalar(0.5), 2);
+	btCapsuleShape capsuleB(btScalar(0.5), 2);
+	//side by side with a partial overlap along the axis, one contact at each end of the overlap
+	ContactCollector result;
+	collide(&capsuleA, translation(0, 0, 0), &capsuleB, translation(0, btScalar(0.5), btScalar(0.9)), result);
+	expectContacts(result, 2, btScalar(-0.1), btVector3(0, 0, -1));
+}
+
+TEST_F(CapsuleCollisionTest, CapsuleCapsuleSeparated)
+{
+	btCapsuleShape capsuleA(btScalar(0.5), 2);
+	btCapsuleShape capsuleB(btScalar(0.5), 2);
+	ContactCollector result;
+	collide(&capsuleA, translation(0, 0, 0), &capsuleB, translation(btScalar(1.1), 0, 0), result);
+	EXPECT_EQ(0, result.m_depths.size());
+}
+
+TEST_F(CapsuleCollisionTest, CapsuleLyingOnBox)
+{
+	btCapsuleShapeX capsule(btScalar(0.25), 1);
+	btBoxShape box(btVector3(2, btScalar(0.5), 2));
+	ContactCollector result;
+	collide(&capsule, translation(btScalar(0.3), btScalar(0.7), btScalar(-0.2)), &box, translation(0, 0, 0), result);
+	expectContacts(result, 2, btScalar(-0.05), btVector3(0, 1, 0));
+}
+
+TEST_F(CapsuleCollisionTest, CapsuleOnBoxEdge)
+{
+	btCapsuleShape capsule(btScalar(0.25), 1);
+	btBoxShape box(btVector3(1, 1, 1));
+	//the lower sphere center is at (1.2, 1.1, 0), next to the edge x = y = 1
+	btVector3 offset(btScalar(0.2), btScalar(0.1), 0);
+	ContactCollector result;
+	collide(&capsule, translation(btScalar(1.2), btScalar(1.6), 0), &box, translation(0, 0, 0), result);
+	expectContacts(result, 1, offset.length() - btScalar(0.25), offset.normalized());
+}
+
+TEST_F(CapsuleCollisionTest, CapsuleBoxRotated)
+{
+	btCapsuleShape capsule(btScalar(0.25), 1);
+	btBoxShape box(btVector3(1, 1, 1));
+	btTransform boxTrans(btQuaternion(btVector3(0, 1, 0), btScalar(0.6)), btVector3(1, -2, 3));
+	//the capsule stands on the top face of the rotated box, tilted by its rotation
+	btTransform capsuleTrans = boxTrans * translation(btScalar(0.2), btScalar(1.7), btScalar(-0.3));
+	ContactCollector result;
+	collide(&capsule, capsuleTrans, &box, boxTrans, result);
+	expectContacts(result, 1, btScalar(-0.05), btVector3(0, 1, 0));
+}
+
+TEST_F(CapsuleCollisionTest, CapsuleOnTriangle)
+{
+	btTriangleMesh mesh;
+	mesh.addTriangle(btVector3(-5, 0, -5), btVector3(5, 0, -5), btVector3(0, 0, 5));
+	btBvhTriangleMeshShape triangleShape(&mesh, true);
+	btCapsuleShapeX capsule(btScalar(0.25), 1);
+
+	//lying on the face, both ends get a contact
+	ContactCollector above;
+	collide(&capsule, translation(0, btScalar(0.2), 0), &triangleShape, translation(0, 0, 0), above);
+	expectContacts(above, 2, btScalar(-0.05), btVector3(0, 1, 0));
+
+	//the triangle is two sided
+	ContactCollector below;
+	collide(&capsule, translation(0, btScalar(-0.2), 0), &triangleShape, translation(0, 0, 0), below);
+	expectContacts(below, 2, btScalar(-0.05), btVector3(0, -1, 0));
+}
+
+TEST_F(CapsuleCollisionTest, CapsuleOnTriangleEdge)
+{
+	btTriangleMesh mesh;
+	mesh.addTriangle(btVector3(-5, 0, -5), btVector3(5, 0, -5), btVector3(0, 0, 5));
+	btBvhTriangleMeshShape triangleShape(&mesh, true);
+	btCapsuleShape capsule(btScalar(0.25), 1);
+	//vertical capsule beside the edge z = -5, its segment is 0.2 away from the edge
+	ContactCollector result;
+	collide(&capsule, translation(0, 0, btScalar(-5.2)), &triangleShape, translation(0, 0, 0), result);
+	expectContacts(result, 1, btScalar(-0.05), btVector3(0, 0, -1));
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,157 @@
+
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/BroadphaseCollision/btDbvt.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
+#include <BulletCollision/CollisionShapes/btCylinderShape.h>
+#include <gtest/gtest.h>
+
+static const int NUM_CHILDREN = 64;
+
+static btScalar randomScalar(btScalar lo, btScalar hi)
+{
+	return lo + (hi - lo) * btScalar(rand()) / btScalar(RAND_MAX);
+}
+
+static btTransform randomTransform()
+{
+	btQuaternion rotation(btVector3(randomScalar(-1, 1), randomScalar(-1, 1), randomScalar(-1, 1) + btScalar(2)).normalized(), randomScalar(0, SIMD_2_PI));
+	return btTransform(rotation, btVector3(randomScalar(-10, 10), randomScalar(-10, 10), randomScalar(-10, 10)));
+}
+
+struct CollectChildren : btDbvt::ICollide
+{
+	btAlignedObjectArray<int> m_found;
+	void Process(const btDbvtNode* leaf)
+	{
+		m_found.push_back(leaf->dataAsInt);
+	}
+};
+
+struct IntLess
+{
+	bool operator()(int a, int b) const { return a < b; }
+};
+
+struct CompoundScene
+{
+	btBoxShape m_box;
+	btSphereShape m_sphere;
+	btCylinderShape m_cylinder;
+	//moved one child at a time with updateChildTransform
+	btCompoundShape m_single;
+	//moved with one updateChildTransforms call
+	btCompoundShape m_batched;
+
+	CompoundScene()
+		: m_box(btVector3(0.5, 1, 0.25)),
+		  m_sphere(0.75),
+		  m_cylinder(btVector3(0.3, 1, 0.3))
+	{
+		btCollisionShape* shapes[3] = {&m_box, &m_sphere, &m_cylinder};
+		for (int i = 0; i < NUM_CHILDREN; i++)
+		{
+			const btTransform transform = randomTransform();
+			m_single.addChildShape(transform, shapes[i % 3]);
+			m_batched.addChildShape(transform, shapes[i % 3]);
+		}
+	}
+
+	void checkSame()
+	{
+		ASSERT_EQ(m_single.getNumChildShapes(), m_batched.getNumChildShapes());
+		for (int i = 0; i < m_single.getNumChildShapes(); i++)
+		{
+			const btDbvtVolume& volumeSingle = m_single.getChildList()[i].m_node->volume;
+			const btDbvtVolume& volumeBatched = m_batched.getChildList()[i].m_node->volume;
+			EXPECT_EQ(volumeSingle.Mins(), volumeBatched.Mins()) << "child " << i;
+			EXPECT_EQ(volumeSingle.Maxs(), volumeBatched.Maxs()) << "child " << i;
+			EXPECT_EQ(i, m_batched.getChildList()[i].m_node->dataAsInt);
+		}
+
+		const btTransform trans = randomTransform();
+		btVector3 minSingle, maxSingle, minBatched, maxBatched;
+		m_single.getAabb(trans, minSingle, maxSingle);
+		m_batched.getAabb(trans, minBatched, maxBatched);
+		EXPECT_NEAR(0, (minSingle - minBatched).length(), SIMD_EPSILON);
+		EXPECT_NEAR(0, (maxSingle - maxBatched).length(), SIMD_EPSILON);
+
+		//every internal node of the refit tree bounds its children
+		checkVolumes(m_batched.getDynamicAabbTree()->m_root);
+
+		for (int q = 0; q < 20; q++)
+		{
+			const btDbvtVolume query = btDbvtVolume::FromCE(btVector3(randomScalar(-10, 10), randomScalar(-10, 10), randomScalar(-10, 10)), btVector3(3, 3, 3));
+			CollectChildren single;
+			CollectChildren batched;
+			m_single.getDynamicAabbTree()->collideTV(m_single.getDynamicAabbTree()->m_root, query, single);
+			m_batched.getDynamicAabbTree()->collideTV(m_batched.getDynamicAabbTree()->m_root, query, batched);
+			single.m_found.quickSort(IntLess());
+			batched.m_found.quickSort(IntLess());
+			ASSERT_EQ(single.m_found.size(), batched.m_found.size());
+			for (int i = 0; i < single.m_found.size(); i++)
+			{
+				EXPECT_EQ(single.m_found[i], batched.m_found[i]);
+			}
+		}
+	}
+
+	void checkVolumes(const btDbvtNode* node)
+	{
+		if (node->isinternal())
+		{
+			EXPECT_TRUE(node->volume.Contain(node->childs[0]->volume));
+			EXPECT_TRUE(node->volume.Contain(node->childs[1]->volume));
+			checkVolumes(node->childs[0]);
+			checkVolumes(node->childs[1]);
+		}
+	}
+};
+
+TEST(BulletCollisionTest, CompoundBatchedUpdateMatchesSingleUpdates)
+{
+	srand(21);
+	CompoundScene scene;
+	scene.checkSame();
+
+	//a subset of the children, in random order
+	for (int pass = 0; pass < 5; pass++)
+	{
+		btAlignedObjectArray<int> indices;
+		btAlignedObjectArray<btTransform> transforms;
+		for (int i = 0; i < NUM_CHILDREN / 4; i++)
+		{
+			indices.push_back(rand() % NUM_CHILDREN);
+			transforms.push_back(randomTransform());
+		}
+		for (int i = 0; i < indices.size(); i++)
+		{
+			scene.m_single.updateChildTransform(indices[i], transforms[i]);
+		}
+		scene.m_batched.updateChildTransforms(indices.size(), &indices[0], &transforms[0]);
+		scene.checkSame();
+	}
+
+	//all children, without an index array
+	btAlignedObjectArray<btTransform> transforms;
+	for (int i = 0; i < NUM_CHILDREN; i++)
+	{
+		transforms.push_back(randomTransform());
+		scene.m_single.updateChildTransform(i, transforms[i], i == NUM_CHILDREN - 1);
+	}
+	scene.m_batched.updateChildTransforms(NUM_CHILDREN, 0, &transforms[0]);
+	scene.checkSame();
+
+	//a child that stays in place keeps its volume
+	const btTransform unchanged = scene.m_batched.getChildTransform(3);
+	const int index = 3;
+	scene.m_single.updateChildTransform(index, unchanged);
+	scene.m_batched.updateChildTransforms(1, &index, &unchanged);
+	scene.checkSame();
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
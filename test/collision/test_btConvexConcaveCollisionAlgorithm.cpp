@@ -0,0 +1,202 @@
+
+#include <btBulletCollisionCommon.h>
+#include <BulletCollision/CollisionDispatch/btConvexConcaveCollisionAlgorithm.h>
+#include <gtest/gtest.h>
+
+static const int GRID_SIZE = 16;
+static const btScalar GRID_SPACING = btScalar(0.5);
+static const btScalar DEPTH_TOLERANCE = btScalar(5e-3);
+
+//vertices and indices of a GRID_SIZE x GRID_SIZE quad grid centered at the origin, in the y = 0 plane unless bumpy
+struct GridMesh
+{
+	btAlignedObjectArray<btVector3> m_vertices;
+	btAlignedObjectArray<int> m_indices;
+	btTriangleIndexVertexArray* m_meshInterface;
+	btBvhTriangleMeshShape* m_shape;
+
+	GridMesh(bool bumpy)
+	{
+		for (int j = 0; j <= GRID_SIZE; j++)
+		{
+			for (int i = 0; i <= GRID_SIZE; i++)
+			{
+				btScalar x = (i - GRID_SIZE / 2) * GRID_SPACING;
+				btScalar z = (j - GRID_SIZE / 2) * GRID_SPACING;
+				btScalar y = bumpy ? btScalar(0.3) * btSin(x) * btCos(btScalar(1.3) * z) : 0;
+				m_vertices.push_back(btVector3(x, y, z));
+			}
+		}
+		for (int j = 0; j < GRID_SIZE; j++)
+		{
+			for (int i = 0; i < GRID_SIZE; i++)
+			{
+				int v = j * (GRID_SIZE + 1) + i;
+				m_indices.push_back(v);
+				m_indices.push_back(v + GRID_SIZE + 1);
+				m_indices.push_back(v + 1);
+				m_indices.push_back(v + 1);
+				m_indices.push_back(v + GRID_SIZE + 1);
+				m_indices.push_back(v + GRID_SIZE + 2);
+			}
+		}
+		m_meshInterface = new btTriangleIndexVertexArray(m_indices.size() / 3, &m_indices[0], 3 * sizeof(int),
+														 m_vertices.size(), m_vertices[0].m_floats, sizeof(btVector3));
+		//leave room in the quantization range for moving the vertices
+		m_shape = new btBvhTriangleMeshShape(m_meshInterface, true, btVector3(-10, -10, -10), btVector3(10, 10, 10));
+	}
+
+	~GridMesh()
+	{
+		delete m_shape;
+		delete m_meshInterface;
+	}
+};
+
+class ConvexConcaveTest : public ::testing::Test
+{
+protected:
+	btDefaultCollisionConfiguration m_configuration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btCollisionWorld m_world;
+	bool m_savedBatchFlag;
+
+	ConvexConcaveTest()
+		: m_dispatcher(&m_configuration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_configuration),
+		  m_savedBatchFlag(gBatchConvexConcaveTriangles)
+	{
+	}
+
+	virtual ~ConvexConcaveTest()
+	{
+		gBatchConvexConcaveTriangles = m_savedBatchFlag;
+		while (m_world.getNumCollisionObjects())
+		{
+			m_world.removeCollisionObject(m_world.getCollisionObjectArray()[0]);
+		}
+	}
+
+	//contacts of all manifolds after one pass of the persistent narrowphase, sorted by depth
+	void detect(btAlignedObjectArray<btScalar>& depths)
+	{
+		m_world.performDiscreteCollisionDetection();
+		depths.resize(0);
+		for (int i = 0; i < m_dispatcher.getNumManifolds(); i++)
+		{
+			const btPersistentManifold* manifold = m_dispatcher.getManifoldByIndexInternal(i);
+			for (int p = 0; p < manifold->getNumContacts(); p++)
+			{
+				depths.push_back(manifold->getContactPoint(p).getDistance());
+			}
+		}
+		depths.quickSort(btLess());
+	}
+
+	void clearManifolds()
+	{
+		for (int i = 0; i < m_dispatcher.getNumManifolds(); i++)
+		{
+			m_dispatcher.clearManifold(m_dispatcher.getManifoldByIndexInternal(i));
+		}
+	}
+
+	struct btLess
+	{
+		bool operator()(btScalar a, btScalar b) const
+		{
+			return a < b;
+		}
+	};
+};
+
+TEST_F(ConvexConcaveTest, BatchedMatchesPerTriangle)
+{
+	GridMesh mesh(true);
+	btBoxShape box(btVector3(btScalar(0.4), btScalar(0.3), btScalar(0.5)));
+	btSphereShape sphere(btScalar(0.45));
+	btCylinderShape cylinder(btVector3(btScalar(0.3), btScalar(0.5), btScalar(0.3)));
+	btCapsuleShapeX capsule(btScalar(0.25), btScalar(0.8));
+	btCollisionShape* shapes[] = {&box, &sphere, &cylinder, &capsule};
+	const int numShapes = sizeof(shapes) / sizeof(shapes[0]);
+
+	for (int pose = 0; pose < 8; pose++)
+	{
+		btTransform convexTrans(btQuaternion(btVector3(1, btScalar(pose), btScalar(0.5)).normalized(), btScalar(0.37) * pose),
+								btVector3(btScalar(-1.6) + btScalar(0.45) * pose, btScalar(0.25), btScalar(1.1) - btScalar(0.3) * pose));
+		for (int s = 0; s < numShapes; s++)
+		{
+			btAlignedObjectArray<btScalar> depths[2];
+			for (int batched = 0; batched < 2; batched++)
+			{
+				gBatchConvexConcaveTriangles = batched != 0;
+				btCollisionObject meshObject;
+				meshObject.setCollisionShape(mesh.m_shape);
+				btCollisionObject convexObject;
+				convexObject.setCollisionShape(shapes[s]);
+				convexObject.setWorldTransform(convexTrans);
+				m_world.addCollisionObject(&meshObject);
+				m_world.addCollisionObject(&convexObject);
+				detect(depths[batched]);
+				m_world.removeCollisionObject(&convexObject);
+				m_world.removeCollisionObject(&meshObject);
+			}
+			ASSERT_EQ(depths[0].size(), depths[1].size()) << "pose " << pose << " shape " << s;
+			for (int i = 0; i < depths[0].size(); i++)
+			{
+				EXPECT_NEAR(depths[0][i], depths[1][i], SIMD_EPSILON) << "pose " << pose << " shape " << s;
+			}
+		}
+	}
+}
+
+TEST_F(ConvexConcaveTest, RefitInvalidatesCachedTriangles)
+{
+	gBatchConvexConcaveTriangles = true;
+	GridMesh mesh(false);
+	btBoxShape box(btVector3(btScalar(0.5), btScalar(0.5), btScalar(0.5)));
+	btCollisionObject meshObject;
+	meshObject.setCollisionShape(mesh.m_shape);
+	btCollisionObject boxObject;
+	boxObject.setCollisionShape(&box);
+	boxObject.setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(btScalar(0.1), btScalar(0.45), btScalar(0.2))));
+	m_world.addCollisionObject(&meshObject);
+	m_world.addCollisionObject(&boxObject);
+
+	btAlignedObjectArray<btScalar> depths;
+	detect(depths);
+	ASSERT_GT(depths.size(), 0);
+	EXPECT_NEAR(btScalar(-0.05), depths[0], DEPTH_TOLERANCE);
+
+	//raise the mesh in place, the refit announces the change to the cached triangles of the pair
+	for (int i = 0; i < mesh.m_vertices.size(); i++)
+	{
+		mesh.m_vertices[i].setY(btScalar(0.1));
+	}
+	btVector3 aabbMin, aabbMax;
+	mesh.m_meshInterface->calculateAabbBruteForce(aabbMin, aabbMax);
+	mesh.m_shape->refitTree(aabbMin, aabbMax);
+
+	clearManifolds();
+	detect(depths);
+	ASSERT_GT(depths.size(), 0);
+	EXPECT_NEAR(btScalar(-0.15), depths[0], DEPTH_TOLERANCE);
+
+	//same contacts as the per triangle path, which reads the vertices directly
+	gBatchConvexConcaveTriangles = false;
+	clearManifolds();
+	btAlignedObjectArray<btScalar> perTriangleDepths;
+	detect(perTriangleDepths);
+	ASSERT_EQ(perTriangleDepths.size(), depths.size());
+	for (int i = 0; i < depths.size(); i++)
+	{
+		EXPECT_NEAR(perTriangleDepths[i], depths[i], SIMD_EPSILON);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,92 @@
+
+#include <LinearMath/btConvexHullComputer.h>
+#include <LinearMath/btVector3.h>
+#include <gtest/gtest.h>
+
+static const int ALL_FLAGS = btConvexHullComputer::CHC_PREFILTER_POINTS | btConvexHullComputer::CHC_PARALLEL;
+
+//small inputs go through the accelerated paths when m_minAcceleratedPointCount is 0
+static btScalar computeHull(btConvexHullComputer& hull, const btAlignedObjectArray<btVector3>& points, int flags)
+{
+	hull.m_flags = flags;
+	hull.m_minAcceleratedPointCount = 0;
+	const btScalar* coords = points.size() ? points[0].m_floats : 0;
+	return hull.compute(coords, sizeof(btVector3), points.size(), 0, 0);
+}
+
+static void expectSameHull(const btConvexHullComputer& a, const btConvexHullComputer& b)
+{
+	ASSERT_EQ(a.vertices.size(), b.vertices.size());
+	EXPECT_EQ(a.edges.size(), b.edges.size());
+	EXPECT_EQ(a.faces.size(), b.faces.size());
+	//vertex order may differ between the paths, compare as sets
+	for (int i = 0; i < a.vertices.size(); i++)
+	{
+		bool found = false;
+		for (int j = 0; j < b.vertices.size() && !found; j++)
+		{
+			found = (a.vertices[i] - b.vertices[j]).length2() < SIMD_EPSILON;
+		}
+		EXPECT_TRUE(found) << "vertex " << i;
+	}
+}
+
+TEST(btConvexHullComputerTest, EmptyInput)
+{
+	btAlignedObjectArray<btVector3> points;
+	btConvexHullComputer hull;
+	EXPECT_EQ(0, computeHull(hull, points, ALL_FLAGS));
+	EXPECT_EQ(0, hull.vertices.size());
+	EXPECT_EQ(0, hull.edges.size());
+	EXPECT_EQ(0, hull.faces.size());
+}
+
+TEST(btConvexHullComputerTest, DegenerateInputs)
+{
+	btAlignedObjectArray<btVector3> points;
+	points.push_back(btVector3(0, 0, 0));
+	points.push_back(btVector3(1, 0, 0));
+	points.push_back(btVector3(0, 1, 0));
+	points.push_back(btVector3(1, 1, 0));
+	//a point, a segment, a triangle and a coplanar quad
+	for (int count = 1; count <= points.size(); count++)
+	{
+		btAlignedObjectArray<btVector3> input;
+		for (int i = 0; i < count; i++)
+		{
+			input.push_back(points[i]);
+		}
+		btConvexHullComputer reference;
+		btConvexHullComputer accelerated;
+		computeHull(reference, input, 0);
+		computeHull(accelerated, input, ALL_FLAGS);
+		EXPECT_EQ(count, reference.vertices.size());
+		expectSameHull(reference, accelerated);
+	}
+}
+
+TEST(btConvexHullComputerTest, PrefilterKeepsHull)
+{
+	//a cube with interior points, only the corners are on the hull
+	btAlignedObjectArray<btVector3> points;
+	for (int i = 0; i < 8; i++)
+	{
+		points.push_back(btVector3(i & 1 ? 1 : -1, i & 2 ? 1 : -1, i & 4 ? 1 : -1));
+	}
+	for (int i = 0; i < 1000; i++)
+	{
+		points.push_back(btVector3(btScalar(((i * 37) % 101) / 101.0 * 1.8 - 0.9), btScalar(((i * 61) % 103) / 103.0 * 1.8 - 0.9), btScalar(((i * 83) % 107) / 107.0 * 1.8 - 0.9)));
+	}
+	btConvexHullComputer reference;
+	btConvexHullComputer accelerated;
+	computeHull(reference, points, 0);
+	computeHull(accelerated, points, ALL_FLAGS);
+	EXPECT_EQ(8, reference.vertices.size());
+	expectSameHull(reference, accelerated);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,229 @@
+
+#include <BulletCollision/BroadphaseCollision/btDbvt.h>
+#include <LinearMath/btAlignedObjectArray.h>
+#include <gtest/gtest.h>
+
+static const int NUM_LEAVES = 500;
+
+static btScalar randomScalar(btScalar lo, btScalar hi)
+{
+	return lo + (hi - lo) * btScalar(rand()) / btScalar(RAND_MAX);
+}
+
+static btDbvtVolume randomVolume()
+{
+	const btVector3 center(randomScalar(-50, 50), randomScalar(-50, 50), randomScalar(-50, 50));
+	const btVector3 extents(randomScalar(0.1, 3), randomScalar(0.1, 3), randomScalar(0.1, 3));
+	return btDbvtVolume::FromCE(center, extents);
+}
+
+//checks the parent links and volumes below 'node', returns the number of leaves
+static int checkNode(const btDbvtNode* node, const btDbvtNode* parent, int& numInternalNodes)
+{
+	EXPECT_EQ(parent, node->parent);
+	if (node->isleaf())
+		return 1;
+	++numInternalNodes;
+	for (int i = 0; i < 2; i++)
+	{
+		EXPECT_TRUE(node->childs[i] != 0);
+		if (node->childs[i] == 0)
+			return 0;
+		EXPECT_TRUE(node->volume.Contain(node->childs[i]->volume));
+	}
+	return checkNode(node->childs[0], node, numInternalNodes) + checkNode(node->childs[1], node, numInternalNodes);
+}
+
+static void checkTree(const btDbvt& tree, int numLeaves)
+{
+	ASSERT_EQ(numLeaves, tree.m_leaves);
+	if (numLeaves == 0)
+	{
+		EXPECT_TRUE(tree.m_root == 0);
+		return;
+	}
+	ASSERT_TRUE(tree.m_root != 0);
+	int numInternalNodes = 0;
+	EXPECT_EQ(numLeaves, checkNode(tree.m_root, 0, numInternalNodes));
+	EXPECT_EQ(numLeaves - 1, numInternalNodes);
+	EXPECT_EQ(numInternalNodes, tree.m_internalNodes.m_numNodes);
+	EXPECT_EQ(numLeaves, tree.m_leafNodes.m_numNodes);
+}
+
+//the leaf data holds the index of the leaf in the test arrays
+struct CollectLeaves : btDbvt::ICollide
+{
+	btAlignedObjectArray<int> m_found;
+	void Process(const btDbvtNode* leaf)
+	{
+		m_found.push_back(int(size_t(leaf->data)));
+	}
+};
+
+struct CollectPairs : btDbvt::ICollide
+{
+	btAlignedObjectArray<int> m_found;
+	int m_numLeaves1;
+	void Process(const btDbvtNode* a, const btDbvtNode* b)
+	{
+		m_found.push_back(int(size_t(a->data)) * m_numLeaves1 + int(size_t(b->data)));
+	}
+};
+
+struct IntLess
+{
+	bool operator()(int a, int b) const { return a < b; }
+};
+
+struct DbvtScene
+{
+	btDbvt m_tree;
+	btAlignedObjectArray<btDbvtNode*> m_leaves;
+	btAlignedObjectArray<btDbvtVolume> m_volumes;
+
+	DbvtScene(int numLeaves)
+	{
+		for (int i = 0; i < numLeaves; i++)
+		{
+			m_volumes.push_back(randomVolume());
+			m_leaves.push_back(m_tree.insert(m_volumes[i], (void*)size_t(i)));
+		}
+	}
+
+	//removes leaf i, the last leaf takes its index
+	void remove(int i)
+	{
+		m_tree.remove(m_leaves[i]);
+		const int last = m_leaves.size() - 1;
+		m_leaves[i] = m_leaves[last];
+		m_volumes[i] = m_volumes[last];
+		m_leaves[i]->data = (void*)size_t(i);
+		m_leaves.pop_back();
+		m_volumes.pop_back();
+	}
+
+	void checkQueries(const btDbvt& tree)
+	{
+		for (int q = 0; q < 20; q++)
+		{
+			const btDbvtVolume query = btDbvtVolume::FromCE(btVector3(randomScalar(-50, 50), randomScalar(-50, 50), randomScalar(-50, 50)), btVector3(10, 10, 10));
+			CollectLeaves collector;
+			tree.collideTV(tree.m_root, query, collector);
+			btAlignedObjectArray<int> expected;
+			for (int i = 0; i < m_volumes.size(); i++)
+			{
+				if (Intersect(m_volumes[i], query))
+					expected.push_back(i);
+			}
+			collector.m_found.quickSort(IntLess());
+			ASSERT_EQ(expected.size(), collector.m_found.size());
+			for (int i = 0; i < expected.size(); i++)
+			{
+				EXPECT_EQ(expected[i], collector.m_found[i]);
+			}
+		}
+	}
+};
+
+static void checkPairs(btDbvt& tree0, const DbvtScene& scene0, const DbvtScene& scene1)
+{
+	CollectPairs collector;
+	collector.m_numLeaves1 = scene1.m_volumes.size();
+	tree0.collideTT(tree0.m_root, scene1.m_tree.m_root, collector);
+	btAlignedObjectArray<int> expected;
+	for (int i = 0; i < scene0.m_volumes.size(); i++)
+	{
+		for (int j = 0; j < scene1.m_volumes.size(); j++)
+		{
+			if (Intersect(scene0.m_volumes[i], scene1.m_volumes[j]))
+				expected.push_back(i * collector.m_numLeaves1 + j);
+		}
+	}
+	collector.m_found.quickSort(IntLess());
+	ASSERT_EQ(expected.size(), collector.m_found.size());
+	for (int i = 0; i < expected.size(); i++)
+	{
+		EXPECT_EQ(expected[i], collector.m_found[i]);
+	}
+}
+
+//insert, remove and update leaves, then move them around so the incremental optimization relayouts the nodes
+static void mutate(DbvtScene& scene)
+{
+	for (int i = 0; i < NUM_LEAVES / 5; i++)
+	{
+		scene.remove(rand() % scene.m_leaves.size());
+	}
+	for (int i = 0; i < NUM_LEAVES / 10; i++)
+	{
+		const int index = scene.m_leaves.size();
+		scene.m_volumes.push_back(randomVolume());
+		scene.m_leaves.push_back(scene.m_tree.insert(scene.m_volumes[index], (void*)size_t(index)));
+	}
+	for (int step = 0; step < 20; step++)
+	{
+		for (int i = 0; i < scene.m_leaves.size(); i += 3)
+		{
+			const int index = rand() % scene.m_leaves.size();
+			scene.m_volumes[index] = randomVolume();
+			scene.m_tree.update(scene.m_leaves[index], scene.m_volumes[index]);
+		}
+		scene.m_tree.optimizeIncremental(1);
+	}
+}
+
+TEST(BulletCollisionTest, DbvtQueriesMatchBruteForce)
+{
+	srand(7);
+	DbvtScene scene(NUM_LEAVES);
+	checkTree(scene.m_tree, scene.m_leaves.size());
+	scene.checkQueries(scene.m_tree);
+
+	mutate(scene);
+	checkTree(scene.m_tree, scene.m_leaves.size());
+	scene.checkQueries(scene.m_tree);
+
+	scene.m_tree.optimizeNodeLayout();
+	EXPECT_EQ(0, scene.m_tree.computeLayoutFragmentation());
+	checkTree(scene.m_tree, scene.m_leaves.size());
+	scene.checkQueries(scene.m_tree);
+
+	scene.m_tree.optimizeTopDown();
+	checkTree(scene.m_tree, scene.m_leaves.size());
+	scene.checkQueries(scene.m_tree);
+}
+
+TEST(BulletCollisionTest, DbvtCollideTTMatchesBruteForce)
+{
+	srand(11);
+	DbvtScene scene0(NUM_LEAVES);
+	DbvtScene scene1(NUM_LEAVES / 2);
+	checkPairs(scene0.m_tree, scene0, scene1);
+
+	mutate(scene0);
+	mutate(scene1);
+	scene1.m_tree.optimizeNodeLayout();
+	checkPairs(scene0.m_tree, scene0, scene1);
+}
+
+TEST(BulletCollisionTest, DbvtCloneKeepsStructure)
+{
+	srand(13);
+	DbvtScene scene(NUM_LEAVES);
+	mutate(scene);
+	btDbvt clone;
+	scene.m_tree.clone(clone);
+	checkTree(clone, scene.m_leaves.size());
+	scene.checkQueries(clone);
+
+	//the clone owns its nodes, so changing the source must not affect it
+	scene.m_tree.clear();
+	checkTree(clone, scene.m_leaves.size());
+	scene.checkQueries(clone);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,170 @@
+
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <BulletCollision/CollisionShapes/btConvexPolyhedron.h>
+#include <BulletCollision/NarrowPhaseCollision/btPolyhedralContactClipping.h>
+#include <gtest/gtest.h>
+
+extern bool gUseGaussMapPruning;
+
+static const int NUM_HULLS = 12;
+static const int NUM_PAIRS = 200;
+static const int NUM_FRAMES = 8;
+
+static btScalar randomScalar(btScalar lo, btScalar hi)
+{
+	return lo + (hi - lo) * btScalar(rand()) / btScalar(RAND_MAX);
+}
+
+struct ContactCollector : btDiscreteCollisionDetectorInterface::Result
+{
+	btAlignedObjectArray<btVector3> m_points;
+	btAlignedObjectArray<btScalar> m_depths;
+
+	void setShapeIdentifiersA(int, int) {}
+	void setShapeIdentifiersB(int, int) {}
+	void addContactPoint(const btVector3&, const btVector3& pointInWorld, btScalar depth)
+	{
+		m_points.push_back(pointInWorld);
+		m_depths.push_back(depth);
+	}
+};
+
+struct SatResult
+{
+	bool m_overlap;
+	btVector3 m_axis;
+	btScalar m_depth;
+	ContactCollector m_contacts;
+};
+
+static btScalar overlapDepth(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, const btVector3& axis)
+{
+	btScalar minA, maxA, minB, maxB;
+	btVector3 witnessMin, witnessMax;
+	hullA.project(transA, axis, minA, maxA, witnessMin, witnessMax);
+	hullB.project(transB, axis, minB, maxB, witnessMin, witnessMax);
+	return btMin(maxA - minB, maxB - minA);
+}
+
+static void runSat(const btConvexPolyhedron& hullA, const btConvexPolyhedron& hullB, const btTransform& transA, const btTransform& transB, bool pruning, btPolyhedralSatCache* cache, SatResult& result)
+{
+	gUseGaussMapPruning = pruning;
+	ContactCollector unused;
+	result.m_axis.setValue(0, 1, 0);
+	result.m_overlap = btPolyhedralContactClipping::findSeparatingAxis(hullA, hullB, transA, transB, result.m_axis, unused, cache);
+	gUseGaussMapPruning = true;
+	result.m_depth = 0;
+	if (result.m_overlap)
+	{
+		result.m_depth = overlapDepth(hullA, hullB, transA, transB, result.m_axis);
+		btVertexArray worldVertsB1;
+		btVertexArray worldVertsB2;
+		btPolyhedralContactClipping::clipHullAgainstHull(result.m_axis, hullA, hullB, transA, transB, btScalar(-1e30), btScalar(0), worldVertsB1, worldVertsB2, result.m_contacts);
+	}
+}
+
+static void expectSameResult(const SatResult& expected, const SatResult& actual, int pair, int frame)
+{
+	ASSERT_EQ(expected.m_overlap, actual.m_overlap) << "pair " << pair << " frame " << frame;
+	if (!expected.m_overlap)
+		return;
+	//the minimum penetration axis is a face of the Minkowski difference, so pruning must not lose it
+	EXPECT_NEAR(expected.m_depth, actual.m_depth, 1e-4) << "pair " << pair << " frame " << frame;
+	EXPECT_NEAR(0, (expected.m_axis - actual.m_axis).length(), 1e-3) << "pair " << pair << " frame " << frame;
+	ASSERT_EQ(expected.m_contacts.m_points.size(), actual.m_contacts.m_points.size()) << "pair " << pair << " frame " << frame;
+	for (int i = 0; i < expected.m_contacts.m_points.size(); i++)
+	{
+		EXPECT_NEAR(0, (expected.m_contacts.m_points[i] - actual.m_contacts.m_points[i]).length(), 1e-3) << "pair " << pair << " frame " << frame;
+		EXPECT_NEAR(expected.m_contacts.m_depths[i], actual.m_contacts.m_depths[i], 1e-3) << "pair " << pair << " frame " << frame;
+	}
+}
+
+static btConvexHullShape* createRandomHull(int numPoints)
+{
+	btConvexHullShape* shape = new btConvexHullShape();
+	const btVector3 scaling(randomScalar(0.3, 1), randomScalar(0.3, 1), randomScalar(0.3, 1));
+	for (int j = 0; j < numPoints; j++)
+	{
+		btVector3 p;
+		do
+		{
+			p.setValue(randomScalar(-1, 1), randomScalar(-1, 1), randomScalar(-1, 1));
+		} while (p.length2() > 1 || p.length2() < 1e-6);
+		p.normalize();
+		shape->addPoint(p * scaling, false);
+	}
+	shape->recalcLocalAabb();
+	shape->initializePolyhedralFeatures();
+	return shape;
+}
+
+//boxes have parallel edges and merged coplanar faces
+static btConvexHullShape* createBoxHull()
+{
+	btConvexHullShape* shape = new btConvexHullShape();
+	const btVector3 halfExtents(randomScalar(0.2, 0.8), randomScalar(0.2, 0.8), randomScalar(0.2, 0.8));
+	for (int j = 0; j < 8; j++)
+	{
+		shape->addPoint(btVector3(j & 1 ? 1 : -1, j & 2 ? 1 : -1, j & 4 ? 1 : -1) * halfExtents, false);
+	}
+	shape->recalcLocalAabb();
+	shape->initializePolyhedralFeatures();
+	return shape;
+}
+
+static btTransform randomTransform(btScalar range)
+{
+	btQuaternion rotation(btVector3(randomScalar(-1, 1), randomScalar(-1, 1), randomScalar(-1, 1) + btScalar(2)).normalized(), randomScalar(0, SIMD_2_PI));
+	return btTransform(rotation, btVector3(randomScalar(-range, range), randomScalar(-range, range), randomScalar(-range, range)));
+}
+
+TEST(BulletCollisionTest, GaussMapPruningKeepsSeparatingAxisAndContacts)
+{
+	srand(1234);
+	btAlignedObjectArray<btConvexHullShape*> hulls;
+	for (int i = 0; i < NUM_HULLS; i++)
+	{
+		hulls.push_back(i < 3 ? createBoxHull() : createRandomHull(4 * i));
+	}
+
+	int numOverlaps = 0;
+	for (int pair = 0; pair < NUM_PAIRS; pair++)
+	{
+		const btConvexPolyhedron& hullA = *hulls[rand() % NUM_HULLS]->getConvexPolyhedron();
+		const btConvexPolyhedron& hullB = *hulls[rand() % NUM_HULLS]->getConvexPolyhedron();
+		btTransform transA = randomTransform(0.5);
+		btTransform transB = randomTransform(0.5);
+		const btTransform motionA = randomTransform(0.02);
+		const btTransform motionB = randomTransform(0.02);
+		btPolyhedralSatCache cache;
+		//the pair moves a little every frame, so the cached feature is tried first and sometimes goes stale
+		for (int frame = 0; frame < NUM_FRAMES; frame++)
+		{
+			SatResult full;
+			SatResult pruned;
+			SatResult cached;
+			runSat(hullA, hullB, transA, transB, false, 0, full);
+			runSat(hullA, hullB, transA, transB, true, 0, pruned);
+			runSat(hullA, hullB, transA, transB, true, &cache, cached);
+			expectSameResult(full, pruned, pair, frame);
+			expectSameResult(full, cached, pair, frame);
+			numOverlaps += full.m_overlap;
+			transA = transA * motionA;
+			transB = transB * motionB;
+		}
+	}
+	//the random placement has to exercise both outcomes
+	EXPECT_GT(numOverlaps, NUM_PAIRS);
+	EXPECT_LT(numOverlaps, NUM_PAIRS * NUM_FRAMES);
+
+	for (int i = 0; i < hulls.size(); i++)
+	{
+		delete hulls[i];
+	}
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,149 @@
+
+#include <btBulletCollisionCommon.h>
+#include <BulletCollision/CollisionShapes/btSdfBaker.h>
+#include <BulletCollision/CollisionShapes/btSdfCollisionShape.h>
+#include <gtest/gtest.h>
+
+static const btScalar BOX_HALF_EXTENT = 1;
+static const btScalar SPHERE_RADIUS = btScalar(0.5);
+static const btScalar DEPTH_TOLERANCE = btScalar(0.02);
+static const btScalar NORMAL_TOLERANCE = btScalar(0.01);
+
+//closed box mesh with outward facing triangles
+static void addBoxTriangles(btTriangleMesh& mesh, btScalar h)
+{
+	btVector3 v[8];
+	for (int i = 0; i < 8; i++)
+	{
+		v[i].setValue(i & 1 ? h : -h, i & 2 ? h : -h, i & 4 ? h : -h);
+	}
+	static const int quads[6][4] = {
+		{0, 4, 6, 2},  //-x
+		{1, 3, 7, 5},  //+x
+		{0, 1, 5, 4},  //-y
+		{2, 6, 7, 3},  //+y
+		{0, 2, 3, 1},  //-z
+		{4, 5, 7, 6},  //+z
+	};
+	for (int q = 0; q < 6; q++)
+	{
+		mesh.addTriangle(v[quads[q][0]], v[quads[q][1]], v[quads[q][2]]);
+		mesh.addTriangle(v[quads[q][0]], v[quads[q][2]], v[quads[q][3]]);
+	}
+}
+
+struct DeepestContactCallback : public btCollisionWorld::ContactResultCallback
+{
+	int m_numContacts;
+	btScalar m_depth;
+	btVector3 m_normalOnSdf;
+
+	DeepestContactCallback()
+		: m_numContacts(0),
+		  m_depth(BT_LARGE_FLOAT),
+		  m_normalOnSdf(0, 0, 0)
+	{
+	}
+
+	virtual btScalar addSingleResult(btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1)
+	{
+		m_numContacts++;
+		if (cp.getDistance() < m_depth)
+		{
+			m_depth = cp.getDistance();
+			m_normalOnSdf = cp.m_normalWorldOnB;
+		}
+		return 0;
+	}
+};
+
+class SdfBoxTest : public ::testing::Test
+{
+protected:
+	btDefaultCollisionConfiguration m_configuration;
+	btCollisionDispatcher m_dispatcher;
+	btDbvtBroadphase m_broadphase;
+	btCollisionWorld m_world;
+	btTriangleMesh m_mesh;
+	btAlignedObjectArray<char> m_sdfData;
+	btSdfCollisionShape m_sdfShape;
+	btSphereShape m_sphereShape;
+	btCollisionObject m_sdfObject;
+	btCollisionObject m_sphereObject;
+
+	SdfBoxTest()
+		: m_dispatcher(&m_configuration),
+		  m_world(&m_dispatcher, &m_broadphase, &m_configuration),
+		  m_sphereShape(SPHERE_RADIUS)
+	{
+	}
+
+	virtual void SetUp()
+	{
+		addBoxTriangles(m_mesh, BOX_HALF_EXTENT);
+		btSdfBakeSettings settings;
+		//leave room around the box so sphere centers outside the box are still inside the grid
+		settings.m_padding = btScalar(0.5);
+		ASSERT_TRUE(btSdfBaker::bake(&m_mesh, settings, m_sdfData));
+		ASSERT_TRUE(m_sdfShape.initializeSDF(&m_sdfData[0], m_sdfData.size()));
+		m_sdfObject.setCollisionShape(&m_sdfShape);
+		m_sphereObject.setCollisionShape(&m_sphereShape);
+	}
+
+	void collide(const btTransform& sdfTrans, const btVector3& sphereCenter, DeepestContactCallback& result)
+	{
+		m_sdfObject.setWorldTransform(sdfTrans);
+		m_sphereObject.setWorldTransform(btTransform(btQuaternion::getIdentity(), sphereCenter));
+		m_world.contactPairTest(&m_sphereObject, &m_sdfObject, result);
+	}
+};
+
+TEST_F(SdfBoxTest, SphereOnEachFace)
+{
+	const btScalar penetration = btScalar(0.2);
+	for (int axis = 0; axis < 3; axis++)
+	{
+		for (int sign = -1; sign <= 1; sign += 2)
+		{
+			btVector3 faceNormal(0, 0, 0);
+			faceNormal[axis] = btScalar(sign);
+			//offset the center a little along the face so the query is not on a symmetry plane of the grid
+			btVector3 tangent(0, 0, 0);
+			tangent[(axis + 1) % 3] = btScalar(0.3);
+			btVector3 center = faceNormal * (BOX_HALF_EXTENT + SPHERE_RADIUS - penetration) + tangent;
+
+			DeepestContactCallback result;
+			collide(btTransform::getIdentity(), center, result);
+			ASSERT_GT(result.m_numContacts, 0) << "axis " << axis << " sign " << sign;
+			EXPECT_NEAR(-penetration, result.m_depth, DEPTH_TOLERANCE) << "axis " << axis << " sign " << sign;
+			EXPECT_NEAR(1, result.m_normalOnSdf.dot(faceNormal), NORMAL_TOLERANCE) << "axis " << axis << " sign " << sign;
+		}
+	}
+}
+
+TEST_F(SdfBoxTest, TransformedSdf)
+{
+	btTransform sdfTrans(btQuaternion(btVector3(1, 1, 0).normalized(), btScalar(0.7)), btVector3(3, -2, 1));
+	const btScalar penetration = btScalar(0.1);
+	btVector3 localFaceNormal(0, 1, 0);
+	btVector3 localCenter = localFaceNormal * (BOX_HALF_EXTENT + SPHERE_RADIUS - penetration) + btVector3(btScalar(0.2), 0, btScalar(-0.4));
+
+	DeepestContactCallback result;
+	collide(sdfTrans, sdfTrans * localCenter, result);
+	ASSERT_GT(result.m_numContacts, 0);
+	EXPECT_NEAR(-penetration, result.m_depth, DEPTH_TOLERANCE);
+	EXPECT_NEAR(1, result.m_normalOnSdf.dot(sdfTrans.getBasis() * localFaceNormal), NORMAL_TOLERANCE);
+}
+
+TEST_F(SdfBoxTest, SeparatedSphere)
+{
+	DeepestContactCallback result;
+	collide(btTransform::getIdentity(), btVector3(0, 0, BOX_HALF_EXTENT + SPHERE_RADIUS + btScalar(0.1)), result);
+	EXPECT_EQ(0, result.m_numContacts);
+}
+
+int main(int argc, char** argv)
+{
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}